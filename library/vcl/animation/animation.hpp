@@ -0,0 +1,10 @@
+#pragma once
+
+// ***************************************************************** //
+// Animation helpers
+//
+// Deformation and animation of shapes driven by skeletons
+// ***************************************************************** //
+
+#include "clip/animation_clip.hpp"
+#include "skinning/skinning.hpp"
@@ -0,0 +1,155 @@
+#include "animation_clip.hpp"
+
+#include "vcl/base/base.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vcl
+{
+	size_t animation_find_segment(buffer<float> const& time, float t, size_t& segment)
+	{
+		size_t const N = time.size();
+		assert_vcl(N>=2, "Searching a segment requires at least 2 keys");
+
+		// Sequential playback: t is in the same segment, or in the next one
+		size_t const s = segment;
+		if (s+1<N && time[s]<=t) {
+			if (t<time[s+1])
+				return s;
+			if (s+2<N && t<time[s+2])
+				return segment = s+1;
+		}
+
+		// Binary search of the first key after t
+		size_t const k = size_t(std::upper_bound(time.data.begin(), time.data.end(), t) - time.data.begin());
+		segment = std::min(std::max(k, size_t(1)), N-1) - 1;
+		return segment;
+	}
+
+	// Cardinal spline between (t1,p1) and (t2,p2), the tangents are computed from the neighboring keys
+	template <typename T>
+	static T cardinal_spline(float t, float t0, float t1, float t2, float t3, T const& p0, T const& p1, T const& p2, T const& p3, float K)
+	{
+		float const s = (t-t1)/(t2-t1);
+		float const s2 = s*s;
+		float const s3 = s2*s;
+		T const d1 = (2*K*(t2-t1)/(t2-t0)) * (p2-p0);
+		T const d2 = (2*K*(t2-t1)/(t3-t1)) * (p3-p1);
+		return (2*s3-3*s2+1)*p1 + (s3-2*s2+s)*d1 + (-2*s3+3*s2)*p2 + (s3-s2)*d2;
+	}
+
+	template <typename T>
+	static T interpolate_value(animation_interpolation mode, float t, float t0, float t1, float t2, float t3, T const& p0, T const& p1, T const& p2, T const& p3, float K)
+	{
+		switch (mode)
+		{
+		case animation_interpolation::step:
+			return p1;
+		case animation_interpolation::cardinal:
+			return cardinal_spline(t, t0, t1, t2, t3, p0, p1, p2, p3, K);
+		default: // linear and slerp
+		{
+			float const alpha = (t-t1)/(t2-t1);
+			return (1-alpha)*p1 + alpha*p2;
+		}
+		}
+	}
+
+	float animation_interpolate(animation_interpolation mode, float t, float t0, float t1, float t2, float t3, float p0, float p1, float p2, float p3, float K)
+	{
+		return interpolate_value(mode, t, t0, t1, t2, t3, p0, p1, p2, p3, K);
+	}
+
+	vec3 animation_interpolate(animation_interpolation mode, float t, float t0, float t1, float t2, float t3, vec3 const& p0, vec3 const& p1, vec3 const& p2, vec3 const& p3, float K)
+	{
+		return interpolate_value(mode, t, t0, t1, t2, t3, p0, p1, p2, p3, K);
+	}
+
+	rotation animation_interpolate(animation_interpolation mode, float t, float, float t1, float t2, float, rotation const& p0, rotation const& p1, rotation const& p2, rotation const& p3, float)
+	{
+		float const alpha = (t-t1)/(t2-t1);
+		switch (mode)
+		{
+		case animation_interpolation::step:
+			return p1;
+		case animation_interpolation::linear:
+			return rotation::nlerp(p1, p2, alpha);
+		case animation_interpolation::cardinal:
+			return rotation::squad(p0, p1, p2, p3, alpha);
+		default:
+			return rotation::slerp(p1, p2, alpha);
+		}
+	}
+
+
+	float animation_clip::duration() const
+	{
+		float d = 0.0f;
+		for (animation_channel const& c : channel) {
+			if (!c.translate.empty()) d = std::max(d, c.translate.time[c.translate.time.size()-1]);
+			if (!c.rotate.empty())    d = std::max(d, c.rotate.time[c.rotate.time.size()-1]);
+			if (!c.scale.empty())     d = std::max(d, c.scale.time[c.scale.time.size()-1]);
+		}
+		return d;
+	}
+
+	void animation_sampler::clear()
+	{
+		node_index.clear();
+		segment.clear();
+	}
+
+	void animation_sample(animation_clip const& clip, float t, hierarchy_mesh_drawable& hierarchy, animation_sampler& sampler)
+	{
+		size_t const N = clip.channel.size();
+
+		// Resolve the names of the animated nodes once
+		if (sampler.node_index.size()!=N) {
+			sampler.node_index.resize(N);
+			sampler.segment.resize(3*N);
+			for (size_t k = 0; k < N; ++k) {
+				int const index = hierarchy.index(clip.channel[k].node);
+				assert_vcl(index>=0, "Animated node ["+clip.channel[k].node+"] is not in the hierarchy");
+				sampler.node_index[k] = index;
+				sampler.segment[3*k] = sampler.segment[3*k+1] = sampler.segment[3*k+2] = 0;
+			}
+		}
+
+		// Time in the clip
+		float const duration = clip.duration();
+		if (clip.loop && duration>0) {
+			t = std::fmod(t, duration);
+			if (t<0)
+				t += duration;
+		}
+
+		for (size_t k = 0; k < N; ++k)
+		{
+			animation_channel const& channel = clip.channel[k];
+			affine_rts& transform = hierarchy.elements[sampler.node_index[k]].transform;
+			size_t* segment = &sampler.segment[3*k];
+			if (!channel.translate.empty())
+				transform.translate = channel.translate.sample(t, segment[0]);
+			if (!channel.rotate.empty())
+				transform.rotate = channel.rotate.sample(t, segment[1]);
+			if (!channel.scale.empty())
+				transform.scale = channel.scale.sample(t, segment[2]);
+		}
+	}
+
+	void animation_sample(std::vector<animation_clip> const& clip, buffer<float> const& time, std::vector<hierarchy_mesh_drawable>& hierarchy, std::vector<animation_sampler>& sampler)
+	{
+		size_t const N = hierarchy.size();
+		assert_vcl(clip.size()==1 || clip.size()==N, "Batch sampling requires one clip, or one clip per hierarchy");
+		assert_vcl(time.size()==N, "Batch sampling requires one time per hierarchy");
+		if (sampler.size()!=N)
+			sampler.resize(N);
+
+		// Each hierarchy is modified by a single thread
+		parallel_for_range(N, [&](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k)
+				animation_sample(clip.size()==1 ? clip[0] : clip[k], time[k], hierarchy[k], sampler[k]);
+		}, 8);
+	}
+}
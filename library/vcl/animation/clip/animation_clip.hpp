@@ -0,0 +1,119 @@
+#pragma once
+
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/display/drawable/hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
+
+#include <string>
+#include <vector>
+
+namespace vcl
+{
+	enum class animation_interpolation { step, linear, cardinal, slerp };
+
+	/** Find the segment [time[k],time[k+1]] containing t (time is increasing and has at least 2 values, t is clamped to the first/last segment)
+	* segment is the segment returned by the previous call: it is checked first together with the next one (sequential playback in O(1)),
+	*  a binary search is used otherwise. segment is updated with the result. */
+	size_t animation_find_segment(buffer<float> const& time, float t, size_t& segment);
+
+	// Interpolation between the keys (p1,t1) and (p2,t2) with the neighboring keys (p0,t0) and (p3,t3) used by the cardinal spline
+	float animation_interpolate(animation_interpolation mode, float t, float t0, float t1, float t2, float t3, float p0, float p1, float p2, float p3, float K);
+	vec3 animation_interpolate(animation_interpolation mode, float t, float t0, float t1, float t2, float t3, vec3 const& p0, vec3 const& p1, vec3 const& p2, vec3 const& p3, float K);
+	// The rotations are interpolated with nlerp (linear), slerp, or squad (cardinal: the tension K is not used).
+	rotation animation_interpolate(animation_interpolation mode, float t, float t0, float t1, float t2, float t3, rotation const& p0, rotation const& p1, rotation const& p2, rotation const& p3, float K);
+
+	/** Keyframes of a value of type T (float, vec3 or rotation) */
+	template <typename T>
+	struct animation_track
+	{
+		buffer<float> time;  // increasing times of the keys
+		buffer<T> value;     // value at each key
+		animation_interpolation interpolation = animation_interpolation::linear;
+		float K = 0.5f;      // tension of the cardinal spline (K=0.5 is the Catmull-Rom spline)
+
+		bool empty() const;
+		/** Add a key at the end of the track */
+		animation_track<T>& add(float t, T const& v);
+
+		/** Value at time t (clamped to the first/last key) */
+		T sample(float t) const;
+		/** Value at time t using the segment cached by the previous call */
+		T sample(float t, size_t& segment) const;
+	};
+
+	/** Animation of the local transform of a node of a hierarchy. Empty tracks keep the current value of the node. */
+	struct animation_channel
+	{
+		std::string node;  // name of the animated node
+		animation_track<vec3> translate;
+		animation_track<rotation> rotate;
+		animation_track<float> scale;
+	};
+
+	/** Set of channels played together (e.g. a walk cycle of a character) */
+	struct animation_clip
+	{
+		std::vector<animation_channel> channel;
+		bool loop = true;  // the time is wrapped in [0,duration], or clamped if false
+
+		/** Time of the last key of the clip */
+		float duration() const;
+	};
+
+	/** Playback state of a clip on a hierarchy: the node index of each channel (resolved at the first sampling), and the last segment of each track.
+	* A sampler is associated to a single pair (clip, hierarchy). */
+	struct animation_sampler
+	{
+		buffer<int> node_index;
+		buffer<size_t> segment;  // 3 segments per channel: translate, rotate, scale
+
+		void clear();
+	};
+
+	/** Set the local transforms of the nodes of the hierarchy animated by the clip at time t */
+	void animation_sample(animation_clip const& clip, float t, hierarchy_mesh_drawable& hierarchy, animation_sampler& sampler);
+	/** Batch sampling in parallel: clip[k] (or clip[0] if a single clip is given) is sampled at time[k] into hierarchy[k] */
+	void animation_sample(std::vector<animation_clip> const& clip, buffer<float> const& time, std::vector<hierarchy_mesh_drawable>& hierarchy, std::vector<animation_sampler>& sampler);
+}
+
+
+namespace vcl
+{
+	template <typename T>
+	bool animation_track<T>::empty() const
+	{
+		return time.size()==0;
+	}
+
+	template <typename T>
+	animation_track<T>& animation_track<T>::add(float t, T const& v)
+	{
+		assert_vcl(time.size()==0 || t>time[time.size()-1], "Keys must be added with increasing times");
+		time.push_back(t);
+		value.push_back(v);
+		return *this;
+	}
+
+	template <typename T>
+	T animation_track<T>::sample(float t) const
+	{
+		size_t segment = 0;
+		return sample(t, segment);
+	}
+
+	template <typename T>
+	T animation_track<T>::sample(float t, size_t& segment) const
+	{
+		size_t const N = time.size();
+		assert_vcl(N>0 && value.size()==N, "Incorrect animation track");
+		if (N==1 || t<=time[0])
+			return value[0];
+		if (t>=time[N-1])
+			return value[N-1];
+
+		size_t const k = animation_find_segment(time, t, segment);
+		size_t const k0 = (k>0) ? k-1 : k;
+		size_t const k3 = (k+2<N) ? k+2 : k+1;
+		return animation_interpolate(interpolation, t, time[k0], time[k], time[k+1], time[k3], value[k0], value[k], value[k+1], value[k3], K);
+	}
+}
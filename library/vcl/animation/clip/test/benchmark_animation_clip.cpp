@@ -0,0 +1,90 @@
+#include "benchmark_animation_clip.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../animation_clip.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Linear scan of the keys at each call (find_index_of_interval of the interpolation scene)
+	static size_t find_segment_linear(buffer<float> const& time, float t)
+	{
+		size_t k = 0;
+		while (time[k+1] < t)
+			++k;
+		return k;
+	}
+
+	void benchmark_animation_clip()
+	{
+		int const N_character = 500;
+		int const N_node = 30;
+		int const N_key = 200;
+		int const N_frame = 100;
+		float const dt = 0.02f;
+
+		// Clip animating the translation and rotation of every node
+		animation_clip clip;
+		hierarchy_mesh_drawable skeleton;
+		for (int n = 0; n < N_node; ++n) {
+			skeleton.add(mesh_drawable(), "node"+str(n), n==0 ? "global_frame" : "node"+str(n-1), vec3{ 0,0,0.1f });
+			animation_channel channel;
+			channel.node = "node"+str(n);
+			channel.rotate.interpolation = animation_interpolation::slerp;
+			channel.translate.interpolation = animation_interpolation::cardinal;
+			for (int k = 0; k < N_key; ++k) {
+				float const t = 0.05f*k;
+				channel.translate.add(t, { 0.01f*std::sin(t+n),0,0.1f });
+				channel.rotate.add(t, rotation({ 1,0,0 }, 0.3f*std::sin(2*t+n)));
+			}
+			clip.channel.push_back(channel);
+		}
+		std::vector<hierarchy_mesh_drawable> crowd(N_character, skeleton);
+		std::vector<animation_clip> const clips = { clip };
+		std::vector<animation_sampler> sampler;
+		buffer<float> time(N_character);
+
+		std::cout << "Sampling of " << N_character << " characters x " << N_node << " animated nodes, " << N_key << " keys per track, " << parallel_thread_count() << " threads" << std::endl;
+
+		// Segment search only (the time is looped over the clip)
+		{
+			buffer<float> const& key_time = clip.channel[0].translate.time;
+			float const duration = clip.duration();
+			size_t checksum_linear = 0, checksum_cached = 0; // keeps the searches from being optimized out
+			auto const t0 = std::chrono::steady_clock::now();
+			for (int c = 0; c < N_character; ++c)
+				for (int f = 0; f < N_frame; ++f)
+					for (int n = 0; n < N_node; ++n)
+						checksum_linear += find_segment_linear(key_time, std::fmod((f+c)*dt, duration));
+			auto const t1 = std::chrono::steady_clock::now();
+			for (int c = 0; c < N_character; ++c) {
+				buffer<size_t> segment(N_node);
+				for (int f = 0; f < N_frame; ++f)
+					for (int n = 0; n < N_node; ++n)
+						checksum_cached += animation_find_segment(key_time, std::fmod((f+c)*dt, duration), segment[n]);
+			}
+			auto const t2 = std::chrono::steady_clock::now();
+			// The results differ only when t is exactly a key time (end of a segment or start of the next one)
+			assert_vcl_no_msg(checksum_cached >= checksum_linear);
+			double const N_search = double(N_character)*N_frame*N_node;
+			std::cout << "  segment search: linear scan " << 1e6*std::chrono::duration<double, std::milli>(t1-t0).count()/N_search << " ns vs cached " << 1e6*std::chrono::duration<double, std::milli>(t2-t1).count()/N_search << " ns" << std::endl;
+		}
+
+		// Full sampling of the crowd
+		{
+			auto const t0 = std::chrono::steady_clock::now();
+			for (int f = 0; f < N_frame; ++f) {
+				for (int c = 0; c < N_character; ++c)
+					time[c] = (f+c)*dt;
+				animation_sample(clips, time, crowd, sampler);
+			}
+			auto const t1 = std::chrono::steady_clock::now();
+			std::cout << "  batch sampling: " << std::chrono::duration<double, std::milli>(t1-t0).count()/N_frame << " ms/frame" << std::endl;
+		}
+	}
+}
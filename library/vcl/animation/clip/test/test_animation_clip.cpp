@@ -0,0 +1,101 @@
+#include "test_animation_clip.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../animation_clip.hpp"
+
+#include <cmath>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_animation_clip()
+	{
+		// Segment search: cached and binary search give the same result as a linear scan
+		{
+			buffer<float> time;
+			for (int k = 0; k < 50; ++k)
+				time.push_back(0.1f*k + 0.01f*(k%3));
+			size_t segment = 0;
+			for (int k = -10; k < 600; ++k) {
+				float const t = (k%7==0) ? rand_interval(-0.5f, 5.5f) : 0.01f*k; // sequential times with random jumps
+				size_t expected = 0;
+				while (expected+2 < time.size() && time[expected+1] <= t)
+					++expected;
+				assert_vcl_no_msg( animation_find_segment(time, t, segment) == expected );
+				assert_vcl_no_msg( segment == expected );
+			}
+		}
+
+		// Interpolation modes
+		{
+			animation_track<vec3> track;
+			track.add(0.0f, { 0,0,0 }).add(1.0f, { 1,0,0 }).add(3.0f, { 1,2,0 }).add(4.0f, { 0,2,0 });
+
+			track.interpolation = animation_interpolation::step;
+			assert_vcl_no_msg( norm(track.sample(1.5f) - vec3(1,0,0)) < 1e-6f );
+			track.interpolation = animation_interpolation::linear;
+			assert_vcl_no_msg( norm(track.sample(2.0f) - vec3(1,1,0)) < 1e-6f );
+			assert_vcl_no_msg( norm(track.sample(-1.0f) - vec3(0,0,0)) < 1e-6f );
+			assert_vcl_no_msg( norm(track.sample(5.0f) - vec3(0,2,0)) < 1e-6f );
+
+			// The cardinal spline interpolates the keys and is continuous
+			track.interpolation = animation_interpolation::cardinal;
+			for (size_t k = 0; k < track.time.size(); ++k)
+				assert_vcl_no_msg( norm(track.sample(track.time[k]) - track.value[k]) < 1e-5f );
+			assert_vcl_no_msg( norm(track.sample(3.0f-1e-4f) - track.sample(3.0f+1e-4f)) < 1e-3f );
+
+			animation_track<float> scale;
+			scale.add(0.0f, 1.0f).add(2.0f, 3.0f);
+			assert_vcl_no_msg( std::abs(scale.sample(0.5f) - 1.5f) < 1e-6f );
+		}
+
+		// Rotations: slerp has a constant angular velocity
+		{
+			animation_track<rotation> track;
+			track.interpolation = animation_interpolation::slerp;
+			track.add(0.0f, rotation()).add(1.0f, rotation({ 0,0,1 }, 2.0f));
+			for (float t = 0; t <= 1.0f; t += 0.125f) {
+				vec3 axis; float angle;
+				track.sample(t).axis_angle(axis, angle);
+				assert_vcl_no_msg( std::abs(angle - 2.0f*t) < 1e-4f );
+			}
+			track.interpolation = animation_interpolation::linear;
+			vec3 axis; float angle;
+			track.sample(0.5f).axis_angle(axis, angle);
+			assert_vcl_no_msg( std::abs(angle - 1.0f) < 1e-4f ); // nlerp is exact at the middle
+		}
+
+		// Clip applied to a hierarchy, single and batch sampling
+		{
+			animation_clip clip;
+			clip.channel.resize(2);
+			clip.channel[0].node = "body";
+			clip.channel[0].translate.add(0.0f, { 0,0,0 }).add(2.0f, { 2,0,0 });
+			clip.channel[1].node = "arm";
+			clip.channel[1].rotate.add(0.0f, rotation()).add(2.0f, rotation({ 1,0,0 }, 1.0f));
+			assert_vcl_no_msg( std::abs(clip.duration()-2.0f) < 1e-6f );
+
+			hierarchy_mesh_drawable hierarchy;
+			hierarchy.add(mesh_drawable(), "body");
+			hierarchy.add(mesh_drawable(), "arm", "body", vec3{ 0,1,0 });
+
+			animation_sampler sampler;
+			animation_sample(clip, 2.5f, hierarchy, sampler); // looped: t=0.5
+			assert_vcl_no_msg( norm(hierarchy["body"].transform.translate - vec3(0.5f,0,0)) < 1e-6f );
+			assert_vcl_no_msg( norm(hierarchy["arm"].transform.translate - vec3(0,1,0)) < 1e-6f ); // not animated
+			assert_vcl_no_msg( sampler.node_index.size()==2 && sampler.node_index[1]==1 );
+
+			std::vector<hierarchy_mesh_drawable> crowd(20, hierarchy);
+			buffer<float> time;
+			for (size_t k = 0; k < crowd.size(); ++k)
+				time.push_back(0.1f*k);
+			std::vector<animation_sampler> samplers;
+			animation_sample(std::vector<animation_clip>{ clip }, time, crowd, samplers);
+			for (size_t k = 0; k < crowd.size(); ++k) {
+				float const t = std::fmod(time[k], 2.0f);
+				assert_vcl_no_msg( norm(crowd[k]["body"].transform.translate - vec3(t,0,0)) < 1e-5f );
+			}
+		}
+	}
+}
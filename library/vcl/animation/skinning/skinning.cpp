@@ -0,0 +1,226 @@
+#include "skinning.hpp"
+
+#include "vcl/base/base.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VCL_SKINNING_SSE
+#endif
+
+// The kernels work on raw pointers: they are called on every vertex at each frame and avoid the bound checks of the containers.
+
+namespace vcl
+{
+	size_t skinning_mesh::bone_count() const
+	{
+		return bone_bind.size();
+	}
+
+	void skinning_mesh::normalize_weights()
+	{
+		size_t const N = bone_weight.size();
+		for (size_t k = 0; k < N; ++k) {
+			vec4& w = bone_weight[k];
+			float const sum = w.x + w.y + w.z + w.w;
+			assert_vcl(sum > 0, "Vertex "+str(k)+" is not influenced by any bone");
+			w.x /= sum; w.y /= sum; w.z /= sum; w.w /= sum;
+		}
+	}
+
+	// Deformation of a bone (G B^-1) stored as the 4 columns of its 3x4 matrix
+	static void bone_matrix(affine_rts const& T, vec4* column)
+	{
+		vec3 const x = T.scale * T.rotate.matrix_col_x();
+		vec3 const y = T.scale * T.rotate.matrix_col_y();
+		vec3 const z = T.scale * T.rotate.matrix_col_z();
+		column[0] = { x, 0.0f };
+		column[1] = { y, 0.0f };
+		column[2] = { z, 0.0f };
+		column[3] = { T.translate, 1.0f };
+	}
+
+	// Deformation of a bone (G B^-1) stored as a dual quaternion: real part = rotation, dual part = 1/2 (t,0) * rotation
+	static void bone_dual_quaternion(affine_rts const& T, vec4* q)
+	{
+		quaternion const r = T.rotate.quat();
+		quaternion const d = 0.5f * (quaternion(T.translate, 0.0f) * r);
+		q[0] = r;
+		q[1] = d;
+	}
+
+	static void skinning_linear_blend(size_t k_begin, size_t k_end, vec3 const* p_bind, vec3 const* n_bind, int4 const* index, vec4 const* weight, vec4 const* bone, size_t N_bone, vec3* p, vec3* n)
+	{
+		for (size_t k = k_begin; k < k_end; ++k)
+		{
+			int const* b = &index[k].x;
+			float const* w = &weight[k].x;
+
+#ifdef VCL_SKINNING_SSE
+			// Blend the columns of the bone matrices weighted by the influences
+			__m128 c0 = _mm_setzero_ps(), c1 = _mm_setzero_ps(), c2 = _mm_setzero_ps(), c3 = _mm_setzero_ps();
+			for (int i = 0; i < 4; ++i) {
+				assert_vcl(size_t(b[i]) < N_bone, "Incorrect bone index");
+				float const* M = &bone[4*size_t(b[i])].x;
+				__m128 const wi = _mm_set1_ps(w[i]);
+				c0 = _mm_add_ps(c0, _mm_mul_ps(wi, _mm_loadu_ps(M)));
+				c1 = _mm_add_ps(c1, _mm_mul_ps(wi, _mm_loadu_ps(M+4)));
+				c2 = _mm_add_ps(c2, _mm_mul_ps(wi, _mm_loadu_ps(M+8)));
+				c3 = _mm_add_ps(c3, _mm_mul_ps(wi, _mm_loadu_ps(M+12)));
+			}
+
+			vec3 const& pb = p_bind[k];
+			vec3 const& nb = n_bind[k];
+			__m128 const pk = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(pb.x)), _mm_mul_ps(c1, _mm_set1_ps(pb.y))), _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(pb.z)), c3));
+			__m128 const nk = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(nb.x)), _mm_mul_ps(c1, _mm_set1_ps(nb.y))), _mm_mul_ps(c2, _mm_set1_ps(nb.z)));
+
+			float pr[4], nr[4];
+			_mm_storeu_ps(pr, pk);
+			_mm_storeu_ps(nr, nk);
+#else
+			float pr[3] = { 0,0,0 }, nr[3] = { 0,0,0 };
+			for (int i = 0; i < 4; ++i) {
+				assert_vcl(size_t(b[i]) < N_bone, "Incorrect bone index");
+				vec4 const* M = &bone[4*size_t(b[i])];
+				vec3 const& pb = p_bind[k];
+				vec3 const& nb = n_bind[k];
+				for (int c = 0; c < 3; ++c) {
+					pr[c] += w[i] * (M[0][c]*pb.x + M[1][c]*pb.y + M[2][c]*pb.z + M[3][c]);
+					nr[c] += w[i] * (M[0][c]*nb.x + M[1][c]*nb.y + M[2][c]*nb.z);
+				}
+			}
+#endif
+			p[k] = { pr[0], pr[1], pr[2] };
+
+			float const n_norm = std::sqrt(nr[0]*nr[0] + nr[1]*nr[1] + nr[2]*nr[2]);
+			float const inv_norm = n_norm > 1e-12f ? 1.0f/n_norm : 0.0f;
+			n[k] = { nr[0]*inv_norm, nr[1]*inv_norm, nr[2]*inv_norm };
+		}
+	}
+
+	// Rotation of v by the unit quaternion r: v + 2 r.v x (r.v x v + r.w v)
+	static inline vec3 rotate_quaternion(float rx, float ry, float rz, float rw, vec3 const& v)
+	{
+		float const ux = ry*v.z - rz*v.y + rw*v.x;
+		float const uy = rz*v.x - rx*v.z + rw*v.y;
+		float const uz = rx*v.y - ry*v.x + rw*v.z;
+		return { v.x + 2*(ry*uz - rz*uy), v.y + 2*(rz*ux - rx*uz), v.z + 2*(rx*uy - ry*ux) };
+	}
+
+	static void skinning_dual_quaternion(size_t k_begin, size_t k_end, vec3 const* p_bind, vec3 const* n_bind, int4 const* index, vec4 const* weight, vec4 const* bone, size_t N_bone, vec3* p, vec3* n)
+	{
+		for (size_t k = k_begin; k < k_end; ++k)
+		{
+			int const* b = &index[k].x;
+			float const* w = &weight[k].x;
+
+			// Blend the dual quaternions, with the real parts in the same hemisphere as the first influence
+			assert_vcl(size_t(b[0]) < N_bone, "Incorrect bone index");
+			float const* r0 = &bone[2*size_t(b[0])].x;
+			float qr[4] = { 0,0,0,0 }, qd[4] = { 0,0,0,0 };
+			for (int i = 0; i < 4; ++i) {
+				assert_vcl(size_t(b[i]) < N_bone, "Incorrect bone index");
+				float const* r = &bone[2*size_t(b[i])].x;
+				float const* d = r+4;
+				float const wi = (r[0]*r0[0] + r[1]*r0[1] + r[2]*r0[2] + r[3]*r0[3]) < 0 ? -w[i] : w[i];
+				for (int c = 0; c < 4; ++c) {
+					qr[c] += wi * r[c];
+					qd[c] += wi * d[c];
+				}
+			}
+
+			float const q_norm = std::sqrt(qr[0]*qr[0] + qr[1]*qr[1] + qr[2]*qr[2] + qr[3]*qr[3]);
+			float const inv_norm = q_norm > 1e-12f ? 1.0f/q_norm : 0.0f;
+			float const rx = qr[0]*inv_norm, ry = qr[1]*inv_norm, rz = qr[2]*inv_norm, rw = qr[3]*inv_norm;
+			float const dx = qd[0]*inv_norm, dy = qd[1]*inv_norm, dz = qd[2]*inv_norm, dw = qd[3]*inv_norm;
+
+			// Translation: 2 (r.w d.v - d.w r.v + r.v x d.v)
+			float const tx = 2*(rw*dx - dw*rx + ry*dz - rz*dy);
+			float const ty = 2*(rw*dy - dw*ry + rz*dx - rx*dz);
+			float const tz = 2*(rw*dz - dw*rz + rx*dy - ry*dx);
+
+			p[k] = rotate_quaternion(rx, ry, rz, rw, p_bind[k]);
+			p[k].x += tx; p[k].y += ty; p[k].z += tz;
+			n[k] = rotate_quaternion(rx, ry, rz, rw, n_bind[k]);
+		}
+	}
+
+	void skinning_mesh::update(buffer<affine_rts> const& bone_global)
+	{
+		size_t const N_bone = bone_bind.size();
+		assert_vcl(bone_global.size() >= N_bone, "Skinning requires the global transform of "+str(N_bone)+" bones");
+
+		// Deformation of each bone with respect to the bind pose
+		if (method == skinning_method::linear_blend) {
+			bone_deformation.resize(4*N_bone);
+			for (size_t k = 0; k < N_bone; ++k)
+				bone_matrix(bone_global[k] * inverse(bone_bind[k]), &bone_deformation[4*k]);
+		}
+		else {
+			bone_deformation.resize(2*N_bone);
+			for (size_t k = 0; k < N_bone; ++k)
+				bone_dual_quaternion(bone_global[k] * inverse(bone_bind[k]), &bone_deformation[2*k]);
+		}
+
+		size_t const N = position_bind.size();
+		assert_vcl(normal_bind.size()==N && bone_index.size()==N && bone_weight.size()==N, "Incoherent size of skinning attributes");
+		position.resize(N);
+		normal.resize(N);
+
+		vec3 const* p_bind = position_bind.data.data();
+		vec3 const* n_bind = normal_bind.data.data();
+		int4 const* index = bone_index.data.data();
+		vec4 const* weight = bone_weight.data.data();
+		vec4 const* bone = bone_deformation.data.data();
+		vec3* p = position.data.data();
+		vec3* n = normal.data.data();
+
+		if (method == skinning_method::linear_blend)
+			parallel_for_range(N, [=](size_t k_begin, size_t k_end) { skinning_linear_blend(k_begin, k_end, p_bind, n_bind, index, weight, bone, N_bone, p, n); });
+		else
+			parallel_for_range(N, [=](size_t k_begin, size_t k_end) { skinning_dual_quaternion(k_begin, k_end, p_bind, n_bind, index, weight, bone, N_bone, p, n); });
+	}
+
+	void skinning_mesh::update(hierarchy_mesh_drawable const& skeleton)
+	{
+		update(skinning_bone_transforms(skeleton));
+	}
+
+	void skinning_mesh::update_drawable(mesh_drawable& drawable) const
+	{
+		drawable.update_position(position);
+		drawable.update_normal(normal);
+	}
+
+
+	skinning_mesh skinning_from_mesh(mesh const& shape, buffer<affine_rts> const& bone_bind)
+	{
+		assert_vcl(bone_bind.size() > 0, "Skinning requires at least one bone");
+		size_t const N = shape.position.size();
+		assert_vcl(shape.normal.size()==N, "Skinning requires the normals of the mesh");
+
+		skinning_mesh skin;
+		skin.position_bind = shape.position;
+		skin.normal_bind = shape.normal;
+		skin.bone_bind = bone_bind;
+		skin.bone_index.resize(N);
+		skin.bone_weight.resize(N);
+		for (size_t k = 0; k < N; ++k) {
+			skin.bone_index[k] = { 0,0,0,0 };
+			skin.bone_weight[k] = { 1,0,0,0 };
+		}
+		skin.position = shape.position;
+		skin.normal = shape.normal;
+		return skin;
+	}
+
+	buffer<affine_rts> skinning_bone_transforms(hierarchy_mesh_drawable const& skeleton)
+	{
+		size_t const N = skeleton.elements.size();
+		buffer<affine_rts> transforms(N);
+		for (size_t k = 0; k < N; ++k)
+			transforms[k] = skeleton.elements[k].global_transform;
+		return transforms;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/shape/mesh/mesh.hpp"
+#include "vcl/display/drawable/mesh_drawable/mesh_drawable.hpp"
+#include "vcl/display/drawable/hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
+
+namespace vcl
+{
+	enum class skinning_method { linear_blend, dual_quaternion };
+
+	/** Mesh deformed by a skeleton (skinning)
+	* - Each vertex is influenced by up to 4 bones: bone_index[k] and bone_weight[k] (the unused influences have a zero weight, and the weights of a vertex sum to 1).
+	* - The bind pose is the shape of the mesh and the global transform of the bones in the rest configuration.
+	*   The deformation of a bone is its current global transform times the inverse of its bind transform.
+	* - Vertex attributes are stored per vertex (buffer<vec3>, the layout of the vbo of mesh_drawable), and the vertices are deformed in parallel.
+	*   Linear blend skinning accumulates the 4 columns of the bone matrices of a vertex in SSE registers.
+	* - Dual quaternion skinning avoids the loss of volume around the joints, but only handles rigid transforms (the scaling of the bones is ignored). */
+	struct skinning_mesh
+	{
+		// Bind pose
+		buffer<vec3> position_bind;
+		buffer<vec3> normal_bind;
+		buffer<affine_rts> bone_bind;
+
+		// Influences
+		buffer<int4> bone_index;
+		buffer<vec4> bone_weight;
+
+		// Deformed shape (computed by update)
+		buffer<vec3> position;
+		buffer<vec3> normal;
+
+		skinning_method method = skinning_method::linear_blend;
+
+		size_t bone_count() const;
+		/** Scale the weights of each vertex such that their sum is 1 */
+		void normalize_weights();
+
+		/** Deform the mesh using the current global transform of each bone */
+		void update(buffer<affine_rts> const& bone_global);
+		/** Deform the mesh using a hierarchy as skeleton: bone k is hierarchy.elements[k] (update_local_to_global_coordinates must be called before) */
+		void update(hierarchy_mesh_drawable const& skeleton);
+
+		/** Send the deformed positions and normals to the GPU */
+		void update_drawable(mesh_drawable& drawable) const;
+
+		/** Internal data - Deformation of each bone: 4 columns (x,y,z,translation) of its 3x4 matrix for linear blend skinning,
+		*   or 2 quaternions (real, dual) for dual quaternion skinning */
+		buffer<vec4> bone_deformation;
+	};
+
+	/** Skinning of a mesh in bind pose: all vertices are initially attached to the first bone */
+	skinning_mesh skinning_from_mesh(mesh const& shape, buffer<affine_rts> const& bone_bind);
+	/** Global transform of all the nodes of a hierarchy (used as the bind pose of a skeleton) */
+	buffer<affine_rts> skinning_bone_transforms(hierarchy_mesh_drawable const& skeleton);
+}
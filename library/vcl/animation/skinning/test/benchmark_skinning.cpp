@@ -0,0 +1,94 @@
+#include "benchmark_skinning.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../skinning.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Skinning evaluated with the affine_rts operators (transform of the vertex by each bone, then weighted sum)
+	static void skinning_reference(skinning_mesh& skin, buffer<affine_rts> const& bone_global)
+	{
+		size_t const N_bone = skin.bone_count();
+		buffer<affine_rts> T(N_bone);
+		for (size_t b = 0; b < N_bone; ++b)
+			T[b] = bone_global[b] * inverse(skin.bone_bind[b]);
+
+		for (size_t k = 0; k < skin.position_bind.size(); ++k) {
+			vec3 p, n;
+			for (int i = 0; i < 4; ++i) {
+				affine_rts const& Ti = T[skin.bone_index[k][i]];
+				float const w = skin.bone_weight[k][i];
+				p += w * (Ti*skin.position_bind[k]);
+				n += w * (Ti.scale*(Ti.rotate*skin.normal_bind[k]));
+			}
+			skin.position[k] = p;
+			skin.normal[k] = normalize(n);
+		}
+	}
+
+	void benchmark_skinning()
+	{
+		int const N_bone = 60;
+		int const N_frame = 20;
+
+		// Grid of ~100k vertices along z, bone b covers z in [b, b+1]: each vertex is influenced by 4 consecutive bones
+		mesh const shape = mesh_primitive_grid({ -0.5f,0,0 }, { 0.5f,0,0 }, { 0.5f,0,float(N_bone) }, { -0.5f,0,float(N_bone) }, 100, 1000);
+		buffer<affine_rts> bone_bind(N_bone);
+		for (int b = 0; b < N_bone; ++b)
+			bone_bind[b] = affine_rts(rotation(), { 0,0,float(b) }, 1.0f);
+		skinning_mesh skin = skinning_from_mesh(shape, bone_bind);
+		for (size_t k = 0; k < skin.position_bind.size(); ++k) {
+			int const b = std::min(std::max(int(skin.position_bind[k].z)-1, 0), N_bone-4);
+			skin.bone_index[k] = { b, b+1, b+2, b+3 };
+			skin.bone_weight[k] = { 0.1f, 0.4f, 0.4f, 0.1f };
+		}
+
+		std::cout << "Skinning of " << skin.position_bind.size() << " vertices with " << N_bone << " bones (4 influences per vertex), " << parallel_thread_count() << " threads" << std::endl;
+
+		auto pose = [&](int frame) {
+			buffer<affine_rts> bone_global(N_bone);
+			for (int b = 0; b < N_bone; ++b)
+				bone_global[b] = affine_rts(rotation({ 1,0,0 }, 0.02f*b*std::sin(0.1f*frame)), { 0,0,float(b) }, 1.0f);
+			return bone_global;
+		};
+
+		double time_reference = 0, time_lbs = 0, time_dqs = 0;
+		float max_error = 0;
+		for (int frame = 0; frame < N_frame; ++frame)
+		{
+			buffer<affine_rts> const bone_global = pose(frame);
+
+			auto const t0 = std::chrono::steady_clock::now();
+			skinning_reference(skin, bone_global);
+			auto const t1 = std::chrono::steady_clock::now();
+			buffer<vec3> const position_reference = skin.position;
+
+			skin.method = skinning_method::linear_blend;
+			auto const t2 = std::chrono::steady_clock::now();
+			skin.update(bone_global);
+			auto const t3 = std::chrono::steady_clock::now();
+			for (size_t k = 0; k < skin.position.size(); ++k)
+				max_error = std::max(max_error, norm(skin.position[k]-position_reference[k]));
+
+			skin.method = skinning_method::dual_quaternion;
+			auto const t4 = std::chrono::steady_clock::now();
+			skin.update(bone_global);
+			auto const t5 = std::chrono::steady_clock::now();
+
+			time_reference += std::chrono::duration<double, std::milli>(t1-t0).count() / N_frame;
+			time_lbs += std::chrono::duration<double, std::milli>(t3-t2).count() / N_frame;
+			time_dqs += std::chrono::duration<double, std::milli>(t5-t4).count() / N_frame;
+		}
+
+		std::cout << "  affine_rts reference  : " << time_reference << " ms/frame" << std::endl;
+		std::cout << "  linear blend skinning : " << time_lbs << " ms/frame (max difference with the reference " << max_error << ")" << std::endl;
+		std::cout << "  dual quaternion       : " << time_dqs << " ms/frame" << std::endl;
+	}
+}
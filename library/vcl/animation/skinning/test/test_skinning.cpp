@@ -0,0 +1,111 @@
+#include "test_skinning.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../skinning.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	static bool is_equal(vec3 const& a, vec3 const& b, float eps = 1e-4f)
+	{
+		return norm(a-b) < eps;
+	}
+
+	// Cylinder along z in [0,2] attached to two bones placed at z=0 and z=1, with a smooth transition of the weights around z=1
+	static skinning_mesh skinning_cylinder()
+	{
+		mesh const shape = mesh_primitive_cylinder(0.2f, { 0,0,0 }, { 0,0,2 }, 10, 40);
+		buffer<affine_rts> const bone_bind = { affine_rts(), affine_rts(rotation(), { 0,0,1 }, 1.0f) };
+		skinning_mesh skin = skinning_from_mesh(shape, bone_bind);
+		for (size_t k = 0; k < skin.position_bind.size(); ++k) {
+			float const w = std::min(std::max(skin.position_bind[k].z-0.5f, 0.0f), 1.0f);
+			skin.bone_index[k] = { 0,1,0,0 };
+			skin.bone_weight[k] = { 1-w, w, 0, 0 };
+		}
+		return skin;
+	}
+
+	void test_skinning()
+	{
+		// Bind pose: the mesh is not deformed
+		{
+			skinning_mesh skin = skinning_cylinder();
+			for (skinning_method method : { skinning_method::linear_blend, skinning_method::dual_quaternion }) {
+				skin.method = method;
+				skin.update(skin.bone_bind);
+				for (size_t k = 0; k < skin.position.size(); ++k) {
+					assert_vcl_no_msg( is_equal(skin.position[k], skin.position_bind[k]) );
+					assert_vcl_no_msg( is_equal(skin.normal[k], normalize(skin.normal_bind[k])) );
+				}
+			}
+		}
+
+		// Linear blend skinning is the weighted sum of the vertex deformed by each bone
+		{
+			skinning_mesh skin = skinning_cylinder();
+			buffer<affine_rts> const bone_global = {
+				affine_rts(rotation({ 0,1,0 }, 0.3f), { 0.1f,0.2f,0.3f }, 1.2f),
+				affine_rts(rotation({ 1,0,0 }, 1.1f), { 0.5f,0.0f,1.0f }, 0.8f) };
+			skin.update(bone_global);
+
+			affine_rts const T0 = bone_global[0] * inverse(skin.bone_bind[0]);
+			affine_rts const T1 = bone_global[1] * inverse(skin.bone_bind[1]);
+			for (size_t k = 0; k < skin.position.size(); ++k) {
+				float const w1 = skin.bone_weight[k].y;
+				vec3 const p = (1-w1) * (T0*skin.position_bind[k]) + w1 * (T1*skin.position_bind[k]);
+				assert_vcl_no_msg( is_equal(skin.position[k], p) );
+				assert_vcl_no_msg( std::abs(norm(skin.normal[k])-1.0f) < 1e-4f );
+			}
+		}
+
+		// Rigid transform of all the bones: both methods apply it to every vertex
+		{
+			skinning_mesh skin = skinning_cylinder();
+			affine_rts const T = affine_rts(rotation({ 0,0,1 }, 2.5f), { 1,2,3 }, 1.0f);
+			buffer<affine_rts> const bone_global = { T*skin.bone_bind[0], T*skin.bone_bind[1] };
+			for (skinning_method method : { skinning_method::linear_blend, skinning_method::dual_quaternion }) {
+				skin.method = method;
+				skin.update(bone_global);
+				for (size_t k = 0; k < skin.position.size(); ++k) {
+					assert_vcl_no_msg( is_equal(skin.position[k], T*skin.position_bind[k]) );
+					assert_vcl_no_msg( is_equal(skin.normal[k], T.rotate*normalize(skin.normal_bind[k])) );
+				}
+			}
+		}
+
+		// Dual quaternion skinning preserves the distance to the axis at the joint (no candy-wrapper effect)
+		{
+			skinning_mesh skin = skinning_cylinder();
+			skin.method = skinning_method::dual_quaternion;
+			buffer<affine_rts> const bone_global = { skin.bone_bind[0], affine_rts(rotation({ 0,0,1 }, 3.0f), { 0,0,1 }, 1.0f) };
+			skin.update(bone_global);
+			for (size_t k = 0; k < skin.position.size(); ++k) {
+				vec3 const& p = skin.position[k];
+				assert_vcl_no_msg( std::abs(std::sqrt(p.x*p.x + p.y*p.y) - 0.2f) < 1e-3f );
+			}
+		}
+
+		// Bones given by the nodes of a hierarchy
+		{
+			skinning_mesh skin = skinning_cylinder();
+			hierarchy_mesh_drawable skeleton;
+			skeleton.add(mesh_drawable(), "bone0");
+			skeleton.add(mesh_drawable(), "bone1", "bone0", vec3{ 0,0,1 });
+			skeleton.update_local_to_global_coordinates();
+			skin.bone_bind = skinning_bone_transforms(skeleton);
+
+			skeleton["bone0"].transform.translate = { 0,1,0 };
+			skeleton["bone1"].transform.rotate = rotation({ 1,0,0 }, 0.5f);
+			skeleton.update_local_to_global_coordinates();
+			skin.update(skeleton);
+			buffer<vec3> const position = skin.position;
+			skin.update(buffer<affine_rts>{ skeleton.elements[0].global_transform, skeleton.elements[1].global_transform });
+			for (size_t k = 0; k < skin.position.size(); ++k)
+				assert_vcl_no_msg( is_equal(skin.position[k], position[k]) );
+		}
+	}
+}
@@ -0,0 +1,183 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vcl
+{
+	// True for the worker threads, and for the calling thread while it runs a parallel loop
+	static thread_local bool inside_parallel_loop = false;
+
+	// Pool of worker threads shared by all parallel loops
+	//  A loop is split into chunks that are claimed by the workers (and the calling thread) through an atomic counter.
+	//  A new loop only starts when no worker is still looking for chunks of the previous one.
+	struct parallel_thread_pool
+	{
+		std::vector<std::thread> workers;
+		std::atomic<size_t> thread_count{std::max<size_t>(1, std::thread::hardware_concurrency())};
+
+		std::mutex call_mutex; // only one parallel loop is distributed at a time
+		std::mutex mutex;
+		std::condition_variable cv_start;
+		std::condition_variable cv_done;
+
+		std::function<void(size_t, size_t)> const* task = nullptr;
+		size_t N = 0;
+		size_t chunk_count = 0;
+		std::atomic<size_t> next_chunk{0};
+		size_t chunk_done = 0;
+		size_t active_workers = 0;
+		unsigned long long generation = 0;
+		bool stop = false;
+
+		~parallel_thread_pool()
+		{
+			stop_workers();
+		}
+
+		void stop_workers()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			cv_start.notify_all();
+			for (std::thread& worker : workers)
+				worker.join();
+			workers.clear();
+			stop = false;
+		}
+
+		void start_workers()
+		{
+			for (size_t k = 1; k < thread_count; ++k)
+				workers.emplace_back(&parallel_thread_pool::worker_loop, this, generation);
+		}
+
+		// Run chunks of the current loop until none remains
+		void run_chunks(std::function<void(size_t, size_t)> const& f, size_t N_loop, size_t N_chunk)
+		{
+			size_t done = 0;
+			size_t chunk;
+			while ((chunk = next_chunk.fetch_add(1)) < N_chunk)
+			{
+				size_t const k_begin = N_loop * chunk / N_chunk;
+				size_t const k_end = N_loop * (chunk + 1) / N_chunk;
+				f(k_begin, k_end);
+				++done;
+			}
+
+			if (done > 0) {
+				std::lock_guard<std::mutex> lock(mutex);
+				chunk_done += done;
+				if (chunk_done == N_chunk)
+					cv_done.notify_all();
+			}
+		}
+
+		void worker_loop(unsigned long long generation_seen)
+		{
+			inside_parallel_loop = true;
+			while (true)
+			{
+				std::function<void(size_t, size_t)> const* f = nullptr;
+				size_t N_loop = 0, N_chunk = 0;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					cv_start.wait(lock, [&] { return stop || generation != generation_seen; });
+					if (stop)
+						return;
+					generation_seen = generation;
+					f = task; N_loop = N; N_chunk = chunk_count;
+					++active_workers;
+				}
+
+				run_chunks(*f, N_loop, N_chunk);
+
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					--active_workers;
+				}
+				cv_done.notify_all();
+			}
+		}
+
+		void run(size_t N_loop, std::function<void(size_t, size_t)> const& f, size_t grain)
+		{
+			std::lock_guard<std::mutex> call_lock(call_mutex);
+			if (workers.size() + 1 != thread_count) {
+				stop_workers();
+				start_workers();
+			}
+
+			size_t const N_chunk = std::min((N_loop + grain - 1) / grain, 4 * thread_count);
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				cv_done.wait(lock, [&] { return active_workers == 0; });
+				task = &f;
+				N = N_loop;
+				chunk_count = N_chunk;
+				chunk_done = 0;
+				next_chunk = 0;
+				++generation;
+			}
+			cv_start.notify_all();
+
+			inside_parallel_loop = true;
+			run_chunks(f, N_loop, N_chunk);
+			inside_parallel_loop = false;
+
+			std::unique_lock<std::mutex> lock(mutex);
+			cv_done.wait(lock, [&] { return chunk_done == N_chunk; });
+		}
+	};
+
+	static parallel_thread_pool& thread_pool()
+	{
+		static parallel_thread_pool pool;
+		return pool;
+	}
+
+	size_t parallel_thread_count()
+	{
+		return thread_pool().thread_count;
+	}
+
+	void parallel_set_thread_count(size_t N)
+	{
+		parallel_thread_pool& pool = thread_pool();
+		std::lock_guard<std::mutex> call_lock(pool.call_mutex);
+		pool.thread_count = (N > 0) ? N : std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+
+	void parallel_set_sequential_in_this_thread(bool sequential)
+	{
+		inside_parallel_loop = sequential;
+	}
+
+	void parallel_for_range(size_t N, std::function<void(size_t k_begin, size_t k_end)> const& f, size_t grain)
+	{
+		if (N == 0)
+			return;
+		grain = std::max<size_t>(1, grain);
+
+		parallel_thread_pool& pool = thread_pool();
+		if (inside_parallel_loop || pool.thread_count <= 1 || N <= grain) {
+			f(0, N);
+			return;
+		}
+		pool.run(N, f, grain);
+	}
+
+	void parallel_for(size_t N, std::function<void(size_t k)> const& f, size_t grain)
+	{
+		parallel_for_range(N, [&f](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k)
+				f(k);
+		}, grain);
+	}
+}
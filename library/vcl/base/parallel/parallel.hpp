@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Helper functions to distribute loops over several threads
+//
+// - parallel_for_range(N, f) : call f(k_begin, k_end) on disjoint sub-ranges covering [0,N). The calling thread takes part in the work.
+// - parallel_for(N, f) : call f(k) for every k in [0,N).
+//
+// The worker threads are created once (at the first call) and reused for all following calls.
+// Loops smaller than the grain size, as well as nested calls from inside a parallel loop, are run sequentially on the calling thread.
+
+namespace vcl
+{
+	/** Number of threads used by the parallel loops (including the calling thread) */
+	size_t parallel_thread_count();
+	/** Set the number of threads used by the parallel loops.
+	* N=1 runs all loops sequentially, N=0 resets to the number of hardware threads. */
+	void parallel_set_thread_count(size_t N);
+	/** Run the parallel loops called from the current thread sequentially (sequential=true), or distribute them again over the pool (sequential=false).
+	* Used by threads that already run concurrently with the others (such as background workers) to avoid waiting for the shared pool. */
+	void parallel_set_sequential_in_this_thread(bool sequential);
+
+	void parallel_for_range(size_t N, std::function<void(size_t k_begin, size_t k_end)> const& f, size_t grain=1024);
+	void parallel_for(size_t N, std::function<void(size_t k)> const& f, size_t grain=1024);
+}
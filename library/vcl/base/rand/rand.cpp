@@ -1,16 +1,240 @@
 #include "rand.hpp"
-#include <random>
+#include "../parallel/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VCL_RAND_SSE
+#endif
 
 namespace vcl
 {
 
+// Philox4x32-10 constants (Salmon et al. "Parallel random numbers: as easy as 1, 2, 3", 2011)
+static unsigned int const philox_M0 = 0xD2511F53u;
+static unsigned int const philox_M1 = 0xCD9E8D57u;
+static unsigned int const philox_W0 = 0x9E3779B9u;
+static unsigned int const philox_W1 = 0xBB67AE85u;
+
+// Conversion of the 24 upper bits of a random integer to a float in [0,1)
+static float const uint24_to_float = 1.0f/16777216.0f;
+
+// Largest value returned by a uniform draw in [value_min, value_max): value_min + (value_max-value_min)*u
+//  can round up to value_max in float precision even for u<1.
+static float uniform_upper_bound(float value_min, float value_max)
+{
+	if (value_max > value_min)
+		return std::nextafter(value_max, value_min);
+	return std::numeric_limits<float>::max();
+}
+
+void philox4x32(unsigned long long seed, unsigned long long stream, unsigned long long counter, unsigned int result[4])
+{
+	unsigned int c0 = static_cast<unsigned int>(counter), c1 = static_cast<unsigned int>(counter>>32);
+	unsigned int c2 = static_cast<unsigned int>(stream),  c3 = static_cast<unsigned int>(stream>>32);
+	unsigned int k0 = static_cast<unsigned int>(seed),    k1 = static_cast<unsigned int>(seed>>32);
+
+	for (int round = 0; round < 10; ++round)
+	{
+		unsigned long long const p0 = static_cast<unsigned long long>(philox_M0) * c0;
+		unsigned long long const p1 = static_cast<unsigned long long>(philox_M1) * c2;
+		unsigned int const hi0 = static_cast<unsigned int>(p0>>32), lo0 = static_cast<unsigned int>(p0);
+		unsigned int const hi1 = static_cast<unsigned int>(p1>>32), lo1 = static_cast<unsigned int>(p1);
+		c0 = hi1 ^ c1 ^ k0;
+		c1 = lo1;
+		c2 = hi0 ^ c3 ^ k1;
+		c3 = lo0;
+		k0 += philox_W0;
+		k1 += philox_W1;
+	}
+	result[0] = c0; result[1] = c1; result[2] = c2; result[3] = c3;
+}
+
+// Four consecutive blocks (counter ... counter+3) stored in block order in result[16]
+#ifdef VCL_RAND_SSE
+// 32x32 bits products of the 4 lanes of a with m: low and high 32 bits
+static inline void philox_mulhilo(__m128i a, __m128i m, __m128i& lo, __m128i& hi)
+{
+	__m128i const even = _mm_mul_epu32(a, m);                     // 64-bit products of lanes 0 and 2
+	__m128i const odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);  // 64-bit products of lanes 1 and 3
+	__m128i const mask_even = _mm_set_epi32(0, -1, 0, -1);
+	lo = _mm_or_si128(_mm_and_si128(even, mask_even), _mm_slli_epi64(odd, 32));
+	hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(mask_even, odd));
+}
+
+static void philox4x32_4blocks(unsigned long long seed, unsigned long long stream, unsigned long long counter, unsigned int result[16])
+{
+	unsigned int lane_c0[4], lane_c1[4];
+	for (int b = 0; b < 4; ++b) {
+		lane_c0[b] = static_cast<unsigned int>(counter+b);
+		lane_c1[b] = static_cast<unsigned int>((counter+b)>>32);
+	}
+	__m128i c0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lane_c0));
+	__m128i c1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(lane_c1));
+	__m128i c2 = _mm_set1_epi32(static_cast<int>(static_cast<unsigned int>(stream)));
+	__m128i c3 = _mm_set1_epi32(static_cast<int>(static_cast<unsigned int>(stream>>32)));
+	unsigned int k0 = static_cast<unsigned int>(seed), k1 = static_cast<unsigned int>(seed>>32);
+
+	__m128i const M0 = _mm_set1_epi32(static_cast<int>(philox_M0));
+	__m128i const M1 = _mm_set1_epi32(static_cast<int>(philox_M1));
+	for (int round = 0; round < 10; ++round)
+	{
+		__m128i lo0, hi0, lo1, hi1;
+		philox_mulhilo(c0, M0, lo0, hi0);
+		philox_mulhilo(c2, M1, lo1, hi1);
+		c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32(static_cast<int>(k0)));
+		c1 = lo1;
+		c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32(static_cast<int>(k1)));
+		c3 = lo0;
+		k0 += philox_W0;
+		k1 += philox_W1;
+	}
+
+	// Transpose: lane b of (c0,c1,c2,c3) is the block b
+	__m128i const t0 = _mm_unpacklo_epi32(c0, c1); // c0[0] c1[0] c0[1] c1[1]
+	__m128i const t1 = _mm_unpacklo_epi32(c2, c3); // c2[0] c3[0] c2[1] c3[1]
+	__m128i const t2 = _mm_unpackhi_epi32(c0, c1); // c0[2] c1[2] c0[3] c1[3]
+	__m128i const t3 = _mm_unpackhi_epi32(c2, c3); // c2[2] c3[2] c2[3] c3[3]
+	__m128i* r = reinterpret_cast<__m128i*>(result);
+	_mm_storeu_si128(r+0, _mm_unpacklo_epi64(t0, t1));
+	_mm_storeu_si128(r+1, _mm_unpackhi_epi64(t0, t1));
+	_mm_storeu_si128(r+2, _mm_unpacklo_epi64(t2, t3));
+	_mm_storeu_si128(r+3, _mm_unpackhi_epi64(t2, t3));
+}
+#else
+static void philox4x32_4blocks(unsigned long long seed, unsigned long long stream, unsigned long long counter, unsigned int result[16])
+{
+	for (int b = 0; b < 4; ++b)
+		philox4x32(seed, stream, counter+b, result+4*b);
+}
+#endif
+
+// Box-Muller transform of two random integers: two independent normal values
+static inline void box_muller(unsigned int a, unsigned int b, float& z0, float& z1)
+{
+	float const u0 = ((a>>8)+1) * uint24_to_float; // (0,1]
+	float const u1 = (b>>8) * uint24_to_float;     // [0,1)
+	float const r = std::sqrt(-2.0f*std::log(u0));
+	float const theta = 6.28318530718f*u1;
+	z0 = r*std::cos(theta);
+	z1 = r*std::sin(theta);
+}
+
+// Compute the values of the blocks [counter, counter+ceil(N/4)) in parallel by groups of 4 blocks.
+//  convert(values, k, n) maps the n (<=16) random integers of a group to the floats data[k...k+n-1].
+template <typename CONVERT>
+static void fill_blocks(rand_generator const& generator, size_t N, CONVERT const& convert)
+{
+	size_t const N_group = (N+15)/16;
+	unsigned long long const seed = generator.seed;
+	unsigned long long const stream = generator.stream;
+	unsigned long long const counter = generator.counter;
+	parallel_for_range(N_group, [=,&convert](size_t g_begin, size_t g_end) {
+		unsigned int values[16];
+		for (size_t g = g_begin; g < g_end; ++g) {
+			philox4x32_4blocks(seed, stream, counter+4*g, values);
+			size_t const k = 16*g;
+			convert(values, k, std::min<size_t>(16, N-k));
+		}
+	}, 1024);
+}
+
+
+rand_generator::rand_generator(unsigned long long seed_arg, unsigned long long stream_arg)
+	:seed(seed_arg), stream(stream_arg), counter(0), block(), block_index(4)
+{}
+
+unsigned int rand_generator::uint32()
+{
+	if (block_index == 4) {
+		philox4x32(seed, stream, counter, block);
+		++counter;
+		block_index = 0;
+	}
+	return block[block_index++];
+}
+
+float rand_generator::uniform(float value_min, float value_max)
+{
+	// Same operations as fill_uniform: identical values in scalar and bulk generation
+	float const u = (uint32()>>8) * uint24_to_float;
+	float const value = value_min + (value_max-value_min)*u;
+	return std::min(value, uniform_upper_bound(value_min, value_max));
+}
+
+float rand_generator::normal(float mean, float standard_deviation)
+{
+	unsigned int const a = uint32();
+	unsigned int const b = uint32();
+	float z0, z1;
+	box_muller(a, b, z0, z1);
+	return mean + standard_deviation*z0;
+}
+
+void rand_generator::fill_uniform(float* data, size_t N, float value_min, float value_max)
+{
+	float const range = value_max-value_min;
+	float const upper = uniform_upper_bound(value_min, value_max);
+	fill_blocks(*this, N, [=](unsigned int const* values, size_t k, size_t n) {
+		float* out = data + k;
+		size_t i = 0;
+#ifdef VCL_RAND_SSE
+		__m128 const u24_4 = _mm_set1_ps(uint24_to_float);
+		__m128 const range4 = _mm_set1_ps(range);
+		__m128 const min4 = _mm_set1_ps(value_min);
+		__m128 const upper4 = _mm_set1_ps(upper);
+		for (; i+4 <= n; i += 4) {
+			__m128i const v = _mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(values+i)), 8);
+			__m128 const u = _mm_mul_ps(_mm_cvtepi32_ps(v), u24_4);
+			_mm_storeu_ps(out+i, _mm_min_ps(_mm_add_ps(min4, _mm_mul_ps(range4, u)), upper4));
+		}
+#endif
+		for (; i < n; ++i) {
+			float const u = (values[i]>>8) * uint24_to_float;
+			out[i] = std::min(value_min + range*u, upper);
+		}
+	});
+	counter += (N+3)/4;
+	block_index = 4;
+}
+
+void rand_generator::fill_normal(float* data, size_t N, float mean, float standard_deviation)
+{
+	fill_blocks(*this, N, [=](unsigned int const* values, size_t k, size_t n) {
+		float* out = data + k;
+		for (size_t i = 0; i < n; i += 2) {
+			float z0, z1;
+			box_muller(values[i], values[i+1], z0, z1);
+			out[i] = mean + standard_deviation*z0;
+			if (i+1 < n)
+				out[i+1] = mean + standard_deviation*z1;
+		}
+	});
+	counter += (N+3)/4;
+	block_index = 4;
+}
+
 
-static std::default_random_engine generator(0);
-static std::uniform_real_distribution<float> distribution(0,1);
+// Generator used by rand_interval: one stream per thread, numbered in the order of the first call in each thread
+static rand_generator& rand_generator_thread()
+{
+	static std::atomic<unsigned long long> stream_counter{0};
+	thread_local rand_generator generator(0, stream_counter++);
+	return generator;
+}
 
 float rand_interval(const float value_min, const float value_max)
 {
-    return distribution(generator)* (value_max-value_min) + value_min;
+	return rand_generator_thread().uniform(value_min, value_max);
 }
 
+float rand_normal(const float mean, const float standard_deviation)
+{
+	return rand_generator_thread().normal(mean, standard_deviation);
 }
+
+}
\ No newline at end of file
@@ -1,8 +1,48 @@
 #pragma once
 
+#include <cstddef>
+
 namespace vcl
 {
 
+/** Counter-based random number generator (Philox4x32-10)
+*
+* The k-th block of 4 random 32-bit values of a stream is a hash of (seed, stream, k): no shared state is required and any block can be computed independently.
+* - Different streams (e.g. one per thread, per particle emitter, per terrain tile) give independent sequences.
+* - The bulk fill functions compute the blocks in parallel: the result only depends on (seed, stream, counter) and not on the number of threads.
+* - A rand_generator must not be shared between threads without synchronization: use one stream per thread instead. */
+struct rand_generator
+{
+	rand_generator(unsigned long long seed=0, unsigned long long stream=0);
+
+	unsigned long long seed;
+	unsigned long long stream;
+	/** Index of the next block of 4 values */
+	unsigned long long counter;
+
+	/** Next random value */
+	unsigned int uint32();
+	/** Uniform distribution in [value_min, value_max) */
+	float uniform(float value_min=0.0f, float value_max=1.0f);
+	/** Normal distribution (Box-Muller transform) */
+	float normal(float mean=0.0f, float standard_deviation=1.0f);
+
+	/** Fill N values in bulk (SIMD and parallel). The generator moves to the first block after the generated ones. */
+	void fill_uniform(float* data, size_t N, float value_min=0.0f, float value_max=1.0f);
+	void fill_normal(float* data, size_t N, float mean=0.0f, float standard_deviation=1.0f);
+
+	/** Internal data - Remaining values of the current block */
+	unsigned int block[4];
+	int block_index;
+};
+
+/** Random number generation from a block counter - Philox4x32-10 - (key: seed, counter: (counter, stream)) */
+void philox4x32(unsigned long long seed, unsigned long long stream, unsigned long long counter, unsigned int result[4]);
+
+/** Uniform random value in [value_min, value_max)
+* Thread-safe: each thread uses its own stream of a counter-based generator (the calling order within a thread is reproducible). */
 float rand_interval(const float value_min=0.0f, const float value_max=1.0f);
+/** Normal random value - Thread-safe, same generator as rand_interval */
+float rand_normal(const float mean=0.0f, const float standard_deviation=1.0f);
 
-}
+}
\ No newline at end of file
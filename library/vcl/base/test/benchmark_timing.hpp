@@ -0,0 +1,16 @@
+#pragma once
+
+#include <chrono>
+
+namespace vcl_test
+{
+	/** Average time (in ms) of a call to f() over N_repeat calls - shared by the benchmarks */
+	template <typename F> double timing(F const& f, int N_repeat)
+	{
+		auto const t0 = std::chrono::steady_clock::now();
+		for (int k = 0; k < N_repeat; ++k)
+			f();
+		auto const t1 = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(t1 - t0).count() / N_repeat;
+	}
+}
@@ -0,0 +1,181 @@
+#include "allocator.hpp"
+
+#include "vcl/base/base.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace vcl
+{
+	static size_t const huge_page_size = 2*1024*1024;
+	// The allocations in a memory_arena end on a multiple of this size
+	static size_t const arena_granularity = 64;
+
+	// Round value up to a multiple of a power of 2
+	static size_t round_up(size_t value, size_t multiple)
+	{
+		return (value + multiple - 1) & ~(multiple - 1);
+	}
+
+	namespace detail
+	{
+		void* aligned_malloc(size_t bytes, size_t alignment)
+		{
+			if (alignment < sizeof(void*))
+				alignment = sizeof(void*);
+			if (bytes == 0)
+				bytes = alignment;
+#if defined(_WIN32)
+			void* p = _aligned_malloc(bytes, alignment);
+#else
+			void* p = nullptr;
+			if (posix_memalign(&p, alignment, bytes) != 0)
+				p = nullptr;
+#endif
+			if (p == nullptr)
+				throw std::bad_alloc();
+			return p;
+		}
+
+		void aligned_free(void* p)
+		{
+#if defined(_WIN32)
+			_aligned_free(p);
+#else
+			free(p);
+#endif
+		}
+
+		void* huge_page_malloc(size_t bytes)
+		{
+#if defined(__linux__)
+			if (bytes >= huge_page_size)
+			{
+				// Map one extra huge page to be able to align the start of the memory on a huge page, then unmap the parts outside the aligned range
+				size_t const size = round_up(bytes, huge_page_size);
+				void* mapped = mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (mapped == MAP_FAILED)
+					throw std::bad_alloc();
+
+				uintptr_t const start = reinterpret_cast<uintptr_t>(mapped);
+				uintptr_t const aligned = round_up(start, huge_page_size);
+				if (aligned > start)
+					munmap(mapped, aligned - start);
+				uintptr_t const end = aligned + size;
+				if (start + size + huge_page_size > end)
+					munmap(reinterpret_cast<void*>(end), start + size + huge_page_size - end);
+
+#ifdef MADV_HUGEPAGE
+				madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);
+#endif
+				return reinterpret_cast<void*>(aligned);
+			}
+#endif
+			return aligned_malloc(bytes, 64);
+		}
+
+		void huge_page_free(void* p, size_t bytes)
+		{
+			if (p == nullptr)
+				return;
+#if defined(__linux__)
+			if (bytes >= huge_page_size) {
+				munmap(p, round_up(bytes, huge_page_size));
+				return;
+			}
+#endif
+			aligned_free(p);
+		}
+	}
+
+
+	memory_arena::memory_arena(size_t block_size_arg)
+		:blocks(), offset(0), size_used(0), block_size(block_size_arg)
+	{}
+
+	memory_arena::~memory_arena()
+	{
+		for (block const& b : blocks)
+			detail::aligned_free(b.data);
+	}
+
+	void* memory_arena::allocate(size_t bytes, size_t alignment)
+	{
+		assert_vcl((alignment & (alignment-1)) == 0, "Alignment must be a power of 2");
+		if (!blocks.empty())
+		{
+			block const& current = blocks.back();
+			uintptr_t const base = reinterpret_cast<uintptr_t>(current.data);
+			size_t const aligned_offset = size_t(round_up(base + offset, alignment) - base);
+			if (aligned_offset + bytes <= current.size) {
+				offset = round_up(aligned_offset + bytes, arena_granularity);
+				size_used += bytes;
+				return current.data + aligned_offset;
+			}
+		}
+
+		// The current block is full: add a new one (its start is 64-byte aligned)
+		size_t const new_size = std::max(block_size, bytes + alignment);
+		block const b = { static_cast<char*>(detail::aligned_malloc(new_size, 64)), new_size };
+		blocks.push_back(b);
+
+		uintptr_t const base = reinterpret_cast<uintptr_t>(b.data);
+		size_t const aligned_offset = size_t(round_up(base, alignment) - base);
+		offset = round_up(aligned_offset + bytes, arena_granularity);
+		size_used += bytes;
+		return b.data + aligned_offset;
+	}
+
+	void memory_arena::deallocate(void* p, size_t bytes)
+	{
+		if (blocks.empty())
+			return;
+		block const& current = blocks.back();
+		// Rolled back only if p is the last allocation of the current block
+		size_t const end_offset = size_t(static_cast<char*>(p) + bytes - current.data);
+		if (end_offset <= current.size && round_up(end_offset, arena_granularity) == offset) {
+			offset = size_t(static_cast<char*>(p) - current.data);
+			size_used -= bytes;
+		}
+	}
+
+	void memory_arena::reset()
+	{
+		// Merge the blocks into a single one to fit the same allocations without new block
+		if (blocks.size() > 1)
+		{
+			size_t const total = capacity();
+			for (block const& b : blocks)
+				detail::aligned_free(b.data);
+			blocks.clear();
+			block const b = { static_cast<char*>(detail::aligned_malloc(total, 64)), total };
+			blocks.push_back(b);
+		}
+		offset = 0;
+		size_used = 0;
+	}
+
+	size_t memory_arena::capacity() const
+	{
+		size_t total = 0;
+		for (block const& b : blocks)
+			total += b.size;
+		return total;
+	}
+
+	memory_arena& memory_arena::frame()
+	{
+		static thread_local memory_arena arena;
+		return arena;
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/* Allocators for the internal storage of buffer, grid_2D and grid_3D (second template parameter)
+*  - aligned_allocator<T, Alignment>: data aligned on Alignment bytes (default 64: cache line, and 32-byte AVX registers)
+*  - arena_allocator<T>: bump allocation in a memory_arena, released all at once with arena.reset() (ex. temporary buffers of a frame)
+*  - huge_page_allocator<T>: very large allocations mapped on huge pages when the OS supports it (fewer TLB misses on large grids)
+*
+* Ex. buffer<vec3, aligned_allocator<vec3>> p(N);
+*     grid_3D<float, huge_page_allocator<float>> density(512);
+*     buffer<vec3, arena_allocator<vec3>> temporary(N); // allocated in memory_arena::frame()
+*/
+
+namespace vcl
+{
+	namespace detail
+	{
+		void* aligned_malloc(size_t bytes, size_t alignment);
+		void aligned_free(void* p);
+		void* huge_page_malloc(size_t bytes);
+		void huge_page_free(void* p, size_t bytes);
+	}
+
+	/** Allocator returning memory aligned on Alignment bytes (power of 2) */
+	template <typename T, size_t Alignment = 64>
+	struct aligned_allocator
+	{
+		static_assert((Alignment & (Alignment-1)) == 0 && Alignment >= alignof(T), "Alignment must be a power of 2, at least the alignment of T");
+
+		using value_type = T;
+		template <typename U> struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+		aligned_allocator() = default;
+		template <typename U> aligned_allocator(aligned_allocator<U, Alignment> const&) {}
+
+		T* allocate(size_t n) { return static_cast<T*>(detail::aligned_malloc(n*sizeof(T), Alignment)); }
+		void deallocate(T* p, size_t) { detail::aligned_free(p); }
+	};
+	template <typename T, typename U, size_t Alignment> bool operator==(aligned_allocator<T, Alignment> const&, aligned_allocator<U, Alignment> const&) { return true; }
+	template <typename T, typename U, size_t Alignment> bool operator!=(aligned_allocator<T, Alignment> const&, aligned_allocator<U, Alignment> const&) { return false; }
+
+
+	/** Memory arena: linear (bump) allocation in large blocks
+	 * - allocate() only moves an offset in the current block (a new block is added when it is full), the allocations are padded to a multiple of 64 bytes
+	 * - individual deallocations do nothing, except for the last allocation which is rolled back (stack-like temporaries reuse the same memory)
+	 * - all the memory is released at once with reset(), after which all the previous allocations are invalid
+	 * - after a reset(), the blocks are merged in a single one so that the next frame with the same allocations does not call the system allocator */
+	struct memory_arena
+	{
+		struct block { char* data; size_t size; };
+
+		/** Memory blocks, allocations are done in the last one */
+		std::vector<block> blocks;
+		/** Offset of the next allocation in the last block */
+		size_t offset;
+		/** Total number of bytes allocated since the last reset */
+		size_t size_used;
+		/** Minimal size of a new block */
+		size_t block_size;
+
+		explicit memory_arena(size_t block_size = 16*1024*1024);
+		~memory_arena();
+		memory_arena(memory_arena const&) = delete;
+		memory_arena& operator=(memory_arena const&) = delete;
+
+		void* allocate(size_t bytes, size_t alignment);
+		void deallocate(void* p, size_t bytes);
+		void reset();
+		size_t capacity() const;
+
+		/** Arena of the current thread used by default by arena_allocator.
+		 *  The caller is responsible for reset() once the temporary data are no longer used (ex. at the beginning of each frame). */
+		static memory_arena& frame();
+	};
+
+	/** Allocator using a memory_arena (memory_arena::frame() by default). The allocations are 64-byte aligned. */
+	template <typename T>
+	struct arena_allocator
+	{
+		using value_type = T;
+
+		memory_arena* arena;
+
+		arena_allocator() : arena(&memory_arena::frame()) {}
+		arena_allocator(memory_arena& arena_arg) : arena(&arena_arg) {}
+		template <typename U> arena_allocator(arena_allocator<U> const& other) : arena(other.arena) {}
+
+		T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n*sizeof(T), alignof(T) > 64 ? alignof(T) : 64)); }
+		void deallocate(T* p, size_t n) { arena->deallocate(p, n*sizeof(T)); }
+	};
+	template <typename T, typename U> bool operator==(arena_allocator<T> const& a, arena_allocator<U> const& b) { return a.arena==b.arena; }
+	template <typename T, typename U> bool operator!=(arena_allocator<T> const& a, arena_allocator<U> const& b) { return a.arena!=b.arena; }
+
+
+	/** Allocator for very large containers
+	 * Allocations of at least 2MB are mapped directly and aligned on 2MB, with transparent huge pages requested (Linux: mmap + madvise(MADV_HUGEPAGE)).
+	 * Smaller allocations, and other platforms, use 64-byte aligned allocations. */
+	template <typename T>
+	struct huge_page_allocator
+	{
+		using value_type = T;
+
+		huge_page_allocator() = default;
+		template <typename U> huge_page_allocator(huge_page_allocator<U> const&) {}
+
+		T* allocate(size_t n) { return static_cast<T*>(detail::huge_page_malloc(n*sizeof(T))); }
+		void deallocate(T* p, size_t n) { detail::huge_page_free(p, n*sizeof(T)); }
+	};
+	template <typename T, typename U> bool operator==(huge_page_allocator<T> const&, huge_page_allocator<U> const&) { return true; }
+	template <typename T, typename U> bool operator!=(huge_page_allocator<T> const&, huge_page_allocator<U> const&) { return false; }
+}
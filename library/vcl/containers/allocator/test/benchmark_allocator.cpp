@@ -0,0 +1,106 @@
+#include "benchmark_allocator.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/base/test/benchmark_timing.hpp"
+
+#include <cstdint>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Kernels on data in cache, with the buffer starting at a given offset from a 64-byte boundary
+	template <typename A> static double timing_kernels(buffer<vec3, A>& p, buffer<vec3, A> const& q, int N_repeat, float& checksum)
+	{
+		return timing([&]() { axpy(0.5f, q, p); normalize(p); checksum += sum(p).x; }, N_repeat);
+	}
+
+	// Temporary buffers of a frame: N_buffer buffers of vec3 and float with sizes up to max_size
+	template <typename A> static float frame_temporaries(buffer<vec3> const& p, A const& allocator, int N_buffer, size_t max_size)
+	{
+		float checksum = 0.0f;
+		for (int k = 0; k < N_buffer; ++k) {
+			size_t const N = 1 + (size_t(k)*7919) % max_size;
+			buffer<vec3, A> tmp(N, allocator);
+			for (size_t i = 0; i < N; ++i)
+				tmp.data[i] = p.data[i];
+			buffer<float, typename std::allocator_traits<A>::template rebind_alloc<float>> weight(N, allocator);
+			weight.data[N/2] = float(k);
+			checksum += tmp.data[N/3].x + weight.data[N/2];
+		}
+		return checksum;
+	}
+
+	void benchmark_allocator()
+	{
+		float checksum = 0.0f;
+
+		// Vectorized kernels: aligned allocation vs std::allocator (16-byte aligned), data in the L2 cache
+		{
+			size_t const N = 8192;
+			int const N_repeat = 20000;
+			buffer<vec3> p(N), q(N);
+			buffer<vec3, aligned_allocator<vec3>> p_aligned(N), q_aligned(N);
+			for (size_t k = 0; k < N; ++k) {
+				p[k] = { float(k%7)+1, 1, 0 }; q[k] = { 0, float(k%3), 1 };
+				p_aligned[k] = p[k]; q_aligned[k] = q[k];
+			}
+			std::cout << "Kernels axpy+normalize+sum on " << N << " vec3 in cache (ms), std::allocator (offset " << (reinterpret_cast<uintptr_t>(p.data.data())%64) << " from 64B) vs aligned_allocator<64>:" << std::endl;
+			for (int level = 0; level <= int(simd_level_supported()); ++level) {
+				simd_level_set(simd_level(level));
+				double const t_default = timing_kernels(p, q, N_repeat, checksum);
+				double const t_aligned = timing_kernels(p_aligned, q_aligned, N_repeat, checksum);
+				std::cout << "  " << str(simd_level(level)) << " : " << t_default*N_repeat << " vs " << t_aligned*N_repeat << std::endl;
+			}
+			simd_level_set(simd_level_supported());
+		}
+
+		// Frames with many temporary buffers: std::allocator vs arena reset at each frame
+		{
+			size_t const N = 1000000;
+			int const N_frame = 50;
+			buffer<vec3> p(N);
+			for (size_t k = 0; k < N; ++k)
+				p[k] = { float(k%7), 0, 1 };
+
+			std::cout << "Frames with temporary buffers (ms per frame), std::allocator vs arena_allocator:" << std::endl;
+			double const t_small_default = timing([&]() { checksum += frame_temporaries(p, std::allocator<vec3>(), 20000, 256); }, N_frame);
+			double const t_small_arena = timing([&]() { memory_arena::frame().reset(); checksum += frame_temporaries(p, arena_allocator<vec3>(), 20000, 256); }, N_frame);
+			std::cout << "  2x20000 small buffers (up to 256 elements) : " << t_small_default << " vs " << t_small_arena << std::endl;
+			double const t_large_default = timing([&]() { checksum += frame_temporaries(p, std::allocator<vec3>(), 20, N); }, N_frame);
+			double const t_large_arena = timing([&]() { memory_arena::frame().reset(); checksum += frame_temporaries(p, arena_allocator<vec3>(), 20, N); }, N_frame);
+			std::cout << "  2x20 large buffers (up to " << N << " elements): " << t_large_default << " vs " << t_large_arena << std::endl;
+		}
+
+		// Random access in a large grid: std::allocator vs huge_page_allocator
+		{
+			size_t const N = 256;
+			size_t const N_access = 20000000;
+			grid_3D<float> g(N);
+			grid_3D<float, huge_page_allocator<float>> g_huge(N);
+			g.fill(1.0f);
+			g_huge.fill(1.0f);
+
+			auto random_access = [&](auto const& grid) {
+				float s = 0.0f;
+				uint64_t state = 12345;
+				float const* data = grid.data.data.data();
+				size_t const size = grid.size();
+				for (size_t k = 0; k < N_access; ++k) {
+					state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+					s += data[(state >> 33) % size];
+				}
+				checksum += s;
+			};
+			double const t_default = timing([&]() { random_access(g); }, 3);
+			double const t_huge = timing([&]() { random_access(g_huge); }, 3);
+			std::cout << "Random reads in a grid_3D of " << N << "^3 floats (ms for " << N_access << " reads), std::allocator vs huge_page_allocator: " << t_default << " vs " << t_huge << std::endl;
+		}
+
+		// Keeps the results from being optimized out
+		std::cout << "  (checksum " << checksum << ")" << std::endl;
+	}
+}
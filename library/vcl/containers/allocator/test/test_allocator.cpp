@@ -0,0 +1,106 @@
+#include "test_allocator.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+
+#include <cstdint>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	static bool is_aligned(void const* p, size_t alignment)
+	{
+		return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+	}
+
+	void test_allocator()
+	{
+		// Aligned allocator
+		{
+			buffer<float, aligned_allocator<float>> a(13);
+			assert_vcl_no_msg(is_aligned(a.data.data(), 64));
+			for (int k = 0; k < 100; ++k) {
+				a.push_back(float(k));
+				assert_vcl_no_msg(is_aligned(a.data.data(), 64));
+			}
+			assert_vcl_no_msg(a.size()==113 && a[112]==99.0f);
+
+			buffer<vec3, aligned_allocator<vec3, 32>> p = { {1,2,3}, {4,5,6} };
+			assert_vcl_no_msg(is_aligned(p.data.data(), 32));
+
+			// Operators, expressions and kernels mixing allocators
+			buffer<vec3> const q = { {1,1,1}, {2,2,2} };
+			buffer<vec3, aligned_allocator<vec3, 32>> r = p + 2.0f*q;
+			assert_vcl_no_msg(is_aligned(r.data.data(), 32));
+			assert_vcl_no_msg(is_equal(r, buffer<vec3>{ {3,4,5}, {8,9,10} }));
+			buffer<vec3> s = r - q;
+			assert_vcl_no_msg(is_equal(s, buffer<vec3>{ {2,3,4}, {6,7,8} }));
+			r += 2.0f*q;
+			assert_vcl_no_msg(is_equal(r[1], vec3(12,13,14)));
+			assert_vcl_no_msg(is_equal(sum(r), vec3(17,19,21)));
+			axpy(1.0f, q, r);
+			assert_vcl_no_msg(is_equal(average(r), vec3(10,11,12)));
+
+			grid_2D<float, aligned_allocator<float>> g(3, 5);
+			assert_vcl_no_msg(is_aligned(g.data.data.data(), 64));
+			g(2,4) = 1.0f;
+			grid_2D<float> const g2 = g + g;
+			assert_vcl_no_msg(g2(2,4)==2.0f && g2.size()==15);
+		}
+
+		// Arena allocator
+		{
+			memory_arena arena(1024);
+			arena_allocator<float> const allocator(arena);
+
+			buffer<float, arena_allocator<float>> a(100, allocator);
+			assert_vcl_no_msg(is_aligned(a.data.data(), 64));
+			assert_vcl_no_msg(arena.blocks.size()==1 && arena.size_used==100*sizeof(float));
+
+			// Allocation larger than a block: a new block is added
+			buffer<vec3, arena_allocator<vec3>> b(1000, arena_allocator<vec3>(arena));
+			b[999] = { 1,2,3 };
+			assert_vcl_no_msg(arena.blocks.size()==2);
+			assert_vcl_no_msg(arena.size_used==100*sizeof(float)+1000*sizeof(vec3));
+			size_t const capacity = arena.capacity();
+
+			// Copies use the same arena
+			buffer<vec3, arena_allocator<vec3>> c = b;
+			assert_vcl_no_msg(c.data.get_allocator().arena==&arena);
+			assert_vcl_no_msg(is_equal(c[999], vec3(1,2,3)));
+
+			a.clear(); b.clear(); c.clear();
+			a.data.shrink_to_fit(); b.data.shrink_to_fit(); c.data.shrink_to_fit();
+
+			// After reset the blocks are merged
+			arena.reset();
+			assert_vcl_no_msg(arena.blocks.size()==1 && arena.capacity()>=capacity && arena.size_used==0);
+			buffer<vec3, arena_allocator<vec3>> d(1000, arena_allocator<vec3>(arena));
+			assert_vcl_no_msg(arena.blocks.size()==1);
+
+			// Default arena of the frame
+			buffer<float, arena_allocator<float>> e(10);
+			assert_vcl_no_msg(e.data.get_allocator().arena==&memory_arena::frame());
+			assert_vcl_no_msg(memory_arena::frame().size_used>=10*sizeof(float));
+			e.clear();
+			e.data.shrink_to_fit();
+			memory_arena::frame().reset();
+		}
+
+		// Huge page allocator
+		{
+			grid_3D<float, huge_page_allocator<float>> g(128);
+			assert_vcl_no_msg(is_aligned(g.data.data.data(), 64));
+			g(127,127,127) = 2.0f;
+			g(0,0,0) = 1.0f;
+			assert_vcl_no_msg(g(0,0,0)+g(127,127,127)==3.0f);
+
+			buffer<int, huge_page_allocator<int>> small = { 1,2,3 };
+			assert_vcl_no_msg(is_equal(small, { 1,2,3 }));
+			g.resize(2);
+			assert_vcl_no_msg(g.size()==8);
+		}
+	}
+}
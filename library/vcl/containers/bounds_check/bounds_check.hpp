@@ -0,0 +1,37 @@
+#pragma once
+
+/* Bound checking policies of the element access in the views (second template parameter of buffer_view and grid_2D_view)
+*  - bounds_check_default: checked unless VCL_NO_DEBUG is defined (same behavior as buffer, grid_2D, grid_3D, buffer_stack, etc.)
+*  - bounds_check_always: always checked, even when VCL_NO_DEBUG is defined (ex. code indexing with values coming from files or user input)
+*  - bounds_check_none: never checked (ex. inner loops of a kernel once its index range has been validated)
+*
+* The policy can be chosen locally without changing the global VCL_NO_DEBUG setting:
+*   buffer<vec3> p; ...
+*   auto pu = unchecked(p);   // buffer_view<vec3, bounds_check_none> on the same memory
+*   for(size_t k=0; k<N; ++k) pu[k] += ...;
+*   auto pc = checked(p);     // buffer_view<vec3, bounds_check_always>
+*
+* The containers also provide at_unsafe(...) for a single unchecked access.
+*/
+
+namespace vcl
+{
+    struct bounds_check_default
+    {
+#ifndef VCL_NO_DEBUG
+        static constexpr bool enabled = true;
+#else
+        static constexpr bool enabled = false;
+#endif
+    };
+
+    struct bounds_check_always
+    {
+        static constexpr bool enabled = true;
+    };
+
+    struct bounds_check_none
+    {
+        static constexpr bool enabled = false;
+    };
+}
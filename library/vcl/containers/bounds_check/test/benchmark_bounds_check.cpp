@@ -0,0 +1,82 @@
+#include "benchmark_bounds_check.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/interpolation/interpolation.hpp"
+#include "vcl/base/test/benchmark_timing.hpp"
+
+#include <iostream>
+
+using namespace vcl;
+
+// The comparison is meaningful in a debug-but-optimized build (ex. -O2 without VCL_NO_DEBUG): the checked accesses then test their index.
+//  With VCL_NO_DEBUG all the versions are expected to run at the same speed.
+
+namespace vcl_test
+{
+	// Discrete laplacian of the interior of the grid
+	template <typename Access>
+	static void laplacian(grid_2D<float>& out, size_t2 const& dimension, Access const& value)
+	{
+		for (size_t y = 1; y + 1 < dimension.y; ++y)
+			for (size_t x = 1; x + 1 < dimension.x; ++x)
+				out.at_unsafe(x, y) = value(x-1, y) + value(x+1, y) + value(x, y-1) + value(x, y+1) - 4*value(x, y);
+	}
+
+	void benchmark_bounds_check()
+	{
+#ifdef VCL_NO_DEBUG
+		std::cout << "Bound checking benchmark built with VCL_NO_DEBUG: the checked accesses are not tested" << std::endl;
+#endif
+		int const N_repeat = 20;
+		float checksum = 0.0f;
+
+		// Sum and axpy on 1D buffers
+		{
+			size_t const N = 4*1024*1024;
+			buffer<float> a(N);
+			for (size_t k = 0; k < N; ++k)
+				a[k] = float(k % 17);
+
+			std::cout << "Sum of " << N << " floats" << std::endl;
+			std::cout << "  operator[]       : " << timing([&]() { float s = 0; for (size_t k = 0; k < N; ++k) s += a[k]; checksum += s; }, N_repeat) << " ms" << std::endl;
+			std::cout << "  at_unsafe        : " << timing([&]() { float s = 0; for (size_t k = 0; k < N; ++k) s += a.at_unsafe(k); checksum += s; }, N_repeat) << " ms" << std::endl;
+			std::cout << "  unchecked view   : " << timing([&]() { auto ua = unchecked(a); float s = 0; for (size_t k = 0; k < N; ++k) s += ua[k]; checksum += s; }, N_repeat) << " ms" << std::endl;
+			std::cout << "  range-for        : " << timing([&]() { float s = 0; for (float x : a) s += x; checksum += s; }, N_repeat) << " ms" << std::endl;
+
+			buffer<vec3> p(N/4), v(N/4);
+			v.fill(vec3(1,2,3));
+			float const dt = 0.01f;
+			std::cout << "Update p += dt*v of " << p.size() << " vec3" << std::endl;
+			std::cout << "  operator[]       : " << timing([&]() { for (size_t k = 0; k < p.size(); ++k) p[k] += dt*v[k]; }, N_repeat) << " ms" << std::endl;
+			std::cout << "  unchecked view   : " << timing([&]() { auto up = unchecked(p); auto uv = unchecked(v); for (size_t k = 0; k < up.size(); ++k) up[k] += dt*uv[k]; }, N_repeat) << " ms" << std::endl;
+			checksum += p[0].x;
+		}
+
+		// 5-point stencil on a grid_2D
+		{
+			size_t const N = 1024;
+			grid_2D<float> g(N, N), out(N, N);
+			for (size_t k = 0; k < g.size(); ++k)
+				g[k] = float(k % 13);
+			grid_2D<float> const& cg = g;
+
+			std::cout << "Laplacian on a " << N << "x" << N << " grid_2D" << std::endl;
+			std::cout << "  operator()       : " << timing([&]() { laplacian(out, g.dimension, [&](size_t x, size_t y) { return cg(x, y); }); }, N_repeat) << " ms" << std::endl;
+			std::cout << "  at_unsafe        : " << timing([&]() { laplacian(out, g.dimension, [&](size_t x, size_t y) { return cg.at_unsafe(x, y); }); }, N_repeat) << " ms" << std::endl;
+			auto const ug = unchecked(cg);
+			std::cout << "  unchecked view   : " << timing([&]() { laplacian(out, g.dimension, [&](size_t x, size_t y) { return ug(x, y); }); }, N_repeat) << " ms" << std::endl;
+			checksum += out(N/2, N/2);
+
+			// Bilinear interpolation at regularly spaced positions
+			size_t const M = 1024*1024;
+			float const step = (N-1.5f) / M;
+			std::cout << "Bilinear interpolation of " << M << " values" << std::endl;
+			std::cout << "  checked          : " << timing([&]() { float s = 0; for (size_t k = 0; k < M; ++k) s += interpolation_bilinear(cg, k*step, (M-k)*step); checksum += s; }, N_repeat) << " ms" << std::endl;
+			std::cout << "  unchecked view   : " << timing([&]() { float s = 0; for (size_t k = 0; k < M; ++k) s += interpolation_bilinear(ug, k*step, (M-k)*step); checksum += s; }, N_repeat) << " ms" << std::endl;
+		}
+
+		std::cout << "(checksum " << checksum << ")" << std::endl;
+	}
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+
+namespace vcl_test
+{
+	void benchmark_bounds_check();
+}
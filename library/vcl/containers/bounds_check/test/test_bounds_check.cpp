@@ -0,0 +1,107 @@
+#include "test_bounds_check.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/interpolation/interpolation.hpp"
+
+#include <type_traits>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_bounds_check()
+	{
+		// Policies
+		{
+			assert_vcl_no_msg(bounds_check_always::enabled == true);
+			assert_vcl_no_msg(bounds_check_none::enabled == false);
+#ifndef VCL_NO_DEBUG
+			assert_vcl_no_msg(bounds_check_default::enabled == true);
+#else
+			assert_vcl_no_msg(bounds_check_default::enabled == false);
+#endif
+		}
+
+		// at_unsafe accesses the same elements as the checked operators
+		{
+			buffer<float> a = { 1,2,3,4 };
+			for (size_t k = 0; k < a.size(); ++k)
+				assert_vcl_no_msg(&a.at_unsafe(k) == &a[k]);
+			a.at_unsafe(2) = 5.0f;
+			assert_vcl_no_msg(is_equal(a[2], 5.0f));
+
+			grid_2D<int> g(3, 2);
+			for (size_t k = 0; k < g.size(); ++k)
+				g[k] = int(k);
+			for (size_t y = 0; y < 2; ++y)
+				for (size_t x = 0; x < 3; ++x)
+					assert_vcl_no_msg(&g.at_unsafe(x, y) == &g(x, y) && g.at_unsafe(x + 3*y) == g(x, y));
+
+			grid_3D<int> h(size_t3{ 2,3,4 });
+			for (size_t k = 0; k < h.size(); ++k)
+				h[k] = int(k);
+			for (size_t z = 0; z < 4; ++z)
+				for (size_t y = 0; y < 3; ++y)
+					for (size_t x = 0; x < 2; ++x)
+						assert_vcl_no_msg(&h.at_unsafe(x, y, z) == &h(x, y, z));
+
+			soa_buffer<vec3> p(buffer<vec3>{ {1,2,3}, {4,5,6} });
+			soa_buffer<vec3> const& cp = p;
+			assert_vcl_no_msg(is_equal(cp.at_unsafe(1), vec3(4,5,6)));
+			p.at_unsafe(0) = vec3(7,8,9);
+			assert_vcl_no_msg(is_equal(cp[0], vec3(7,8,9)));
+		}
+
+		// unchecked() and checked() views share the memory of the container
+		{
+			buffer<float> a = { 1,2,3 };
+			auto ua = unchecked(a);
+			static_assert(std::is_same<decltype(ua), buffer_view<float, bounds_check_none>>::value, "unchecked(buffer<T>&)");
+			ua[1] = 10.0f;
+			assert_vcl_no_msg(is_equal(a[1], 10.0f) && ua.size() == 3);
+
+			buffer<float> const& ca = a;
+			auto uca = unchecked(ca);
+			static_assert(std::is_same<decltype(uca), buffer_view<float const, bounds_check_none>>::value, "unchecked(buffer<T> const&)");
+			assert_vcl_no_msg(uca.data == a.data.data());
+
+			auto cva = checked(ua.subview(1));
+			static_assert(std::is_same<decltype(cva), buffer_view<float, bounds_check_always>>::value, "checked(buffer_view)");
+			assert_vcl_no_msg(is_equal(cva[0], 10.0f) && cva.size() == 2);
+
+			// Views with different policies convert to each other, and to read-only views
+			buffer_view<float const> v = ua;
+			assert_vcl_no_msg(v.data == a.data.data() && is_equal(v, a));
+
+			grid_2D<float> g(4, 3);
+			g.fill(1.0f);
+			auto ug = unchecked(g);
+			static_assert(std::is_same<decltype(ug), grid_2D_view<float, bounds_check_none>>::value, "unchecked(grid_2D<T>&)");
+			ug(2, 1) = 3.0f;
+			assert_vcl_no_msg(is_equal(g(2, 1), 3.0f) && &ug.at_unsafe(2, 1) == &g(2, 1));
+			auto row = ug.row(1);
+			static_assert(std::is_same<decltype(row), buffer_view<float, bounds_check_none>>::value, "row of an unchecked view");
+			assert_vcl_no_msg(is_equal(row[2], 3.0f));
+
+			// Bilinear interpolation gives the same value with checked and unchecked views
+			float const checked_value = interpolation_bilinear(g, 1.5f, 0.5f);
+			float const unchecked_value = interpolation_bilinear(unchecked(static_cast<grid_2D<float> const&>(g)), 1.5f, 0.5f);
+			assert_vcl_no_msg(is_equal(checked_value, 1.5f) && is_equal(checked_value, unchecked_value));
+		}
+
+		// Compound operators and reductions (unchecked inner loops) are unchanged
+		{
+			buffer<vec3> a = { {1,2,3}, {4,5,6} };
+			buffer<vec3> b = { {1,1,1}, {2,2,2} };
+			a += b;
+			a -= vec3(1,1,1);
+			assert_vcl_no_msg(is_equal(a, buffer<vec3>{ {1,2,3}, {5,6,7} }));
+			assert_vcl_no_msg(is_equal(average(a), vec3(3,4,5)));
+
+			buffer<float> c = { 3,-1,7,2 };
+			assert_vcl_no_msg(is_equal(min(c), -1.0f) && is_equal(max(c), 7.0f));
+		}
+	}
+}
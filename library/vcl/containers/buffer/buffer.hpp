@@ -1,9 +1,15 @@
 #pragma once
 
 #include "vcl/base/base.hpp"
+#include "vcl/containers/expression/expression.hpp"
+#include "vcl/containers/buffer_view/buffer_view.hpp"
 
 #include <vector>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
 
 /* ************************************************** */
 /*           Header                                   */
@@ -16,42 +22,69 @@ namespace vcl
  *
  * The buffer structure is a wrapper around an std::vector with additional convenient functionalities
  * - Overloaded operators + - * / as well as common outputs
- * - Strict bound checking with operator [] and () (unless VCL_NO_DEBUG is defined)
+ *   The operators are evaluated lazily: a = b + 0.5f*c is computed in a single loop without temporary buffer (see containers/expression)
+ * - Strict bound checking with operator [] and () (unless VCL_NO_DEBUG is defined), at_unsafe(index) for an access without check
  *
  * Buffer follows the main syntax than std::vector
  * Elements in a buffer sotred contiguously in memory (use std::vector internally)
  *
+ * The Allocator of the std::vector can be changed (default: std::allocator), see containers/allocator
+ *   buffer<vec3, aligned_allocator<vec3>> - 64-byte aligned data
+ *   buffer<vec3, arena_allocator<vec3>>   - temporary data allocated in a per-frame memory_arena
  **/
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 struct buffer
 {
+    using value_type = T;
+    using allocator_type = Allocator;
+
     /** Internal data stored as std::vector */
-    std::vector<T> data;
+    std::vector<T, Allocator> data;
 
     // Constructors
     buffer();                             // Empty buffer - no elements 
     buffer(size_t size);                  // Buffer with a given size 
     buffer(std::initializer_list<T> arg); // Inline initialization using { } 
-    buffer(std::vector<T> const& arg);    // Direct initialization from std::vector 
+    buffer(std::vector<T, Allocator> const& arg);    // Direct initialization from std::vector 
+    buffer(std::vector<T, Allocator>&& arg);         // Initialization taking the elements of a temporary std::vector (no copy)
+    explicit buffer(Allocator const& allocator);     // Empty buffer using a given allocator instance (ex. a specific arena)
+    buffer(size_t size, Allocator const& allocator); // Buffer with a given size using a given allocator instance
+
+    /** Evaluation of an expression of buffers (result of the operators + - * /) */
+    template <typename E, typename = enable_if_expression_of<E, buffer<T, Allocator>>> buffer(E const& e);
+    template <typename E, typename = enable_if_expression_of<E, buffer<T, Allocator>>> buffer<T, Allocator>& operator=(E const& e);
 
     /** Similar to matlab linespace 
     * Linear interpolation between p1 and p2 along N variable */
-    static buffer<T> linespace(T const& p1, T const& p2, size_t N);
+    static buffer<T, Allocator> linespace(T const& p1, T const& p2, size_t N);
 
     /** Container size similar to vector.size() */
     size_t size() const;
     /** Resize container to a new size (similar to vector.resize()) */
-    buffer<T>& resize(size_t size);
+    buffer<T, Allocator>& resize(size_t size);
     /** Resize container to a new size, and clear it initialy to delete previous values */
-    buffer<T>& resize_clear(size_t size);
+    buffer<T, Allocator>& resize_clear(size_t size);
+    /** Number of elements that can be stored without reallocation (similar to vector.capacity()) */
+    size_t capacity() const;
+    /** Allocate the memory for at least capacity elements, the size is unchanged (similar to vector.reserve()) */
+    buffer<T, Allocator>& reserve(size_t capacity);
     /** Add an element at the end of the container (similar to vector.push_back()) */
-    buffer<T>& push_back(T const& value);
-    /** Add an buffer of elements at the end of the container */
-    buffer<T>& push_back(buffer<T> const& value);
+    buffer<T, Allocator>& push_back(T const& value);
+    buffer<T, Allocator>& push_back(T&& value);
+    /** Build an element in place at the end of the container and return it (similar to vector.emplace_back()) */
+    template <typename... Args> T& emplace_back(Args&&... args);
+    /** Add an buffer of elements at the end of the container (single allocation, and memcpy for trivially copyable elements) */
+    buffer<T, Allocator>& push_back(buffer<T, Allocator> const& value);
+    /** Add the elements of a temporary buffer at the end of the container (an empty buffer takes its memory without copy) */
+    buffer<T, Allocator>& push_back(buffer<T, Allocator>&& value);
+    /** Insert a range of elements before the element at index (index=size() adds them at the end)
+     * The range is any buffer_view (buffer, std::vector, part of a buffer, raw memory), and may be a part of this buffer.
+     * The elements are copied with memcpy when T is trivially copyable. */
+    buffer<T, Allocator>& insert(size_t index, buffer_view<T const> values);
     /** Remove all elements of the container, new size is 0 (similar to vector.clear()) */
-    buffer<T>& clear();
+    buffer<T, Allocator>& clear();
     /** Fill the container with the same element (from index 0 to size-1) */
-    buffer<T>& fill(T const& value);
+    buffer<T, Allocator>& fill(T const& value);
 
     /** Element access
      * Allows buffer[i], buffer(i), and buffer.at(i)
@@ -74,76 +107,69 @@ struct buffer
     T const& at(size_t index) const; // Internal call to std::vector.at
     T & at(size_t index);            // Internal call to std::vector.at
 
+    /** Element access without bound checking, even in debug mode
+     * Use in inner loops once the index range has been validated (see also unchecked(buffer) in buffer_view). */
+    T const& at_unsafe(size_t index) const;
+    T & at_unsafe(size_t index);
+
     /** Iterators
      * Iterators on buffer are compatible with STL syntax
      * allows "forall" loops (for(auto& e : buffer) {...}) */
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::const_iterator end() const;
-    typename std::vector<T>::const_iterator cbegin() const;
-    typename std::vector<T>::const_iterator cend() const;
+    typename std::vector<T, Allocator>::iterator begin();
+    typename std::vector<T, Allocator>::iterator end();
+    typename std::vector<T, Allocator>::const_iterator begin() const;
+    typename std::vector<T, Allocator>::const_iterator end() const;
+    typename std::vector<T, Allocator>::const_iterator cbegin() const;
+    typename std::vector<T, Allocator>::const_iterator cend() const;
 };
 
-template <typename T> std::string type_str(buffer<T> const&);
+template <typename T, typename Allocator> std::string type_str(buffer<T, Allocator> const&);
 
 /** Display all elements of the buffer.*/
-template <typename T> std::ostream& operator<<(std::ostream& s, buffer<T> const& v);
+template <typename T, typename Allocator> std::ostream& operator<<(std::ostream& s, buffer<T, Allocator> const& v);
 
 /** Convert all elements of the buffer to a string.
  * \param buffer: the input buffer
  * \param separator: the separator between each element 
  * \param begin/end: character added in the beginning/end of the display
  */
-template <typename T> std::string str(buffer<T> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
+template <typename T, typename Allocator> std::string str(buffer<T, Allocator> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
 
-template <typename T> size_t size_in_memory(buffer<T> const& v);
-template <typename T> auto const* ptr(buffer<T> const& v);
+template <typename T, typename Allocator> size_t size_in_memory(buffer<T, Allocator> const& v);
+template <typename T, typename Allocator> auto const* ptr(buffer<T, Allocator> const& v);
 
 /** Equality check
  * Check equality (element by element) between two buffers.
  * Buffers with different size are always considered as not equal.
  * Only approximated equality is performed for comprison with float (absolute value between floats) */
-template <typename T> bool is_equal(buffer<T> const& a, buffer<T> const& b);
+template <typename T, typename Allocator> bool is_equal(buffer<T, Allocator> const& a, buffer<T, Allocator> const& b);
 /** Allows to check value equality between different type (float and int for instance). */
-template <typename T1, typename T2> bool is_equal(buffer<T1> const& a, buffer<T2> const& b);
+template <typename T1, typename A1, typename T2, typename A2> bool is_equal(buffer<T1, A1> const& a, buffer<T2, A2> const& b);
 
 
-template <typename T> T max(buffer<T> const& v);
-template <typename T> T min(buffer<T> const& v);
+template <typename T, typename Allocator> T max(buffer<T, Allocator> const& v);
+template <typename T, typename Allocator> T min(buffer<T, Allocator> const& v);
 
 
 /** Compute average value of all elements of the buffer.*/
-template <typename T> T average(buffer<T> const& a);
+template <typename T, typename Allocator> T average(buffer<T, Allocator> const& a);
 
 
 /** Math operators
- * Common mathematical operations between buffers, and scalar or element values. */
-
-template <typename T> buffer<T>  operator-(buffer<T> const& a);
+ * Common mathematical operations between buffers, and scalar or element values.
+ * The operators + - * / returning a new buffer are the lazy expressions of containers/expression/expression.hpp */
 
-template <typename T> buffer<T>& operator+=(buffer<T>& a, buffer<T> const& b);
-template <typename T> buffer<T>& operator+=(buffer<T>& a, T const& b);
-template <typename T> buffer<T>  operator+(buffer<T> const& a, buffer<T> const& b);
-template <typename T> buffer<T>  operator+(buffer<T> const& a, T const& b); // Componentwise sum: a[i]+b 
-template <typename T> buffer<T>  operator+(T const& a, buffer<T> const& b); // Componentwise sum: a+b[i]
+template <typename T, typename Allocator> buffer<T, Allocator>& operator+=(buffer<T, Allocator>& a, buffer<T, Allocator> const& b);
+template <typename T, typename Allocator> buffer<T, Allocator>& operator+=(buffer<T, Allocator>& a, T const& b);
 
-template <typename T> buffer<T>& operator-=(buffer<T>& a, buffer<T> const& b);
-template <typename T> buffer<T>& operator-=(buffer<T>& a, T const& b);
-template <typename T> buffer<T>  operator-(buffer<T> const& a, buffer<T> const& b);
-template <typename T> buffer<T>  operator-(buffer<T> const& a, T const& b); // Componentwise substraction: a[i]-b 
-template <typename T> buffer<T>  operator-(T const& a, buffer<T> const& b); // Componentwise substraction: a-b[i] 
+template <typename T, typename Allocator> buffer<T, Allocator>& operator-=(buffer<T, Allocator>& a, buffer<T, Allocator> const& b);
+template <typename T, typename Allocator> buffer<T, Allocator>& operator-=(buffer<T, Allocator>& a, T const& b);
 
-template <typename T> buffer<T>& operator*=(buffer<T>& a, buffer<T> const& b);
-template <typename T> buffer<T>  operator*(buffer<T> const& a, buffer<T> const& b);
-template <typename T> buffer<T>& operator*=(buffer<T>& a, float b);
-template <typename T> buffer<T>  operator*(buffer<T> const& a, float b);
-template <typename T> buffer<T>  operator*(float a, buffer<T> const& b);
+template <typename T, typename Allocator> buffer<T, Allocator>& operator*=(buffer<T, Allocator>& a, buffer<T, Allocator> const& b);
+template <typename T, typename Allocator> buffer<T, Allocator>& operator*=(buffer<T, Allocator>& a, float b);
 
-template <typename T> buffer<T>& operator/=(buffer<T>& a, buffer<T> const& b);
-template <typename T> buffer<T>& operator/=(buffer<T>& a, float b);
-template <typename T> buffer<T>  operator/(buffer<T> const& a, buffer<T> const& b);
-template <typename T> buffer<T>  operator/(buffer<T> const& a, float b);
+template <typename T, typename Allocator> buffer<T, Allocator>& operator/=(buffer<T, Allocator>& a, buffer<T, Allocator> const& b);
+template <typename T, typename Allocator> buffer<T, Allocator>& operator/=(buffer<T, Allocator>& a, float b);
 
 
 }
@@ -157,71 +183,184 @@ template <typename T> buffer<T>  operator/(buffer<T> const& a, float b);
 namespace vcl
 {
 
-template <typename T>
-buffer<T>::buffer()
+template <typename T, typename Allocator>
+buffer<T, Allocator>::buffer()
     :data()
 {}
 
-template <typename T>
-buffer<T>::buffer(size_t size)
+template <typename T, typename Allocator>
+buffer<T, Allocator>::buffer(size_t size)
     :data(size)
 {}
 
-template <typename T>
-buffer<T>::buffer(std::initializer_list<T> arg)
+template <typename T, typename Allocator>
+buffer<T, Allocator>::buffer(std::initializer_list<T> arg)
     :data(arg)
 {}
 
-template <typename T>
-buffer<T>::buffer(const std::vector<T>& arg)
+template <typename T, typename Allocator>
+buffer<T, Allocator>::buffer(const std::vector<T, Allocator>& arg)
     :data(arg)
 {}
 
-template <typename T>
-size_t buffer<T>::size() const
+template <typename T, typename Allocator>
+buffer<T, Allocator>::buffer(std::vector<T, Allocator>&& arg)
+    :data(std::move(arg))
+{}
+
+template <typename T, typename Allocator>
+buffer<T, Allocator>::buffer(Allocator const& allocator)
+    :data(allocator)
+{}
+
+template <typename T, typename Allocator>
+buffer<T, Allocator>::buffer(size_t size, Allocator const& allocator)
+    :data(size, allocator)
+{}
+
+template <typename T, typename Allocator>
+template <typename E, typename>
+buffer<T, Allocator>::buffer(E const& e)
+    :data(e.size())
+{
+    detail::expression_assign(*this, e);
+}
+
+template <typename T, typename Allocator>
+template <typename E, typename>
+buffer<T, Allocator>& buffer<T, Allocator>::operator=(E const& e)
+{
+    detail::expression_assign(*this, e);
+    return *this;
+}
+
+template <typename T, typename Allocator>
+size_t buffer<T, Allocator>::size() const
 {
     return data.size();
 }
 
-template <typename T>
-buffer<T>& buffer<T>::resize(size_t size)
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::resize(size_t size)
 {
     data.resize(size);
     return *this;
 }
 
-template <typename T>
-buffer<T>& buffer<T>::resize_clear(size_t size)
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::resize_clear(size_t size)
 {
     clear();
     resize(size);
     return *this;
 }
 
-template <typename T>
-buffer<T>& buffer<T>::push_back(T const& value)
+template <typename T, typename Allocator>
+size_t buffer<T, Allocator>::capacity() const
+{
+    return data.capacity();
+}
+
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::reserve(size_t capacity_arg)
+{
+    data.reserve(capacity_arg);
+    return *this;
+}
+
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::push_back(T const& value)
 {
     data.push_back(value);
     return *this;
 }
 
-template <typename T>
-buffer<T>& buffer<T>::push_back(buffer<T> const& value)
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::push_back(T&& value)
+{
+    data.push_back(std::move(value));
+    return *this;
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+T& buffer<T, Allocator>::emplace_back(Args&&... args)
+{
+    data.emplace_back(std::forward<Args>(args)...);
+    return data.back();
+}
+
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::push_back(buffer<T, Allocator> const& value)
+{
+    return insert(size(), value);
+}
+
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::push_back(buffer<T, Allocator>&& value)
+{
+    // Take the memory of value, unless the current (empty) buffer already has enough memory reserved
+    if (data.empty() && data.capacity() < value.size())
+        data = std::move(value.data);
+    else
+        insert(size(), value);
+    return *this;
+}
+
+namespace detail
+{
+    // Insertion of N elements at index, the capacity of data is already sufficient
+    template <typename T, typename Allocator>
+    void buffer_insert(std::vector<T, Allocator>& data, size_t index, T const* values, size_t N, std::true_type /*trivially copyable*/)
+    {
+        size_t const old_size = data.size();
+        data.resize(old_size + N);
+        T* const p = data.data();
+        if (index < old_size)
+            std::memmove(p + index + N, p + index, (old_size - index)*sizeof(T));
+        std::memcpy(p + index, values, N*sizeof(T));
+    }
+
+    template <typename T, typename Allocator>
+    void buffer_insert(std::vector<T, Allocator>& data, size_t index, T const* values, size_t N, std::false_type /*trivially copyable*/)
+    {
+        data.insert(data.begin() + index, values, values + N);
+    }
+}
+
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::insert(size_t index, buffer_view<T const> values)
 {
-    for(T const& element : value)
-        data.push_back(element);
+    assert_vcl(index <= size(), "Insertion at index " + str(index) + " in a buffer of size " + str(size()));
+    size_t const N = values.size();
+    if (N == 0)
+        return *this;
+
+    // The inserted elements are part of this buffer: they are copied before a possible reallocation
+    std::less<T const*> const before;
+    if (before(values.data, data.data()+data.size()) && before(data.data(), values.data+N)) {
+        std::vector<T> const copy(values.begin(), values.end());
+        return insert(index, copy);
+    }
+
+    // Geometric growth: repeated insertions remain in amortized constant time per element
+    size_t const new_size = data.size() + N;
+    if (new_size > data.capacity())
+        data.reserve(std::max(new_size, 2*data.capacity()));
+
+    detail::buffer_insert(data, index, values.data, N, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
     return *this;
 }
 
-template <typename T>
-buffer<T>& buffer<T>::clear()
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::clear()
 {
     data.clear();
     return *this;
 }
 
-template <typename T>
-buffer<T>& buffer<T>::fill(T const& value)
+template <typename T, typename Allocator>
+buffer<T, Allocator>& buffer<T, Allocator>::fill(T const& value)
 {
     size_t const N = size();
     for (size_t k = 0; k < N; ++k)
@@ -229,7 +368,7 @@ buffer<T>& buffer<T>::fill(T const& value)
     return *this;
 }
 
-template <typename T> std::string type_str(buffer<T> const&)
+template <typename T, typename Allocator> std::string type_str(buffer<T, Allocator> const&)
 {
     using vcl::type_str;
     return "buffer<" + type_str(T()) + ">";
@@ -237,8 +376,8 @@ template <typename T> std::string type_str(buffer<T> const&)
 
 
 
-template <typename T, typename INDEX_TYPE>
-void check_index_bounds(INDEX_TYPE index, buffer<T> const& data)
+template <typename T, typename Allocator, typename INDEX_TYPE>
+void check_index_bounds(INDEX_TYPE index, buffer<T, Allocator> const& data)
 {
 #ifndef VCL_NO_DEBUG
     size_t const N = data.size();
@@ -294,57 +433,57 @@ void check_index_bounds(INDEX_TYPE index, buffer<T> const& data)
 #endif
 }
 
-template <typename T>
-T const& buffer<T>::operator[](int index) const
+template <typename T, typename Allocator>
+T const& buffer<T, Allocator>::operator[](int index) const
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T& buffer<T>::operator[](int index)
+template <typename T, typename Allocator>
+T& buffer<T, Allocator>::operator[](int index)
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T const& buffer<T>::operator()(int index) const
+template <typename T, typename Allocator>
+T const& buffer<T, Allocator>::operator()(int index) const
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T& buffer<T>::operator()(int index)
+template <typename T, typename Allocator>
+T& buffer<T, Allocator>::operator()(int index)
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T const& buffer<T>::operator[](unsigned int index) const
+template <typename T, typename Allocator>
+T const& buffer<T, Allocator>::operator[](unsigned int index) const
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T & buffer<T>::operator[](unsigned int index)
+template <typename T, typename Allocator>
+T & buffer<T, Allocator>::operator[](unsigned int index)
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T const& buffer<T>::operator()(unsigned int index) const
+template <typename T, typename Allocator>
+T const& buffer<T, Allocator>::operator()(unsigned int index) const
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T & buffer<T>::operator()(unsigned int index)
+template <typename T, typename Allocator>
+T & buffer<T, Allocator>::operator()(unsigned int index)
 {
     check_index_bounds(index, *this);
     return data[index];
@@ -352,141 +491,151 @@ T & buffer<T>::operator()(unsigned int index)
 
 
 
-template <typename T>
-T const& buffer<T>::operator[](size_t index) const
+template <typename T, typename Allocator>
+T const& buffer<T, Allocator>::operator[](size_t index) const
 {
     check_index_bounds(index, *this);
     return data[index];
 }
-template <typename T>
-T & buffer<T>::operator[](size_t index)
+template <typename T, typename Allocator>
+T & buffer<T, Allocator>::operator[](size_t index)
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T const& buffer<T>::operator()(size_t index) const
+template <typename T, typename Allocator>
+T const& buffer<T, Allocator>::operator()(size_t index) const
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T & buffer<T>::operator()(size_t index)
+template <typename T, typename Allocator>
+T & buffer<T, Allocator>::operator()(size_t index)
 {
     check_index_bounds(index, *this);
     return data[index];
 }
 
-template <typename T>
-T const& buffer<T>::at(size_t index) const
+template <typename T, typename Allocator>
+T const& buffer<T, Allocator>::at(size_t index) const
 {
     return data.at(index);
 }
+template <typename T, typename Allocator>
+T const& buffer<T, Allocator>::at_unsafe(size_t index) const
+{
+    return data[index];
+}
+template <typename T, typename Allocator>
+T & buffer<T, Allocator>::at_unsafe(size_t index)
+{
+    return data[index];
+}
 
-template <typename T>
-T & buffer<T>::at(size_t index)
+template <typename T, typename Allocator>
+T & buffer<T, Allocator>::at(size_t index)
 {
     return data.at(index);
 }
 
 
 
-template <typename T>
-typename std::vector<T>::iterator buffer<T>::begin()
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator buffer<T, Allocator>::begin()
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::iterator buffer<T>::end()
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::iterator buffer<T, Allocator>::end()
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator buffer<T>::begin() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator buffer<T, Allocator>::begin() const
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator buffer<T>::end() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator buffer<T, Allocator>::end() const
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator buffer<T>::cbegin() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator buffer<T, Allocator>::cbegin() const
 {
     return data.cbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator buffer<T>::cend() const
+template <typename T, typename Allocator>
+typename std::vector<T, Allocator>::const_iterator buffer<T, Allocator>::cend() const
 {
     return data.cend();
 }
 
 
-template <typename T> std::ostream& operator<<(std::ostream& s, buffer<T> const& v)
+template <typename T, typename Allocator> std::ostream& operator<<(std::ostream& s, buffer<T, Allocator> const& v)
 {
     std::string const s_out = str(v);
     s << s_out;
     return s;
 }
-template <typename T> std::string str(buffer<T> const& v, std::string const& separator, std::string const& begin, std::string const& end)
+template <typename T, typename Allocator> std::string str(buffer<T, Allocator> const& v, std::string const& separator, std::string const& begin, std::string const& end)
 {
     return vcl::detail::str_container(v, separator, begin, end);
 }
 
-template <typename T> size_t size_in_memory(buffer<T> const& v)
+template <typename T, typename Allocator> size_t size_in_memory(buffer<T, Allocator> const& v)
 {
     size_t s = 0;
     size_t const N = v.size();
     for (size_t k = 0; k < N; ++k)
-        s += vcl::size_in_memory(v[k]);
+        s += vcl::size_in_memory(v.at_unsafe(k));
     return s;
 }
 
-template <typename T> T average(buffer<T> const& a)
+template <typename T, typename Allocator> T average(buffer<T, Allocator> const& a)
 {
     size_t const N = a.size();
     assert_vcl(N>0, "Cannot compute average on empty buffer");
 
     T value = {}; // assume value start at zero
     for(size_t k=0; k<N; ++k)
-        value += a[k];
+        value += a.at_unsafe(k);
     value /= float(N);
 
     return value;
 }
 
 
-template <typename T> T max(buffer<T> const& v)
+template <typename T, typename Allocator> T max(buffer<T, Allocator> const& v)
 {
     size_t const N = v.size();
     assert_vcl(N>0, "Cannot get max on empty buffer");
 
-    T const& current_max = v[0];
+    T current_max = v.at_unsafe(0);
     for (size_t k = 1; k < N; ++k) {
-        T const& element = v[k];
+        T const& element = v.at_unsafe(k);
         if(element>current_max) 
             current_max = element;
     }
         
     return current_max;
 }
-template <typename T> T min(buffer<T> const& v)
+template <typename T, typename Allocator> T min(buffer<T, Allocator> const& v)
 {
     size_t const N = v.size();
-    assert_vcl(N>0, "Cannot get max on empty buffer");
+    assert_vcl(N>0, "Cannot get min on empty buffer");
 
-    T const& current_min = v[0];
+    T current_min = v.at_unsafe(0);
     for (size_t k = 1; k < N; ++k) {
-        T const& element = v[k];
-        if(element>current_min) 
+        T const& element = v.at_unsafe(k);
+        if(element<current_min) 
             current_min = element;
     }
         
@@ -494,182 +643,82 @@ template <typename T> T min(buffer<T> const& v)
 }
 
 
-template <typename T>
-buffer<T>& operator+=(buffer<T>& a, buffer<T> const& b)
+template <typename T, typename Allocator>
+buffer<T, Allocator>& operator+=(buffer<T, Allocator>& a, buffer<T, Allocator> const& b)
 {
     assert_vcl(a.size()>0 && b.size()>0, "Size must be >0");
     assert_vcl(a.size()==b.size(), "Size do not agree");
 
     const size_t N = a.size();
     for(size_t k=0; k<N; ++k)
-        a[k] += b[k];
+        a.at_unsafe(k) += b.at_unsafe(k);
     return a;
 }
 
-template <typename T>
-buffer<T>& operator+=(buffer<T>& a, T const& b)
+template <typename T, typename Allocator>
+buffer<T, Allocator>& operator+=(buffer<T, Allocator>& a, T const& b)
 {
     assert_vcl(a.size()>0, "Size must be >0");
     const size_t N = a.size();
     for(size_t k=0; k<N; ++k)
-        a[k] += b;
+        a.at_unsafe(k) += b;
     return a;
 }
 
-template <typename T>
-buffer<T>  operator+(buffer<T> const& a, buffer<T> const& b)
-{
-    buffer<T> res = a;
-    res += b;
-    return res;
-}
-
-template <typename T>
-buffer<T>  operator+(buffer<T> const& a, T const& b)
-{
-    buffer<T> res = a;
-    res += b;
-    return res;
-}
-
-template <typename T>
-buffer<T>  operator+(T const& a, buffer<T> const& b)
-{
-    size_t const N = b.size();
-    buffer<T> res(N);
-    for(size_t k=0; k<N; ++k)
-        res[k] = a+b[k];
-    return res;
-}
-
-template <typename T> buffer<T>  operator-(buffer<T> const& a)
-{
-    size_t const N = a.size();
-    buffer<T> b(N);
-    for(size_t k=0; k<N; ++k)
-        b[k] = -a[k];
-    return b;
-}
-
-
-template <typename T> buffer<T>& operator-=(buffer<T>& a, buffer<T> const& b)
+template <typename T, typename Allocator> buffer<T, Allocator>& operator-=(buffer<T, Allocator>& a, buffer<T, Allocator> const& b)
 {
     assert_vcl(a.size()>0 && b.size()>0, "Size must be >0");
     assert_vcl(a.size()==b.size(), "Size do not agree");
 
     const size_t N = a.size();
     for(size_t k=0; k<N; ++k)
-        a[k] -= b[k];
+        a.at_unsafe(k) -= b.at_unsafe(k);
     return a;
 }
-template <typename T> buffer<T>& operator-=(buffer<T>& a, T const& b)
+template <typename T, typename Allocator> buffer<T, Allocator>& operator-=(buffer<T, Allocator>& a, T const& b)
 {
     assert_vcl(a.size()>0, "Size must be >0");
     const size_t N = a.size();
     for(size_t k=0; k<N; ++k)
-        a[k] -= b;
+        a.at_unsafe(k) -= b;
     return a;
 }
-template <typename T> buffer<T>  operator-(buffer<T> const& a, buffer<T> const& b)
-{
-    buffer<T> res = a;
-    res -= b;
-    return res;
-}
-template <typename T> buffer<T>  operator-(buffer<T> const& a, T const& b)
-{
-    buffer<T> res = a;
-    res -= b;
-    return res;
-}
-template <typename T> buffer<T>  operator-(T const& a, buffer<T> const& b)
-{
-    size_t const N = b.size();
-    buffer<T> res(N);
-    for(size_t k=0; k<N; ++k)
-        res[k] = a-b[k];
-    return res;
-}
-
-
-template <typename T> buffer<T>& operator*=(buffer<T>& a, buffer<T> const& b)
+template <typename T, typename Allocator> buffer<T, Allocator>& operator*=(buffer<T, Allocator>& a, buffer<T, Allocator> const& b)
 {
     assert_vcl(a.size()>0 && b.size()>0, "Size must be >0");
     assert_vcl(a.size()==b.size(), "Size do not agree");
 
     const size_t N = a.size();
     for(size_t k=0; k<N; ++k)
-        a[k] *= b[k];
+        a.at_unsafe(k) *= b.at_unsafe(k);
     return a;
 }
-template <typename T> buffer<T>  operator*(buffer<T> const& a, buffer<T> const& b)
-{
-    buffer<T> res = a;
-    res *= b;
-    return res;
-}
-
-
-
-
-template <typename T> buffer<T>& operator*=(buffer<T>& a, float b)
+template <typename T, typename Allocator> buffer<T, Allocator>& operator*=(buffer<T, Allocator>& a, float b)
 {
     size_t const N = a.size();
     for(size_t k=0; k<N; ++k)
-        a[k] *= b;
+        a.at_unsafe(k) *= b;
     return a;
 }
-template <typename T> buffer<T>  operator*(buffer<T> const& a, float b)
-{
-    size_t const N = a.size();
-    buffer<T> res(N);
-    for(size_t k=0; k<N; ++k)
-        res[k] = a[k]*b;
-    return res;
-}
-template <typename T> buffer<T>  operator*(float a, buffer<T> const& b)
-{
-    size_t const N = b.size();
-    buffer<T> res(N);
-    for(size_t k=0; k<N; ++k)
-        res[k] = a*b[k];
-    return res;
-}
-
-template <typename T> buffer<T>& operator/=(buffer<T>& a, buffer<T> const& b)
+template <typename T, typename Allocator> buffer<T, Allocator>& operator/=(buffer<T, Allocator>& a, buffer<T, Allocator> const& b)
 {
     assert_vcl(a.size()>0 && b.size()>0, "Size must be >0");
     assert_vcl(a.size()==b.size(), "Size do not agree");
 
     const size_t N = a.size();
     for(size_t k=0; k<N; ++k)
-        a[k] /= b[k];
+        a.at_unsafe(k) /= b.at_unsafe(k);
     return a;
 }
-template <typename T> buffer<T>& operator/=(buffer<T>& a, float b)
+template <typename T, typename Allocator> buffer<T, Allocator>& operator/=(buffer<T, Allocator>& a, float b)
 {
     assert_vcl(a.size()>0, "Size must be >0");
     const size_t N = a.size();
     for(size_t k=0; k<N; ++k)
-        a[k] /= b;
+        a.at_unsafe(k) /= b;
     return a;
 }
-template <typename T> buffer<T>  operator/(buffer<T> const& a, buffer<T> const& b)
-{
-    buffer<T> res = a;
-    res /= b;
-    return res;
-}
-template <typename T> buffer<T>  operator/(buffer<T> const& a, float b)
-{
-    buffer<T> res = a;
-    res /= b;
-    return res;
-}
-
-
-
-template <typename T1, typename T2> bool is_equal(buffer<T1> const& a, buffer<T2> const& b)
+template <typename T1, typename A1, typename T2, typename A2> bool is_equal(buffer<T1, A1> const& a, buffer<T2, A2> const& b)
 {
     size_t const N = a.size();
     if(b.size()!=N)
@@ -677,19 +726,19 @@ template <typename T1, typename T2> bool is_equal(buffer<T1> const& a, buffer<T2
 
     using vcl::is_equal;
     for(size_t k=0; k<N; ++k)
-        if( is_equal(a[k],b[k])==false )
+        if( is_equal(a.at_unsafe(k),b.at_unsafe(k))==false )
             return false;
     return true;
 }
-template <typename T> bool is_equal(buffer<T> const& a, buffer<T> const& b)
+template <typename T, typename Allocator> bool is_equal(buffer<T, Allocator> const& a, buffer<T, Allocator> const& b)
 {
-    return is_equal<T,T>(a,b);
+    return is_equal<T, Allocator, T, Allocator>(a, b);
 }
 
-template <typename T>
-buffer<T> buffer<T>::linespace(T const& p1, T const& p2, size_t N)
+template <typename T, typename Allocator>
+buffer<T, Allocator> buffer<T, Allocator>::linespace(T const& p1, T const& p2, size_t N)
 {
-    buffer<T> buf; 
+    buffer<T, Allocator> buf; 
     buf.resize(N);
 
     T const increment = (p2 - p1) / float(N - 1);
@@ -703,7 +752,7 @@ buffer<T> buffer<T>::linespace(T const& p1, T const& p2, size_t N)
 
 }
 
-template <typename T> auto const* ptr(buffer<T> const& v)
+template <typename T, typename Allocator> auto const* ptr(buffer<T, Allocator> const& v)
 {
     using vcl::ptr;
     return ptr(v[0]);
@@ -102,5 +102,54 @@ namespace vcl_test
 			assert_vcl_no_msg(vcl::is_equal(a[5], 8.2f));
 		}
 
+		// Move from std::vector, reserve, emplace_back
+		{
+			std::vector<int> v = { 1,2,3 };
+			int const* p = v.data();
+			vcl::buffer<int> a = std::move(v);
+			assert_vcl_no_msg(a.size()==3 && &a[0]==p);
+
+			a.reserve(100);
+			assert_vcl_no_msg(a.capacity()>=100 && a.size()==3);
+			p = &a[0];
+			int& e = a.emplace_back(4);
+			assert_vcl_no_msg(e==4 && a.size()==4 && &a[0]==p);
+
+			vcl::buffer<vcl::buffer<int>> b;
+			b.emplace_back(size_t(2));
+			assert_vcl_no_msg(b.size()==1 && b[0].size()==2);
+		}
+
+		// Bulk append and insertion
+		{
+			vcl::buffer<int> a = { 1,2 };
+			a.push_back(vcl::buffer<int>{ 3,4 });
+			assert_vcl_no_msg(vcl::is_equal(a, vcl::buffer<int>{ 1,2,3,4 }));
+
+			a.insert(1, std::vector<int>{ 8,9 });
+			assert_vcl_no_msg(vcl::is_equal(a, vcl::buffer<int>{ 1,8,9,2,3,4 }));
+			a.insert(0, vcl::buffer<int>{ 0 });
+			a.insert(a.size(), vcl::buffer<int>{ 5 });
+			assert_vcl_no_msg(vcl::is_equal(a, vcl::buffer<int>{ 0,1,8,9,2,3,4,5 }));
+
+			// The inserted range is a part of the buffer itself
+			a.insert(2, vcl::buffer_view<int const>(a).subview(0, 3));
+			assert_vcl_no_msg(vcl::is_equal(a, vcl::buffer<int>{ 0,1,0,1,8,8,9,2,3,4,5 }));
+			a.push_back(a);
+			assert_vcl_no_msg(a.size()==22 && a[11]==0 && a[21]==5);
+
+			// Elements that are not trivially copyable
+			vcl::buffer<std::string> s = { "a", "d" };
+			s.insert(1, std::vector<std::string>{ "b", "c" });
+			assert_vcl_no_msg(s.size()==4 && s[1]=="b" && s[2]=="c" && s[3]=="d");
+
+			// An empty buffer takes the memory of a temporary one
+			vcl::buffer<int> c = { 1,2,3 };
+			int const* p = &c[0];
+			vcl::buffer<int> d;
+			d.push_back(std::move(c));
+			assert_vcl_no_msg(d.size()==3 && &d[0]==p);
+		}
+
 	}
 }
\ No newline at end of file
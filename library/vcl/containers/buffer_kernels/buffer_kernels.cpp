@@ -0,0 +1,608 @@
+#include "buffer_kernels.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define VCL_KERNELS_SSE
+#define VCL_KERNELS_AVX
+// AVX functions are compiled for this instruction set only, and called only if the CPU supports it
+#if defined(__GNUC__) || defined(__clang__)
+#define VCL_TARGET_AVX __attribute__((target("avx")))
+#else
+#define VCL_TARGET_AVX
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace vcl
+{
+	static float const normalize_epsilon = 1e-12f;
+
+
+	// ********************************************** //
+	//  Scalar kernels (also used for the remainders)
+	// ********************************************** //
+
+	// y[i] += a x[i]
+	static void axpy_scalar(float a, float const* x, float* y, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+			y[i] += a * x[i];
+	}
+
+	// out[i%d] += p[i]
+	static void sum_scalar(float const* p, size_t n, int d, float* out)
+	{
+		for (size_t i = 0; i < n; ++i)
+			out[i%d] += p[i];
+	}
+
+	static float dot_scalar(float const* a, float const* b, size_t n)
+	{
+		float s = 0.0f;
+		for (size_t i = 0; i < n; ++i)
+			s += a[i] * b[i];
+		return s;
+	}
+
+	// p_min[i%d] = min(p_min[i%d], p[i]), and similarly for p_max
+	static void min_max_scalar(float const* p, size_t n, int d, float* p_min, float* p_max)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			p_min[i%d] = std::min(p_min[i%d], p[i]);
+			p_max[i%d] = std::max(p_max[i%d], p[i]);
+		}
+	}
+
+	// Kernels on elements of dimension D (n elements)
+	template <int D> static float dot_element(float const* a, float const* b)
+	{
+		float s = a[0]*b[0];
+		for (int c = 1; c < D; ++c)
+			s += a[c]*b[c];
+		return s;
+	}
+	template <int D> static void dot_elements_scalar(float const* a, float const* b, float* out, size_t n)
+	{
+		for (size_t k = 0; k < n; ++k)
+			out[k] = dot_element<D>(a+D*k, b+D*k);
+	}
+	template <int D> static void norm_elements_scalar(float const* v, float* out, size_t n)
+	{
+		for (size_t k = 0; k < n; ++k)
+			out[k] = std::sqrt(dot_element<D>(v+D*k, v+D*k));
+	}
+	template <int D> static void normalize_elements_scalar(float* v, size_t n)
+	{
+		for (size_t k = 0; k < n; ++k) {
+			float* e = v + D*k;
+			float const norm = std::sqrt(dot_element<D>(e, e));
+			float const inv_norm = norm > normalize_epsilon ? 1.0f/norm : 1.0f;
+			for (int c = 0; c < D; ++c)
+				e[c] *= inv_norm;
+		}
+	}
+
+
+#ifdef VCL_KERNELS_SSE
+	// ********************************************** //
+	//  SSE kernels (4 floats)
+	// ********************************************** //
+
+	static void axpy_sse(float a, float const* x, float* y, size_t n)
+	{
+		__m128 const va = _mm_set1_ps(a);
+		size_t i = 0;
+		for (; i+4 <= n; i += 4)
+			_mm_storeu_ps(y+i, _mm_add_ps(_mm_loadu_ps(y+i), _mm_mul_ps(va, _mm_loadu_ps(x+i))));
+		axpy_scalar(a, x+i, y+i, n-i);
+	}
+
+	// Blocks of 12 floats (a multiple of d=1,3,4): the float j of the block is a coordinate j%d
+	static void sum_sse(float const* p, size_t n, int d, float* out)
+	{
+		__m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps(), s2 = _mm_setzero_ps();
+		size_t i = 0;
+		for (; i+12 <= n; i += 12) {
+			s0 = _mm_add_ps(s0, _mm_loadu_ps(p+i));
+			s1 = _mm_add_ps(s1, _mm_loadu_ps(p+i+4));
+			s2 = _mm_add_ps(s2, _mm_loadu_ps(p+i+8));
+		}
+		float block[12];
+		_mm_storeu_ps(block, s0); _mm_storeu_ps(block+4, s1); _mm_storeu_ps(block+8, s2);
+		sum_scalar(block, 12, d, out);
+		sum_scalar(p+i, n-i, d, out);
+	}
+
+	static float dot_sse(float const* a, float const* b, size_t n)
+	{
+		__m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps(), s2 = _mm_setzero_ps();
+		size_t i = 0;
+		for (; i+12 <= n; i += 12) {
+			s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i)));
+			s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(a+i+4), _mm_loadu_ps(b+i+4)));
+			s2 = _mm_add_ps(s2, _mm_mul_ps(_mm_loadu_ps(a+i+8), _mm_loadu_ps(b+i+8)));
+		}
+		float block[4];
+		_mm_storeu_ps(block, _mm_add_ps(_mm_add_ps(s0, s1), s2));
+		return (block[0] + block[1]) + (block[2] + block[3]) + dot_scalar(a+i, b+i, n-i);
+	}
+
+	static void min_max_sse(float const* p, size_t n, int d, float* p_min, float* p_max)
+	{
+		float const inf = std::numeric_limits<float>::infinity();
+		__m128 m0 = _mm_set1_ps(inf), m1 = _mm_set1_ps(inf), m2 = _mm_set1_ps(inf);
+		__m128 M0 = _mm_set1_ps(-inf), M1 = _mm_set1_ps(-inf), M2 = _mm_set1_ps(-inf);
+		size_t i = 0;
+		for (; i+12 <= n; i += 12) {
+			__m128 const a = _mm_loadu_ps(p+i), b = _mm_loadu_ps(p+i+4), c = _mm_loadu_ps(p+i+8);
+			m0 = _mm_min_ps(m0, a); m1 = _mm_min_ps(m1, b); m2 = _mm_min_ps(m2, c);
+			M0 = _mm_max_ps(M0, a); M1 = _mm_max_ps(M1, b); M2 = _mm_max_ps(M2, c);
+		}
+		float block_min[12], block_max[12];
+		_mm_storeu_ps(block_min, m0); _mm_storeu_ps(block_min+4, m1); _mm_storeu_ps(block_min+8, m2);
+		_mm_storeu_ps(block_max, M0); _mm_storeu_ps(block_max+4, M1); _mm_storeu_ps(block_max+8, M2);
+		for (int j = 0; j < 12; ++j) {
+			p_min[j%d] = std::min(p_min[j%d], block_min[j]);
+			p_max[j%d] = std::max(p_max[j%d], block_max[j]);
+		}
+		min_max_scalar(p+i, n-i, d, p_min, p_max);
+	}
+
+	// Load 4 elements and rearrange them in one register per coordinate (c[0]=x, c[1]=y, ...)
+	template <int D> static void load_elements_sse(float const* p, __m128* c);
+	template <int D> static void store_elements_sse(float* p, __m128 const* c);
+
+	template <> inline void load_elements_sse<3>(float const* p, __m128* c)
+	{
+		// a = x0 y0 z0 x1, b = y1 z1 x2 y2, e = z2 x3 y3 z3
+		__m128 const a = _mm_loadu_ps(p), b = _mm_loadu_ps(p+4), e = _mm_loadu_ps(p+8);
+		__m128 const x01 = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3,0,3,0)); // x0 x1 x0 x1
+		__m128 const x23 = _mm_shuffle_ps(b, e, _MM_SHUFFLE(1,1,2,2)); // x2 x2 x3 x3
+		__m128 const y01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0,0,1,1)); // y0 y0 y1 y1
+		__m128 const y23 = _mm_shuffle_ps(b, e, _MM_SHUFFLE(2,2,3,3)); // y2 y2 y3 y3
+		__m128 const z01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1,1,2,2)); // z0 z0 z1 z1
+		__m128 const z23 = _mm_shuffle_ps(e, e, _MM_SHUFFLE(3,3,0,0)); // z2 z2 z3 z3
+		c[0] = _mm_shuffle_ps(x01, x23, _MM_SHUFFLE(2,0,1,0));
+		c[1] = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2,0,2,0));
+		c[2] = _mm_shuffle_ps(z01, z23, _MM_SHUFFLE(2,0,2,0));
+	}
+	template <> inline void store_elements_sse<3>(float* p, __m128 const* c)
+	{
+		__m128 const xy01 = _mm_unpacklo_ps(c[0], c[1]);                     // x0 y0 x1 y1
+		__m128 const xy23 = _mm_unpackhi_ps(c[0], c[1]);                     // x2 y2 x3 y3
+		__m128 const z0x1 = _mm_shuffle_ps(c[2], xy01, _MM_SHUFFLE(2,2,0,0)); // z0 z0 x1 x1
+		__m128 const y1z1 = _mm_shuffle_ps(xy01, c[2], _MM_SHUFFLE(1,1,3,3)); // y1 y1 z1 z1
+		__m128 const z2x3 = _mm_shuffle_ps(c[2], xy23, _MM_SHUFFLE(2,2,2,2)); // z2 z2 x3 x3
+		__m128 const y3z3 = _mm_shuffle_ps(xy23, c[2], _MM_SHUFFLE(3,3,3,3)); // y3 y3 z3 z3
+		_mm_storeu_ps(p,   _mm_shuffle_ps(xy01, z0x1, _MM_SHUFFLE(2,0,1,0)));  // x0 y0 z0 x1
+		_mm_storeu_ps(p+4, _mm_shuffle_ps(y1z1, xy23, _MM_SHUFFLE(1,0,2,0)));  // y1 z1 x2 y2
+		_mm_storeu_ps(p+8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2,0,2,0)));  // z2 x3 y3 z3
+	}
+
+	template <> inline void load_elements_sse<4>(float const* p, __m128* c)
+	{
+		c[0] = _mm_loadu_ps(p); c[1] = _mm_loadu_ps(p+4); c[2] = _mm_loadu_ps(p+8); c[3] = _mm_loadu_ps(p+12);
+		_MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+	}
+	template <> inline void store_elements_sse<4>(float* p, __m128 const* c)
+	{
+		__m128 r0 = c[0], r1 = c[1], r2 = c[2], r3 = c[3];
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_storeu_ps(p, r0); _mm_storeu_ps(p+4, r1); _mm_storeu_ps(p+8, r2); _mm_storeu_ps(p+12, r3);
+	}
+
+	template <int D> static __m128 dot_coordinates_sse(__m128 const* a, __m128 const* b)
+	{
+		__m128 s = _mm_mul_ps(a[0], b[0]);
+		for (int c = 1; c < D; ++c)
+			s = _mm_add_ps(s, _mm_mul_ps(a[c], b[c]));
+		return s;
+	}
+
+	template <int D> static void dot_elements_sse(float const* a, float const* b, float* out, size_t n)
+	{
+		size_t k = 0;
+		for (; k+4 <= n; k += 4) {
+			__m128 ca[4], cb[4];
+			load_elements_sse<D>(a+D*k, ca);
+			load_elements_sse<D>(b+D*k, cb);
+			_mm_storeu_ps(out+k, dot_coordinates_sse<D>(ca, cb));
+		}
+		dot_elements_scalar<D>(a+D*k, b+D*k, out+k, n-k);
+	}
+
+	template <int D> static void norm_elements_sse(float const* v, float* out, size_t n)
+	{
+		size_t k = 0;
+		for (; k+4 <= n; k += 4) {
+			__m128 c[4];
+			load_elements_sse<D>(v+D*k, c);
+			_mm_storeu_ps(out+k, _mm_sqrt_ps(dot_coordinates_sse<D>(c, c)));
+		}
+		norm_elements_scalar<D>(v+D*k, out+k, n-k);
+	}
+
+	template <int D> static void normalize_elements_sse(float* v, size_t n)
+	{
+		__m128 const one = _mm_set1_ps(1.0f);
+		__m128 const epsilon = _mm_set1_ps(normalize_epsilon);
+		size_t k = 0;
+		for (; k+4 <= n; k += 4) {
+			__m128 c[4];
+			load_elements_sse<D>(v+D*k, c);
+			__m128 const norm = _mm_sqrt_ps(dot_coordinates_sse<D>(c, c));
+			__m128 const valid = _mm_cmpgt_ps(norm, epsilon);
+			__m128 const inv_norm = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(one, norm)), _mm_andnot_ps(valid, one));
+			for (int i = 0; i < D; ++i)
+				c[i] = _mm_mul_ps(c[i], inv_norm);
+			store_elements_sse<D>(v+D*k, c);
+		}
+		normalize_elements_scalar<D>(v+D*k, n-k);
+	}
+#endif
+
+
+#ifdef VCL_KERNELS_AVX
+	// ********************************************** //
+	//  AVX kernels (8 floats)
+	// ********************************************** //
+
+	VCL_TARGET_AVX static void axpy_avx(float a, float const* x, float* y, size_t n)
+	{
+		__m256 const va = _mm256_set1_ps(a);
+		size_t i = 0;
+		for (; i+8 <= n; i += 8)
+			_mm256_storeu_ps(y+i, _mm256_add_ps(_mm256_loadu_ps(y+i), _mm256_mul_ps(va, _mm256_loadu_ps(x+i))));
+		axpy_scalar(a, x+i, y+i, n-i);
+	}
+
+	// Blocks of 24 floats (a multiple of d=1,3,4): the float j of the block is a coordinate j%d
+	VCL_TARGET_AVX static void sum_avx(float const* p, size_t n, int d, float* out)
+	{
+		__m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps();
+		size_t i = 0;
+		for (; i+24 <= n; i += 24) {
+			s0 = _mm256_add_ps(s0, _mm256_loadu_ps(p+i));
+			s1 = _mm256_add_ps(s1, _mm256_loadu_ps(p+i+8));
+			s2 = _mm256_add_ps(s2, _mm256_loadu_ps(p+i+16));
+		}
+		float block[24];
+		_mm256_storeu_ps(block, s0); _mm256_storeu_ps(block+8, s1); _mm256_storeu_ps(block+16, s2);
+		sum_scalar(block, 24, d, out);
+		sum_scalar(p+i, n-i, d, out);
+	}
+
+	VCL_TARGET_AVX static float dot_avx(float const* a, float const* b, size_t n)
+	{
+		__m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps();
+		size_t i = 0;
+		for (; i+24 <= n; i += 24) {
+			s0 = _mm256_add_ps(s0, _mm256_mul_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i)));
+			s1 = _mm256_add_ps(s1, _mm256_mul_ps(_mm256_loadu_ps(a+i+8), _mm256_loadu_ps(b+i+8)));
+			s2 = _mm256_add_ps(s2, _mm256_mul_ps(_mm256_loadu_ps(a+i+16), _mm256_loadu_ps(b+i+16)));
+		}
+		float block[8];
+		_mm256_storeu_ps(block, _mm256_add_ps(_mm256_add_ps(s0, s1), s2));
+		return ((block[0] + block[1]) + (block[2] + block[3])) + ((block[4] + block[5]) + (block[6] + block[7])) + dot_scalar(a+i, b+i, n-i);
+	}
+
+	VCL_TARGET_AVX static void min_max_avx(float const* p, size_t n, int d, float* p_min, float* p_max)
+	{
+		float const inf = std::numeric_limits<float>::infinity();
+		__m256 m0 = _mm256_set1_ps(inf), m1 = _mm256_set1_ps(inf), m2 = _mm256_set1_ps(inf);
+		__m256 M0 = _mm256_set1_ps(-inf), M1 = _mm256_set1_ps(-inf), M2 = _mm256_set1_ps(-inf);
+		size_t i = 0;
+		for (; i+24 <= n; i += 24) {
+			__m256 const a = _mm256_loadu_ps(p+i), b = _mm256_loadu_ps(p+i+8), c = _mm256_loadu_ps(p+i+16);
+			m0 = _mm256_min_ps(m0, a); m1 = _mm256_min_ps(m1, b); m2 = _mm256_min_ps(m2, c);
+			M0 = _mm256_max_ps(M0, a); M1 = _mm256_max_ps(M1, b); M2 = _mm256_max_ps(M2, c);
+		}
+		float block_min[24], block_max[24];
+		_mm256_storeu_ps(block_min, m0); _mm256_storeu_ps(block_min+8, m1); _mm256_storeu_ps(block_min+16, m2);
+		_mm256_storeu_ps(block_max, M0); _mm256_storeu_ps(block_max+8, M1); _mm256_storeu_ps(block_max+16, M2);
+		for (int j = 0; j < 24; ++j) {
+			p_min[j%d] = std::min(p_min[j%d], block_min[j]);
+			p_max[j%d] = std::max(p_max[j%d], block_max[j]);
+		}
+		min_max_scalar(p+i, n-i, d, p_min, p_max);
+	}
+
+	// Load 8 elements and rearrange them in one register per coordinate
+	template <int D> static void load_elements_avx(float const* p, __m256* c);
+	template <int D> static void store_elements_avx(float* p, __m256 const* c);
+
+	// vec3: two groups of 4 elements rearranged with SSE, then merged in the low and high halves
+	template <> VCL_TARGET_AVX inline void load_elements_avx<3>(float const* p, __m256* c)
+	{
+		__m128 low[4], high[4];
+		load_elements_sse<3>(p, low);
+		load_elements_sse<3>(p+12, high);
+		for (int i = 0; i < 3; ++i)
+			c[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(low[i]), high[i], 1);
+	}
+	template <> VCL_TARGET_AVX inline void store_elements_avx<3>(float* p, __m256 const* c)
+	{
+		__m128 low[4], high[4];
+		for (int i = 0; i < 3; ++i) {
+			low[i] = _mm256_castps256_ps128(c[i]);
+			high[i] = _mm256_extractf128_ps(c[i], 1);
+		}
+		store_elements_sse<3>(p, low);
+		store_elements_sse<3>(p+12, high);
+	}
+
+	// vec4: register i holds the elements i (low half) and i+4 (high half), then the 4x4 blocks are transposed in each half
+	VCL_TARGET_AVX static inline void transpose_halves_avx(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+	{
+		__m256 const t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpacklo_ps(r2, r3);
+		__m256 const t2 = _mm256_unpackhi_ps(r0, r1), t3 = _mm256_unpackhi_ps(r2, r3);
+		r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1,0,1,0));
+		r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3,2,3,2));
+		r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1,0,1,0));
+		r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3,2,3,2));
+	}
+	template <> VCL_TARGET_AVX inline void load_elements_avx<4>(float const* p, __m256* c)
+	{
+		for (int i = 0; i < 4; ++i)
+			c[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p+4*i)), _mm_loadu_ps(p+16+4*i), 1);
+		transpose_halves_avx(c[0], c[1], c[2], c[3]);
+	}
+	template <> VCL_TARGET_AVX inline void store_elements_avx<4>(float* p, __m256 const* c)
+	{
+		__m256 r[4] = { c[0], c[1], c[2], c[3] };
+		transpose_halves_avx(r[0], r[1], r[2], r[3]);
+		for (int i = 0; i < 4; ++i) {
+			_mm_storeu_ps(p+4*i, _mm256_castps256_ps128(r[i]));
+			_mm_storeu_ps(p+16+4*i, _mm256_extractf128_ps(r[i], 1));
+		}
+	}
+
+	template <int D> VCL_TARGET_AVX static __m256 dot_coordinates_avx(__m256 const* a, __m256 const* b)
+	{
+		__m256 s = _mm256_mul_ps(a[0], b[0]);
+		for (int c = 1; c < D; ++c)
+			s = _mm256_add_ps(s, _mm256_mul_ps(a[c], b[c]));
+		return s;
+	}
+
+	template <int D> VCL_TARGET_AVX static void dot_elements_avx(float const* a, float const* b, float* out, size_t n)
+	{
+		size_t k = 0;
+		for (; k+8 <= n; k += 8) {
+			__m256 ca[4], cb[4];
+			load_elements_avx<D>(a+D*k, ca);
+			load_elements_avx<D>(b+D*k, cb);
+			_mm256_storeu_ps(out+k, dot_coordinates_avx<D>(ca, cb));
+		}
+		dot_elements_scalar<D>(a+D*k, b+D*k, out+k, n-k);
+	}
+
+	template <int D> VCL_TARGET_AVX static void norm_elements_avx(float const* v, float* out, size_t n)
+	{
+		size_t k = 0;
+		for (; k+8 <= n; k += 8) {
+			__m256 c[4];
+			load_elements_avx<D>(v+D*k, c);
+			_mm256_storeu_ps(out+k, _mm256_sqrt_ps(dot_coordinates_avx<D>(c, c)));
+		}
+		norm_elements_scalar<D>(v+D*k, out+k, n-k);
+	}
+
+	template <int D> VCL_TARGET_AVX static void normalize_elements_avx(float* v, size_t n)
+	{
+		__m256 const one = _mm256_set1_ps(1.0f);
+		__m256 const epsilon = _mm256_set1_ps(normalize_epsilon);
+		size_t k = 0;
+		for (; k+8 <= n; k += 8) {
+			__m256 c[4];
+			load_elements_avx<D>(v+D*k, c);
+			__m256 const norm = _mm256_sqrt_ps(dot_coordinates_avx<D>(c, c));
+			__m256 const valid = _mm256_cmp_ps(norm, epsilon, _CMP_GT_OQ);
+			__m256 const inv_norm = _mm256_blendv_ps(one, _mm256_div_ps(one, norm), valid);
+			for (int i = 0; i < D; ++i)
+				c[i] = _mm256_mul_ps(c[i], inv_norm);
+			store_elements_avx<D>(v+D*k, c);
+		}
+		normalize_elements_scalar<D>(v+D*k, n-k);
+	}
+#endif
+
+
+	// ********************************************** //
+	//  Runtime selection of the instruction set
+	// ********************************************** //
+
+	simd_level simd_level_supported()
+	{
+#ifdef VCL_KERNELS_AVX
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 1);
+		bool const avx = (info[2] & (1<<27)) && (info[2] & (1<<28)) && ((_xgetbv(0) & 6) == 6); // OSXSAVE, AVX, and AVX registers saved by the OS
+#else
+		__builtin_cpu_init();
+		bool const avx = __builtin_cpu_supports("avx");
+#endif
+		if (avx)
+			return simd_level::avx;
+#endif
+#ifdef VCL_KERNELS_SSE
+		return simd_level::sse;
+#else
+		return simd_level::scalar;
+#endif
+	}
+
+	static simd_level& simd_level_state()
+	{
+		static simd_level level = simd_level_supported();
+		return level;
+	}
+
+	simd_level simd_level_current()
+	{
+		return simd_level_state();
+	}
+
+	void simd_level_set(simd_level level)
+	{
+		simd_level const supported = simd_level_supported();
+		simd_level_state() = int(level) < int(supported) ? level : supported;
+	}
+
+	std::string str(simd_level level)
+	{
+		switch (level) {
+		case simd_level::avx: return "avx";
+		case simd_level::sse: return "sse";
+		default: return "scalar";
+		}
+	}
+
+	static void axpy_floats(float a, float const* x, float* y, size_t n)
+	{
+		switch (simd_level_current()) {
+#ifdef VCL_KERNELS_AVX
+		case simd_level::avx: axpy_avx(a, x, y, n); return;
+#endif
+#ifdef VCL_KERNELS_SSE
+		case simd_level::sse: axpy_sse(a, x, y, n); return;
+#endif
+		default: axpy_scalar(a, x, y, n);
+		}
+	}
+
+	static void sum_floats(float const* p, size_t n, int d, float* out)
+	{
+		for (int c = 0; c < d; ++c)
+			out[c] = 0.0f;
+		switch (simd_level_current()) {
+#ifdef VCL_KERNELS_AVX
+		case simd_level::avx: sum_avx(p, n, d, out); return;
+#endif
+#ifdef VCL_KERNELS_SSE
+		case simd_level::sse: sum_sse(p, n, d, out); return;
+#endif
+		default: sum_scalar(p, n, d, out);
+		}
+	}
+
+	static float dot_floats(float const* a, float const* b, size_t n)
+	{
+		switch (simd_level_current()) {
+#ifdef VCL_KERNELS_AVX
+		case simd_level::avx: return dot_avx(a, b, n);
+#endif
+#ifdef VCL_KERNELS_SSE
+		case simd_level::sse: return dot_sse(a, b, n);
+#endif
+		default: return dot_scalar(a, b, n);
+		}
+	}
+
+	static void min_max_floats(float const* p, size_t n, int d, float* p_min, float* p_max)
+	{
+		for (int c = 0; c < d; ++c) {
+			p_min[c] = std::numeric_limits<float>::infinity();
+			p_max[c] = -std::numeric_limits<float>::infinity();
+		}
+		switch (simd_level_current()) {
+#ifdef VCL_KERNELS_AVX
+		case simd_level::avx: min_max_avx(p, n, d, p_min, p_max); return;
+#endif
+#ifdef VCL_KERNELS_SSE
+		case simd_level::sse: min_max_sse(p, n, d, p_min, p_max); return;
+#endif
+		default: min_max_scalar(p, n, d, p_min, p_max);
+		}
+	}
+
+	template <int D> static void dot_elements(float const* a, float const* b, float* out, size_t n)
+	{
+		switch (simd_level_current()) {
+#ifdef VCL_KERNELS_AVX
+		case simd_level::avx: dot_elements_avx<D>(a, b, out, n); return;
+#endif
+#ifdef VCL_KERNELS_SSE
+		case simd_level::sse: dot_elements_sse<D>(a, b, out, n); return;
+#endif
+		default: dot_elements_scalar<D>(a, b, out, n);
+		}
+	}
+
+	template <int D> static void norm_elements(float const* v, float* out, size_t n)
+	{
+		switch (simd_level_current()) {
+#ifdef VCL_KERNELS_AVX
+		case simd_level::avx: norm_elements_avx<D>(v, out, n); return;
+#endif
+#ifdef VCL_KERNELS_SSE
+		case simd_level::sse: norm_elements_sse<D>(v, out, n); return;
+#endif
+		default: norm_elements_scalar<D>(v, out, n);
+		}
+	}
+
+	template <int D> static void normalize_elements(float* v, size_t n)
+	{
+		switch (simd_level_current()) {
+#ifdef VCL_KERNELS_AVX
+		case simd_level::avx: normalize_elements_avx<D>(v, n); return;
+#endif
+#ifdef VCL_KERNELS_SSE
+		case simd_level::sse: normalize_elements_sse<D>(v, n); return;
+#endif
+		default: normalize_elements_scalar<D>(v, n);
+		}
+	}
+
+	// ********************************************** //
+	//  Entry points of the kernels (called by the functions on buffers of buffer_kernels.hpp)
+	// ********************************************** //
+
+	namespace detail
+	{
+		void kernel_axpy(float a, float const* x, float* y, size_t n_floats)
+		{
+			axpy_floats(a, x, y, n_floats);
+		}
+		float kernel_dot(float const* a, float const* b, size_t n_floats)
+		{
+			return dot_floats(a, b, n_floats);
+		}
+		void kernel_sum(float const* p, size_t n_floats, int dimension, float* out)
+		{
+			sum_floats(p, n_floats, dimension, out);
+		}
+		void kernel_min_max(float const* p, size_t n_floats, int dimension, float* p_min, float* p_max)
+		{
+			min_max_floats(p, n_floats, dimension, p_min, p_max);
+		}
+
+		void kernel_dot_elements(float const* a, float const* b, float* out, size_t n, int dimension)
+		{
+			assert_vcl(dimension==3 || dimension==4, "Elements of dimension 3 or 4 expected");
+			if (dimension==3) dot_elements<3>(a, b, out, n);
+			else dot_elements<4>(a, b, out, n);
+		}
+		void kernel_norm_elements(float const* v, float* out, size_t n, int dimension)
+		{
+			assert_vcl(dimension==3 || dimension==4, "Elements of dimension 3 or 4 expected");
+			if (dimension==3) norm_elements<3>(v, out, n);
+			else norm_elements<4>(v, out, n);
+		}
+		void kernel_normalize_elements(float* v, size_t n, int dimension)
+		{
+			assert_vcl(dimension==3 || dimension==4, "Elements of dimension 3 or 4 expected");
+			if (dimension==3) normalize_elements<3>(v, n);
+			else normalize_elements<4>(v, n);
+		}
+	}
+}
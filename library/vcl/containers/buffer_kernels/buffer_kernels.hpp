@@ -0,0 +1,200 @@
+#pragma once
+
+#include "vcl/containers/buffer/buffer.hpp"
+#include "vcl/containers/buffer_stack/buffer_stack.hpp"
+
+/* Vectorized bulk operations on buffer<float>, buffer<vec3> and buffer<vec4>
+*  - The kernels work on the raw memory of the buffers (no bound checking per element) and process 4 (SSE) or 8 (AVX) floats per instruction.
+*  - The instruction set is selected at runtime: AVX if the CPU supports it, SSE otherwise (always available on x86-64), and a scalar fallback on other platforms.
+*  - Elements of buffer<vec3> are stored as consecutive x,y,z floats: they are loaded 4 by 4 and rearranged in one register per coordinate.
+*  - The reductions (sum, dot, average) accumulate in several registers: their result can differ from a sequential sum by the rounding errors.
+*  - The functions accept buffers with any allocator (ex. buffer<vec3, aligned_allocator<vec3>>). */
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace vcl
+{
+	/** Instruction sets used by the kernels */
+	enum class simd_level { scalar, sse, avx };
+
+	/** Best instruction set supported by the CPU and the build */
+	simd_level simd_level_supported();
+	/** Instruction set currently used by the kernels (initialized to simd_level_supported()) */
+	simd_level simd_level_current();
+	/** Select the instruction set used by the kernels (clamped to simd_level_supported()) - used to compare the implementations */
+	void simd_level_set(simd_level level);
+	std::string str(simd_level level);
+
+
+	/** y[k] += a * x[k] */
+	template <typename A1, typename A2> void axpy(float a, buffer<float, A1> const& x, buffer<float, A2>& y);
+	template <typename A1, typename A2> void axpy(float a, buffer<vec3, A1> const& x, buffer<vec3, A2>& y);
+	template <typename A1, typename A2> void axpy(float a, buffer<vec4, A1> const& x, buffer<vec4, A2>& y);
+
+	/** Sum of a[k] * b[k] */
+	template <typename A1, typename A2> float dot(buffer<float, A1> const& a, buffer<float, A2> const& b);
+	/** out[k] = dot(a[k], b[k]) */
+	template <typename A1, typename A2, typename A3> void dot(buffer<vec3, A1> const& a, buffer<vec3, A2> const& b, buffer<float, A3>& out);
+	template <typename A1, typename A2, typename A3> void dot(buffer<vec4, A1> const& a, buffer<vec4, A2> const& b, buffer<float, A3>& out);
+
+	/** out[k] = norm(v[k]) */
+	template <typename A1, typename A2> void norm(buffer<vec3, A1> const& v, buffer<float, A2>& out);
+	template <typename A1, typename A2> void norm(buffer<vec4, A1> const& v, buffer<float, A2>& out);
+
+	/** v[k] = v[k] / norm(v[k]) - vectors with a norm smaller than 1e-12 are left unchanged */
+	template <typename A> void normalize(buffer<vec3, A>& v);
+	template <typename A> void normalize(buffer<vec4, A>& v);
+
+	/** Sum and average of the elements (overloads of the generic average() of buffer) */
+	template <typename A> float sum(buffer<float, A> const& v);
+	template <typename A> vec3 sum(buffer<vec3, A> const& v);
+	template <typename A> vec4 sum(buffer<vec4, A> const& v);
+	template <typename A> float average(buffer<float, A> const& v);
+	template <typename A> vec3 average(buffer<vec3, A> const& v);
+	template <typename A> vec4 average(buffer<vec4, A> const& v);
+
+	/** Minimal and maximal values (overloads of the generic min() and max() of buffer) */
+	template <typename A> float min(buffer<float, A> const& v);
+	template <typename A> float max(buffer<float, A> const& v);
+	/** Componentwise minimal and maximal coordinates of the elements */
+	template <typename A> void bounding_box(buffer<float, A> const& v, float& v_min, float& v_max);
+	template <typename A> void bounding_box(buffer<vec3, A> const& v, vec3& p_min, vec3& p_max);
+	template <typename A> void bounding_box(buffer<vec4, A> const& v, vec4& p_min, vec4& p_max);
+
+	/** Calls with expressions of buffers as inputs (ex. dot(a+b, c)) evaluate the expressions first
+	*   (sum, average, min and max of an expression are the generic functions of containers/expression) */
+	template <typename E, typename A2, typename T, typename = enable_if_expression<E>> void axpy(float a, E const& x, buffer<T, A2>& y);
+	template <typename E1, typename E2, typename = enable_if_any_expression<E1, E2>> float dot(E1 const& a, E2 const& b);
+	template <typename E1, typename E2, typename A3, typename = enable_if_any_expression<E1, E2>> void dot(E1 const& a, E2 const& b, buffer<float, A3>& out);
+	template <typename E, typename A2, typename = enable_if_expression<E>> void norm(E const& v, buffer<float, A2>& out);
+	template <typename E, typename T, typename = enable_if_expression<E>> void bounding_box(E const& v, T& p_min, T& p_max);
+
+
+	namespace detail
+	{
+		// Kernels on raw floats, implemented in buffer_kernels.cpp with the selected instruction set
+		//  Elements of dimension d (1, 3 or 4) are d consecutive floats, n_floats = d * number of elements
+		void kernel_axpy(float a, float const* x, float* y, size_t n_floats);
+		float kernel_dot(float const* a, float const* b, size_t n_floats);
+		void kernel_sum(float const* p, size_t n_floats, int dimension, float* out);
+		void kernel_min_max(float const* p, size_t n_floats, int dimension, float* p_min, float* p_max);
+		void kernel_dot_elements(float const* a, float const* b, float* out, size_t n, int dimension);
+		void kernel_norm_elements(float const* v, float* out, size_t n, int dimension);
+		void kernel_normalize_elements(float* v, size_t n, int dimension);
+	}
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+// The kernels work on the floats of the buffers: vec3 and vec4 are stored as 3 and 4 consecutive floats.
+static_assert(sizeof(vcl::vec3)==3*sizeof(float), "vec3 is expected to be stored as 3 consecutive floats");
+static_assert(sizeof(vcl::vec4)==4*sizeof(float), "vec4 is expected to be stored as 4 consecutive floats");
+
+namespace vcl
+{
+	namespace detail
+	{
+		template <typename T, typename A> float const* kernel_floats(buffer<T, A> const& v) { return reinterpret_cast<float const*>(v.data.data()); }
+		template <typename T, typename A> float* kernel_floats(buffer<T, A>& v) { return reinterpret_cast<float*>(v.data.data()); }
+
+		template <typename T, typename A1, typename A2> void kernel_axpy(float a, buffer<T, A1> const& x, buffer<T, A2>& y, int dimension)
+		{
+			assert_vcl(x.size()==y.size(), "Size do not agree: x:"+str(x.size())+", y:"+str(y.size()));
+			kernel_axpy(a, kernel_floats(x), kernel_floats(y), dimension*x.size());
+		}
+		template <typename T, typename A1, typename A2, typename A3> void kernel_dot_elements(buffer<T, A1> const& a, buffer<T, A2> const& b, buffer<float, A3>& out, int dimension)
+		{
+			assert_vcl(a.size()==b.size(), "Size do not agree: a:"+str(a.size())+", b:"+str(b.size()));
+			out.resize(a.size());
+			kernel_dot_elements(kernel_floats(a), kernel_floats(b), kernel_floats(out), a.size(), dimension);
+		}
+		template <typename T, typename A> T kernel_sum(buffer<T, A> const& v, int dimension)
+		{
+			T s;
+			kernel_sum(kernel_floats(v), dimension*v.size(), dimension, reinterpret_cast<float*>(&s));
+			return s;
+		}
+		template <typename T, typename A> void kernel_bounding_box(buffer<T, A> const& v, T& p_min, T& p_max, int dimension)
+		{
+			assert_vcl(v.size()>0, "Cannot compute the bounding box of an empty buffer");
+			kernel_min_max(kernel_floats(v), dimension*v.size(), dimension, reinterpret_cast<float*>(&p_min), reinterpret_cast<float*>(&p_max));
+		}
+	}
+
+	template <typename A1, typename A2> void axpy(float a, buffer<float, A1> const& x, buffer<float, A2>& y) { detail::kernel_axpy(a, x, y, 1); }
+	template <typename A1, typename A2> void axpy(float a, buffer<vec3, A1> const& x, buffer<vec3, A2>& y) { detail::kernel_axpy(a, x, y, 3); }
+	template <typename A1, typename A2> void axpy(float a, buffer<vec4, A1> const& x, buffer<vec4, A2>& y) { detail::kernel_axpy(a, x, y, 4); }
+
+	template <typename A1, typename A2> float dot(buffer<float, A1> const& a, buffer<float, A2> const& b)
+	{
+		assert_vcl(a.size()==b.size(), "Size do not agree: a:"+str(a.size())+", b:"+str(b.size()));
+		return detail::kernel_dot(detail::kernel_floats(a), detail::kernel_floats(b), a.size());
+	}
+	template <typename A1, typename A2, typename A3> void dot(buffer<vec3, A1> const& a, buffer<vec3, A2> const& b, buffer<float, A3>& out) { detail::kernel_dot_elements(a, b, out, 3); }
+	template <typename A1, typename A2, typename A3> void dot(buffer<vec4, A1> const& a, buffer<vec4, A2> const& b, buffer<float, A3>& out) { detail::kernel_dot_elements(a, b, out, 4); }
+
+	template <typename A1, typename A2> void norm(buffer<vec3, A1> const& v, buffer<float, A2>& out)
+	{
+		out.resize(v.size());
+		detail::kernel_norm_elements(detail::kernel_floats(v), detail::kernel_floats(out), v.size(), 3);
+	}
+	template <typename A1, typename A2> void norm(buffer<vec4, A1> const& v, buffer<float, A2>& out)
+	{
+		out.resize(v.size());
+		detail::kernel_norm_elements(detail::kernel_floats(v), detail::kernel_floats(out), v.size(), 4);
+	}
+
+	template <typename A> void normalize(buffer<vec3, A>& v) { detail::kernel_normalize_elements(detail::kernel_floats(v), v.size(), 3); }
+	template <typename A> void normalize(buffer<vec4, A>& v) { detail::kernel_normalize_elements(detail::kernel_floats(v), v.size(), 4); }
+
+	template <typename A> float sum(buffer<float, A> const& v) { return detail::kernel_sum(v, 1); }
+	template <typename A> vec3 sum(buffer<vec3, A> const& v) { return detail::kernel_sum(v, 3); }
+	template <typename A> vec4 sum(buffer<vec4, A> const& v) { return detail::kernel_sum(v, 4); }
+
+	template <typename A> float average(buffer<float, A> const& v)
+	{
+		assert_vcl(v.size()>0, "Cannot compute average on empty buffer");
+		return sum(v) / float(v.size());
+	}
+	template <typename A> vec3 average(buffer<vec3, A> const& v)
+	{
+		assert_vcl(v.size()>0, "Cannot compute average on empty buffer");
+		return sum(v) / float(v.size());
+	}
+	template <typename A> vec4 average(buffer<vec4, A> const& v)
+	{
+		assert_vcl(v.size()>0, "Cannot compute average on empty buffer");
+		return sum(v) / float(v.size());
+	}
+
+	template <typename A> void bounding_box(buffer<float, A> const& v, float& v_min, float& v_max) { detail::kernel_bounding_box(v, v_min, v_max, 1); }
+	template <typename A> void bounding_box(buffer<vec3, A> const& v, vec3& p_min, vec3& p_max) { detail::kernel_bounding_box(v, p_min, p_max, 3); }
+	template <typename A> void bounding_box(buffer<vec4, A> const& v, vec4& p_min, vec4& p_max) { detail::kernel_bounding_box(v, p_min, p_max, 4); }
+
+	template <typename A> float min(buffer<float, A> const& v)
+	{
+		assert_vcl(v.size()>0, "Cannot get min on empty buffer");
+		float v_min, v_max;
+		bounding_box(v, v_min, v_max);
+		return v_min;
+	}
+	template <typename A> float max(buffer<float, A> const& v)
+	{
+		assert_vcl(v.size()>0, "Cannot get max on empty buffer");
+		float v_min, v_max;
+		bounding_box(v, v_min, v_max);
+		return v_max;
+	}
+
+	template <typename E, typename A2, typename T, typename> void axpy(float a, E const& x, buffer<T, A2>& y) { axpy(a, x.eval(), y); }
+	template <typename E1, typename E2, typename> float dot(E1 const& a, E2 const& b) { return dot(detail::expression_evaluate(a), detail::expression_evaluate(b)); }
+	template <typename E1, typename E2, typename A3, typename> void dot(E1 const& a, E2 const& b, buffer<float, A3>& out) { dot(detail::expression_evaluate(a), detail::expression_evaluate(b), out); }
+	template <typename E, typename A2, typename> void norm(E const& v, buffer<float, A2>& out) { norm(v.eval(), out); }
+	template <typename E, typename T, typename> void bounding_box(E const& v, T& p_min, T& p_max) { bounding_box(v.eval(), p_min, p_max); }
+}
@@ -0,0 +1,88 @@
+#include "benchmark_buffer_kernels.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/base/test/benchmark_timing.hpp"
+
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void benchmark_buffer_kernels()
+	{
+		size_t const N = 4000000;
+		int const N_repeat = 10;
+
+		buffer<float> f(N), g(N), out(N);
+		buffer<vec3> p(N), q(N);
+		for (size_t k = 0; k < N; ++k) {
+			f[k] = float(k%17); g[k] = float(k%5);
+			p[k] = { float(k%7)+1, float(k%3), 1 }; q[k] = { 0, 1, float(k%3) };
+		}
+		float checksum = 0.0f;
+
+		std::cout << "Bulk operations on buffers of " << N << " elements (ms), loop with vcl operators vs kernels scalar / sse / avx:" << std::endl;
+
+		// Reference: loops on the elements using the operators of vec3 and the bound-checked accessors of buffer
+		double const t_axpy_loop = timing([&]() { for (size_t k = 0; k < N; ++k) q[k] += 0.01f*p[k]; }, N_repeat);
+		double const t_dot_loop = timing([&]() { for (size_t k = 0; k < N; ++k) out[k] = dot(p[k], q[k]); }, N_repeat);
+		double const t_normalize_loop = timing([&]() { for (size_t k = 0; k < N; ++k) p[k] = normalize(p[k]); }, N_repeat);
+		double const t_sum_loop = timing([&]() { vec3 s; for (size_t k = 0; k < N; ++k) s += p[k]; checksum += s.x; }, N_repeat);
+		double const t_box_loop = timing([&]() {
+			vec3 p_min = p[0], p_max = p[0];
+			for (size_t k = 0; k < N; ++k) for (int c = 0; c < 3; ++c) {
+				p_min[c] = std::min(p_min[c], p[k][c]);
+				p_max[c] = std::max(p_max[c], p[k][c]);
+			}
+			checksum += p_min.x + p_max.y; }, N_repeat);
+
+		std::cout << "  axpy vec3       : " << t_axpy_loop;
+		for (int level = 0; level <= int(simd_level_supported()); ++level) {
+			simd_level_set(simd_level(level));
+			std::cout << (level==0 ? " vs " : " / ") << timing([&]() { axpy(0.01f, p, q); }, N_repeat);
+		}
+		std::cout << std::endl;
+
+		std::cout << "  dot vec3        : " << t_dot_loop;
+		for (int level = 0; level <= int(simd_level_supported()); ++level) {
+			simd_level_set(simd_level(level));
+			std::cout << (level==0 ? " vs " : " / ") << timing([&]() { dot(p, q, out); }, N_repeat);
+		}
+		std::cout << std::endl;
+
+		std::cout << "  normalize vec3  : " << t_normalize_loop;
+		for (int level = 0; level <= int(simd_level_supported()); ++level) {
+			simd_level_set(simd_level(level));
+			std::cout << (level==0 ? " vs " : " / ") << timing([&]() { normalize(p); }, N_repeat);
+		}
+		std::cout << std::endl;
+
+		std::cout << "  sum vec3        : " << t_sum_loop;
+		for (int level = 0; level <= int(simd_level_supported()); ++level) {
+			simd_level_set(simd_level(level));
+			std::cout << (level==0 ? " vs " : " / ") << timing([&]() { checksum += sum(p).x; }, N_repeat);
+		}
+		std::cout << std::endl;
+
+		std::cout << "  bounding box    : " << t_box_loop;
+		for (int level = 0; level <= int(simd_level_supported()); ++level) {
+			simd_level_set(simd_level(level));
+			std::cout << (level==0 ? " vs " : " / ") << timing([&]() { vec3 p_min, p_max; bounding_box(p, p_min, p_max); checksum += p_min.x + p_max.y; }, N_repeat);
+		}
+		std::cout << std::endl;
+
+		std::cout << "  dot float       : ";
+		for (int level = 0; level <= int(simd_level_supported()); ++level) {
+			simd_level_set(simd_level(level));
+			std::cout << (level==0 ? "" : " / ") << timing([&]() { checksum += dot(f, g); }, N_repeat);
+		}
+		std::cout << std::endl;
+		simd_level_set(simd_level_supported());
+
+		// Keeps the results from being optimized out
+		std::cout << "  (checksum " << checksum + out[N/2] + q[N/3].z << ")" << std::endl;
+	}
+}
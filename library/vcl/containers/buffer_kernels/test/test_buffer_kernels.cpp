@@ -0,0 +1,183 @@
+#include "test_buffer_kernels.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+
+#include <cmath>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	static bool is_close(double a, double b, double tolerance = 1e-5)
+	{
+		return std::abs(a-b) <= tolerance*(1.0+std::abs(b));
+	}
+	static bool is_close(vec3 const& a, vec3 const& b)
+	{
+		return is_close(a.x, b.x) && is_close(a.y, b.y) && is_close(a.z, b.z);
+	}
+	static bool is_close(vec4 const& a, vec4 const& b)
+	{
+		return is_close(a.x, b.x) && is_close(a.y, b.y) && is_close(a.z, b.z) && is_close(a.w, b.w);
+	}
+
+	// Deterministic values in [-1,1]
+	static float value(size_t k, int c)
+	{
+		return float(std::sin(0.37*double(k) + 1.3*double(c) + 0.1));
+	}
+
+	static void test_kernels_size(size_t N)
+	{
+		buffer<float> f(N), g(N);
+		buffer<vec3> p(N), q(N);
+		buffer<vec4> u(N), w(N);
+		for (size_t k = 0; k < N; ++k) {
+			f[k] = value(k, 0); g[k] = value(k, 1);
+			p[k] = { value(k,2), value(k,3), value(k,4) }; q[k] = { value(k,5), value(k,6), value(k,7) };
+			u[k] = { value(k,8), value(k,9), value(k,10), value(k,11) }; w[k] = { value(k,12), value(k,13), value(k,14), value(k,15) };
+		}
+		// A null vector is left unchanged by normalize
+		p[N/2] = { 0,0,0 };
+		u[N/2] = { 0,0,0,0 };
+
+		// axpy
+		{
+			buffer<float> y = g;
+			axpy(0.5f, f, y);
+			buffer<vec3> r = q;
+			axpy(0.5f, p, r);
+			buffer<vec4> s = w;
+			axpy(0.5f, u, s);
+			for (size_t k = 0; k < N; ++k) {
+				assert_vcl_no_msg(is_close(y[k], g[k]+0.5f*f[k]));
+				assert_vcl_no_msg(is_close(r[k], q[k]+0.5f*p[k]));
+				assert_vcl_no_msg(is_close(s[k], w[k]+0.5f*u[k]));
+			}
+		}
+
+		// dot, norm
+		{
+			double dot_fg = 0.0;
+			for (size_t k = 0; k < N; ++k)
+				dot_fg += double(f[k])*double(g[k]);
+			assert_vcl_no_msg(is_close(dot(f, g), dot_fg, 1e-5*double(N)));
+
+			buffer<float> d3, d4, n3, n4;
+			dot(p, q, d3);
+			dot(u, w, d4);
+			norm(p, n3);
+			norm(u, n4);
+			assert_vcl_no_msg(d3.size()==N && d4.size()==N && n3.size()==N && n4.size()==N);
+			for (size_t k = 0; k < N; ++k) {
+				assert_vcl_no_msg(is_close(d3[k], dot(p[k], q[k])));
+				assert_vcl_no_msg(is_close(d4[k], dot(u[k], w[k])));
+				assert_vcl_no_msg(is_close(n3[k], norm(p[k])));
+				assert_vcl_no_msg(is_close(n4[k], norm(u[k])));
+			}
+		}
+
+		// normalize
+		{
+			buffer<vec3> r = p;
+			buffer<vec4> s = u;
+			normalize(r);
+			normalize(s);
+			for (size_t k = 0; k < N; ++k) {
+				if (k == N/2) {
+					assert_vcl_no_msg(is_equal(r[k], vec3(0,0,0)));
+					assert_vcl_no_msg(is_equal(s[k], vec4(0,0,0,0)));
+				}
+				else {
+					assert_vcl_no_msg(is_close(r[k], p[k]/norm(p[k])));
+					assert_vcl_no_msg(is_close(s[k], u[k]/norm(u[k])));
+				}
+			}
+		}
+
+		// sum, average, min, max, bounding box
+		{
+			double sum_f = 0.0;
+			double sum_p[3] = { 0,0,0 };
+			double sum_u[4] = { 0,0,0,0 };
+			float min_f = f[0], max_f = f[0];
+			vec3 min_p = p[0], max_p = p[0];
+			vec4 min_u = u[0], max_u = u[0];
+			for (size_t k = 0; k < N; ++k) {
+				sum_f += f[k];
+				for (int c = 0; c < 3; ++c) {
+					sum_p[c] += p[k][c];
+					min_p[c] = std::min(min_p[c], p[k][c]);
+					max_p[c] = std::max(max_p[c], p[k][c]);
+				}
+				for (int c = 0; c < 4; ++c) {
+					sum_u[c] += u[k][c];
+					min_u[c] = std::min(min_u[c], u[k][c]);
+					max_u[c] = std::max(max_u[c], u[k][c]);
+				}
+				min_f = std::min(min_f, f[k]);
+				max_f = std::max(max_f, f[k]);
+			}
+
+			double const tolerance = 1e-5*double(N);
+			assert_vcl_no_msg(is_close(sum(f), sum_f, tolerance));
+			assert_vcl_no_msg(is_close(average(f), sum_f/N, tolerance));
+			vec3 const sp = sum(p), ap = average(p);
+			vec4 const su = sum(u), au = average(u);
+			for (int c = 0; c < 3; ++c) {
+				assert_vcl_no_msg(is_close(sp[c], sum_p[c], tolerance));
+				assert_vcl_no_msg(is_close(ap[c], sum_p[c]/N, tolerance));
+			}
+			for (int c = 0; c < 4; ++c) {
+				assert_vcl_no_msg(is_close(su[c], sum_u[c], tolerance));
+				assert_vcl_no_msg(is_close(au[c], sum_u[c]/N, tolerance));
+			}
+
+			// min and max are exact
+			assert_vcl_no_msg(min(f)==min_f);
+			assert_vcl_no_msg(max(f)==max_f);
+			vec3 bb_p_min, bb_p_max;
+			vec4 bb_u_min, bb_u_max;
+			bounding_box(p, bb_p_min, bb_p_max);
+			bounding_box(u, bb_u_min, bb_u_max);
+			assert_vcl_no_msg(is_equal(bb_p_min, min_p) && is_equal(bb_p_max, max_p));
+			assert_vcl_no_msg(is_equal(bb_u_min, min_u) && is_equal(bb_u_max, max_u));
+		}
+	}
+
+	void test_buffer_kernels()
+	{
+		simd_level const initial_level = simd_level_current();
+		assert_vcl_no_msg(initial_level==simd_level_supported());
+
+		// Every instruction set available on this CPU gives the same results as the reference
+		for (int level = int(simd_level::scalar); level <= int(simd_level_supported()); ++level)
+		{
+			simd_level_set(simd_level(level));
+			assert_vcl_no_msg(simd_level_current()==simd_level(level));
+
+			// Sizes below, equal to, and between the block sizes of the vectorized loops
+			for (size_t N : { 1, 2, 3, 4, 5, 7, 8, 9, 13, 24, 37, 1000 })
+				test_kernels_size(N);
+
+			// Empty buffers
+			buffer<float> empty_f;
+			buffer<vec3> empty_p, out_p;
+			buffer<float> out;
+			assert_vcl_no_msg(sum(empty_f)==0.0f);
+			assert_vcl_no_msg(is_equal(sum(empty_p), vec3(0,0,0)));
+			norm(empty_p, out);
+			assert_vcl_no_msg(out.size()==0);
+			normalize(empty_p);
+			axpy(1.0f, empty_p, out_p);
+		}
+
+		// The requested level is clamped to the supported one
+		simd_level_set(simd_level::avx);
+		assert_vcl_no_msg(simd_level_current()==simd_level_supported());
+
+		simd_level_set(initial_level);
+	}
+}
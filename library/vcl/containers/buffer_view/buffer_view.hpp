@@ -0,0 +1,286 @@
+#pragma once
+
+#include "vcl/base/base.hpp"
+#include "vcl/containers/bounds_check/bounds_check.hpp"
+
+#include <vector>
+#include <iostream>
+#include <type_traits>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace vcl
+{
+
+template <typename T, typename Allocator> struct buffer;
+
+/** Non-owning view on contiguous elements (pointer + number of elements)
+ *
+ * A buffer_view refers to elements stored elsewhere - a buffer, an std::vector, a memory-mapped file, a part of a larger buffer - without copying them.
+ * It is cheap to copy and is passed by value.
+ * - buffer_view<T const>: read-only access, built implicitly from a buffer<T>, an std::vector<T>, or a buffer_view<T>
+ * - buffer_view<T>: read-write access, built implicitly from a non-const buffer<T> or std::vector<T>
+ * - buffer_view<T>(pointer, size): view on raw memory (ex. a memory-mapped file)
+ * - subview(offset, size): view on the elements [offset, offset+size-1] without copy
+ *
+ * The viewed memory must remain valid - and must not be reallocated, ex. by a push_back on the buffer - while the view is used.
+ * Bound checking of operator [] and () depends on the policy Check (see containers/bounds_check):
+ *   checked unless VCL_NO_DEBUG is defined by default, never checked for the views returned by unchecked(...), always checked for checked(...).
+ **/
+template <typename T, typename Check = bounds_check_default>
+struct buffer_view
+{
+    using value_type = typename std::remove_const<T>::type;
+
+    /** Pointer to the first element */
+    T* data;
+    /** Number of elements of the view */
+    size_t count;
+
+    // Constructors
+    buffer_view();                      // Empty view
+    buffer_view(T* data, size_t count); // View on count elements starting at data (raw memory)
+
+    template <typename Allocator> buffer_view(buffer<value_type, Allocator>& arg);
+    template <typename Allocator> buffer_view(std::vector<value_type, Allocator>& arg);
+
+    // Read-only views (buffer_view<T const>) can also be built from const containers
+    template <typename Allocator, typename U = T, typename = typename std::enable_if<std::is_const<U>::value>::type>
+    buffer_view(buffer<value_type, Allocator> const& arg);
+    template <typename Allocator, typename U = T, typename = typename std::enable_if<std::is_const<U>::value>::type>
+    buffer_view(std::vector<value_type, Allocator> const& arg);
+
+    /** Conversion from a view with another checking policy, or from a read-write view to a read-only one */
+    template <typename U, typename CheckU, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    buffer_view(buffer_view<U, CheckU> const& arg);
+
+    /** Number of elements */
+    size_t size() const;
+    bool empty() const;
+
+    /** View on the elements [offset, offset+size-1] */
+    buffer_view<T, Check> subview(size_t offset, size_t size) const;
+    /** View on the elements [offset, end] */
+    buffer_view<T, Check> subview(size_t offset) const;
+
+    /** Element access
+     * Bound checking depends on the policy Check. */
+    T& operator[](size_t index) const;
+    T& operator()(size_t index) const;
+    /** Element access without bound checking */
+    T& at_unsafe(size_t index) const;
+
+    /** Iterators (allows "forall" loops) */
+    T* begin() const;
+    T* end() const;
+};
+
+/** View without bound checking on the elements of a container (for inner loops) */
+template <typename T, typename Allocator> buffer_view<T, bounds_check_none> unchecked(buffer<T, Allocator>& v);
+template <typename T, typename Allocator> buffer_view<T const, bounds_check_none> unchecked(buffer<T, Allocator> const& v);
+template <typename T, typename Allocator> buffer_view<T, bounds_check_none> unchecked(std::vector<T, Allocator>& v);
+template <typename T, typename Allocator> buffer_view<T const, bounds_check_none> unchecked(std::vector<T, Allocator> const& v);
+template <typename T, typename Check> buffer_view<T, bounds_check_none> unchecked(buffer_view<T, Check> const& v);
+
+/** View always bound checked on the elements of a container, even when VCL_NO_DEBUG is defined */
+template <typename T, typename Allocator> buffer_view<T, bounds_check_always> checked(buffer<T, Allocator>& v);
+template <typename T, typename Allocator> buffer_view<T const, bounds_check_always> checked(buffer<T, Allocator> const& v);
+template <typename T, typename Check> buffer_view<T, bounds_check_always> checked(buffer_view<T, Check> const& v);
+
+template <typename T, typename Check> std::string type_str(buffer_view<T, Check> const&);
+
+/** Display all elements of the view */
+template <typename T, typename Check> std::ostream& operator<<(std::ostream& s, buffer_view<T, Check> const& v);
+
+/** Size in bytes of the viewed elements */
+template <typename T, typename Check> size_t size_in_memory(buffer_view<T, Check> const& v);
+/** Pointer to the first viewed element */
+template <typename T, typename Check> T const* ptr(buffer_view<T, Check> const& v);
+
+/** Equality test between the viewed elements and another container */
+template <typename T, typename Check, typename Container> bool is_equal(buffer_view<T, Check> const& a, Container const& b);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace vcl
+{
+
+template <typename T, typename Check>
+buffer_view<T, Check>::buffer_view()
+    :data(nullptr), count(0)
+{}
+
+template <typename T, typename Check>
+buffer_view<T, Check>::buffer_view(T* data_arg, size_t count_arg)
+    :data(data_arg), count(count_arg)
+{}
+
+template <typename T, typename Check>
+template <typename Allocator>
+buffer_view<T, Check>::buffer_view(buffer<value_type, Allocator>& arg)
+    :data(arg.data.data()), count(arg.data.size())
+{}
+
+template <typename T, typename Check>
+template <typename Allocator>
+buffer_view<T, Check>::buffer_view(std::vector<value_type, Allocator>& arg)
+    :data(arg.data()), count(arg.size())
+{}
+
+template <typename T, typename Check>
+template <typename Allocator, typename U, typename>
+buffer_view<T, Check>::buffer_view(buffer<value_type, Allocator> const& arg)
+    :data(arg.data.data()), count(arg.data.size())
+{}
+
+template <typename T, typename Check>
+template <typename Allocator, typename U, typename>
+buffer_view<T, Check>::buffer_view(std::vector<value_type, Allocator> const& arg)
+    :data(arg.data()), count(arg.size())
+{}
+
+template <typename T, typename Check>
+template <typename U, typename CheckU, typename>
+buffer_view<T, Check>::buffer_view(buffer_view<U, CheckU> const& arg)
+    :data(arg.data), count(arg.count)
+{}
+
+template <typename T, typename Check>
+size_t buffer_view<T, Check>::size() const
+{
+    return count;
+}
+
+template <typename T, typename Check>
+bool buffer_view<T, Check>::empty() const
+{
+    return count==0;
+}
+
+template <typename T, typename Check>
+buffer_view<T, Check> buffer_view<T, Check>::subview(size_t offset, size_t size_arg) const
+{
+    assert_vcl(offset+size_arg <= count, "Subview [" + str(offset) + "," + str(offset+size_arg) + "[ outside of a view of size " + str(count));
+    return buffer_view<T, Check>(data+offset, size_arg);
+}
+
+template <typename T, typename Check>
+buffer_view<T, Check> buffer_view<T, Check>::subview(size_t offset) const
+{
+    assert_vcl(offset <= count, "Subview starting at " + str(offset) + " outside of a view of size " + str(count));
+    return buffer_view<T, Check>(data+offset, count-offset);
+}
+
+template <typename T, typename Check>
+T& buffer_view<T, Check>::operator[](size_t index) const
+{
+    if (Check::enabled && index >= count)
+        error_vcl("Index " + str(index) + " outside of a buffer_view of size " + str(count));
+    return data[index];
+}
+
+template <typename T, typename Check>
+T& buffer_view<T, Check>::operator()(size_t index) const
+{
+    return (*this)[index];
+}
+
+template <typename T, typename Check>
+T& buffer_view<T, Check>::at_unsafe(size_t index) const
+{
+    return data[index];
+}
+
+template <typename T, typename Check>
+T* buffer_view<T, Check>::begin() const
+{
+    return data;
+}
+
+template <typename T, typename Check>
+T* buffer_view<T, Check>::end() const
+{
+    return data+count;
+}
+
+template <typename T, typename Allocator> buffer_view<T, bounds_check_none> unchecked(buffer<T, Allocator>& v)
+{
+    return buffer_view<T, bounds_check_none>(v);
+}
+template <typename T, typename Allocator> buffer_view<T const, bounds_check_none> unchecked(buffer<T, Allocator> const& v)
+{
+    return buffer_view<T const, bounds_check_none>(v);
+}
+template <typename T, typename Allocator> buffer_view<T, bounds_check_none> unchecked(std::vector<T, Allocator>& v)
+{
+    return buffer_view<T, bounds_check_none>(v);
+}
+template <typename T, typename Allocator> buffer_view<T const, bounds_check_none> unchecked(std::vector<T, Allocator> const& v)
+{
+    return buffer_view<T const, bounds_check_none>(v);
+}
+template <typename T, typename Check> buffer_view<T, bounds_check_none> unchecked(buffer_view<T, Check> const& v)
+{
+    return buffer_view<T, bounds_check_none>(v);
+}
+
+template <typename T, typename Allocator> buffer_view<T, bounds_check_always> checked(buffer<T, Allocator>& v)
+{
+    return buffer_view<T, bounds_check_always>(v);
+}
+template <typename T, typename Allocator> buffer_view<T const, bounds_check_always> checked(buffer<T, Allocator> const& v)
+{
+    return buffer_view<T const, bounds_check_always>(v);
+}
+template <typename T, typename Check> buffer_view<T, bounds_check_always> checked(buffer_view<T, Check> const& v)
+{
+    return buffer_view<T, bounds_check_always>(v);
+}
+
+template <typename T, typename Check> std::string type_str(buffer_view<T, Check> const&)
+{
+    using vcl::type_str;
+    return "buffer_view<" + type_str(typename buffer_view<T, Check>::value_type()) + ">";
+}
+
+template <typename T, typename Check> std::ostream& operator<<(std::ostream& s, buffer_view<T, Check> const& v)
+{
+    std::string s_out = "";
+    for (size_t k = 0; k < v.size(); ++k) {
+        s_out += str(v.at_unsafe(k));
+        if (k < v.size()-1)
+            s_out += " ";
+    }
+    s << s_out;
+    return s;
+}
+
+template <typename T, typename Check> size_t size_in_memory(buffer_view<T, Check> const& v)
+{
+    return v.size() * sizeof(typename buffer_view<T, Check>::value_type);
+}
+
+template <typename T, typename Check> T const* ptr(buffer_view<T, Check> const& v)
+{
+    return v.data;
+}
+
+template <typename T, typename Check, typename Container> bool is_equal(buffer_view<T, Check> const& a, Container const& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t k = 0; k < a.size(); ++k)
+        if (is_equal(a.at_unsafe(k), b[k]) == false)
+            return false;
+    return true;
+}
+
+}
@@ -0,0 +1,92 @@
+#include "test_buffer_view.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	static float sum_view(buffer_view<float const> v)
+	{
+		float s = 0.0f;
+		for (float x : v)
+			s += x;
+		return s;
+	}
+
+	void test_buffer_view()
+	{
+		// Implicit conversions from buffer, std::vector and raw memory
+		{
+			buffer<float> a = { 1,2,3,4 };
+			std::vector<float> b = { 5,6 };
+			float c[3] = { 7,8,9 };
+
+			assert_vcl_no_msg(is_equal(sum_view(a), 10.0f));
+			assert_vcl_no_msg(is_equal(sum_view(b), 11.0f));
+			assert_vcl_no_msg(is_equal(sum_view(buffer_view<float const>(c, 3)), 24.0f));
+
+			buffer<float, aligned_allocator<float>> d = { 1,1 };
+			assert_vcl_no_msg(is_equal(sum_view(d), 2.0f));
+
+			buffer_view<float> va = a;
+			buffer_view<float const> vc = va;
+			assert_vcl_no_msg(vc.data==&a[0] && vc.size()==4);
+			assert_vcl_no_msg(is_equal(vc, a));
+		}
+
+		// Subviews share the memory of the viewed buffer
+		{
+			buffer<vec3> p = { {0,0,0}, {1,1,1}, {2,2,2}, {3,3,3} };
+			buffer_view<vec3> v = buffer_view<vec3>(p).subview(1, 2);
+			assert_vcl_no_msg(v.size()==2);
+			assert_vcl_no_msg(is_equal(v[0], vec3(1,1,1)));
+
+			v[1] = vec3(-2,-2,-2);
+			assert_vcl_no_msg(is_equal(p[2], vec3(-2,-2,-2)));
+
+			buffer_view<vec3> end = buffer_view<vec3>(p).subview(3);
+			assert_vcl_no_msg(end.size()==1 && is_equal(end[0], vec3(3,3,3)));
+			assert_vcl_no_msg(buffer_view<vec3>(p).subview(4).empty());
+
+			assert_vcl_no_msg(size_in_memory(v)==2*sizeof(vec3));
+			assert_vcl_no_msg(ptr(v)==&p[1]);
+		}
+
+		// grid_2D_view: element (x,y), rectangular subview and rows
+		{
+			grid_2D<float> g(4, 3);
+			for (size_t ky = 0; ky < 3; ++ky)
+				for (size_t kx = 0; kx < 4; ++kx)
+					g(kx, ky) = float(kx + 10*ky);
+
+			grid_2D_view<float const> v = g;
+			assert_vcl_no_msg(v.is_contiguous() && v.size()==12);
+			assert_vcl_no_msg(is_equal(v(2, 1), 12.0f));
+
+			grid_2D_view<float> s = grid_2D_view<float>(g).subview({ 1,1 }, { 2,2 });
+			assert_vcl_no_msg(!s.is_contiguous() && s.stride==4);
+			assert_vcl_no_msg(is_equal(s(0, 0), 11.0f));
+			assert_vcl_no_msg(is_equal(s(1, 1), 22.0f));
+			assert_vcl_no_msg(is_equal(s.row(1), buffer<float>{ 21,22 }));
+
+			s(0, 1) = -1.0f;
+			assert_vcl_no_msg(is_equal(g(1, 2), -1.0f));
+		}
+
+		// Interpolation on a subview uses coordinates relative to the view
+		{
+			grid_2D<float> g(5, 5);
+			for (size_t ky = 0; ky < 5; ++ky)
+				for (size_t kx = 0; kx < 5; ++kx)
+					g(kx, ky) = float(kx*ky);
+
+			grid_2D_view<float const> s = grid_2D_view<float const>(g).subview({ 2,1 }, { 3,3 });
+			float const a = interpolation_bilinear(s, 0.5f, 0.25f);
+			float const b = interpolation_bilinear(g, 2.5f, 1.25f);
+			assert_vcl_no_msg(is_equal(a, b));
+		}
+	}
+}
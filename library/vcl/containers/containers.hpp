@@ -10,7 +10,13 @@
 
 #include "offset_grid/offset_grid.hpp"
 #include "buffer_stack/buffer_stack.hpp"
+#include "allocator/allocator.hpp"
 #include "grid_stack/grid_stack.hpp"
 #include "buffer/buffer.hpp"
+#include "bounds_check/bounds_check.hpp"
+#include "buffer_view/buffer_view.hpp"
+#include "soa_buffer/soa_buffer.hpp"
 #include "grid/grid.hpp"
+#include "sparse_grid_3D/sparse_grid_3D.hpp"
+#include "buffer_kernels/buffer_kernels.hpp"
 
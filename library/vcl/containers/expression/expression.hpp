@@ -0,0 +1,438 @@
+#pragma once
+
+#include "vcl/base/base.hpp"
+
+#include <type_traits>
+#include <iostream>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+/** Lazy expression templates for the arithmetic of buffer, grid_2D and grid_3D
+ *
+ * The operators + - * / between containers (and with scalar values) do not compute their result immediately:
+ * they return a lightweight expression storing references to their operands.
+ * The whole expression is evaluated element by element in a single loop when it is assigned to a container.
+ *   buffer<vec3> p = a + 0.5f*b - c;  // One allocation for p and one pass over the memory
+ *   p = p + dt*v;                      // No allocation (p already has the correct size)
+ *
+ * An expression converts implicitly to its container type (the containers have a constructor and an assignment operator from expressions),
+ *  and can be evaluated explicitly with expression.eval().
+ * The functions of the library taking containers (average, min, max, sum, dot, str, ...) also accept expressions and evaluate them first.
+ *  A user function template deducing its parameter from buffer<T,A> const& does not accept an expression: call it with (a+b).eval().
+ * Warning: expressions store references to their operands. Do not store them in "auto" variables
+ *  when an operand is a temporary container, or after resizing one of the operands - use the container type instead.
+ **/
+
+namespace vcl
+{
+
+template <typename T, typename Allocator> struct buffer;
+template <typename T, typename Allocator, typename Layout> struct grid_2D;
+template <typename T, typename Allocator, typename Layout> struct grid_3D;
+struct layout_row_major;
+
+/** Tag inherited by all expression types */
+struct container_expression_tag {};
+
+/** is_container_expression<E>::value is true if E is an expression (and not a container) */
+template <typename E> struct is_container_expression : std::is_base_of<container_expression_tag, E> {};
+
+/** Operand of an expression: a reference to a container, a scalar value, or a sub-expression
+ *  expression_operand<X>::value is false for any other type (used to enable the operators). */
+template <typename X, typename Enable = void> struct expression_operand { static constexpr bool value = false; };
+
+/** is_same_container_kind<C1,C2>::value is true if C1 and C2 are the same container with the same elements, possibly with different allocators
+ *  (ex. buffer<float> and buffer<float, aligned_allocator<float>>). The grids must have the default row-major layout. */
+template <typename C1, typename C2> struct is_same_container_kind : std::false_type {};
+template <typename T, typename A1, typename A2> struct is_same_container_kind<buffer<T,A1>, buffer<T,A2>> : std::true_type {};
+template <typename T, typename A1, typename A2> struct is_same_container_kind<grid_2D<T,A1,layout_row_major>, grid_2D<T,A2,layout_row_major>> : std::true_type {};
+template <typename T, typename A1, typename A2> struct is_same_container_kind<grid_3D<T,A1,layout_row_major>, grid_3D<T,A2,layout_row_major>> : std::true_type {};
+
+/** Helper: enabled if E is an expression evaluating to the container C (or to the same container with another allocator) */
+template <typename E, typename C>
+using enable_if_expression_of = typename std::enable_if<is_container_expression<E>::value && is_same_container_kind<typename E::container_type, C>::value>::type;
+/** Helper: enabled if E is an expression */
+template <typename E>
+using enable_if_expression = typename std::enable_if<is_container_expression<E>::value>::type;
+/** Helper: enabled if at least one of the arguments is an expression (functions with several container arguments) */
+template <typename A, typename B>
+using enable_if_any_expression = typename std::enable_if<is_container_expression<A>::value || is_container_expression<B>::value>::type;
+
+
+/** Elementwise operations */
+struct expression_add      { template <typename A, typename B> static auto apply(A const& a, B const& b) { return a + b; } };
+struct expression_subtract { template <typename A, typename B> static auto apply(A const& a, B const& b) { return a - b; } };
+struct expression_multiply { template <typename A, typename B> static auto apply(A const& a, B const& b) { return a * b; } };
+struct expression_divide   { template <typename A, typename B> static auto apply(A const& a, B const& b) { return a / b; } };
+
+
+/** Leaf of the expression: reference to a container */
+template <typename C>
+struct expression_leaf
+{
+    using container_type = C;
+    using value_type = typename C::value_type;
+    static constexpr bool is_scalar = false;
+
+    C const* container;
+    value_type const* ptr;
+
+    explicit expression_leaf(C const& c);
+    value_type const& operator[](size_t k) const { return ptr[k]; }
+    C const& shape() const { return *container; }
+};
+
+/** Leaf of the expression: scalar value used for all elements */
+template <typename S>
+struct expression_scalar
+{
+    static constexpr bool is_scalar = true;
+
+    S value;
+
+    explicit expression_scalar(S const& s) : value(s) {}
+    S const& operator[](size_t) const { return value; }
+};
+
+/** Binary expression: element k is Op::apply(a[k], b[k]) */
+template <typename Op, typename A, typename B>
+struct container_expression : container_expression_tag
+{
+    using container_type = typename std::conditional<A::is_scalar, B, A>::type::container_type;
+    using value_type = typename container_type::value_type;
+    static constexpr bool is_scalar = false;
+
+    A a;
+    B b;
+
+    container_expression(A const& a, B const& b);
+
+    /** Number of elements of the result */
+    size_t size() const { return shape().size(); }
+    /** Value of the element k of the result (no bound checking) */
+    value_type operator[](size_t k) const { return value_type(Op::apply(a[k], b[k])); }
+    /** Container giving the dimension of the result */
+    container_type const& shape() const;
+
+    /** Evaluate the expression into a new container */
+    container_type eval() const { return container_type(*this); }
+};
+
+/** Unary expression: element k is -a[k] */
+template <typename A>
+struct container_expression_negate : container_expression_tag
+{
+    using container_type = typename A::container_type;
+    using value_type = typename container_type::value_type;
+    static constexpr bool is_scalar = false;
+
+    A a;
+
+    explicit container_expression_negate(A const& a) : a(a) {}
+
+    size_t size() const { return shape().size(); }
+    value_type operator[](size_t k) const { return value_type(-a[k]); }
+    container_type const& shape() const { return a.shape(); }
+
+    container_type eval() const { return container_type(*this); }
+};
+
+
+/** Math operators
+ * Enabled for any combination of containers of the same type (allocators may differ) and expressions (with the container scalar type for + -, and float for * /) */
+
+template <typename A, typename B> using expression_binary_enable = typename std::enable_if<expression_operand<A>::value && expression_operand<B>::value && is_same_container_kind<typename expression_operand<A>::container_type, typename expression_operand<B>::container_type>::value>::type;
+template <typename A> using expression_unary_enable = typename std::enable_if<expression_operand<A>::value>::type;
+template <typename A> using expression_value_type = typename expression_operand<A>::container_type::value_type;
+
+template <typename A, typename B, typename = expression_binary_enable<A,B>> auto operator+(A const& a, B const& b);
+template <typename A, typename = expression_unary_enable<A>> auto operator+(A const& a, expression_value_type<A> const& b);
+template <typename A, typename = expression_unary_enable<A>> auto operator+(expression_value_type<A> const& a, A const& b);
+
+template <typename A, typename B, typename = expression_binary_enable<A,B>> auto operator-(A const& a, B const& b);
+template <typename A, typename = expression_unary_enable<A>> auto operator-(A const& a, expression_value_type<A> const& b);
+template <typename A, typename = expression_unary_enable<A>> auto operator-(expression_value_type<A> const& a, A const& b);
+template <typename A, typename = expression_unary_enable<A>> auto operator-(A const& a);
+
+template <typename A, typename B, typename = expression_binary_enable<A,B>> auto operator*(A const& a, B const& b);
+template <typename A, typename = expression_unary_enable<A>> auto operator*(A const& a, float b);
+template <typename A, typename = expression_unary_enable<A>> auto operator*(float a, A const& b);
+
+template <typename A, typename B, typename = expression_binary_enable<A,B>> auto operator/(A const& a, B const& b);
+template <typename A, typename = expression_unary_enable<A>> auto operator/(A const& a, float b);
+template <typename A, typename = expression_unary_enable<A>> auto operator/(float a, A const& b);
+
+/** Compound assignment of an expression to a container of the same type (single loop, no temporary) */
+template <typename C, typename E, typename = enable_if_expression_of<E,C>> C& operator+=(C& a, E const& e);
+template <typename C, typename E, typename = enable_if_expression_of<E,C>> C& operator-=(C& a, E const& e);
+template <typename C, typename E, typename = enable_if_expression_of<E,C>> C& operator*=(C& a, E const& e);
+template <typename C, typename E, typename = enable_if_expression_of<E,C>> C& operator/=(C& a, E const& e);
+
+/** Generic functions on containers called on an expression evaluate it first */
+template <typename E, typename = typename std::enable_if<is_container_expression<E>::value>::type> bool is_equal(E const& a, typename E::container_type const& b);
+template <typename E, typename = typename std::enable_if<is_container_expression<E>::value>::type> bool is_equal(typename E::container_type const& a, E const& b);
+template <typename E1, typename E2, typename = typename std::enable_if<is_container_expression<E1>::value && is_container_expression<E2>::value>::type> bool is_equal(E1 const& a, E2 const& b);
+template <typename E, typename = typename std::enable_if<is_container_expression<E>::value>::type> std::string str(E const& e, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
+template <typename E, typename = typename std::enable_if<is_container_expression<E>::value>::type> std::ostream& operator<<(std::ostream& s, E const& e);
+template <typename E, typename = enable_if_expression<E>> auto average(E const& e);
+template <typename E, typename = enable_if_expression<E>> auto min(E const& e);
+template <typename E, typename = enable_if_expression<E>> auto max(E const& e);
+template <typename E, typename = enable_if_expression<E>> auto sum(E const& e);
+template <typename Op, typename A, typename B> std::string type_str(container_expression<Op,A,B> const& e);
+template <typename A> std::string type_str(container_expression_negate<A> const& e);
+template <typename E, typename = enable_if_expression<E>> size_t size_in_memory(E const& e);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace vcl
+{
+
+namespace detail
+{
+    // Raw pointer to the elements of the containers
+    template <typename T, typename A> T const* expression_data(buffer<T,A> const& c) { return c.data.data(); }
+    template <typename T, typename A> T const* expression_data(grid_2D<T,A,layout_row_major> const& c) { return c.data.data.data(); }
+    template <typename T, typename A> T const* expression_data(grid_3D<T,A,layout_row_major> const& c) { return c.data.data.data(); }
+    template <typename T, typename A> T* expression_data(buffer<T,A>& c) { return c.data.data(); }
+    template <typename T, typename A> T* expression_data(grid_2D<T,A,layout_row_major>& c) { return c.data.data.data(); }
+    template <typename T, typename A> T* expression_data(grid_3D<T,A,layout_row_major>& c) { return c.data.data.data(); }
+
+    // Check that the two operands have the same dimension
+    template <typename T, typename A1, typename A2> void expression_check_shape(buffer<T,A1> const& a, buffer<T,A2> const& b)
+    {
+        assert_vcl(a.size()==b.size(), "Size do not agree: a:"+str(a.size())+", b:"+str(b.size()));
+    }
+    template <typename T, typename A1, typename A2> void expression_check_shape(grid_2D<T,A1,layout_row_major> const& a, grid_2D<T,A2,layout_row_major> const& b)
+    {
+        assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
+    }
+    template <typename T, typename A1, typename A2> void expression_check_shape(grid_3D<T,A1,layout_row_major> const& a, grid_3D<T,A2,layout_row_major> const& b)
+    {
+        assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
+    }
+
+    // Resize the container c to the dimension of the container shape
+    template <typename T, typename A1, typename A2> void expression_resize(buffer<T,A1>& c, buffer<T,A2> const& shape) { if (c.size()!=shape.size()) c.resize(shape.size()); }
+    template <typename T, typename A1, typename A2> void expression_resize(grid_2D<T,A1,layout_row_major>& c, grid_2D<T,A2,layout_row_major> const& shape) { if (!is_equal(c.dimension,shape.dimension)) c.resize(shape.dimension); }
+    template <typename T, typename A1, typename A2> void expression_resize(grid_3D<T,A1,layout_row_major>& c, grid_3D<T,A2,layout_row_major> const& shape) { if (!is_equal(c.dimension,shape.dimension)) c.resize(shape.dimension); }
+
+    template <typename A, typename B> void expression_check_operands(A const& a, B const& b, std::false_type, std::false_type) { expression_check_shape(a.shape(), b.shape()); }
+    template <typename A, typename B, typename S1, typename S2> void expression_check_operands(A const&, B const&, S1, S2) {}
+
+    template <typename A, typename B> auto const& expression_shape(A const& a, B const&, std::false_type) { return a.shape(); }
+    template <typename A, typename B> auto const& expression_shape(A const&, B const& b, std::true_type) { return b.shape(); }
+
+    template <typename C, typename E> void expression_check_size(C const& c, E const& e)
+    {
+        expression_check_shape(c, e.shape());
+    }
+
+    // Argument of a function taking containers: expressions are evaluated, containers are used directly
+    template <typename E> typename std::enable_if<is_container_expression<E>::value, typename E::container_type>::type expression_evaluate(E const& e) { return e.eval(); }
+    template <typename C> typename std::enable_if<!is_container_expression<C>::value, C const&>::type expression_evaluate(C const& c) { return c; }
+
+    // Evaluate the expression e into the container c (resized only if its dimension differs)
+    template <typename C, typename E> void expression_assign(C& c, E const& e)
+    {
+        expression_resize(c, e.shape());
+        size_t const N = c.size();
+        auto* p = expression_data(c);
+        for (size_t k = 0; k < N; ++k)
+            p[k] = e[k];
+    }
+}
+
+template <typename C>
+struct expression_operand<C, typename std::enable_if<is_container_expression<C>::value>::type>
+{
+    static constexpr bool value = true;
+    using container_type = typename C::container_type;
+    using type = C;
+    static type wrap(C const& e) { return e; }
+};
+template <typename T, typename A>
+struct expression_operand<buffer<T,A>>
+{
+    static constexpr bool value = true;
+    using container_type = buffer<T,A>;
+    using type = expression_leaf<buffer<T,A>>;
+    static type wrap(buffer<T,A> const& c) { return type(c); }
+};
+template <typename T, typename A>
+struct expression_operand<grid_2D<T,A,layout_row_major>>
+{
+    static constexpr bool value = true;
+    using container_type = grid_2D<T,A,layout_row_major>;
+    using type = expression_leaf<grid_2D<T,A,layout_row_major>>;
+    static type wrap(grid_2D<T,A,layout_row_major> const& c) { return type(c); }
+};
+template <typename T, typename A>
+struct expression_operand<grid_3D<T,A,layout_row_major>>
+{
+    static constexpr bool value = true;
+    using container_type = grid_3D<T,A,layout_row_major>;
+    using type = expression_leaf<grid_3D<T,A,layout_row_major>>;
+    static type wrap(grid_3D<T,A,layout_row_major> const& c) { return type(c); }
+};
+
+
+template <typename C>
+expression_leaf<C>::expression_leaf(C const& c)
+    :container(&c), ptr(detail::expression_data(c))
+{}
+
+template <typename Op, typename A, typename B>
+container_expression<Op,A,B>::container_expression(A const& a_arg, B const& b_arg)
+    :a(a_arg), b(b_arg)
+{
+    detail::expression_check_operands(a, b, std::integral_constant<bool,A::is_scalar>(), std::integral_constant<bool,B::is_scalar>());
+}
+
+template <typename Op, typename A, typename B>
+typename container_expression<Op,A,B>::container_type const& container_expression<Op,A,B>::shape() const
+{
+    return detail::expression_shape(a, b, std::integral_constant<bool,A::is_scalar>());
+}
+
+
+namespace detail
+{
+    template <typename Op, typename A, typename B>
+    auto make_expression(A const& a, B const& b)
+    {
+        using operand_a = expression_operand<A>;
+        using operand_b = expression_operand<B>;
+        return container_expression<Op, typename operand_a::type, typename operand_b::type>(operand_a::wrap(a), operand_b::wrap(b));
+    }
+    template <typename Op, typename A, typename S>
+    auto make_expression_scalar(A const& a, S const& s)
+    {
+        using operand_a = expression_operand<A>;
+        return container_expression<Op, typename operand_a::type, expression_scalar<S>>(operand_a::wrap(a), expression_scalar<S>(s));
+    }
+    template <typename Op, typename S, typename B>
+    auto make_scalar_expression(S const& s, B const& b)
+    {
+        using operand_b = expression_operand<B>;
+        return container_expression<Op, expression_scalar<S>, typename operand_b::type>(expression_scalar<S>(s), operand_b::wrap(b));
+    }
+}
+
+template <typename A, typename B, typename> auto operator+(A const& a, B const& b)                       { return detail::make_expression<expression_add>(a, b); }
+template <typename A, typename> auto operator+(A const& a, expression_value_type<A> const& b)            { return detail::make_expression_scalar<expression_add>(a, b); }
+template <typename A, typename> auto operator+(expression_value_type<A> const& a, A const& b)            { return detail::make_scalar_expression<expression_add>(a, b); }
+
+template <typename A, typename B, typename> auto operator-(A const& a, B const& b)                       { return detail::make_expression<expression_subtract>(a, b); }
+template <typename A, typename> auto operator-(A const& a, expression_value_type<A> const& b)            { return detail::make_expression_scalar<expression_subtract>(a, b); }
+template <typename A, typename> auto operator-(expression_value_type<A> const& a, A const& b)            { return detail::make_scalar_expression<expression_subtract>(a, b); }
+template <typename A, typename> auto operator-(A const& a)
+{
+    using operand_a = expression_operand<A>;
+    return container_expression_negate<typename operand_a::type>(operand_a::wrap(a));
+}
+
+template <typename A, typename B, typename> auto operator*(A const& a, B const& b)                       { return detail::make_expression<expression_multiply>(a, b); }
+template <typename A, typename> auto operator*(A const& a, float b)                                      { return detail::make_expression_scalar<expression_multiply>(a, b); }
+template <typename A, typename> auto operator*(float a, A const& b)                                      { return detail::make_scalar_expression<expression_multiply>(a, b); }
+
+template <typename A, typename B, typename> auto operator/(A const& a, B const& b)                       { return detail::make_expression<expression_divide>(a, b); }
+template <typename A, typename> auto operator/(A const& a, float b)                                      { return detail::make_expression_scalar<expression_divide>(a, b); }
+template <typename A, typename> auto operator/(float a, A const& b)                                      { return detail::make_scalar_expression<expression_divide>(a, b); }
+
+
+template <typename C, typename E, typename> C& operator+=(C& a, E const& e)
+{
+    detail::expression_check_size(a, e);
+    size_t const N = a.size();
+    auto* p = detail::expression_data(a);
+    for (size_t k = 0; k < N; ++k)
+        p[k] += e[k];
+    return a;
+}
+template <typename C, typename E, typename> C& operator-=(C& a, E const& e)
+{
+    detail::expression_check_size(a, e);
+    size_t const N = a.size();
+    auto* p = detail::expression_data(a);
+    for (size_t k = 0; k < N; ++k)
+        p[k] -= e[k];
+    return a;
+}
+template <typename C, typename E, typename> C& operator*=(C& a, E const& e)
+{
+    detail::expression_check_size(a, e);
+    size_t const N = a.size();
+    auto* p = detail::expression_data(a);
+    for (size_t k = 0; k < N; ++k)
+        p[k] *= e[k];
+    return a;
+}
+template <typename C, typename E, typename> C& operator/=(C& a, E const& e)
+{
+    detail::expression_check_size(a, e);
+    size_t const N = a.size();
+    auto* p = detail::expression_data(a);
+    for (size_t k = 0; k < N; ++k)
+        p[k] /= e[k];
+    return a;
+}
+
+
+template <typename E, typename> bool is_equal(E const& a, typename E::container_type const& b)
+{
+    return is_equal(a.eval(), b);
+}
+template <typename E, typename> bool is_equal(typename E::container_type const& a, E const& b)
+{
+    return is_equal(a, b.eval());
+}
+template <typename E1, typename E2, typename> bool is_equal(E1 const& a, E2 const& b)
+{
+    return is_equal(a.eval(), b.eval());
+}
+template <typename E, typename> std::string str(E const& e, std::string const& separator, std::string const& begin, std::string const& end)
+{
+    return str(e.eval(), separator, begin, end);
+}
+template <typename E, typename> std::ostream& operator<<(std::ostream& s, E const& e)
+{
+    return s << e.eval();
+}
+template <typename E, typename> auto average(E const& e)
+{
+    return average(e.eval());
+}
+template <typename E, typename> auto min(E const& e)
+{
+    return min(e.eval());
+}
+template <typename E, typename> auto max(E const& e)
+{
+    return max(e.eval());
+}
+template <typename E, typename> auto sum(E const& e)
+{
+    return sum(e.eval());
+}
+template <typename Op, typename A, typename B> std::string type_str(container_expression<Op,A,B> const&)
+{
+    return type_str(typename container_expression<Op,A,B>::container_type());
+}
+template <typename A> std::string type_str(container_expression_negate<A> const&)
+{
+    return type_str(typename container_expression_negate<A>::container_type());
+}
+template <typename E, typename> size_t size_in_memory(E const& e)
+{
+    return size_in_memory(e.eval());
+}
+
+}
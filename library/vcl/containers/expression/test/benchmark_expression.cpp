@@ -0,0 +1,67 @@
+#include "benchmark_expression.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/base/test/benchmark_timing.hpp"
+
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Operators evaluated eagerly (one new buffer per operation) as before the expression templates
+	template <typename T> static buffer<T> eager_add(buffer<T> const& a, buffer<T> const& b)
+	{
+		buffer<T> res = a;
+		for (size_t k = 0; k < res.size(); ++k) res[k] += b[k];
+		return res;
+	}
+	template <typename T> static buffer<T> eager_subtract(buffer<T> const& a, buffer<T> const& b)
+	{
+		buffer<T> res = a;
+		for (size_t k = 0; k < res.size(); ++k) res[k] -= b[k];
+		return res;
+	}
+	template <typename T> static buffer<T> eager_multiply(float s, buffer<T> const& a)
+	{
+		buffer<T> res(a.size());
+		for (size_t k = 0; k < res.size(); ++k) res[k] = s*a[k];
+		return res;
+	}
+
+	void benchmark_expression()
+	{
+		size_t const N = 10000000;
+		int const N_repeat = 5;
+		float const dt = 0.01f;
+
+		buffer<float> a(N), b(N), c(N), d(N);
+		buffer<vec3> p(N), v(N), f(N);
+		for (size_t k = 0; k < N; ++k) {
+			a[k] = float(k%17); b[k] = float(k%5); c[k] = 1.0f;
+			p[k] = { float(k%7), 0, 1 }; v[k] = { 0, 1, float(k%3) }; f[k] = { 0, 0, -9.81f };
+		}
+
+		std::cout << "Expressions on buffers of " << N << " elements (ms), operators evaluated eagerly vs expression templates:" << std::endl;
+
+		double const t_abc_eager = timing([&]() { d = eager_subtract(eager_add(a, eager_multiply(0.5f, b)), c); }, N_repeat);
+		double const t_abc_lazy = timing([&]() { d = a + 0.5f*b - c; }, N_repeat);
+		std::cout << "  d = a + 0.5f*b - c          : " << t_abc_eager << " vs " << t_abc_lazy << std::endl;
+
+		double const t_euler_eager = timing([&]() { v = eager_add(v, eager_multiply(dt, f)); p = eager_add(p, eager_multiply(dt, v)); }, N_repeat);
+		double const t_euler_lazy = timing([&]() { v = v + dt*f; p = p + dt*v; }, N_repeat);
+		std::cout << "  v = v + dt*f; p = p + dt*v  : " << t_euler_eager << " vs " << t_euler_lazy << std::endl;
+
+		double const t_damping_eager = timing([&]() { v = eager_add(eager_multiply(0.99f, v), eager_multiply(dt, eager_subtract(f, v))); }, N_repeat);
+		double const t_damping_lazy = timing([&]() { v = 0.99f*v + dt*(f - v); }, N_repeat);
+		std::cout << "  v = 0.99f*v + dt*(f - v)    : " << t_damping_eager << " vs " << t_damping_lazy << std::endl;
+
+		double const t_compound_lazy = timing([&]() { p += dt*v; }, N_repeat);
+		std::cout << "  p += dt*v                   : " << t_compound_lazy << std::endl;
+
+		// Keeps the results from being optimized out
+		std::cout << "  (checksum " << d[N/2] + p[N/3].z + v[N/4].y << ")" << std::endl;
+	}
+}
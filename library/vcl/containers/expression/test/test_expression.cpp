@@ -0,0 +1,145 @@
+#include "test_expression.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+
+using namespace vcl;
+
+namespace vcl_test
+{
+
+	void test_expression()
+	{
+		// Fused expression on buffers
+		{
+			buffer<float> const a = { 1,2,3,4 };
+			buffer<float> const b = { 2,4,6,8 };
+			buffer<float> const c = { 1,1,1,1 };
+
+			buffer<float> d = a + 0.5f*b - c;
+			assert_vcl_no_msg(is_equal(d, { 1,3,5,7 }));
+
+			// Assignment to a buffer of the same size does not reallocate
+			float const* ptr_d = d.data.data();
+			d = a*b - (-c);
+			assert_vcl_no_msg(d.data.data()==ptr_d);
+			assert_vcl_no_msg(is_equal(d, { 3,9,19,33 }));
+
+			// Scalar on both sides, division
+			assert_vcl_no_msg(is_equal(1.0f + a, { 2,3,4,5 }));
+			assert_vcl_no_msg(is_equal(10.0f - a, { 9,8,7,6 }));
+			assert_vcl_no_msg(is_equal(b/2.0f, { 1,2,3,4 }));
+			assert_vcl_no_msg(is_equal(12.0f/a, { 12,6,4,3 }));
+			assert_vcl_no_msg(is_equal(b/a, { 2,2,2,2 }));
+			assert_vcl_no_msg(is_equal(a-b, -a));
+
+			// Resize on assignment of an expression of different size
+			buffer<float> e;
+			e = a + b;
+			assert_vcl_no_msg(is_equal(e, { 3,6,9,12 }));
+
+			// Expressions can be evaluated explicitly and converted to string
+			assert_vcl_no_msg((a+b).size()==4);
+			assert_vcl_no_msg(is_equal((a+b).eval(), e));
+			assert_vcl_no_msg(is_equal(str(a+c), str(buffer<float>{ 2,3,4,5 })));
+		}
+
+		// Aliasing: the assigned buffer is also an operand
+		{
+			buffer<float> a = { 1,2,3 };
+			buffer<float> const b = { 1,1,1 };
+			a = a + 2.0f*b;
+			assert_vcl_no_msg(is_equal(a, { 3,4,5 }));
+			a += a*b;
+			assert_vcl_no_msg(is_equal(a, { 6,8,10 }));
+			a -= 0.5f*a;
+			assert_vcl_no_msg(is_equal(a, { 3,4,5 }));
+			a *= b + b;
+			assert_vcl_no_msg(is_equal(a, { 6,8,10 }));
+			a /= b + 1.0f;
+			assert_vcl_no_msg(is_equal(a, { 3,4,5 }));
+		}
+
+		// Same element conversion as the previous eager operators for integer buffers
+		{
+			buffer<int> const a = { 1,2,3 };
+			assert_vcl_no_msg(is_equal(a*0.5f, { 0,1,1 }));
+			assert_vcl_no_msg(is_equal(a*0.5f + a, { 1,3,4 }));
+		}
+
+		// Buffer of vectors with scalar vectors
+		{
+			buffer<vec3> p = { {0,0,0}, {1,0,0} };
+			buffer<vec3> const v = { {0,1,0}, {0,0,2} };
+			float const dt = 0.5f;
+			p = p + dt*v + vec3{ 1,0,0 };
+			assert_vcl_no_msg(is_equal(p, { vec3{1,0.5f,0}, vec3{2,0,1} }));
+			p += v*2.0f;
+			assert_vcl_no_msg(is_equal(p, { vec3{1,2.5f,0}, vec3{2,0,5} }));
+			buffer<vec3> const q = vec3{ 1,1,1 } - p;
+			assert_vcl_no_msg(is_equal(q, { vec3{0,-1.5f,1}, vec3{-1,1,-4} }));
+		}
+
+		// Functions taking buffers accept expressions, as the buffers returned by the operators before
+		{
+			buffer<float> const a = { 1,2,3,4 };
+			buffer<float> const b = { 2,4,6,-8 };
+			assert_vcl_no_msg(is_equal(average(a+b), 3.5f));
+			assert_vcl_no_msg(is_equal(min(a+b), -4.0f) && is_equal(max(a+b), 9.0f));
+			assert_vcl_no_msg(is_equal(sum(a-b), 6.0f));
+			assert_vcl_no_msg(is_equal(dot(a+b, a), 26.0f) && is_equal(dot(a, 2.0f*a), 60.0f) && is_equal(dot(a+b, a+b), 142.0f));
+			float v_min = 0, v_max = 0;
+			bounding_box(a*b, v_min, v_max);
+			assert_vcl_no_msg(is_equal(v_min, -32.0f) && is_equal(v_max, 18.0f));
+			buffer<float> y = { 0,0,0,0 };
+			axpy(2.0f, a+b, y);
+			assert_vcl_no_msg(is_equal(y, { 6,12,18,-8 }));
+			assert_vcl_no_msg(type_str(a+b)==type_str(a) && size_in_memory(a+b)==size_in_memory(a));
+
+			buffer<vec3> const p = { {1,0,0}, {0,2,0} };
+			buffer<vec3> const q = { {1,1,0}, {0,0,2} };
+			assert_vcl_no_msg(is_equal(average(p+q), vec3{ 1,1.5f,1 }));
+			assert_vcl_no_msg(is_equal(sum(p-q), vec3{ 0,1,-2 }));
+			buffer<float> n;
+			norm(p+q, n);
+			assert_vcl_no_msg(is_equal(n, { std::sqrt(5.0f), std::sqrt(8.0f) }));
+			dot(p+q, p, n);
+			assert_vcl_no_msg(is_equal(n, { 2.0f, 4.0f }));
+			vec3 p_min, p_max;
+			bounding_box(p+q, p_min, p_max);
+			assert_vcl_no_msg(is_equal(p_min, vec3{ 0,1,0 }) && is_equal(p_max, vec3{ 2,2,2 }));
+
+			buffer<int> const i = { 4,-2,7 };
+			assert_vcl_no_msg(average(i+i)==6 && min(i+i)==-4 && max(i-i)==0);
+		}
+
+		// Grids keep their dimension
+		{
+			grid_2D<float> a(2, 3);
+			grid_2D<float> b(2, 3);
+			for (size_t k = 0; k < a.size(); ++k) {
+				a[k] = float(k);
+				b[k] = 1.0f;
+			}
+			grid_2D<float> c = 2.0f*a + b;
+			assert_vcl_no_msg(c.dimension.x==2 && c.dimension.y==3);
+			assert_vcl_no_msg(is_equal(c.data, { 1,3,5,7,9,11 }));
+			assert_vcl_no_msg(is_equal(c - b, 2.0f*a));
+
+			grid_2D<float> d;
+			d = a - b;
+			assert_vcl_no_msg(d.dimension.x==2 && d.dimension.y==3);
+			assert_vcl_no_msg(is_equal(d(1,2), 4.0f));
+		}
+		{
+			grid_3D<float> a(2, 2, 2);
+			a.fill(2.0f);
+			grid_3D<float> b = a*a - 1.0f;
+			assert_vcl_no_msg(b.dimension.x==2 && b.dimension.y==2 && b.dimension.z==2);
+			assert_vcl_no_msg(is_equal(b(1,1,1), 3.0f));
+			b += a/a;
+			assert_vcl_no_msg(is_equal(b(0,1,0), 4.0f));
+		}
+	}
+}
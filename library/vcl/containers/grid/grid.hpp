@@ -2,4 +2,5 @@
 
 
 #include "grid_2D/grid_2D.hpp"
+#include "grid_2D_view/grid_2D_view.hpp"
 #include "grid_3D/grid_3D.hpp"
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "../../buffer/buffer.hpp"
 #include "../../buffer_stack/buffer_stack.hpp"
 #include "vcl/containers/offset_grid/offset_grid.hpp"
+#include "../grid_layout/grid_layout.hpp"
 
 
 
@@ -18,29 +19,41 @@ namespace vcl
  *
  * The grid_2D structure provide convenient access for 2D-grid organization where an element can be queried as grid_2D(i,j).
  * Elements of grid_2D are stored contiguously in heap memory and remain fully compatible with std::vector and pointers.
+ * The Allocator of the internal buffer can be changed (ex. aligned_allocator, huge_page_allocator, see containers/allocator).
+ * The Layout of the elements in memory can be changed (ex. layout_morton, layout_tiled<8> for neighborhood-heavy accesses, see grid_layout).
+ *   The lazy expressions (a = b + c) and the grid_2D_view are only defined for the default row-major layout.
  **/
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>, typename Layout = layout_row_major>
 struct grid_2D
 {
+    using value_type = T;
+    using allocator_type = Allocator;
+    using layout_type = Layout;
+
     /** 2D dimension (Nx,Ny) of the container */
     size_t2 dimension;
     /** Internal storage as a 1D buffer */
-    buffer<T> data;
+    buffer<T, Allocator> data;
 
     /** Constructors */
     grid_2D();                              // Empty buffer - no elements
     grid_2D(size_t size);                   // Build a grid_2D of squared dimension (size,size)
     grid_2D(size_t2 const& size);           // Build a grid_2D with specified dimension
     grid_2D(size_t size_1, size_t size_2);  // Build a grid_2D with specified dimension
+    grid_2D(size_t2 const& size, Allocator const& allocator); // Build a grid_2D with specified dimension using a given allocator instance
+
+    /** Evaluation of an expression of grids (result of the operators + - * /) */
+    template <typename E, typename = enable_if_expression_of<E, grid_2D<T, Allocator, Layout>>> grid_2D(E const& e);
+    template <typename E, typename = enable_if_expression_of<E, grid_2D<T, Allocator, Layout>>> grid_2D<T, Allocator, Layout>& operator=(E const& e);
 
     /** Direct build a grid_2D from a given 1D-buffer and its 2D-dimension
-    * \note: the size of the 1D-buffer must satisfy arg.size = size_1 * size_2 */
-    static grid_2D<T> from_buffer(buffer<T> const& arg, size_t size_1, size_t size_2);
+    * \note: the size of the 1D-buffer must satisfy arg.size = size_1 * size_2, its elements are in row-major order */
+    static grid_2D<T, Allocator, Layout> from_buffer(buffer<T, Allocator> const& arg, size_t size_1, size_t size_2);
 
 
     /** Remove all elements from the grid_2D */
     void clear();
-    /** Total number of elements size = dimension[0] * dimension[1] */
+    /** Total number of elements size = dimension[0] * dimension[1] (data.size() can be larger with the padding of a layout) */
     size_t size() const;
     /** Fill all elements of the grid_2D with the same element*/
     void fill(T const& value);
@@ -77,6 +90,11 @@ struct grid_2D
     T const& operator()(size_t k1, size_t k2) const; // grid_2D(x, y)
     T & operator()(size_t k1, size_t k2);            // grid_2D(x, y)
 
+    /** Element access without bound checking, even in debug mode (see also unchecked(grid) in grid_2D_view) */
+    T const& at_unsafe(size_t index) const; // Index as an offset in the 1D structure
+    T & at_unsafe(size_t index);
+    T const& at_unsafe(size_t k1, size_t k2) const; // grid_2D(x, y)
+    T & at_unsafe(size_t k1, size_t k2);
 
     size_t index_to_offset(int k1, int k2) const;
     int2 offset_to_index(size_t offset) const;
@@ -84,58 +102,48 @@ struct grid_2D
     /** Iterators
      * 1D-type iterators on grid_2D are compatible with STL syntax
      * allows "forall" loops (for(auto& e : buffer) {...}) */
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::const_iterator end() const;
-    typename std::vector<T>::const_iterator cbegin() const;
-    typename std::vector<T>::const_iterator cend() const;
+    typename std::vector<T, Allocator>::iterator begin();
+    typename std::vector<T, Allocator>::iterator end();
+    typename std::vector<T, Allocator>::const_iterator begin() const;
+    typename std::vector<T, Allocator>::const_iterator end() const;
+    typename std::vector<T, Allocator>::const_iterator cbegin() const;
+    typename std::vector<T, Allocator>::const_iterator cend() const;
 
 
 
 };
 
 
-template <typename T> std::string type_str(grid_2D<T> const&);
+template <typename T, typename Allocator, typename Layout> std::string type_str(grid_2D<T, Allocator, Layout> const&);
 
 /** Display all elements of the buffer.*/
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_2D<T> const& v);
+template <typename T, typename Allocator, typename Layout> std::ostream& operator<<(std::ostream& s, grid_2D<T, Allocator, Layout> const& v);
 
 /** Convert all elements of the buffer to a string.
  * \param buffer: the input buffer
  * \param separator: the separator between each element
  */
-template <typename T> std::string str(grid_2D<T> const& v, std::string const& separator=" ", std::string const& begin = "", std::string const& end = "");
+template <typename T, typename Allocator, typename Layout> std::string str(grid_2D<T, Allocator, Layout> const& v, std::string const& separator=" ", std::string const& begin = "", std::string const& end = "");
 
 
 /** Equality test between grid_2D */
-template <typename T1, typename T2> bool is_equal(grid_2D<T1> const& a, grid_2D<T2> const& b);
+template <typename T1, typename A1, typename T2, typename A2, typename Layout> bool is_equal(grid_2D<T1, A1, Layout> const& a, grid_2D<T2, A2, Layout> const& b);
 
 /** Math operators
- * Common mathematical operations between buffers, and scalar or element values. */
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, grid_2D<T> const& b);
+ * Common mathematical operations between grids, and scalar or element values.
+ * The operators + - * / returning a new grid are the lazy expressions of containers/expression/expression.hpp */
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator+=(grid_2D<T, Allocator, Layout>& a, grid_2D<T, Allocator, Layout> const& b);
 
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, T const& b);
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, T const& b);
-template <typename T> grid_2D<T>  operator+(T const& a, grid_2D<T> const& b);
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator+=(grid_2D<T, Allocator, Layout>& a, T const& b);
 
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, T const& b);
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, T const& b);
-template <typename T> grid_2D<T>  operator-(T const& a, grid_2D<T> const& b);
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator-=(grid_2D<T, Allocator, Layout>& a, grid_2D<T, Allocator, Layout> const& b);
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator-=(grid_2D<T, Allocator, Layout>& a, T const& b);
 
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, float b);
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, float b);
-template <typename T> grid_2D<T>  operator*(float a, grid_2D<T> const& b);
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator*=(grid_2D<T, Allocator, Layout>& a, grid_2D<T, Allocator, Layout> const& b);
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator*=(grid_2D<T, Allocator, Layout>& a, float b);
 
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, float b);
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, grid_2D<T> const& b);
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, float b);
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator/=(grid_2D<T, Allocator, Layout>& a, grid_2D<T, Allocator, Layout> const& b);
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator/=(grid_2D<T, Allocator, Layout>& a, float b);
 
 
 
@@ -152,111 +160,132 @@ namespace vcl
 
 
 
-template <typename T>
-grid_2D<T>::grid_2D()
+template <typename T, typename Allocator, typename Layout>
+grid_2D<T, Allocator, Layout>::grid_2D()
     :dimension(size_t2{0,0}),data()
 {}
 
-template <typename T>
-grid_2D<T>::grid_2D(size_t size)
-    :dimension({size,size}),data(size*size)
+template <typename T, typename Allocator, typename Layout>
+grid_2D<T, Allocator, Layout>::grid_2D(size_t size)
+    :dimension({size,size}),data(Layout::storage_size(size_t2{size,size}))
+{}
+
+template <typename T, typename Allocator, typename Layout>
+grid_2D<T, Allocator, Layout>::grid_2D(size_t2 const& size)
+    :dimension(size),data(Layout::storage_size(size))
 {}
 
-template <typename T>
-grid_2D<T>::grid_2D(size_t2 const& size)
-    :dimension(size),data(size[0]*size[1])
+template <typename T, typename Allocator, typename Layout>
+grid_2D<T, Allocator, Layout>::grid_2D(size_t2 const& size, Allocator const& allocator)
+    :dimension(size),data(Layout::storage_size(size), allocator)
 {}
 
-template <typename T>
-grid_2D<T>::grid_2D(size_t size_1, size_t size_2)
-    :dimension({size_1,size_2}),data(size_1*size_2)
+template <typename T, typename Allocator, typename Layout>
+grid_2D<T, Allocator, Layout>::grid_2D(size_t size_1, size_t size_2)
+    :dimension({size_1,size_2}),data(Layout::storage_size(size_t2{size_1,size_2}))
 {}
 
+template <typename T, typename Allocator, typename Layout>
+template <typename E, typename>
+grid_2D<T, Allocator, Layout>::grid_2D(E const& e)
+    :dimension(e.shape().dimension),data(Layout::storage_size(e.shape().dimension))
+{
+    detail::expression_assign(*this, e);
+}
+
+template <typename T, typename Allocator, typename Layout>
+template <typename E, typename>
+grid_2D<T, Allocator, Layout>& grid_2D<T, Allocator, Layout>::operator=(E const& e)
+{
+    detail::expression_assign(*this, e);
+    return *this;
+}
 
 
-template <typename T>
-size_t grid_2D<T>::size() const
+
+template <typename T, typename Allocator, typename Layout>
+size_t grid_2D<T, Allocator, Layout>::size() const
 {
     return dimension[0]*dimension[1];
 }
 
-template <typename T>
-void grid_2D<T>::clear()
+template <typename T, typename Allocator, typename Layout>
+void grid_2D<T, Allocator, Layout>::clear()
 {
     resize(0, 0);
 }
 
-template <typename T>
-void grid_2D<T>::resize(size_t size)
+template <typename T, typename Allocator, typename Layout>
+void grid_2D<T, Allocator, Layout>::resize(size_t size)
 {
     resize(size,size);
 }
 
-template <typename T>
-void grid_2D<T>::resize(size_t2 const& size)
+template <typename T, typename Allocator, typename Layout>
+void grid_2D<T, Allocator, Layout>::resize(size_t2 const& size)
 {
     dimension = size;
-    data.resize(size[0]*size[1]);
+    data.resize(Layout::storage_size(size));
 }
 
-template <typename T>
-void grid_2D<T>::resize(size_t size_1, size_t size_2)
+template <typename T, typename Allocator, typename Layout>
+void grid_2D<T, Allocator, Layout>::resize(size_t size_1, size_t size_2)
 {
     dimension = {size_1,size_2};
     resize({size_1,size_2});
 }
 
-template <typename T>
-void grid_2D<T>::fill(T const& value)
+template <typename T, typename Allocator, typename Layout>
+void grid_2D<T, Allocator, Layout>::fill(T const& value)
 {
     data.fill(value);
 }
 
 
-template <typename T>
-T const& grid_2D<T>::operator[](int index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::operator[](int index) const
 {
     return data[index];
 }
 
-template <typename T>
-T& grid_2D<T>::operator[](int index)
+template <typename T, typename Allocator, typename Layout>
+T& grid_2D<T, Allocator, Layout>::operator[](int index)
 {
     return data[index];
 }
 
-template <typename T>
-T const& grid_2D<T>::operator()(int index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::operator()(int index) const
 {
     return data[index];
 }
 
-template <typename T>
-T& grid_2D<T>::operator()(int index)
+template <typename T, typename Allocator, typename Layout>
+T& grid_2D<T, Allocator, Layout>::operator()(int index)
 {
     return data[index];
 }
 
-template <typename T>
-T const& grid_2D<T>::operator[](size_t index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::operator[](size_t index) const
 {
     return data[index];
 }
 
-template <typename T>
-T & grid_2D<T>::operator[](size_t index)
+template <typename T, typename Allocator, typename Layout>
+T & grid_2D<T, Allocator, Layout>::operator[](size_t index)
 {
     return data[index];
 }
 
-template <typename T>
-T const& grid_2D<T>::operator()(size_t index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::operator()(size_t index) const
 {
     return data[index];
 }
 
-template <typename T>
-T & grid_2D<T>::operator()(size_t index)
+template <typename T, typename Allocator, typename Layout>
+T & grid_2D<T, Allocator, Layout>::operator()(size_t index)
 {
     return data[index];
 }
@@ -264,8 +293,8 @@ T & grid_2D<T>::operator()(size_t index)
 
 
 
-template <typename T, typename INDEX_TYPE>
-void check_index_bounds(INDEX_TYPE index1, INDEX_TYPE index2, grid_2D<T> const& data)
+template <typename T, typename Allocator, typename Layout, typename INDEX_TYPE>
+void check_index_bounds(INDEX_TYPE index1, INDEX_TYPE index2, grid_2D<T, Allocator, Layout> const& data)
 {
 #ifndef VCL_NO_DEBUG
     size_t const N1 = data.dimension.x;
@@ -306,136 +335,161 @@ void check_index_bounds(INDEX_TYPE index1, INDEX_TYPE index2, grid_2D<T> const&
 
 
 
-template <typename T>
-T const& grid_2D<T>::operator[](int2 const& index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::operator[](int2 const& index) const
 {
     check_index_bounds(index.x, index.y, *this);
-    size_t const idx = offset_grid(index.x, index.y, dimension.x);
-    return data[idx];
+    size_t const idx = Layout::offset(index.x, index.y, dimension);
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T& grid_2D<T>::operator[](int2 const& index)
+template <typename T, typename Allocator, typename Layout>
+T& grid_2D<T, Allocator, Layout>::operator[](int2 const& index)
 {
     check_index_bounds(index.x, index.y, *this);
-    size_t const idx = offset_grid(index.x, index.y, dimension.x);
+    size_t const idx = Layout::offset(index.x, index.y, dimension);
 
-    return data[idx];
+    return data.at_unsafe(idx);
 }
 
 
 
 
 
-template <typename T>
-T const& grid_2D<T>::operator[](size_t2 const& index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::operator[](size_t2 const& index) const
 {
     check_index_bounds(index.x, index.y, *this);
-    size_t const idx = offset_grid(index.x, index.y, dimension.x);
+    size_t const idx = Layout::offset(index.x, index.y, dimension);
 
-    return data[idx];
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T & grid_2D<T>::operator[](size_t2 const& index)
+template <typename T, typename Allocator, typename Layout>
+T & grid_2D<T, Allocator, Layout>::operator[](size_t2 const& index)
 {
     check_index_bounds(index.x, index.y, *this);
-    size_t const idx = offset_grid(index.x, index.y, dimension.x);
+    size_t const idx = Layout::offset(index.x, index.y, dimension);
 
-    return data[idx];
+    return data.at_unsafe(idx);
 }
 
 
 
-template <typename T>
-T const& grid_2D<T>::operator()(size_t2 const& index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::operator()(size_t2 const& index) const
 {
     check_index_bounds(index.x, index.y, *this);
-    size_t idx = offset_grid(index.x, index.y, dimension.x);
+    size_t idx = Layout::offset(index.x, index.y, dimension);
 
-    return data[idx];
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T & grid_2D<T>::operator()(size_t2 const& index)
+template <typename T, typename Allocator, typename Layout>
+T & grid_2D<T, Allocator, Layout>::operator()(size_t2 const& index)
 {
     check_index_bounds(index.x, index.y, *this);
-    size_t const idx = offset_grid(index.x, index.y, dimension.x);
+    size_t const idx = Layout::offset(index.x, index.y, dimension);
 
-    return data[idx];
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T const& grid_2D<T>::operator()(size_t k1, size_t k2) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::operator()(size_t k1, size_t k2) const
 {
     check_index_bounds(k1, k2, *this);
-    size_t const idx = offset_grid(k1, k2, dimension.x);
+    size_t const idx = Layout::offset(k1, k2, dimension);
 
-    return data[idx];
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T & grid_2D<T>::operator()(size_t k1, size_t k2)
+template <typename T, typename Allocator, typename Layout>
+T & grid_2D<T, Allocator, Layout>::operator()(size_t k1, size_t k2)
 {
     check_index_bounds(k1, k2, *this);
-    size_t const idx = offset_grid(k1, k2, dimension.x);
+    size_t const idx = Layout::offset(k1, k2, dimension);
 
-    return data[idx];
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T const& grid_2D<T>::operator()(int k1, int k2) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::operator()(int k1, int k2) const
 {
     check_index_bounds(k1, k2, *this);
-    size_t const idx = offset_grid(k1, k2, dimension.x);
+    size_t const idx = Layout::offset(k1, k2, dimension);
 
-    return data[idx];
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T& grid_2D<T>::operator()(int k1, int k2)
+template <typename T, typename Allocator, typename Layout>
+T& grid_2D<T, Allocator, Layout>::operator()(int k1, int k2)
 {
     check_index_bounds(k1, k2, *this);
-    size_t const idx = offset_grid(k1, k2, dimension.x);
+    size_t const idx = Layout::offset(k1, k2, dimension);
+
+    return data.at_unsafe(idx);
+}
+
+
 
-    return data[idx];
+
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::at_unsafe(size_t index) const
+{
+    return data.at_unsafe(index);
 }
 
+template <typename T, typename Allocator, typename Layout>
+T & grid_2D<T, Allocator, Layout>::at_unsafe(size_t index)
+{
+    return data.at_unsafe(index);
+}
+
+template <typename T, typename Allocator, typename Layout>
+T const& grid_2D<T, Allocator, Layout>::at_unsafe(size_t k1, size_t k2) const
+{
+    return data.at_unsafe(Layout::offset(k1, k2, dimension));
+}
 
+template <typename T, typename Allocator, typename Layout>
+T & grid_2D<T, Allocator, Layout>::at_unsafe(size_t k1, size_t k2)
+{
+    return data.at_unsafe(Layout::offset(k1, k2, dimension));
+}
 
 
-template <typename T>
-typename std::vector<T>::iterator grid_2D<T>::begin()
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::iterator grid_2D<T, Allocator, Layout>::begin()
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::iterator grid_2D<T>::end()
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::iterator grid_2D<T, Allocator, Layout>::end()
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::begin() const
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::const_iterator grid_2D<T, Allocator, Layout>::begin() const
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::end() const
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::const_iterator grid_2D<T, Allocator, Layout>::end() const
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::cbegin() const
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::const_iterator grid_2D<T, Allocator, Layout>::cbegin() const
 {
     return data.cbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_2D<T>::cend() const
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::const_iterator grid_2D<T, Allocator, Layout>::cend() const
 {
     return data.cend();
 }
@@ -449,165 +503,123 @@ typename std::vector<T>::const_iterator grid_2D<T>::cend() const
 
 
 
-template <typename T> std::string type_str(grid_2D<T> const&)
+template <typename T, typename Allocator, typename Layout> std::string type_str(grid_2D<T, Allocator, Layout> const&)
 {
     return "grid_2D<" + type_str(T()) + ">";
 }
 
 
-template <typename T1, typename T2> bool is_equal(grid_2D<T1> const& a, grid_2D<T2> const& b)
+template <typename T1, typename A1, typename T2, typename A2, typename Layout> bool is_equal(grid_2D<T1, A1, Layout> const& a, grid_2D<T2, A2, Layout> const& b)
 {
     if (is_equal(a.dimension, b.dimension)==false)
         return false;
-    return is_equal(a.data, b.data);
+    if (std::is_same<Layout, layout_row_major>::value)
+        return is_equal(a.data, b.data);
+
+    // The padding elements of the other layouts are not compared
+    using vcl::is_equal;
+    for (size_t ky = 0; ky < a.dimension.y; ++ky)
+        for (size_t kx = 0; kx < a.dimension.x; ++kx)
+            if (is_equal(a.at_unsafe(kx, ky), b.at_unsafe(kx, ky))==false)
+                return false;
+    return true;
 }
 
 
 
 
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_2D<T> const& v)
+template <typename T, typename Allocator, typename Layout> std::ostream& operator<<(std::ostream& s, grid_2D<T, Allocator, Layout> const& v)
 {
-    return s << v.data;
+    return s << str(v);
 }
-template <typename T> std::string str(grid_2D<T> const& v, std::string const& separator, std::string const& begin, std::string const& end)
+template <typename T, typename Allocator, typename Layout> std::string str(grid_2D<T, Allocator, Layout> const& v, std::string const& separator, std::string const& begin, std::string const& end)
 {
-    return to_string(v.data, separator, begin, end);
+    if (std::is_same<Layout, layout_row_major>::value)
+        return str(v.data, separator, begin, end);
+
+    // Elements displayed in the row-major order
+    buffer<T> values(v.size());
+    for (size_t ky = 0; ky < v.dimension.y; ++ky)
+        for (size_t kx = 0; kx < v.dimension.x; ++kx)
+            values.at_unsafe(kx + v.dimension.x*ky) = v.at_unsafe(kx, ky);
+    return str(values, separator, begin, end);
 }
 
 
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, grid_2D<T> const& b)
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator+=(grid_2D<T, Allocator, Layout>& a, grid_2D<T, Allocator, Layout> const& b)
 {
     assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data += b.data;
+    return a;
 }
-template <typename T> grid_2D<T>& operator+=(grid_2D<T>& a, T const& b)
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator+=(grid_2D<T, Allocator, Layout>& a, T const& b)
 {
     a.data += b;
+    return a;
 }
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data+b.data;
-    return res;
 
-}
-template <typename T> grid_2D<T>  operator+(grid_2D<T> const& a, T const& b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data+b;
-    return res;
-}
-template <typename T> grid_2D<T>  operator+(T const& a, grid_2D<T> const& b)
-{
-    grid_2D<T> res(b.dimension);
-    res.data = a + b.data;
-    return res;
-}
-
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, grid_2D<T> const& b)
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator-=(grid_2D<T, Allocator, Layout>& a, grid_2D<T, Allocator, Layout> const& b)
 {
     assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data -= b.data;
+    return a;
 }
-template <typename T> grid_2D<T>& operator-=(grid_2D<T>& a, T const& b)
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator-=(grid_2D<T, Allocator, Layout>& a, T const& b)
 {
     a.data -= b;
-}
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data-b.data;
-    return res;
-}
-template <typename T> grid_2D<T>  operator-(grid_2D<T> const& a, T const& b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data-b;
-    return res;
-}
-template <typename T> grid_2D<T>  operator-(T const& a, grid_2D<T> const& b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a-b.data;
-    return res;
+    return a;
 }
 
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, grid_2D<T> const& b)
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator*=(grid_2D<T, Allocator, Layout>& a, grid_2D<T, Allocator, Layout> const& b)
 {
     assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data *= b.data;
+    return a;
 }
-template <typename T> grid_2D<T>& operator*=(grid_2D<T>& a, float b)
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator*=(grid_2D<T, Allocator, Layout>& a, float b)
 {
     a.data *= b;
-}
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data*b.data;
-    return res;
-}
-template <typename T> grid_2D<T>  operator*(grid_2D<T> const& a, float b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data*b;
-    return res;
-}
-template <typename T> grid_2D<T>  operator*(float a, grid_2D<T> const& b)
-{
-    grid_2D<T> res(b.dimension);
-    res.data = a*b.data;
-    return res;
+    return a;
 }
 
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, grid_2D<T> const& b)
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator/=(grid_2D<T, Allocator, Layout>& a, grid_2D<T, Allocator, Layout> const& b)
 {
     assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data /= b.data;
+    return a;
 }
-template <typename T> grid_2D<T>& operator/=(grid_2D<T>& a, float b)
+template <typename T, typename Allocator, typename Layout> grid_2D<T, Allocator, Layout>& operator/=(grid_2D<T, Allocator, Layout>& a, float b)
 {
     a.data /= b;
+    return a;
 }
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, grid_2D<T> const& b)
-{
-    assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_2D<T> res(a.dimension);
-    res.data = a.data/b.data;
-    return res;
-}
-template <typename T> grid_2D<T>  operator/(grid_2D<T> const& a, float b)
-{
-    grid_2D<T> res(a.dimension);
-    res.data = a.data/b;
-    return res;
-}
-
-
-template <typename T>
-grid_2D<T> grid_2D<T>::from_buffer(buffer<T> const& arg, size_t size_1, size_t size_2)
+template <typename T, typename Allocator, typename Layout>
+grid_2D<T, Allocator, Layout> grid_2D<T, Allocator, Layout>::from_buffer(buffer<T, Allocator> const& arg, size_t size_1, size_t size_2)
 {
     assert_vcl(arg.size()==size_1*size_2, "Incoherent size to generate grid_2D");
 
-    grid_2D<T> b(size_1, size_2);
-    b.data = arg;
+    grid_2D<T, Allocator, Layout> b(size_1, size_2);
+    if (std::is_same<Layout, layout_row_major>::value)
+        b.data = arg;
+    else {
+        for (size_t ky = 0; ky < size_2; ++ky)
+            for (size_t kx = 0; kx < size_1; ++kx)
+                b.at_unsafe(kx, ky) = arg.at_unsafe(kx + size_1*ky);
+    }
 
     return b;
 }
 
-template <typename T>
-size_t grid_2D<T>::index_to_offset(int k1, int k2) const
+template <typename T, typename Allocator, typename Layout>
+size_t grid_2D<T, Allocator, Layout>::index_to_offset(int k1, int k2) const
 {
-    return offset_grid(k1,k2,dimension.x);
+    return Layout::offset(k1, k2, dimension);
 }
-template <typename T>
-int2 grid_2D<T>::offset_to_index(size_t offset) const
+template <typename T, typename Allocator, typename Layout>
+int2 grid_2D<T, Allocator, Layout>::offset_to_index(size_t offset) const
 {
-    auto idx = index_grid_from_offset(offset,dimension.x);
-    return {idx.first, idx.second};
+    size_t2 const idx = Layout::index(offset, dimension);
+    return {int(idx.x), int(idx.y)};
 }
 
 
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "vcl/base/base.hpp"
+#include "../../buffer_stack/buffer_stack.hpp"
+#include "../../buffer_view/buffer_view.hpp"
+#include "../../bounds_check/bounds_check.hpp"
+#include "../grid_layout/grid_layout.hpp"
+
+#include <type_traits>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace vcl
+{
+
+template <typename T, typename Allocator, typename Layout> struct grid_2D;
+
+/** Non-owning view on a 2D-grid of elements (pointer + dimension + stride between rows)
+ *
+ * The element (x,y) of the view is data[x + stride*y], as in grid_2D where stride = dimension.x.
+ * A larger stride allows to view a rectangular part of a larger grid without copy (see subview).
+ * - grid_2D_view<T const>: read-only access, built implicitly from a grid_2D<T> or a grid_2D_view<T>
+ * - grid_2D_view<T>: read-write access, built implicitly from a non-const grid_2D<T>
+ * - grid_2D_view<T>(pointer, dimension, stride): view on raw memory
+ *
+ * The views are defined on grids with the default row-major layout.
+ * The viewed memory must remain valid while the view is used.
+ * Bound checking of operator () depends on the policy Check (see containers/bounds_check), use unchecked(grid) for a view without bound checking.
+ **/
+template <typename T, typename Check = bounds_check_default>
+struct grid_2D_view
+{
+    using value_type = typename std::remove_const<T>::type;
+
+    /** Pointer to the element (0,0) */
+    T* data;
+    /** 2D dimension (Nx,Ny) of the view */
+    size_t2 dimension;
+    /** Number of elements between (x,y) and (x,y+1) - at least dimension.x */
+    size_t stride;
+
+    // Constructors
+    grid_2D_view();                                                 // Empty view
+    grid_2D_view(T* data, size_t2 const& dimension);                // Contiguous elements (stride = dimension.x)
+    grid_2D_view(T* data, size_t2 const& dimension, size_t stride); // Rows separated by stride elements
+
+    template <typename Allocator> grid_2D_view(grid_2D<value_type, Allocator, layout_row_major>& arg);
+
+    // Read-only views (grid_2D_view<T const>) can also be built from const grids
+    template <typename Allocator, typename U = T, typename = typename std::enable_if<std::is_const<U>::value>::type>
+    grid_2D_view(grid_2D<value_type, Allocator, layout_row_major> const& arg);
+
+    /** Conversion from a view with another checking policy, or from a read-write view to a read-only one */
+    template <typename U, typename CheckU, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    grid_2D_view(grid_2D_view<U, CheckU> const& arg);
+
+    /** Total number of elements size = dimension.x * dimension.y */
+    size_t size() const;
+    /** True if the rows follow each other in memory (stride == dimension.x) */
+    bool is_contiguous() const;
+
+    /** View on the rectangle of the given dimension starting at the element offset=(x,y) */
+    grid_2D_view<T, Check> subview(size_t2 const& offset, size_t2 const& dimension) const;
+    /** Row y as a 1D view of dimension.x elements */
+    buffer_view<T, Check> row(size_t y) const;
+
+    /** Element access
+     * Bound checking depends on the policy Check. */
+    T& operator()(int k1, int k2) const;
+    T& operator()(size_t k1, size_t k2) const;
+    T& operator()(int2 const& index) const;
+    T& operator()(size_t2 const& index) const;
+    /** Element access without bound checking */
+    T& at_unsafe(size_t k1, size_t k2) const;
+};
+
+/** View without bound checking on the elements of a grid (for inner loops) */
+template <typename T, typename Allocator> grid_2D_view<T, bounds_check_none> unchecked(grid_2D<T, Allocator, layout_row_major>& v);
+template <typename T, typename Allocator> grid_2D_view<T const, bounds_check_none> unchecked(grid_2D<T, Allocator, layout_row_major> const& v);
+template <typename T, typename Check> grid_2D_view<T, bounds_check_none> unchecked(grid_2D_view<T, Check> const& v);
+
+/** View always bound checked on the elements of a grid, even when VCL_NO_DEBUG is defined */
+template <typename T, typename Allocator> grid_2D_view<T, bounds_check_always> checked(grid_2D<T, Allocator, layout_row_major>& v);
+template <typename T, typename Allocator> grid_2D_view<T const, bounds_check_always> checked(grid_2D<T, Allocator, layout_row_major> const& v);
+template <typename T, typename Check> grid_2D_view<T, bounds_check_always> checked(grid_2D_view<T, Check> const& v);
+
+template <typename T, typename Check> std::string type_str(grid_2D_view<T, Check> const&);
+
+/** Display all elements of the view */
+template <typename T, typename Check> std::ostream& operator<<(std::ostream& s, grid_2D_view<T, Check> const& v);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace vcl
+{
+
+template <typename T, typename Check>
+grid_2D_view<T, Check>::grid_2D_view()
+    :data(nullptr), dimension({0,0}), stride(0)
+{}
+
+template <typename T, typename Check>
+grid_2D_view<T, Check>::grid_2D_view(T* data_arg, size_t2 const& dimension_arg)
+    :data(data_arg), dimension(dimension_arg), stride(dimension_arg.x)
+{}
+
+template <typename T, typename Check>
+grid_2D_view<T, Check>::grid_2D_view(T* data_arg, size_t2 const& dimension_arg, size_t stride_arg)
+    :data(data_arg), dimension(dimension_arg), stride(stride_arg)
+{
+    assert_vcl(stride >= dimension.x, "The stride ("+str(stride)+") must be at least the number of elements per row ("+str(dimension.x)+")");
+}
+
+template <typename T, typename Check>
+template <typename Allocator>
+grid_2D_view<T, Check>::grid_2D_view(grid_2D<value_type, Allocator, layout_row_major>& arg)
+    :data(arg.data.data.data()), dimension(arg.dimension), stride(arg.dimension.x)
+{}
+
+template <typename T, typename Check>
+template <typename Allocator, typename U, typename>
+grid_2D_view<T, Check>::grid_2D_view(grid_2D<value_type, Allocator, layout_row_major> const& arg)
+    :data(arg.data.data.data()), dimension(arg.dimension), stride(arg.dimension.x)
+{}
+
+template <typename T, typename Check>
+template <typename U, typename CheckU, typename>
+grid_2D_view<T, Check>::grid_2D_view(grid_2D_view<U, CheckU> const& arg)
+    :data(arg.data), dimension(arg.dimension), stride(arg.stride)
+{}
+
+template <typename T, typename Check>
+size_t grid_2D_view<T, Check>::size() const
+{
+    return dimension.x * dimension.y;
+}
+
+template <typename T, typename Check>
+bool grid_2D_view<T, Check>::is_contiguous() const
+{
+    return stride == dimension.x;
+}
+
+template <typename T, typename Check>
+grid_2D_view<T, Check> grid_2D_view<T, Check>::subview(size_t2 const& offset, size_t2 const& dimension_arg) const
+{
+    assert_vcl(offset.x+dimension_arg.x <= dimension.x && offset.y+dimension_arg.y <= dimension.y,
+        "Subview of dimension "+str(dimension_arg)+" at offset "+str(offset)+" outside of a grid_2D_view of dimension "+str(dimension));
+    return grid_2D_view<T, Check>(data + offset.x + stride*offset.y, dimension_arg, stride);
+}
+
+template <typename T, typename Check>
+buffer_view<T, Check> grid_2D_view<T, Check>::row(size_t y) const
+{
+    if (Check::enabled && y >= dimension.y)
+        error_vcl("Row "+str(y)+" outside of a grid_2D_view of dimension "+str(dimension));
+    return buffer_view<T, Check>(data + stride*y, dimension.x);
+}
+
+template <typename T, typename Check>
+T& grid_2D_view<T, Check>::operator()(size_t k1, size_t k2) const
+{
+    if (Check::enabled && (k1 >= dimension.x || k2 >= dimension.y))
+        error_vcl("Index ("+str(k1)+","+str(k2)+") outside of a grid_2D_view of dimension "+str(dimension));
+    return data[k1 + stride*k2];
+}
+
+template <typename T, typename Check>
+T& grid_2D_view<T, Check>::operator()(int k1, int k2) const
+{
+    if (Check::enabled && (k1 < 0 || k2 < 0))
+        error_vcl("Negative index ("+str(k1)+","+str(k2)+") in a grid_2D_view");
+    return (*this)(size_t(k1), size_t(k2));
+}
+
+template <typename T, typename Check>
+T& grid_2D_view<T, Check>::operator()(int2 const& index) const
+{
+    return (*this)(index.x, index.y);
+}
+
+template <typename T, typename Check>
+T& grid_2D_view<T, Check>::operator()(size_t2 const& index) const
+{
+    return (*this)(index.x, index.y);
+}
+
+template <typename T, typename Check>
+T& grid_2D_view<T, Check>::at_unsafe(size_t k1, size_t k2) const
+{
+    return data[k1 + stride*k2];
+}
+
+template <typename T, typename Allocator> grid_2D_view<T, bounds_check_none> unchecked(grid_2D<T, Allocator, layout_row_major>& v)
+{
+    return grid_2D_view<T, bounds_check_none>(v);
+}
+template <typename T, typename Allocator> grid_2D_view<T const, bounds_check_none> unchecked(grid_2D<T, Allocator, layout_row_major> const& v)
+{
+    return grid_2D_view<T const, bounds_check_none>(v);
+}
+template <typename T, typename Check> grid_2D_view<T, bounds_check_none> unchecked(grid_2D_view<T, Check> const& v)
+{
+    return grid_2D_view<T, bounds_check_none>(v);
+}
+
+template <typename T, typename Allocator> grid_2D_view<T, bounds_check_always> checked(grid_2D<T, Allocator, layout_row_major>& v)
+{
+    return grid_2D_view<T, bounds_check_always>(v);
+}
+template <typename T, typename Allocator> grid_2D_view<T const, bounds_check_always> checked(grid_2D<T, Allocator, layout_row_major> const& v)
+{
+    return grid_2D_view<T const, bounds_check_always>(v);
+}
+template <typename T, typename Check> grid_2D_view<T, bounds_check_always> checked(grid_2D_view<T, Check> const& v)
+{
+    return grid_2D_view<T, bounds_check_always>(v);
+}
+
+template <typename T, typename Check> std::string type_str(grid_2D_view<T, Check> const&)
+{
+    using vcl::type_str;
+    return "grid_2D_view<" + type_str(typename grid_2D_view<T, Check>::value_type()) + ">";
+}
+
+template <typename T, typename Check> std::ostream& operator<<(std::ostream& s, grid_2D_view<T, Check> const& v)
+{
+    for (size_t ky = 0; ky < v.dimension.y; ++ky) {
+        s << v.row(ky);
+        if (ky < v.dimension.y-1)
+            s << "\n";
+    }
+    return s;
+}
+
+}
@@ -4,6 +4,7 @@
 #include "../../buffer/buffer.hpp"
 #include "../../buffer_stack/buffer_stack.hpp"
 #include "vcl/containers/offset_grid/offset_grid.hpp"
+#include "../grid_layout/grid_layout.hpp"
 
 
 /* ************************************************** */
@@ -17,28 +18,40 @@ namespace vcl
 *
 * The grid_3D structure provide convenient access for 3D-grid organization where an element can be queried as grid_3D(i,j).
 * Elements of grid_3D are stored contiguously in heap memory and remain fully compatible with std::vector and pointers.
+* The Allocator of the internal buffer can be changed (ex. huge_page_allocator for very large grids, see containers/allocator).
+* The Layout of the elements in memory can be changed (ex. layout_morton, layout_tiled<4> for sweeps along z or 3D neighborhoods, see grid_layout).
+*   The lazy expressions (a = b + c) are only defined for the default row-major layout.
 **/
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>, typename Layout = layout_row_major>
 struct grid_3D
 {
+    using value_type = T;
+    using allocator_type = Allocator;
+    using layout_type = Layout;
+
     /** 3D dimension (Nx,Ny,Nz) of the container */
     size_t3 dimension;
     /** Internal storage as a 1D buffer */
-    buffer<T> data;
+    buffer<T, Allocator> data;
 
     /** Constructors */
     grid_3D();
     grid_3D(size_t size);
     grid_3D(size_t3 const& size);
     grid_3D(size_t size_1, size_t size_2, size_t size_3);
+    grid_3D(size_t3 const& size, Allocator const& allocator); // Build a grid_3D with specified dimension using a given allocator instance
+
+    /** Evaluation of an expression of grids (result of the operators + - * /) */
+    template <typename E, typename = enable_if_expression_of<E, grid_3D<T, Allocator, Layout>>> grid_3D(E const& e);
+    template <typename E, typename = enable_if_expression_of<E, grid_3D<T, Allocator, Layout>>> grid_3D<T, Allocator, Layout>& operator=(E const& e);
 
     /** Direct build a grid_3D from a given 1D-buffer and its 3D-dimension
     * \note: the size of the 3D-buffer must satisfy arg.size = size_1 * size_2 * size_3 */
-    static grid_3D<T> from_vector(buffer<T> const& arg, size_t size_1, size_t size_2, size_t size_3);
+    static grid_3D<T, Allocator, Layout> from_vector(buffer<T, Allocator> const& arg, size_t size_1, size_t size_2, size_t size_3);
 
     /** Remove all elements from the grid_2D */
     void clear();
-    /** Total number of elements size = dimension[0] * dimension[1] * dimension[2] */
+    /** Total number of elements size = dimension[0] * dimension[1] * dimension[2] (data.size() can be larger with the padding of a layout) */
     size_t size() const;
     /** Fill all elements of the grid_3D with the same element*/
     void fill(T const& value);
@@ -76,43 +89,37 @@ struct grid_3D
     T const& operator()(int k1, int k2, int k3) const;
     T& operator()(int k1, int k2, int k3);
 
-    typename std::vector<T>::iterator begin();
-    typename std::vector<T>::iterator end();
-    typename std::vector<T>::const_iterator begin() const;
-    typename std::vector<T>::const_iterator end() const;
-    typename std::vector<T>::const_iterator cbegin() const;
-    typename std::vector<T>::const_iterator cend() const;
+    /** Element access without bound checking, even in debug mode */
+    T const& at_unsafe(size_t index) const; // Index as an offset in the 1D structure
+    T & at_unsafe(size_t index);
+    T const& at_unsafe(size_t k1, size_t k2, size_t k3) const;
+    T & at_unsafe(size_t k1, size_t k2, size_t k3);
+
+    typename std::vector<T, Allocator>::iterator begin();
+    typename std::vector<T, Allocator>::iterator end();
+    typename std::vector<T, Allocator>::const_iterator begin() const;
+    typename std::vector<T, Allocator>::const_iterator end() const;
+    typename std::vector<T, Allocator>::const_iterator cbegin() const;
+    typename std::vector<T, Allocator>::const_iterator cend() const;
 };
 
-template <typename T> std::string type_str(grid_3D<T> const&);
-template <typename T1, typename T2> bool is_equal(grid_3D<T1> const& a, grid_3D<T2> const& b);
+template <typename T, typename Allocator, typename Layout> std::string type_str(grid_3D<T, Allocator, Layout> const&);
+template <typename T1, typename A1, typename T2, typename A2, typename Layout> bool is_equal(grid_3D<T1, A1, Layout> const& a, grid_3D<T2, A2, Layout> const& b);
 
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_3D<T> const& v);
-template <typename T> std::string str(grid_3D<T> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
+template <typename T, typename Allocator, typename Layout> std::ostream& operator<<(std::ostream& s, grid_3D<T, Allocator, Layout> const& v);
+template <typename T, typename Allocator, typename Layout> std::string str(grid_3D<T, Allocator, Layout> const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
 
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, T const& b);
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, T const& b);
-template <typename T> grid_3D<T>  operator+(T const& a, grid_3D<T> const& b);
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator+=(grid_3D<T, Allocator, Layout>& a, grid_3D<T, Allocator, Layout> const& b);
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator+=(grid_3D<T, Allocator, Layout>& a, T const& b);
 
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, T const& b);
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, T const& b);
-template <typename T> grid_3D<T>  operator-(T const& a, grid_3D<T> const& b);
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator-=(grid_3D<T, Allocator, Layout>& a, grid_3D<T, Allocator, Layout> const& b);
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator-=(grid_3D<T, Allocator, Layout>& a, T const& b);
 
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, float b);
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, float b);
-template <typename T> grid_3D<T>  operator*(float a, grid_3D<T> const& b);
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator*=(grid_3D<T, Allocator, Layout>& a, grid_3D<T, Allocator, Layout> const& b);
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator*=(grid_3D<T, Allocator, Layout>& a, float b);
 
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, float b);
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, grid_3D<T> const& b);
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, float b);
-template <typename T> grid_3D<T>  operator/(float a, grid_3D<T> const& b);
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator/=(grid_3D<T, Allocator, Layout>& a, grid_3D<T, Allocator, Layout> const& b);
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator/=(grid_3D<T, Allocator, Layout>& a, float b);
 
 }
 
@@ -127,54 +134,75 @@ namespace vcl
 
 
 
-template <typename T>
-grid_3D<T>::grid_3D()
+template <typename T, typename Allocator, typename Layout>
+grid_3D<T, Allocator, Layout>::grid_3D()
     :dimension(size_t3{0,0,0}),data()
 {}
 
-template <typename T>
-grid_3D<T>::grid_3D(size_t size)
-    :dimension({size,size,size}),data(size*size*size)
+template <typename T, typename Allocator, typename Layout>
+grid_3D<T, Allocator, Layout>::grid_3D(size_t size)
+    :dimension({size,size,size}),data(Layout::storage_size(size_t3{size,size,size}))
+{}
+
+template <typename T, typename Allocator, typename Layout>
+grid_3D<T, Allocator, Layout>::grid_3D(size_t3 const& size)
+    :dimension(size),data(Layout::storage_size(size))
 {}
 
-template <typename T>
-grid_3D<T>::grid_3D(size_t3 const& size)
-    :dimension(size),data(size[0]*size[1]*size[2])
+template <typename T, typename Allocator, typename Layout>
+grid_3D<T, Allocator, Layout>::grid_3D(size_t3 const& size, Allocator const& allocator)
+    :dimension(size),data(Layout::storage_size(size), allocator)
 {}
 
-template <typename T>
-grid_3D<T>::grid_3D(size_t size_1, size_t size_2, size_t size_3)
-    :dimension({size_1,size_2, size_3}),data(size_1*size_2*size_3)
+template <typename T, typename Allocator, typename Layout>
+grid_3D<T, Allocator, Layout>::grid_3D(size_t size_1, size_t size_2, size_t size_3)
+    :dimension({size_1,size_2, size_3}),data(Layout::storage_size(size_t3{size_1,size_2,size_3}))
 {}
 
-template <typename T>
-size_t grid_3D<T>::size() const
+template <typename T, typename Allocator, typename Layout>
+template <typename E, typename>
+grid_3D<T, Allocator, Layout>::grid_3D(E const& e)
+    :dimension(e.shape().dimension),data(Layout::storage_size(e.shape().dimension))
+{
+    detail::expression_assign(*this, e);
+}
+
+template <typename T, typename Allocator, typename Layout>
+template <typename E, typename>
+grid_3D<T, Allocator, Layout>& grid_3D<T, Allocator, Layout>::operator=(E const& e)
+{
+    detail::expression_assign(*this, e);
+    return *this;
+}
+
+template <typename T, typename Allocator, typename Layout>
+size_t grid_3D<T, Allocator, Layout>::size() const
 {
     return dimension[0]*dimension[1]*dimension[2];
 }
 
-template <typename T>
-void grid_3D<T>::resize(size_t size)
+template <typename T, typename Allocator, typename Layout>
+void grid_3D<T, Allocator, Layout>::resize(size_t size)
 {
     resize(size,size,size);
 }
 
-template <typename T>
-void grid_3D<T>::resize(size_t3 const& size)
+template <typename T, typename Allocator, typename Layout>
+void grid_3D<T, Allocator, Layout>::resize(size_t3 const& size)
 {
     dimension = size;
-    data.resize(size[0]*size[1]*size[2]);
+    data.resize(Layout::storage_size(size));
 }
 
-template <typename T>
-void grid_3D<T>::resize(size_t size_1, size_t size_2, size_t size_3)
+template <typename T, typename Allocator, typename Layout>
+void grid_3D<T, Allocator, Layout>::resize(size_t size_1, size_t size_2, size_t size_3)
 {
     dimension = {size_1, size_2, size_3};
     resize({size_1, size_2, size_3});
 }
 
-template <typename T>
-void grid_3D<T>::fill(T const& value)
+template <typename T, typename Allocator, typename Layout>
+void grid_3D<T, Allocator, Layout>::fill(T const& value)
 {
     data.fill(value);
 }
@@ -184,39 +212,39 @@ void grid_3D<T>::fill(T const& value)
 
 
 
-template <typename T> T const& grid_3D<T>::operator[](int index) const { return data[index]; }
-template <typename T> T& grid_3D<T>::operator[](int index) { return data[index]; }
-template <typename T> T const& grid_3D<T>::operator()(int index) const { return data[index]; }
-template <typename T> T& grid_3D<T>::operator()(int index) { return data[index]; }
+template <typename T, typename Allocator, typename Layout> T const& grid_3D<T, Allocator, Layout>::operator[](int index) const { return data[index]; }
+template <typename T, typename Allocator, typename Layout> T& grid_3D<T, Allocator, Layout>::operator[](int index) { return data[index]; }
+template <typename T, typename Allocator, typename Layout> T const& grid_3D<T, Allocator, Layout>::operator()(int index) const { return data[index]; }
+template <typename T, typename Allocator, typename Layout> T& grid_3D<T, Allocator, Layout>::operator()(int index) { return data[index]; }
 
-template <typename T>
-T const& grid_3D<T>::operator[](size_t const& index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_3D<T, Allocator, Layout>::operator[](size_t const& index) const
 {
     return data[index];
 }
 
-template <typename T>
-T & grid_3D<T>::operator[](size_t const& index)
+template <typename T, typename Allocator, typename Layout>
+T & grid_3D<T, Allocator, Layout>::operator[](size_t const& index)
 {
     return data[index];
 }
 
-template <typename T>
-T const& grid_3D<T>::operator()(size_t const& index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_3D<T, Allocator, Layout>::operator()(size_t const& index) const
 {
     return data[index];
 }
 
-template <typename T>
-T & grid_3D<T>::operator()(size_t const& index)
+template <typename T, typename Allocator, typename Layout>
+T & grid_3D<T, Allocator, Layout>::operator()(size_t const& index)
 {
     return data[index];
 }
 
 
 
-template <typename T, typename INDEX_TYPE>
-void check_index_bounds(INDEX_TYPE index1, INDEX_TYPE index2, INDEX_TYPE index3, grid_3D<T> const& data)
+template <typename T, typename Allocator, typename Layout, typename INDEX_TYPE>
+void check_index_bounds(INDEX_TYPE index1, INDEX_TYPE index2, INDEX_TYPE index3, grid_3D<T, Allocator, Layout> const& data)
 {
 #ifndef VCL_NO_DEBUG
     size_t const N1 = data.dimension.x;
@@ -258,128 +286,152 @@ void check_index_bounds(INDEX_TYPE index1, INDEX_TYPE index2, INDEX_TYPE index3,
 
 
 
-template <typename T>
-T const& grid_3D<T>::operator[](size_t3 const& index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_3D<T, Allocator, Layout>::operator[](size_t3 const& index) const
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    size_t const idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    size_t const idx = Layout::offset(index.x, index.y, index.z, dimension);
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T & grid_3D<T>::operator[](size_t3 const& index)
+template <typename T, typename Allocator, typename Layout>
+T & grid_3D<T, Allocator, Layout>::operator[](size_t3 const& index)
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    size_t const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(index.x, index.y, index.z, dimension);
+    return data.at_unsafe(idx);
 }
 
 
 
-template <typename T>
-T const& grid_3D<T>::operator()(size_t3 const& index) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_3D<T, Allocator, Layout>::operator()(size_t3 const& index) const
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    size_t const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(index.x, index.y, index.z, dimension);
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T & grid_3D<T>::operator()(size_t3 const& index)
+template <typename T, typename Allocator, typename Layout>
+T & grid_3D<T, Allocator, Layout>::operator()(size_t3 const& index)
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    size_t const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(index.x, index.y, index.z, dimension);
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T const& grid_3D<T>::operator()(size_t k1, size_t k2, size_t k3) const
+template <typename T, typename Allocator, typename Layout>
+T const& grid_3D<T, Allocator, Layout>::operator()(size_t k1, size_t k2, size_t k3) const
 {
     check_index_bounds(k1, k2, k3, *this);
-    size_t const  idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(k1, k2, k3, dimension);
+    return data.at_unsafe(idx);
 }
 
-template <typename T>
-T & grid_3D<T>::operator()(size_t k1, size_t k2, size_t k3)
+template <typename T, typename Allocator, typename Layout>
+T & grid_3D<T, Allocator, Layout>::operator()(size_t k1, size_t k2, size_t k3)
 {
     check_index_bounds(k1, k2, k3, *this);
-    size_t const  idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(k1, k2, k3, dimension);
+    return data.at_unsafe(idx);
 }
 
 
-template <typename T> T const& grid_3D<T>::operator[](int3 const& index) const
+template <typename T, typename Allocator, typename Layout> T const& grid_3D<T, Allocator, Layout>::operator[](int3 const& index) const
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    size_t const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(index.x, index.y, index.z, dimension);
+    return data.at_unsafe(idx);
 }
-template <typename T> T& grid_3D<T>::operator[](int3 const& index)
+template <typename T, typename Allocator, typename Layout> T& grid_3D<T, Allocator, Layout>::operator[](int3 const& index)
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    size_t const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(index.x, index.y, index.z, dimension);
+    return data.at_unsafe(idx);
 }
-template <typename T> T const& grid_3D<T>::operator()(int3 const& index) const
+template <typename T, typename Allocator, typename Layout> T const& grid_3D<T, Allocator, Layout>::operator()(int3 const& index) const
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    size_t const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(index.x, index.y, index.z, dimension);
+    return data.at_unsafe(idx);
 }
-template <typename T> T& grid_3D<T>::operator()(int3 const& index)
+template <typename T, typename Allocator, typename Layout> T& grid_3D<T, Allocator, Layout>::operator()(int3 const& index)
 {
     check_index_bounds(index.x, index.y, index.z, *this);
-    size_t const  idx = offset_grid(index.x, index.y, index.z, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(index.x, index.y, index.z, dimension);
+    return data.at_unsafe(idx);
 }
-template <typename T> T const& grid_3D<T>::operator()(int k1, int k2, int k3) const
+template <typename T, typename Allocator, typename Layout> T const& grid_3D<T, Allocator, Layout>::operator()(int k1, int k2, int k3) const
 {
     check_index_bounds(k1, k2, k3, *this);
-    size_t const  idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(k1, k2, k3, dimension);
+    return data.at_unsafe(idx);
 }
-template <typename T> T& grid_3D<T>::operator()(int k1, int k2, int k3)
+template <typename T, typename Allocator, typename Layout> T& grid_3D<T, Allocator, Layout>::operator()(int k1, int k2, int k3)
 {
     check_index_bounds(k1, k2, k3, *this);
-    size_t const  idx = offset_grid(k1, k2, k3, dimension.x, dimension.y);
-    return data[idx];
+    size_t const  idx = Layout::offset(k1, k2, k3, dimension);
+    return data.at_unsafe(idx);
+}
+
+template <typename T, typename Allocator, typename Layout>
+T const& grid_3D<T, Allocator, Layout>::at_unsafe(size_t index) const
+{
+    return data.at_unsafe(index);
+}
+
+template <typename T, typename Allocator, typename Layout>
+T & grid_3D<T, Allocator, Layout>::at_unsafe(size_t index)
+{
+    return data.at_unsafe(index);
+}
+
+template <typename T, typename Allocator, typename Layout>
+T const& grid_3D<T, Allocator, Layout>::at_unsafe(size_t k1, size_t k2, size_t k3) const
+{
+    return data.at_unsafe(Layout::offset(k1, k2, k3, dimension));
+}
+
+template <typename T, typename Allocator, typename Layout>
+T & grid_3D<T, Allocator, Layout>::at_unsafe(size_t k1, size_t k2, size_t k3)
+{
+    return data.at_unsafe(Layout::offset(k1, k2, k3, dimension));
 }
 
 
 
-template <typename T>
-typename std::vector<T>::iterator grid_3D<T>::begin()
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::iterator grid_3D<T, Allocator, Layout>::begin()
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::iterator grid_3D<T>::end()
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::iterator grid_3D<T, Allocator, Layout>::end()
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::begin() const
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::const_iterator grid_3D<T, Allocator, Layout>::begin() const
 {
     return data.begin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::end() const
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::const_iterator grid_3D<T, Allocator, Layout>::end() const
 {
     return data.end();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::cbegin() const
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::const_iterator grid_3D<T, Allocator, Layout>::cbegin() const
 {
     return data.cbegin();
 }
 
-template <typename T>
-typename std::vector<T>::const_iterator grid_3D<T>::cend() const
+template <typename T, typename Allocator, typename Layout>
+typename std::vector<T, Allocator>::const_iterator grid_3D<T, Allocator, Layout>::cend() const
 {
     return data.cend();
 }
@@ -394,146 +446,93 @@ typename std::vector<T>::const_iterator grid_3D<T>::cend() const
 
 
 
-template <typename T> std::string type_str(grid_3D<T> const&)
+template <typename T, typename Allocator, typename Layout> std::string type_str(grid_3D<T, Allocator, Layout> const&)
 {
     return "grid_3D<" + type_str(T()) + ">";
 }
 
-template <typename T1, typename T2> bool is_equal(grid_3D<T1> const& a, grid_3D<T2> const& b)
+template <typename T1, typename A1, typename T2, typename A2, typename Layout> bool is_equal(grid_3D<T1, A1, Layout> const& a, grid_3D<T2, A2, Layout> const& b)
 {
     if (is_equal(a.dimension, b.dimension) == false)
         return false;
-    return is_equal(a.data, b.data);
+    if (std::is_same<Layout, layout_row_major>::value)
+        return is_equal(a.data, b.data);
+
+    // The padding elements of the other layouts are not compared
+    using vcl::is_equal;
+    for (size_t kz = 0; kz < a.dimension.z; ++kz)
+        for (size_t ky = 0; ky < a.dimension.y; ++ky)
+            for (size_t kx = 0; kx < a.dimension.x; ++kx)
+                if (is_equal(a.at_unsafe(kx, ky, kz), b.at_unsafe(kx, ky, kz)) == false)
+                    return false;
+    return true;
 }
 
 
-template <typename T> std::ostream& operator<<(std::ostream& s, grid_3D<T> const& v)
+template <typename T, typename Allocator, typename Layout> std::ostream& operator<<(std::ostream& s, grid_3D<T, Allocator, Layout> const& v)
 {
-    return s << v.data;
+    return s << str(v);
 }
-template <typename T> std::string str(grid_3D<T> const& v, std::string const& separator, std::string const& begin, std::string const& end)
+template <typename T, typename Allocator, typename Layout> std::string str(grid_3D<T, Allocator, Layout> const& v, std::string const& separator, std::string const& begin, std::string const& end)
 {
-    return str(v.data, separator, begin, end);
+    if (std::is_same<Layout, layout_row_major>::value)
+        return str(v.data, separator, begin, end);
+
+    // Elements displayed in the row-major order
+    buffer<T> values(v.size());
+    for (size_t kz = 0; kz < v.dimension.z; ++kz)
+        for (size_t ky = 0; ky < v.dimension.y; ++ky)
+            for (size_t kx = 0; kx < v.dimension.x; ++kx)
+                values.at_unsafe(kx + v.dimension.x*(ky + v.dimension.y*kz)) = v.at_unsafe(kx, ky, kz);
+    return str(values, separator, begin, end);
 }
 
 
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, grid_3D<T> const& b)
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator+=(grid_3D<T, Allocator, Layout>& a, grid_3D<T, Allocator, Layout> const& b)
 {
     assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data += b.data;
+    return a;
 }
-template <typename T> grid_3D<T>& operator+=(grid_3D<T>& a, T const& b)
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator+=(grid_3D<T, Allocator, Layout>& a, T const& b)
 {
     a.data += b;
-}
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data+b.data;
-    return res;
-
-}
-template <typename T> grid_3D<T>  operator+(grid_3D<T> const& a, T const& b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data+b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator+(T const& a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(b.dimension);
-    res.data = a + b.data;
-    return res;
+    return a;
 }
 
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, grid_3D<T> const& b)
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator-=(grid_3D<T, Allocator, Layout>& a, grid_3D<T, Allocator, Layout> const& b)
 {
     assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data -= b.data;
+    return a;
 }
-template <typename T> grid_3D<T>& operator-=(grid_3D<T>& a, T const& b)
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator-=(grid_3D<T, Allocator, Layout>& a, T const& b)
 {
     a.data -= b;
-}
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data-b.data;
-    return res;
-}
-template <typename T> grid_3D<T>  operator-(grid_3D<T> const& a, T const& b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data-b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator-(T const& a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a-b.data;
-    return res;
+    return a;
 }
 
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, grid_3D<T> const& b)
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator*=(grid_3D<T, Allocator, Layout>& a, grid_3D<T, Allocator, Layout> const& b)
 {
     assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data *= b.data;
+    return a;
 }
-template <typename T> grid_3D<T>& operator*=(grid_3D<T>& a, float b)
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator*=(grid_3D<T, Allocator, Layout>& a, float b)
 {
     a.data *= b;
-}
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data*b.data;
-    return res;
-}
-template <typename T> grid_3D<T>  operator*(grid_3D<T> const& a, float b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data*b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator*(float a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(b.dimension);
-    res.data = a*b.data;
-    return res;
+    return a;
 }
 
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, grid_3D<T> const& b)
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator/=(grid_3D<T, Allocator, Layout>& a, grid_3D<T, Allocator, Layout> const& b)
 {
     assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
     a.data /= b.data;
+    return a;
 }
-template <typename T> grid_3D<T>& operator/=(grid_3D<T>& a, float b)
+template <typename T, typename Allocator, typename Layout> grid_3D<T, Allocator, Layout>& operator/=(grid_3D<T, Allocator, Layout>& a, float b)
 {
     a.data /= b;
+    return a;
 }
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, grid_3D<T> const& b)
-{
-    assert_vcl( is_equal(a.dimension,b.dimension), "Dimension do not agree: a:"+str(a.dimension)+", b:"+str(b.dimension) );
-    grid_3D<T> res(a.dimension);
-    res.data = a.data/b.data;
-    return res;
-}
-template <typename T> grid_3D<T>  operator/(grid_3D<T> const& a, float b)
-{
-    grid_3D<T> res(a.dimension);
-    res.data = a.data/b;
-    return res;
-}
-template <typename T> grid_3D<T>  operator/(float a, grid_3D<T> const& b)
-{
-    grid_3D<T> res(b.dimension);
-    res.data = a/b.data;
-    return res;
-}
-
-
-
 }
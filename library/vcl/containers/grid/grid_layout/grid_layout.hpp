@@ -0,0 +1,85 @@
+#pragma once
+
+#include "vcl/base/base.hpp"
+#include "../../buffer_stack/buffer_stack.hpp"
+#include "vcl/containers/offset_grid/offset_grid.hpp"
+
+/* Storage layouts of grid_2D and grid_3D (third template parameter): position in memory of the element (x,y[,z])
+*  - layout_row_major: x varies first, then y, then z (default: compatible with pointers, views, OpenGL textures and the lazy expressions)
+*  - layout_morton: Morton (Z-order) curve, neighbors in all directions remain close in memory at all scales.
+*      Intended for square/cubic grids of power of 2 dimension: other dimensions are padded up to the Morton offset of the last element.
+*  - layout_tiled<N>: square tiles of NxN elements (cubes of NxNxN in 3D) stored one after the other, row-major inside a tile (ex. layout_tiled<8> in 2D, layout_tiled<4> in 3D).
+*      The dimension is padded up to a multiple of N.
+*
+* The accessors grid(x,y[,z]) are the same for all layouts, while grid[offset], begin()/end() and grid.data follow the storage order and include the padding elements.
+* Ex. grid_2D<float, std::allocator<float>, layout_tiled<8>> height(1024,1024);
+*     grid_3D<float, huge_page_allocator<float>, layout_morton> density(256);
+*
+* A layout provides the offset of an index, the number of stored elements for a dimension, and the index of an offset.
+*/
+
+namespace vcl
+{
+    struct layout_row_major
+    {
+        static size_t offset(size_t k1, size_t k2, size_t2 const& dimension) { return offset_grid(k1, k2, dimension.x); }
+        static size_t offset(size_t k1, size_t k2, size_t k3, size_t3 const& dimension) { return offset_grid(k1, k2, k3, dimension.x, dimension.y); }
+
+        static size_t storage_size(size_t2 const& dimension) { return dimension.x * dimension.y; }
+        static size_t storage_size(size_t3 const& dimension) { return dimension.x * dimension.y * dimension.z; }
+
+        static size_t2 index(size_t offset, size_t2 const& dimension) { return { offset % dimension.x, offset / dimension.x }; }
+        static size_t3 index(size_t offset, size_t3 const& dimension) { return { offset % dimension.x, (offset / dimension.x) % dimension.y, offset / (dimension.x*dimension.y) }; }
+    };
+
+    struct layout_morton
+    {
+        static size_t offset(size_t k1, size_t k2, size_t2 const&) { return morton_encode_2D(k1, k2); }
+        static size_t offset(size_t k1, size_t k2, size_t k3, size_t3 const&) { return morton_encode_3D(k1, k2, k3); }
+
+        static size_t storage_size(size_t2 const& dimension) { return (dimension.x==0 || dimension.y==0) ? 0 : morton_encode_2D(dimension.x-1, dimension.y-1) + 1; }
+        static size_t storage_size(size_t3 const& dimension) { return (dimension.x==0 || dimension.y==0 || dimension.z==0) ? 0 : morton_encode_3D(dimension.x-1, dimension.y-1, dimension.z-1) + 1; }
+
+        static size_t2 index(size_t offset, size_t2 const&) { auto const k = morton_decode_2D(offset); return { k.first, k.second }; }
+        static size_t3 index(size_t offset, size_t3 const&) { auto const k = morton_decode_3D(offset); return { std::get<0>(k), std::get<1>(k), std::get<2>(k) }; }
+    };
+
+    template <size_t N>
+    struct layout_tiled
+    {
+        static_assert(N > 0 && (N & (N-1)) == 0, "The size of the tiles must be a power of 2");
+
+        /** Number of tiles along a dimension of size n */
+        static size_t tile_count(size_t n) { return (n + N-1) / N; }
+
+        static size_t offset(size_t k1, size_t k2, size_t2 const& dimension)
+        {
+            size_t const tile = (k2/N) * tile_count(dimension.x) + k1/N;
+            return tile*N*N + (k2%N)*N + k1%N;
+        }
+        static size_t offset(size_t k1, size_t k2, size_t k3, size_t3 const& dimension)
+        {
+            size_t const tile = ((k3/N) * tile_count(dimension.y) + k2/N) * tile_count(dimension.x) + k1/N;
+            return tile*N*N*N + ((k3%N)*N + k2%N)*N + k1%N;
+        }
+
+        static size_t storage_size(size_t2 const& dimension) { return tile_count(dimension.x) * tile_count(dimension.y) * N*N; }
+        static size_t storage_size(size_t3 const& dimension) { return tile_count(dimension.x) * tile_count(dimension.y) * tile_count(dimension.z) * N*N*N; }
+
+        static size_t2 index(size_t offset, size_t2 const& dimension)
+        {
+            size_t const tile = offset / (N*N);
+            size_t const local = offset % (N*N);
+            size_t const tiles_x = tile_count(dimension.x);
+            return { (tile % tiles_x)*N + local%N, (tile / tiles_x)*N + local/N };
+        }
+        static size_t3 index(size_t offset, size_t3 const& dimension)
+        {
+            size_t const tile = offset / (N*N*N);
+            size_t const local = offset % (N*N*N);
+            size_t const tiles_x = tile_count(dimension.x);
+            size_t const tiles_y = tile_count(dimension.y);
+            return { (tile % tiles_x)*N + local%N, ((tile / tiles_x) % tiles_y)*N + (local/N)%N, (tile / (tiles_x*tiles_y))*N + local/(N*N) };
+        }
+    };
+}
@@ -0,0 +1,141 @@
+#include "benchmark_grid_layout.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/interpolation/interpolation.hpp"
+#include "vcl/base/test/benchmark_timing.hpp"
+
+#include <cstdint>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Deterministic pseudo-random generator (same sequence for all the layouts)
+	struct lcg
+	{
+		uint64_t state = 12345;
+		float operator()() { state = state*6364136223846793005ull + 1442695040888963407ull; return float(state >> 40) / float(1 << 24); }
+	};
+
+	template <typename Grid> static void fill_2D(Grid& g)
+	{
+		for (size_t ky = 0; ky < g.dimension.y; ++ky)
+			for (size_t kx = 0; kx < g.dimension.x; ++kx)
+				g(kx, ky) = float((kx*7 + ky*13) % 17);
+	}
+
+	// 5-point laplacian, traversal along x (inner loop) or along y
+	template <typename Grid> static float laplacian_2D(Grid const& g, Grid& out, bool x_inner)
+	{
+		size_t const Nx = g.dimension.x, Ny = g.dimension.y;
+		auto stencil = [&](size_t x, size_t y) {
+			out.at_unsafe(x, y) = g.at_unsafe(x-1, y) + g.at_unsafe(x+1, y) + g.at_unsafe(x, y-1) + g.at_unsafe(x, y+1) - 4*g.at_unsafe(x, y);
+		};
+		if (x_inner) {
+			for (size_t y = 1; y + 1 < Ny; ++y)
+				for (size_t x = 1; x + 1 < Nx; ++x)
+					stencil(x, y);
+		}
+		else {
+			for (size_t x = 1; x + 1 < Nx; ++x)
+				for (size_t y = 1; y + 1 < Ny; ++y)
+					stencil(x, y);
+		}
+		return out(Nx/2, Ny/2);
+	}
+
+	// Bilinear sampling at uniformly random positions, or along random walks (spatially coherent queries as particles advected in a field)
+	template <typename Grid> static float sampling_2D(Grid const& g, size_t N_sample, bool random_walk)
+	{
+		lcg random;
+		float const max_x = g.dimension.x - 1.001f, max_y = g.dimension.y - 1.001f;
+		float x = max_x/2, y = max_y/2;
+		float s = 0.0f;
+		for (size_t k = 0; k < N_sample; ++k) {
+			if (random_walk) {
+				x += 4*random() - 2; y += 4*random() - 2;
+				if (x < 0 || x >= max_x) x = max_x*random();
+				if (y < 0 || y >= max_y) y = max_y*random();
+			}
+			else {
+				x = max_x*random(); y = max_y*random();
+			}
+			s += interpolation_bilinear(g, x, y);
+		}
+		return s;
+	}
+
+	// Sum along z for each (x,y) - traversal along the slow axis of the row-major layout - and 7-point stencil
+	template <typename Grid> static float sweep_z_3D(Grid const& g)
+	{
+		float s = 0.0f;
+		for (size_t ky = 0; ky < g.dimension.y; ++ky)
+			for (size_t kx = 0; kx < g.dimension.x; ++kx)
+				for (size_t kz = 0; kz < g.dimension.z; ++kz)
+					s += g.at_unsafe(kx, ky, kz);
+		return s;
+	}
+	template <typename Grid> static float laplacian_3D(Grid const& g, Grid& out)
+	{
+		size_t const N = g.dimension.x;
+		for (size_t z = 1; z + 1 < N; ++z)
+			for (size_t y = 1; y + 1 < N; ++y)
+				for (size_t x = 1; x + 1 < N; ++x)
+					out.at_unsafe(x, y, z) = g.at_unsafe(x-1, y, z) + g.at_unsafe(x+1, y, z) + g.at_unsafe(x, y-1, z) + g.at_unsafe(x, y+1, z)
+						+ g.at_unsafe(x, y, z-1) + g.at_unsafe(x, y, z+1) - 6*g.at_unsafe(x, y, z);
+		return out(N/2, N/2, N/2);
+	}
+
+	template <typename Layout> static void benchmark_layout_2D(std::string const& name, size_t N, float& checksum)
+	{
+		using grid_type = grid_2D<float, std::allocator<float>, Layout>;
+		grid_type g(N, N), out(N, N);
+		fill_2D(g);
+		size_t const N_sample = 4*1024*1024;
+
+		std::cout << "  " << name << std::endl;
+		std::cout << "    laplacian along x   : " << timing([&]() { checksum += laplacian_2D(g, out, true); }, 5) << " ms" << std::endl;
+		std::cout << "    laplacian along y   : " << timing([&]() { checksum += laplacian_2D(g, out, false); }, 5) << " ms" << std::endl;
+		std::cout << "    random sampling     : " << timing([&]() { checksum += sampling_2D(g, N_sample, false); }, 3) << " ms" << std::endl;
+		std::cout << "    random walk sampling: " << timing([&]() { checksum += sampling_2D(g, N_sample, true); }, 3) << " ms" << std::endl;
+	}
+
+	template <typename Layout> static void benchmark_layout_3D(std::string const& name, size_t N, float& checksum)
+	{
+		using grid_type = grid_3D<float, std::allocator<float>, Layout>;
+		grid_type g(N), out(N);
+		for (size_t k = 0; k < g.data.size(); ++k)
+			g.data[k] = float(k % 11);
+
+		std::cout << "  " << name << std::endl;
+		std::cout << "    sum along z         : " << timing([&]() { checksum += sweep_z_3D(g); }, 3) << " ms" << std::endl;
+		std::cout << "    laplacian           : " << timing([&]() { checksum += laplacian_3D(g, out); }, 3) << " ms" << std::endl;
+	}
+
+	void benchmark_grid_layout()
+	{
+		float checksum = 0.0f;
+#ifdef VCL_MORTON_BMI2
+		std::cout << "Morton encoding with BMI2 pdep/pext" << std::endl;
+#else
+		std::cout << "Morton encoding with bit manipulations (BMI2 not enabled at compilation)" << std::endl;
+#endif
+
+		size_t const N2 = 4096;
+		std::cout << "grid_2D<float> " << N2 << "x" << N2 << std::endl;
+		benchmark_layout_2D<layout_row_major>("row-major", N2, checksum);
+		benchmark_layout_2D<layout_morton>("morton", N2, checksum);
+		benchmark_layout_2D<layout_tiled<8>>("tiled 8x8", N2, checksum);
+
+		size_t const N3 = 256;
+		std::cout << "grid_3D<float> " << N3 << "^3" << std::endl;
+		benchmark_layout_3D<layout_row_major>("row-major", N3, checksum);
+		benchmark_layout_3D<layout_morton>("morton", N3, checksum);
+		benchmark_layout_3D<layout_tiled<4>>("tiled 4x4x4", N3, checksum);
+
+		std::cout << "(checksum " << checksum << ")" << std::endl;
+	}
+}
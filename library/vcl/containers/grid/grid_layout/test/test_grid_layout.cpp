@@ -0,0 +1,141 @@
+#include "test_grid_layout.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/interpolation/interpolation.hpp"
+
+#include <vector>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// The offsets of all the elements of a grid of the given dimension are different, inside the storage, and decoded back to their index
+	template <typename Layout> static bool is_valid_layout_2D(size_t2 const& dimension)
+	{
+		size_t const storage = Layout::storage_size(dimension);
+		std::vector<bool> used(storage, false);
+		for (size_t ky = 0; ky < dimension.y; ++ky) {
+			for (size_t kx = 0; kx < dimension.x; ++kx) {
+				size_t const offset = Layout::offset(kx, ky, dimension);
+				if (offset >= storage || used[offset])
+					return false;
+				used[offset] = true;
+				if (!is_equal(Layout::index(offset, dimension), size_t2{ kx,ky }))
+					return false;
+			}
+		}
+		return true;
+	}
+	template <typename Layout> static bool is_valid_layout_3D(size_t3 const& dimension)
+	{
+		size_t const storage = Layout::storage_size(dimension);
+		std::vector<bool> used(storage, false);
+		for (size_t kz = 0; kz < dimension.z; ++kz) {
+			for (size_t ky = 0; ky < dimension.y; ++ky) {
+				for (size_t kx = 0; kx < dimension.x; ++kx) {
+					size_t const offset = Layout::offset(kx, ky, kz, dimension);
+					if (offset >= storage || used[offset])
+						return false;
+					used[offset] = true;
+					if (!is_equal(Layout::index(offset, dimension), size_t3{ kx,ky,kz }))
+						return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// Same values and operations on a grid with the row-major layout and with another layout
+	template <typename Layout> static bool is_same_as_row_major(size_t2 const& dimension)
+	{
+		grid_2D<float> a(dimension);
+		grid_2D<float, std::allocator<float>, Layout> b(dimension);
+		for (size_t ky = 0; ky < dimension.y; ++ky)
+			for (size_t kx = 0; kx < dimension.x; ++kx)
+				a(kx, ky) = b(kx, ky) = float(kx + 100*ky);
+
+		grid_2D<float, std::allocator<float>, Layout> c = grid_2D<float, std::allocator<float>, Layout>::from_buffer(a.data, dimension.x, dimension.y);
+		if (!is_equal(b, c) || str(a) != str(b))
+			return false;
+		b *= 2.0f;
+		b += c;
+		for (size_t ky = 0; ky < dimension.y; ++ky)
+			for (size_t kx = 0; kx < dimension.x; ++kx)
+				if (!is_equal(b(kx, ky), 3*a(kx, ky)) || &b.at_unsafe(kx, ky) != &b(kx, ky))
+					return false;
+		return is_equal(interpolation_bilinear(a, 1.5f, 0.25f)*3, interpolation_bilinear(b, 1.5f, 0.25f));
+	}
+
+	void test_grid_layout()
+	{
+		// Morton encoding
+		{
+			assert_vcl_no_msg(morton_encode_2D(0, 0) == 0);
+			assert_vcl_no_msg(morton_encode_2D(1, 0) == 1);
+			assert_vcl_no_msg(morton_encode_2D(0, 1) == 2);
+			assert_vcl_no_msg(morton_encode_2D(3, 3) == 15);
+			assert_vcl_no_msg(morton_encode_2D(5, 9) == 0x93); // x=0101, y=1001
+			assert_vcl_no_msg(morton_encode_3D(1, 1, 1) == 7);
+			assert_vcl_no_msg(morton_encode_3D(2, 0, 1) == 0x0c); // bit 1 of x -> bit 3, bit 0 of z -> bit 2
+
+			size_t const large = (size_t(1) << 20) + 12345;
+			auto const k2 = morton_decode_2D(morton_encode_2D(large, 777));
+			assert_vcl_no_msg(k2.first == large && k2.second == 777);
+			auto const k3 = morton_decode_3D(morton_encode_3D(large, 3, (size_t(1) << 21) - 1));
+			assert_vcl_no_msg(std::get<0>(k3) == large && std::get<1>(k3) == 3 && std::get<2>(k3) == (size_t(1) << 21) - 1);
+		}
+
+		// Offsets of the layouts, including non power of 2 dimensions (padding)
+		{
+			for (size_t2 const& dimension : { size_t2{ 8,8 }, size_t2{ 13,7 }, size_t2{ 1,20 } }) {
+				assert_vcl_no_msg(is_valid_layout_2D<layout_row_major>(dimension));
+				assert_vcl_no_msg(is_valid_layout_2D<layout_morton>(dimension));
+				assert_vcl_no_msg(is_valid_layout_2D<layout_tiled<4>>(dimension));
+			}
+			for (size_t3 const& dimension : { size_t3{ 4,4,4 }, size_t3{ 5,3,9 } }) {
+				assert_vcl_no_msg(is_valid_layout_3D<layout_row_major>(dimension));
+				assert_vcl_no_msg(is_valid_layout_3D<layout_morton>(dimension));
+				assert_vcl_no_msg(is_valid_layout_3D<layout_tiled<2>>(dimension));
+			}
+			assert_vcl_no_msg(layout_morton::storage_size(size_t2{ 16,16 }) == 256);
+			assert_vcl_no_msg(layout_tiled<8>::storage_size(size_t2{ 10,10 }) == 256);
+			assert_vcl_no_msg(layout_tiled<4>::storage_size(size_t3{ 8,8,8 }) == 512);
+		}
+
+		// Grids with other layouts behave as the row-major grid
+		{
+			assert_vcl_no_msg(is_same_as_row_major<layout_morton>(size_t2{ 16,16 }));
+			assert_vcl_no_msg(is_same_as_row_major<layout_morton>(size_t2{ 11,5 }));
+			assert_vcl_no_msg(is_same_as_row_major<layout_tiled<8>>(size_t2{ 20,9 }));
+
+			grid_2D<int, std::allocator<int>, layout_tiled<2>> g(3, 3);
+			assert_vcl_no_msg(g.size() == 9 && g.data.size() == 16);
+			g(2, 1) = 5;
+			assert_vcl_no_msg(g[g.index_to_offset(2, 1)] == 5);
+			assert_vcl_no_msg(is_equal(g.offset_to_index(g.index_to_offset(2, 1)), int2{ 2,1 }));
+
+			grid_3D<float, std::allocator<float>, layout_morton> a(size_t3{ 5,6,7 });
+			grid_3D<float> b(size_t3{ 5,6,7 });
+			for (size_t kz = 0; kz < 7; ++kz)
+				for (size_t ky = 0; ky < 6; ++ky)
+					for (size_t kx = 0; kx < 5; ++kx)
+						a(kx, ky, kz) = b(kx, ky, kz) = float(kx + 10*ky + 100*kz);
+			assert_vcl_no_msg(str(a) == str(b));
+			assert_vcl_no_msg(is_equal(a(int3{ 4,5,6 }), 654.0f) && &a.at_unsafe(4, 5, 6) == &a(4, 5, 6));
+
+			grid_3D<float, std::allocator<float>, layout_morton> c = a;
+			c.fill(1.0f);
+			a -= c;
+			assert_vcl_no_msg(is_equal(a(1, 2, 3), 320.0f));
+		}
+
+		// The row-major grid keeps its offsets
+		{
+			grid_2D<int> g(3, 2);
+			assert_vcl_no_msg(g.index_to_offset(2, 1) == 5);
+			assert_vcl_no_msg(is_equal(g.offset_to_index(5), int2{ 2,1 }));
+		}
+	}
+}
@@ -2,6 +2,12 @@
 
 #include <tuple>
 #include <cstddef>
+#include <cstdint>
+
+#if defined(__BMI2__) && (defined(__x86_64__) || defined(_M_X64))
+#include <immintrin.h>
+#define VCL_MORTON_BMI2
+#endif
 
 namespace vcl
 {
@@ -19,8 +25,107 @@ namespace vcl
 		return { k1,k2 };
 	}
 
-	size_t offset_grid(size_t k1, size_t k2, size_t N1);
+	// Compute the 1D offset corresponding to the index (k1,k2) in a 2D grid
+	inline size_t offset_grid(size_t k1, size_t k2, size_t N1)
+	{
+		return k1 + N1*k2;
+	}
 	std::pair<size_t,size_t> index_grid_from_offset(size_t offset, size_t N1);
-	size_t offset_grid(size_t k0, size_t k1, size_t k2, size_t N1, size_t N2);
+	inline size_t offset_grid(size_t k0, size_t k1, size_t k2, size_t N1, size_t N2)
+	{
+		return k0 + N1 * (k1 + N2 * k2);
+	}
+
+	// Morton (Z-order) offset of the index (k1,k2): the bits of k1 and k2 are interleaved (k1 on the even bits)
+	//  Neighbors in 2D remain close in memory at all scales. Each coordinate must be < 2^32.
+	//  Uses the BMI2 instructions pdep/pext when the compiler targets them (ex. -mbmi2 or -march=native).
+	inline size_t morton_encode_2D(size_t k1, size_t k2);
+	inline std::pair<size_t,size_t> morton_decode_2D(size_t offset);
+	// Morton offset of the index (k0,k1,k2), each coordinate must be < 2^21
+	inline size_t morton_encode_3D(size_t k0, size_t k1, size_t k2);
+	inline std::tuple<size_t,size_t,size_t> morton_decode_3D(size_t offset);
+
+	namespace detail
+	{
+		// Insert one zero bit between each of the 32 lower bits of x
+		inline uint64_t morton_spread_1(uint64_t x)
+		{
+			x &= 0xffffffffull;
+			x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+			x = (x | (x << 8))  & 0x00ff00ff00ff00ffull;
+			x = (x | (x << 4))  & 0x0f0f0f0f0f0f0f0full;
+			x = (x | (x << 2))  & 0x3333333333333333ull;
+			x = (x | (x << 1))  & 0x5555555555555555ull;
+			return x;
+		}
+		inline uint64_t morton_compact_1(uint64_t x)
+		{
+			x &= 0x5555555555555555ull;
+			x = (x | (x >> 1))  & 0x3333333333333333ull;
+			x = (x | (x >> 2))  & 0x0f0f0f0f0f0f0f0full;
+			x = (x | (x >> 4))  & 0x00ff00ff00ff00ffull;
+			x = (x | (x >> 8))  & 0x0000ffff0000ffffull;
+			x = (x | (x >> 16)) & 0x00000000ffffffffull;
+			return x;
+		}
+		// Insert two zero bits between each of the 21 lower bits of x
+		inline uint64_t morton_spread_2(uint64_t x)
+		{
+			x &= 0x1fffffull;
+			x = (x | (x << 32)) & 0x001f00000000ffffull;
+			x = (x | (x << 16)) & 0x001f0000ff0000ffull;
+			x = (x | (x << 8))  & 0x100f00f00f00f00full;
+			x = (x | (x << 4))  & 0x10c30c30c30c30c3ull;
+			x = (x | (x << 2))  & 0x1249249249249249ull;
+			return x;
+		}
+		inline uint64_t morton_compact_2(uint64_t x)
+		{
+			x &= 0x1249249249249249ull;
+			x = (x | (x >> 2))  & 0x10c30c30c30c30c3ull;
+			x = (x | (x >> 4))  & 0x100f00f00f00f00full;
+			x = (x | (x >> 8))  & 0x001f0000ff0000ffull;
+			x = (x | (x >> 16)) & 0x001f00000000ffffull;
+			x = (x | (x >> 32)) & 0x00000000001fffffull;
+			return x;
+		}
+	}
+
+	inline size_t morton_encode_2D(size_t k1, size_t k2)
+	{
+#ifdef VCL_MORTON_BMI2
+		return size_t(_pdep_u64(k1, 0x5555555555555555ull) | _pdep_u64(k2, 0xaaaaaaaaaaaaaaaaull));
+#else
+		return size_t(detail::morton_spread_1(k1) | (detail::morton_spread_1(k2) << 1));
+#endif
+	}
+
+	inline std::pair<size_t,size_t> morton_decode_2D(size_t offset)
+	{
+#ifdef VCL_MORTON_BMI2
+		return { size_t(_pext_u64(offset, 0x5555555555555555ull)), size_t(_pext_u64(offset, 0xaaaaaaaaaaaaaaaaull)) };
+#else
+		return { size_t(detail::morton_compact_1(offset)), size_t(detail::morton_compact_1(uint64_t(offset) >> 1)) };
+#endif
+	}
+
+	inline size_t morton_encode_3D(size_t k0, size_t k1, size_t k2)
+	{
+#ifdef VCL_MORTON_BMI2
+		return size_t(_pdep_u64(k0, 0x1249249249249249ull) | _pdep_u64(k1, 0x2492492492492492ull) | _pdep_u64(k2, 0x4924924924924924ull));
+#else
+		return size_t(detail::morton_spread_2(k0) | (detail::morton_spread_2(k1) << 1) | (detail::morton_spread_2(k2) << 2));
+#endif
+	}
+
+	inline std::tuple<size_t,size_t,size_t> morton_decode_3D(size_t offset)
+	{
+#ifdef VCL_MORTON_BMI2
+		return std::make_tuple(size_t(_pext_u64(offset, 0x1249249249249249ull)), size_t(_pext_u64(offset, 0x2492492492492492ull)), size_t(_pext_u64(offset, 0x4924924924924924ull)));
+#else
+		uint64_t const x = offset;
+		return std::make_tuple(size_t(detail::morton_compact_2(x)), size_t(detail::morton_compact_2(x >> 1)), size_t(detail::morton_compact_2(x >> 2)));
+#endif
+	}
 
 }
\ No newline at end of file
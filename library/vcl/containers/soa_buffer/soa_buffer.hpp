@@ -0,0 +1,365 @@
+#pragma once
+
+#include "vcl/base/base.hpp"
+#include "vcl/containers/buffer_stack/buffer_stack.hpp"
+#include "vcl/containers/buffer/buffer.hpp"
+#include "vcl/containers/buffer_view/buffer_view.hpp"
+#include "vcl/containers/allocator/allocator.hpp"
+
+#include <array>
+#include <iostream>
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace vcl
+{
+
+/** Reference to the element of an soa_buffer: behaves as a vec3/vec4 whose coordinates are stored in separate arrays
+ * Allows soa[k].z = h, soa[k] = vec3(...), soa[k] += vec3(...), vec3 p = soa[k] */
+template <typename T, size_t N> struct soa_reference;
+
+template <typename T>
+struct soa_reference<T, 3>
+{
+    using value_type = buffer_stack<T, 3>;
+
+    T& x;
+    T& y;
+    T& z;
+
+    operator value_type() const { return { x, y, z }; }
+    soa_reference& operator=(value_type const& v) { x = v.x; y = v.y; z = v.z; return *this; }
+    soa_reference& operator=(soa_reference const& r) { return *this = value_type(r); }
+
+    soa_reference& operator+=(value_type const& v) { x += v.x; y += v.y; z += v.z; return *this; }
+    soa_reference& operator-=(value_type const& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+    soa_reference& operator*=(T s) { x *= s; y *= s; z *= s; return *this; }
+    soa_reference& operator/=(T s) { x /= s; y /= s; z /= s; return *this; }
+};
+
+template <typename T>
+struct soa_reference<T, 4>
+{
+    using value_type = buffer_stack<T, 4>;
+
+    T& x;
+    T& y;
+    T& z;
+    T& w;
+
+    operator value_type() const { return { x, y, z, w }; }
+    soa_reference& operator=(value_type const& v) { x = v.x; y = v.y; z = v.z; w = v.w; return *this; }
+    soa_reference& operator=(soa_reference const& r) { return *this = value_type(r); }
+
+    soa_reference& operator+=(value_type const& v) { x += v.x; y += v.y; z += v.z; w += v.w; return *this; }
+    soa_reference& operator-=(value_type const& v) { x -= v.x; y -= v.y; z -= v.z; w -= v.w; return *this; }
+    soa_reference& operator*=(T s) { x *= s; y *= s; z *= s; w *= s; return *this; }
+    soa_reference& operator/=(T s) { x /= s; y /= s; z /= s; w /= s; return *this; }
+};
+
+
+/** Structure-of-arrays container for vec3/vec4 data: soa_buffer<vec3>, soa_buffer<vec4>
+ *
+ * The coordinates are stored in separate contiguous buffers (all the x, then all the y, ...) instead of consecutive x,y,z records as in buffer<vec3>
+ * - Loops touching a single coordinate (ex. writing the height z of a terrain) only load this coordinate
+ * - The arrays of the coordinates are 64-byte aligned by default (aligned_allocator), the Allocator can be changed (see containers/allocator)
+ * - Read-only access to a coordinate returns its buffer<float>: the operators, expressions and kernels of buffer apply on it without copy (ex. sum(p.z()), p.x() + dt*v.x())
+ * - Read-write access to a coordinate returns a buffer_view<float> on its elements: the coordinates can only be resized together (resize, push_back, clear)
+ * - Element access p[k] returns a soa_reference with the same syntax as vec3 (p[k].x, p[k] = vec3(...), vec3 q = p[k])
+ * - to_buffer() converts to buffer<vec3> (ex. before sending the data to the GPU), and the constructor/from_buffer() convert from it
+ *
+ * The buffers of the coordinates always have the same size.
+ **/
+template <typename T> struct soa_default_allocator;
+template <typename T, size_t N> struct soa_default_allocator< buffer_stack<T, N> > { using type = aligned_allocator<T>; };
+
+template <typename T, typename Allocator = typename soa_default_allocator<T>::type> struct soa_buffer;
+
+template <typename T, size_t N, typename Allocator>
+struct soa_buffer< buffer_stack<T, N>, Allocator >
+{
+    static_assert(N==3 || N==4, "soa_buffer is defined for elements of dimension 3 and 4");
+    static_assert(std::is_same<typename Allocator::value_type, T>::value, "The allocator of soa_buffer allocates the coordinates");
+
+    using value_type = buffer_stack<T, N>;
+    using reference = soa_reference<T, N>;
+    using allocator_type = Allocator;
+
+    /** Internal data - Buffers of the coordinates: component[0] stores all the x, component[1] all the y, ...
+     *  They must keep the same size: use the read-write views x(), y(), z(), w() to modify the coordinates */
+    std::array<buffer<T, Allocator>, N> component;
+
+    // Constructors
+    soa_buffer();                                     // Empty buffer - no elements
+    soa_buffer(size_t size);                          // Buffer with a given size
+    soa_buffer(std::initializer_list<value_type> arg); // Inline initialization using { }
+    soa_buffer(buffer<value_type> const& arg);        // Conversion from the array-of-structures layout
+
+    /** Number of elements */
+    size_t size() const;
+    /** Resize all the coordinates */
+    soa_buffer& resize(size_t size);
+    /** Add an element at the end of the container */
+    soa_buffer& push_back(value_type const& value);
+    /** Remove all elements of the container, new size is 0 */
+    soa_buffer& clear();
+    /** Fill the container with the same element */
+    soa_buffer& fill(value_type const& value);
+
+    /** Element access
+     * Bound checking is performed unless VCL_NO_DEBUG is defined. */
+    reference operator[](size_t index);
+    value_type operator[](size_t index) const;
+    /** Element access without bound checking */
+    reference at_unsafe(size_t index);
+    value_type at_unsafe(size_t index) const;
+
+    /** Read-write views on the coordinates (zero-copy, the size cannot be changed) */
+    buffer_view<T> x();
+    buffer_view<T> y();
+    buffer_view<T> z();
+    buffer_view<T> w(); // only for soa_buffer<vec4>
+    /** Buffers of the coordinates (zero-copy, read-only) */
+    buffer<T, Allocator> const& x() const;
+    buffer<T, Allocator> const& y() const;
+    buffer<T, Allocator> const& z() const;
+    buffer<T, Allocator> const& w() const;
+
+    /** Conversion to the array-of-structures layout buffer<vec3> (ex. before sending the data to the GPU)
+     * The second version reuses the memory of the output buffer if it has already the right size */
+    buffer<value_type> to_buffer() const;
+    void to_buffer(buffer<value_type>& out) const;
+    /** Conversion from the array-of-structures layout */
+    soa_buffer& from_buffer(buffer<value_type> const& arg);
+};
+
+template <typename T, size_t N, typename A> std::string type_str(soa_buffer< buffer_stack<T, N>, A > const&);
+
+/** Display all elements of the buffer.*/
+template <typename T, size_t N, typename A> std::ostream& operator<<(std::ostream& s, soa_buffer< buffer_stack<T, N>, A > const& v);
+template <typename T, size_t N> std::ostream& operator<<(std::ostream& s, soa_reference<T, N> const& v);
+template <typename T, size_t N, typename A> std::string str(soa_buffer< buffer_stack<T, N>, A > const& v, std::string const& separator=" ", std::string const& begin="", std::string const& end="");
+
+template <typename T, size_t N, typename A> size_t size_in_memory(soa_buffer< buffer_stack<T, N>, A > const& v);
+
+/** Equality check (element by element) */
+template <typename T, size_t N, typename A1, typename A2> bool is_equal(soa_buffer< buffer_stack<T, N>, A1 > const& a, soa_buffer< buffer_stack<T, N>, A2 > const& b);
+template <typename T, size_t N, typename A1, typename A2> bool is_equal(soa_buffer< buffer_stack<T, N>, A1 > const& a, buffer< buffer_stack<T, N>, A2 > const& b);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace vcl
+{
+
+template <typename T, size_t N, typename Allocator>
+soa_buffer<buffer_stack<T, N>, Allocator>::soa_buffer()
+    :component()
+{}
+
+template <typename T, size_t N, typename Allocator>
+soa_buffer<buffer_stack<T, N>, Allocator>::soa_buffer(size_t size)
+    :component()
+{
+    resize(size);
+}
+
+template <typename T, size_t N, typename Allocator>
+soa_buffer<buffer_stack<T, N>, Allocator>::soa_buffer(std::initializer_list<value_type> arg)
+    :component()
+{
+    resize(arg.size());
+    size_t k = 0;
+    for (value_type const& value : arg)
+        (*this)[k++] = value;
+}
+
+template <typename T, size_t N, typename Allocator>
+soa_buffer<buffer_stack<T, N>, Allocator>::soa_buffer(buffer<value_type> const& arg)
+    :component()
+{
+    from_buffer(arg);
+}
+
+template <typename T, size_t N, typename Allocator>
+size_t soa_buffer<buffer_stack<T, N>, Allocator>::size() const
+{
+    return component[0].size();
+}
+
+template <typename T, size_t N, typename Allocator>
+soa_buffer<buffer_stack<T, N>, Allocator>& soa_buffer<buffer_stack<T, N>, Allocator>::resize(size_t size)
+{
+    for (size_t c = 0; c < N; ++c)
+        component[c].resize(size);
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator>
+soa_buffer<buffer_stack<T, N>, Allocator>& soa_buffer<buffer_stack<T, N>, Allocator>::push_back(value_type const& value)
+{
+    for (size_t c = 0; c < N; ++c)
+        component[c].push_back(value.at_unsafe(c));
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator>
+soa_buffer<buffer_stack<T, N>, Allocator>& soa_buffer<buffer_stack<T, N>, Allocator>::clear()
+{
+    for (size_t c = 0; c < N; ++c)
+        component[c].clear();
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator>
+soa_buffer<buffer_stack<T, N>, Allocator>& soa_buffer<buffer_stack<T, N>, Allocator>::fill(value_type const& value)
+{
+    for (size_t c = 0; c < N; ++c)
+        component[c].fill(value.at_unsafe(c));
+    return *this;
+}
+
+namespace detail
+{
+    template <typename T, typename A> soa_reference<T, 3> soa_element(std::array<buffer<T, A>, 3>& component, size_t k)
+    {
+        return { component[0].data[k], component[1].data[k], component[2].data[k] };
+    }
+    template <typename T, typename A> soa_reference<T, 4> soa_element(std::array<buffer<T, A>, 4>& component, size_t k)
+    {
+        return { component[0].data[k], component[1].data[k], component[2].data[k], component[3].data[k] };
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+soa_reference<T, N> soa_buffer<buffer_stack<T, N>, Allocator>::operator[](size_t index)
+{
+    check_index_bounds(index, component[0]);
+    return detail::soa_element(component, index);
+}
+
+template <typename T, size_t N, typename Allocator>
+buffer_stack<T, N> soa_buffer<buffer_stack<T, N>, Allocator>::operator[](size_t index) const
+{
+    check_index_bounds(index, component[0]);
+    return at_unsafe(index);
+}
+
+template <typename T, size_t N, typename Allocator>
+soa_reference<T, N> soa_buffer<buffer_stack<T, N>, Allocator>::at_unsafe(size_t index)
+{
+    return detail::soa_element(component, index);
+}
+
+template <typename T, size_t N, typename Allocator>
+buffer_stack<T, N> soa_buffer<buffer_stack<T, N>, Allocator>::at_unsafe(size_t index) const
+{
+    value_type value;
+    for (size_t c = 0; c < N; ++c)
+        value.at_unsafe(c) = component[c].data[index];
+    return value;
+}
+
+template <typename T, size_t N, typename Allocator> buffer_view<T> soa_buffer<buffer_stack<T, N>, Allocator>::x() { return component[0]; }
+template <typename T, size_t N, typename Allocator> buffer_view<T> soa_buffer<buffer_stack<T, N>, Allocator>::y() { return component[1]; }
+template <typename T, size_t N, typename Allocator> buffer_view<T> soa_buffer<buffer_stack<T, N>, Allocator>::z() { return component[2]; }
+template <typename T, size_t N, typename Allocator> buffer_view<T> soa_buffer<buffer_stack<T, N>, Allocator>::w() { static_assert(N==4, "w() is only defined for soa_buffer<vec4>"); return component[N-1]; }
+template <typename T, size_t N, typename Allocator> buffer<T, Allocator> const& soa_buffer<buffer_stack<T, N>, Allocator>::x() const { return component[0]; }
+template <typename T, size_t N, typename Allocator> buffer<T, Allocator> const& soa_buffer<buffer_stack<T, N>, Allocator>::y() const { return component[1]; }
+template <typename T, size_t N, typename Allocator> buffer<T, Allocator> const& soa_buffer<buffer_stack<T, N>, Allocator>::z() const { return component[2]; }
+template <typename T, size_t N, typename Allocator> buffer<T, Allocator> const& soa_buffer<buffer_stack<T, N>, Allocator>::w() const { static_assert(N==4, "w() is only defined for soa_buffer<vec4>"); return component[N-1]; }
+
+template <typename T, size_t N, typename Allocator>
+buffer<buffer_stack<T, N>> soa_buffer<buffer_stack<T, N>, Allocator>::to_buffer() const
+{
+    buffer<value_type> out;
+    to_buffer(out);
+    return out;
+}
+
+template <typename T, size_t N, typename Allocator>
+void soa_buffer<buffer_stack<T, N>, Allocator>::to_buffer(buffer<value_type>& out) const
+{
+    size_t const size_buffer = size();
+    out.resize(size_buffer);
+    T const* p[N];
+    for (size_t c = 0; c < N; ++c)
+        p[c] = component[c].data.data();
+    value_type* q = out.data.data();
+    for (size_t k = 0; k < size_buffer; ++k)
+        for (size_t c = 0; c < N; ++c)
+            q[k].at_unsafe(c) = p[c][k];
+}
+
+template <typename T, size_t N, typename Allocator>
+soa_buffer<buffer_stack<T, N>, Allocator>& soa_buffer<buffer_stack<T, N>, Allocator>::from_buffer(buffer<value_type> const& arg)
+{
+    size_t const size_buffer = arg.size();
+    resize(size_buffer);
+    value_type const* p = arg.data.data();
+    T* q[N];
+    for (size_t c = 0; c < N; ++c)
+        q[c] = component[c].data.data();
+    for (size_t k = 0; k < size_buffer; ++k)
+        for (size_t c = 0; c < N; ++c)
+            q[c][k] = p[k].at_unsafe(c);
+    return *this;
+}
+
+template <typename T, size_t N, typename A> std::string type_str(soa_buffer< buffer_stack<T, N>, A > const&)
+{
+    using vcl::type_str;
+    return "soa_buffer<" + type_str(buffer_stack<T, N>()) + ">";
+}
+
+template <typename T, size_t N, typename A> std::ostream& operator<<(std::ostream& s, soa_buffer< buffer_stack<T, N>, A > const& v)
+{
+    s << v.to_buffer();
+    return s;
+}
+
+template <typename T, size_t N> std::ostream& operator<<(std::ostream& s, soa_reference<T, N> const& v)
+{
+    s << buffer_stack<T, N>(v);
+    return s;
+}
+
+template <typename T, size_t N, typename A> std::string str(soa_buffer< buffer_stack<T, N>, A > const& v, std::string const& separator, std::string const& begin, std::string const& end)
+{
+    return str(v.to_buffer(), separator, begin, end);
+}
+
+template <typename T, size_t N, typename A> size_t size_in_memory(soa_buffer< buffer_stack<T, N>, A > const& v)
+{
+    size_t s = 0;
+    for (size_t c = 0; c < N; ++c)
+        s += size_in_memory(v.component[c]);
+    return s;
+}
+
+template <typename T, size_t N, typename A1, typename A2> bool is_equal(soa_buffer< buffer_stack<T, N>, A1 > const& a, soa_buffer< buffer_stack<T, N>, A2 > const& b)
+{
+    for (size_t c = 0; c < N; ++c)
+        if (is_equal(a.component[c], b.component[c]) == false)
+            return false;
+    return true;
+}
+
+template <typename T, size_t N, typename A1, typename A2> bool is_equal(soa_buffer< buffer_stack<T, N>, A1 > const& a, buffer< buffer_stack<T, N>, A2 > const& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t k = 0; k < a.size(); ++k)
+        if (is_equal(a[k], b[k]) == false)
+            return false;
+    return true;
+}
+
+}
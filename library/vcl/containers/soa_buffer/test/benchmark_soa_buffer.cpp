@@ -0,0 +1,147 @@
+#include "benchmark_soa_buffer.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/base/test/benchmark_timing.hpp"
+
+#include <cmath>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Unnormalized normal of the triangle (a,b,c) added to n
+	static void add_triangle_normal(float const* a, float const* b, float const* c, float* n)
+	{
+		float const u[3] = { b[0]-a[0], b[1]-a[1], b[2]-a[2] };
+		float const v[3] = { c[0]-a[0], c[1]-a[1], c[2]-a[2] };
+		n[0] = u[1]*v[2] - u[2]*v[1];
+		n[1] = u[2]*v[0] - u[0]*v[2];
+		n[2] = u[0]*v[1] - u[1]*v[0];
+	}
+
+	// Normals per vertex of a grid mesh of size Nu x Nv (accumulation of the face normals, then normalization)
+	static void normal_aos(buffer<vec3> const& position, buffer<uint3> const& connectivity, buffer<vec3>& normal)
+	{
+		vec3 const* p = position.data.data();
+		vec3* n = normal.data.data();
+		size_t const N = position.size();
+		for (size_t k = 0; k < N; ++k)
+			n[k] = { 0,0,0 };
+		for (uint3 const& f : connectivity.data) {
+			float face[3];
+			add_triangle_normal(&p[f.x].x, &p[f.y].x, &p[f.z].x, face);
+			for (unsigned int idx : f) {
+				n[idx].x += face[0]; n[idx].y += face[1]; n[idx].z += face[2];
+			}
+		}
+		for (size_t k = 0; k < N; ++k) {
+			float const L = std::sqrt(n[k].x*n[k].x + n[k].y*n[k].y + n[k].z*n[k].z);
+			if (L > 1e-6f) { n[k].x /= L; n[k].y /= L; n[k].z /= L; }
+		}
+	}
+	static void normal_soa(soa_buffer<vec3> const& position, buffer<uint3> const& connectivity, soa_buffer<vec3>& normal)
+	{
+		float const* px = position.x().data.data(); float const* py = position.y().data.data(); float const* pz = position.z().data.data();
+		float* nx = normal.x().data; float* ny = normal.y().data; float* nz = normal.z().data;
+		size_t const N = position.size();
+		for (size_t k = 0; k < N; ++k)
+			nx[k] = ny[k] = nz[k] = 0.0f;
+		for (uint3 const& f : connectivity.data) {
+			float const a[3] = { px[f.x], py[f.x], pz[f.x] };
+			float const b[3] = { px[f.y], py[f.y], pz[f.y] };
+			float const c[3] = { px[f.z], py[f.z], pz[f.z] };
+			float face[3];
+			add_triangle_normal(a, b, c, face);
+			for (unsigned int idx : f) {
+				nx[idx] += face[0]; ny[idx] += face[1]; nz[idx] += face[2];
+			}
+		}
+		for (size_t k = 0; k < N; ++k) {
+			float const L = std::sqrt(nx[k]*nx[k] + ny[k]*ny[k] + nz[k]*nz[k]);
+			if (L > 1e-6f) { nx[k] /= L; ny[k] /= L; nz[k] /= L; }
+		}
+	}
+
+	void benchmark_soa_buffer()
+	{
+		size_t const N = 4000000;
+		int const N_repeat = 10;
+		float const dt = 0.01f;
+
+		buffer<vec3> p_aos(N), v_aos(N);
+		for (size_t k = 0; k < N; ++k) {
+			p_aos[k] = { float(k%7), float(k%11), 0 };
+			v_aos[k] = { 0, 1, float(k%3) };
+		}
+		soa_buffer<vec3> p_soa = p_aos, v_soa = v_aos;
+		float checksum = 0.0f;
+
+		std::cout << "buffer<vec3> (AoS) vs soa_buffer<vec3> (SoA) on " << N << " elements (ms):" << std::endl;
+
+		// Height of a terrain: only z is written
+		double const t_height_aos = timing([&]() {
+			vec3* p = p_aos.data.data();
+			for (size_t k = 0; k < N; ++k) p[k].z = 0.5f*p[k].x - 0.25f*p[k].y; }, N_repeat);
+		double const t_height_soa = timing([&]() {
+			float const* x = p_soa.x().data; float const* y = p_soa.y().data; float* z = p_soa.z().data;
+			for (size_t k = 0; k < N; ++k) z[k] = 0.5f*x[k] - 0.25f*y[k]; }, N_repeat);
+		std::cout << "  terrain height z = f(x,y)        : " << t_height_aos << " vs " << t_height_soa << std::endl;
+
+		// Vertical displacement only
+		double const t_lift_aos = timing([&]() {
+			vec3* p = p_aos.data.data();
+			for (size_t k = 0; k < N; ++k) p[k].z += dt; }, N_repeat);
+		double const t_lift_soa = timing([&]() {
+			float* z = p_soa.z().data;
+			for (size_t k = 0; k < N; ++k) z[k] += dt; }, N_repeat);
+		std::cout << "  vertical displacement z += dt    : " << t_lift_aos << " vs " << t_lift_soa << std::endl;
+
+		// Particles with gravity: v.z -= dt*g; p += dt*v
+		double const t_particle_aos = timing([&]() {
+			vec3* p = p_aos.data.data(); vec3* v = v_aos.data.data();
+			for (size_t k = 0; k < N; ++k) {
+				v[k].z -= dt*9.81f;
+				p[k].x += dt*v[k].x; p[k].y += dt*v[k].y; p[k].z += dt*v[k].z;
+			} }, N_repeat);
+		double const t_particle_soa = timing([&]() {
+			float* vz = v_soa.z().data;
+			for (size_t k = 0; k < N; ++k) vz[k] -= dt*9.81f;
+			for (size_t c = 0; c < 3; ++c) {
+				float* p = p_soa.component[c].data.data(); float const* v = v_soa.component[c].data.data();
+				for (size_t k = 0; k < N; ++k) p[k] += dt*v[k];
+			} }, N_repeat);
+		std::cout << "  particles v.z -= dt*g; p += dt*v : " << t_particle_aos << " vs " << t_particle_soa << std::endl;
+
+		// Normals of a grid mesh (random access to the vertices of the triangles)
+		size_t const Nu = 1000, Nv = N/Nu;
+		buffer<uint3> connectivity;
+		for (size_t ku = 0; ku < Nu-1; ++ku) {
+			for (size_t kv = 0; kv < Nv-1; ++kv) {
+				unsigned int const idx = static_cast<unsigned int>(kv + Nv*ku);
+				connectivity.push_back(uint3{ idx, idx+static_cast<unsigned int>(Nv), idx+1 });
+				connectivity.push_back(uint3{ idx+1, idx+static_cast<unsigned int>(Nv), idx+static_cast<unsigned int>(Nv)+1 });
+			}
+		}
+		for (size_t ku = 0; ku < Nu; ++ku)
+			for (size_t kv = 0; kv < Nv; ++kv)
+				p_aos[kv+Nv*ku] = { float(ku), float(kv), std::sin(0.1f*float(ku))*std::cos(0.05f*float(kv)) };
+		p_soa.from_buffer(p_aos);
+		buffer<vec3> n_aos(N);
+		soa_buffer<vec3> n_soa(N);
+		double const t_normal_aos = timing([&]() { normal_aos(p_aos, connectivity, n_aos); }, N_repeat);
+		double const t_normal_soa = timing([&]() { normal_soa(p_soa, connectivity, n_soa); }, N_repeat);
+		std::cout << "  normals of a grid mesh           : " << t_normal_aos << " vs " << t_normal_soa << std::endl;
+
+		// Conversion for the GPU upload
+		buffer<vec3> gpu_data(N);
+		double const t_convert = timing([&]() { p_soa.to_buffer(gpu_data); }, N_repeat);
+		std::cout << "  conversion to buffer<vec3>       : " << t_convert << std::endl;
+
+		// Keeps the results from being optimized out
+		checksum += p_aos[N/2].z + p_soa[N/3].z + n_aos[N/4].z + n_soa[N/5].z + gpu_data[N/6].x;
+		std::cout << "  (checksum " << checksum << ")" << std::endl;
+	}
+}
@@ -0,0 +1,115 @@
+#include "test_soa_buffer.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+
+using namespace vcl;
+
+namespace vcl_test
+{
+
+	void test_soa_buffer()
+	{
+		// Construction, element access with vec3 semantics
+		{
+			soa_buffer<vec3> p = { {1,2,3}, {4,5,6} };
+			assert_vcl_no_msg(p.size()==2);
+			assert_vcl_no_msg(is_equal(p.x(), buffer<float>{ 1,4 }));
+			assert_vcl_no_msg(is_equal(p.y(), buffer<float>{ 2,5 }));
+			assert_vcl_no_msg(is_equal(p.z(), buffer<float>{ 3,6 }));
+
+			vec3 const q = p[1];
+			assert_vcl_no_msg(is_equal(q, vec3(4,5,6)));
+
+			p[0].z = 7.0f;
+			assert_vcl_no_msg(is_equal(p.z(), buffer<float>{ 7,6 }));
+			p[1] = vec3(-1,-2,-3);
+			assert_vcl_no_msg(is_equal(vec3(p[1]), vec3(-1,-2,-3)));
+			p[0] = p[1];
+			assert_vcl_no_msg(is_equal(vec3(p[0]), vec3(-1,-2,-3)));
+
+			p[0] += vec3(1,1,1);
+			p[0] *= 2.0f;
+			assert_vcl_no_msg(is_equal(vec3(p[0]), vec3(0,-2,-4)));
+			p[0] -= vec3(0,0,-4);
+			p[0] /= 2.0f;
+			assert_vcl_no_msg(is_equal(vec3(p[0]), vec3(0,-1,0)));
+
+			p.push_back({ 8,9,10 });
+			assert_vcl_no_msg(p.size()==3 && p.x().size()==3 && p.y().size()==3 && p.z().size()==3);
+			assert_vcl_no_msg(is_equal(str(p), str(buffer<vec3>{ {0,-1,0}, {-1,-2,-3}, {8,9,10} })));
+
+			soa_buffer<vec3> const& p_const = p;
+			assert_vcl_no_msg(is_equal(p_const[2], vec3(8,9,10)));
+
+			p.fill({ 1,1,1 });
+			assert_vcl_no_msg(is_equal(p, buffer<vec3>{ {1,1,1}, {1,1,1}, {1,1,1} }));
+			p.clear();
+			assert_vcl_no_msg(p.size()==0 && p.z().size()==0);
+		}
+
+		// Conversion to and from buffer<vec3>
+		{
+			buffer<vec3> const a = { {1,2,3}, {4,5,6}, {7,8,9} };
+			soa_buffer<vec3> p = a;
+			assert_vcl_no_msg(is_equal(p, a));
+			assert_vcl_no_msg(is_equal(p.to_buffer(), a));
+
+			// The output buffer is reused when it has already the right size
+			buffer<vec3> b(3);
+			vec3 const* ptr_b = b.data.data();
+			p.to_buffer(b);
+			assert_vcl_no_msg(b.data.data()==ptr_b);
+			assert_vcl_no_msg(is_equal(b, a));
+
+			p.from_buffer(buffer<vec3>{ {0,0,1} });
+			assert_vcl_no_msg(p.size()==1 && is_equal(vec3(p[0]), vec3(0,0,1)));
+			assert_vcl_no_msg(is_equal(p, soa_buffer<vec3>{ {0,0,1} }));
+			assert_vcl_no_msg(!is_equal(p, a));
+		}
+
+		// Coordinates: read-only access as buffers (operators and expressions), read-write access as views, without copy
+		{
+			soa_buffer<vec3> p = { {0,0,0}, {1,1,1} };
+			soa_buffer<vec3> const v = { {1,2,3}, {4,5,6} };
+			soa_buffer<vec3> const& p_const = p;
+			float const* ptr_z = p_const.z().data.data();
+
+			buffer_view<float> z = p.z();
+			for (size_t k = 0; k < z.size(); ++k)
+				z[k] += 0.5f*v.z()[k];
+			assert_vcl_no_msg(z.data==ptr_z && p.size()==2);
+			assert_vcl_no_msg(is_equal(p_const.z(), { 1.5f, 4.0f }));
+			assert_vcl_no_msg(is_equal(p_const.x(), { 0,1 }));
+			assert_vcl_no_msg(is_equal(max(p_const.z()), 4.0f));
+			assert_vcl_no_msg(is_equal(sum(p_const.x() + 2.0f*v.x()), 11.0f));
+		}
+
+		// The coordinates are aligned - on 64 bytes by default
+		{
+			soa_buffer<vec3> p(13);
+			for (size_t c = 0; c < 3; ++c)
+				assert_vcl_no_msg(reinterpret_cast<size_t>(p.component[c].data.data()) % 64 == 0);
+			p.push_back({ 1,2,3 });
+			for (size_t c = 0; c < 3; ++c)
+				assert_vcl_no_msg(reinterpret_cast<size_t>(p.component[c].data.data()) % 64 == 0);
+
+			soa_buffer<vec3, aligned_allocator<float, 32>> q = { {1,2,3}, {4,5,6} };
+			assert_vcl_no_msg(reinterpret_cast<size_t>(q.x().data) % 32 == 0);
+			assert_vcl_no_msg(is_equal(q, buffer<vec3>{ {1,2,3}, {4,5,6} }));
+			assert_vcl_no_msg(is_equal(q, soa_buffer<vec3>{ {1,2,3}, {4,5,6} }));
+		}
+
+		// soa_buffer<vec4>
+		{
+			soa_buffer<vec4> c(2);
+			assert_vcl_no_msg(c.size()==2 && c.w().size()==2);
+			c[1] = vec4(1,2,3,4);
+			c[0].w = 0.5f;
+			assert_vcl_no_msg(is_equal(c.w(), buffer<float>{ 0.5f, 4.0f }));
+			assert_vcl_no_msg(is_equal(c.to_buffer(), buffer<vec4>{ {0,0,0,0.5f}, {1,2,3,4} }));
+			assert_vcl_no_msg(size_in_memory(c)>=2*4*sizeof(float));
+		}
+	}
+}
@@ -0,0 +1,537 @@
+#pragma once
+
+#include "vcl/base/base.hpp"
+#include "../buffer_stack/buffer_stack.hpp"
+#include "../grid/grid_3D/grid_3D.hpp"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+
+/* ************************************************** */
+/*           Header                                   */
+/* ************************************************** */
+
+namespace vcl
+{
+
+template <typename Grid> struct sparse_grid_3D_accessor;
+
+/** Sparse container for large 3D volumes where most voxels have the same background value (ex. narrow-band signed distance field, smoke density)
+ *
+ * Only the regions containing active voxels are stored, in dense leaves of 8x8x8 voxels (as the leaves of OpenVDB):
+ * - A leaf is referenced by an internal node covering 16x16x16 leaves (128^3 voxels), the internal nodes are found from their coordinates in a hash map (root).
+ * - A voxel is active once it has been set. Inactive voxels have the background value.
+ * - The voxels are indexed by integer coordinates (x,y,z) without fixed dimension, possibly negative (|x|,|y|,|z| < 2^27).
+ *
+ * Access:
+ * - value(p) / set(p, value): random access through the root, internal node and leaf.
+ * - get_accessor(): accessor caching the last visited leaf, to be preferred for successive accesses close to each other (stencils, interpolation, sweeps).
+ * - for_each_active(f): visit the active voxels only. parallel_for_each_leaf(f) / parallel_for_each_active(f): same, distributed over the leaves (see base/parallel).
+ *   The parallel functions must not create new leaves (no set() on an inactive leaf from f).
+ * - from_grid_3D / to_grid_3D: conversion from and to a dense grid_3D.
+ **/
+template <typename T>
+struct sparse_grid_3D
+{
+    using value_type = T;
+    using accessor = sparse_grid_3D_accessor<sparse_grid_3D<T>>;
+    using const_accessor = sparse_grid_3D_accessor<sparse_grid_3D<T> const>;
+
+    static constexpr int leaf_log2 = 3;     // leaf of 8^3 voxels
+    static constexpr int internal_log2 = 4; // internal node of 16^3 leaves
+    static constexpr size_t leaf_voxel_count = size_t(1) << (3*leaf_log2);
+    static constexpr size_t internal_child_count = size_t(1) << (3*internal_log2);
+
+    /** Dense block of 8x8x8 voxels and their active state */
+    struct leaf
+    {
+        /** Index of the voxel (0,0,0) of the leaf (multiple of 8) */
+        int3 origin;
+        /** Values of the voxels, x varies first */
+        std::array<T, leaf_voxel_count> value;
+        /** Bit k is set if the voxel k is active */
+        std::array<uint64_t, leaf_voxel_count/64> active;
+
+        /** Offset in the leaf of the voxel (x,y,z) - global coordinates */
+        static size_t offset(int3 const& p);
+        /** Global coordinates of the voxel at offset k */
+        int3 voxel(size_t k) const;
+
+        bool is_active(size_t k) const;
+        void set_active(size_t k, bool state);
+        size_t active_count() const;
+    };
+
+    /** Node referencing 16x16x16 leaves: index in leaves, or -1 when the leaf is not allocated */
+    struct internal_node
+    {
+        std::array<int, internal_child_count> child;
+    };
+
+    /** Value of the inactive voxels */
+    T background;
+    /** Allocated leaves (their address does not change when new leaves are added) */
+    std::deque<leaf> leaves;
+    /** Internal nodes */
+    std::vector<internal_node> internals;
+    /** Hash map from the coordinates of an internal node to its index in internals */
+    std::unordered_map<uint64_t, int> root;
+
+    /** Constructors */
+    sparse_grid_3D();                      // Empty grid with background T()
+    sparse_grid_3D(T const& background);   // Empty grid with the given background value
+
+    /** Build a sparse grid from the voxels of a dense grid that are not equal to the background value
+     * The voxel (x,y,z) of the dense grid is the voxel origin+(x,y,z) of the sparse grid. */
+    template <typename Allocator, typename Layout>
+    static sparse_grid_3D<T> from_grid_3D(grid_3D<T, Allocator, Layout> const& grid, T const& background, int3 const& origin = {0,0,0});
+    /** Dense copy of the box of the given dimension starting at the voxel origin */
+    grid_3D<T> to_grid_3D(int3 const& origin, size_t3 const& dimension) const;
+
+    /** Remove all voxels (the background value is kept) */
+    void clear();
+    /** Number of active voxels */
+    size_t active_count() const;
+    /** Number of allocated leaves */
+    size_t leaf_count() const;
+    /** Bounding box [p_min, p_max] of the active voxels (p_min > p_max if there is no active voxel) */
+    void active_bounding_box(int3& p_min, int3& p_max) const;
+
+    /** Random access (without cache) */
+    T value(int3 const& p) const;          // background value if the voxel is inactive
+    T value(int x, int y, int z) const;
+    bool is_active(int3 const& p) const;
+    void set(int3 const& p, T const& value); // the voxel becomes active, its leaf is allocated if needed
+    void set(int x, int y, int z, T const& value);
+    void deactivate(int3 const& p);          // the voxel gets the background value and becomes inactive
+
+    /** Leaf containing the voxel p (nullptr if it is not allocated) */
+    leaf* find_leaf(int3 const& p);
+    leaf const* find_leaf(int3 const& p) const;
+    /** Leaf containing the voxel p, allocated if needed */
+    leaf& touch_leaf(int3 const& p);
+
+    /** Accessor caching the last leaf (see sparse_grid_3D_accessor) */
+    accessor get_accessor();
+    const_accessor get_accessor() const;
+
+    /** Call f(int3 const& p, T& value) on all active voxels */
+    template <typename F> void for_each_active(F const& f);
+    template <typename F> void for_each_active(F const& f) const;
+    /** Call f(leaf&) on all leaves, distributed over the threads */
+    template <typename F> void parallel_for_each_leaf(F const& f);
+    /** Call f(int3 const& p, T& value) on all active voxels, distributed over the threads by leaves */
+    template <typename F> void parallel_for_each_active(F const& f);
+
+    /** Key of the internal node containing the voxel p in the root */
+    static uint64_t root_key(int3 const& p);
+    /** Index of the leaf containing p in its internal node */
+    static size_t internal_offset(int3 const& p);
+};
+
+/** Accessor on a sparse_grid_3D caching the last visited leaf and internal node
+ * A voxel in the same leaf as the previous access is reached directly, a voxel in the same internal node without the root hash map.
+ * Grid is sparse_grid_3D<T> (read and write) or sparse_grid_3D<T> const (read only).
+ * The accessor remains valid when new leaves are added, but not after sparse_grid_3D::clear(). */
+template <typename Grid>
+struct sparse_grid_3D_accessor
+{
+    using value_type = typename std::remove_const<Grid>::type::value_type;
+    using leaf_type = typename std::conditional<std::is_const<Grid>::value, typename Grid::leaf const, typename Grid::leaf>::type;
+
+    Grid* grid;
+    /** Last visited leaf (nullptr if none) */
+    leaf_type* cached_leaf;
+    /** Root key and index in grid->internals of the last visited internal node (index -1 if none) */
+    uint64_t cached_internal_key;
+    int cached_internal;
+
+    sparse_grid_3D_accessor(Grid& grid);
+
+    value_type value(int3 const& p);
+    value_type value(int x, int y, int z);
+    bool is_active(int3 const& p);
+    void set(int3 const& p, value_type const& value); // only for a non-const Grid
+    void set(int x, int y, int z, value_type const& value);
+
+    /** Leaf containing p, from the cache if possible (nullptr if not allocated) */
+    leaf_type* find_leaf(int3 const& p);
+};
+
+template <typename T> std::string type_str(sparse_grid_3D<T> const&);
+/** Size in bytes of the allocated leaves, internal nodes and root */
+template <typename T> size_t size_in_memory(sparse_grid_3D<T> const& grid);
+
+}
+
+
+
+/* ************************************************** */
+/*           IMPLEMENTATION                           */
+/* ************************************************** */
+
+namespace vcl
+{
+
+template <typename T>
+size_t sparse_grid_3D<T>::leaf::offset(int3 const& p)
+{
+    int const mask = (1 << leaf_log2) - 1;
+    return size_t(p.x & mask) + (size_t(p.y & mask) << leaf_log2) + (size_t(p.z & mask) << (2*leaf_log2));
+}
+
+template <typename T>
+int3 sparse_grid_3D<T>::leaf::voxel(size_t k) const
+{
+    int const mask = (1 << leaf_log2) - 1;
+    return { origin.x + int(k & mask), origin.y + int((k >> leaf_log2) & mask), origin.z + int(k >> (2*leaf_log2)) };
+}
+
+template <typename T>
+bool sparse_grid_3D<T>::leaf::is_active(size_t k) const
+{
+    return (active[k/64] >> (k%64)) & 1;
+}
+
+template <typename T>
+void sparse_grid_3D<T>::leaf::set_active(size_t k, bool state)
+{
+    if (state)
+        active[k/64] |= uint64_t(1) << (k%64);
+    else
+        active[k/64] &= ~(uint64_t(1) << (k%64));
+}
+
+template <typename T>
+size_t sparse_grid_3D<T>::leaf::active_count() const
+{
+    size_t count = 0;
+    for (uint64_t const word : active)
+        count += std::bitset<64>(word).count();
+    return count;
+}
+
+template <typename T>
+uint64_t sparse_grid_3D<T>::root_key(int3 const& p)
+{
+    int const shift = leaf_log2 + internal_log2;
+    uint64_t const mask = (uint64_t(1) << 21) - 1;
+    return (uint64_t(uint32_t(p.x >> shift)) & mask) | ((uint64_t(uint32_t(p.y >> shift)) & mask) << 21) | ((uint64_t(uint32_t(p.z >> shift)) & mask) << 42);
+}
+
+template <typename T>
+size_t sparse_grid_3D<T>::internal_offset(int3 const& p)
+{
+    int const mask = (1 << internal_log2) - 1;
+    return size_t((p.x >> leaf_log2) & mask) + (size_t((p.y >> leaf_log2) & mask) << internal_log2) + (size_t((p.z >> leaf_log2) & mask) << (2*internal_log2));
+}
+
+
+template <typename T>
+sparse_grid_3D<T>::sparse_grid_3D()
+    :background(), leaves(), internals(), root()
+{}
+
+template <typename T>
+sparse_grid_3D<T>::sparse_grid_3D(T const& background_arg)
+    :background(background_arg), leaves(), internals(), root()
+{}
+
+template <typename T>
+template <typename Allocator, typename Layout>
+sparse_grid_3D<T> sparse_grid_3D<T>::from_grid_3D(grid_3D<T, Allocator, Layout> const& grid, T const& background, int3 const& origin)
+{
+    using vcl::is_equal;
+    sparse_grid_3D<T> sparse(background);
+    accessor a = sparse.get_accessor();
+    for (size_t kz = 0; kz < grid.dimension.z; ++kz)
+        for (size_t ky = 0; ky < grid.dimension.y; ++ky)
+            for (size_t kx = 0; kx < grid.dimension.x; ++kx) {
+                T const& v = grid.at_unsafe(kx, ky, kz);
+                if (is_equal(v, background) == false)
+                    a.set(origin.x + int(kx), origin.y + int(ky), origin.z + int(kz), v);
+            }
+    return sparse;
+}
+
+template <typename T>
+grid_3D<T> sparse_grid_3D<T>::to_grid_3D(int3 const& origin, size_t3 const& dimension) const
+{
+    grid_3D<T> grid(dimension);
+    const_accessor a = get_accessor();
+    for (size_t kz = 0; kz < dimension.z; ++kz)
+        for (size_t ky = 0; ky < dimension.y; ++ky)
+            for (size_t kx = 0; kx < dimension.x; ++kx)
+                grid.at_unsafe(kx, ky, kz) = a.value(origin.x + int(kx), origin.y + int(ky), origin.z + int(kz));
+    return grid;
+}
+
+template <typename T>
+void sparse_grid_3D<T>::clear()
+{
+    leaves.clear();
+    internals.clear();
+    root.clear();
+}
+
+template <typename T>
+size_t sparse_grid_3D<T>::active_count() const
+{
+    size_t count = 0;
+    for (leaf const& l : leaves)
+        count += l.active_count();
+    return count;
+}
+
+template <typename T>
+size_t sparse_grid_3D<T>::leaf_count() const
+{
+    return leaves.size();
+}
+
+template <typename T>
+void sparse_grid_3D<T>::active_bounding_box(int3& p_min, int3& p_max) const
+{
+    int const max_int = std::numeric_limits<int>::max();
+    p_min = { max_int, max_int, max_int };
+    p_max = { -max_int, -max_int, -max_int };
+    for_each_active([&](int3 const& p, T const&) {
+        p_min = { std::min(p_min.x, p.x), std::min(p_min.y, p.y), std::min(p_min.z, p.z) };
+        p_max = { std::max(p_max.x, p.x), std::max(p_max.y, p.y), std::max(p_max.z, p.z) };
+    });
+}
+
+template <typename T>
+typename sparse_grid_3D<T>::leaf const* sparse_grid_3D<T>::find_leaf(int3 const& p) const
+{
+    auto const it = root.find(root_key(p));
+    if (it == root.end())
+        return nullptr;
+    int const index = internals[it->second].child[internal_offset(p)];
+    return index < 0 ? nullptr : &leaves[index];
+}
+
+template <typename T>
+typename sparse_grid_3D<T>::leaf* sparse_grid_3D<T>::find_leaf(int3 const& p)
+{
+    return const_cast<leaf*>(static_cast<sparse_grid_3D<T> const&>(*this).find_leaf(p));
+}
+
+template <typename T>
+typename sparse_grid_3D<T>::leaf& sparse_grid_3D<T>::touch_leaf(int3 const& p)
+{
+    auto it = root.find(root_key(p));
+    if (it == root.end()) {
+        internals.push_back(internal_node());
+        internals.back().child.fill(-1);
+        it = root.insert({ root_key(p), int(internals.size()-1) }).first;
+    }
+
+    int& index = internals[it->second].child[internal_offset(p)];
+    if (index < 0) {
+        int const mask = ~((1 << leaf_log2) - 1);
+        leaves.push_back(leaf());
+        leaf& l = leaves.back();
+        l.origin = { p.x & mask, p.y & mask, p.z & mask };
+        l.value.fill(background);
+        l.active.fill(0);
+        index = int(leaves.size()-1);
+    }
+    return leaves[index];
+}
+
+template <typename T>
+T sparse_grid_3D<T>::value(int3 const& p) const
+{
+    leaf const* l = find_leaf(p);
+    return l == nullptr ? background : l->value[leaf::offset(p)];
+}
+
+template <typename T>
+T sparse_grid_3D<T>::value(int x, int y, int z) const
+{
+    return value(int3{ x,y,z });
+}
+
+template <typename T>
+bool sparse_grid_3D<T>::is_active(int3 const& p) const
+{
+    leaf const* l = find_leaf(p);
+    return l != nullptr && l->is_active(leaf::offset(p));
+}
+
+template <typename T>
+void sparse_grid_3D<T>::set(int3 const& p, T const& value_arg)
+{
+    leaf& l = touch_leaf(p);
+    size_t const k = leaf::offset(p);
+    l.value[k] = value_arg;
+    l.set_active(k, true);
+}
+
+template <typename T>
+void sparse_grid_3D<T>::set(int x, int y, int z, T const& value_arg)
+{
+    set(int3{ x,y,z }, value_arg);
+}
+
+template <typename T>
+void sparse_grid_3D<T>::deactivate(int3 const& p)
+{
+    leaf* l = find_leaf(p);
+    if (l != nullptr) {
+        size_t const k = leaf::offset(p);
+        l->value[k] = background;
+        l->set_active(k, false);
+    }
+}
+
+template <typename T>
+typename sparse_grid_3D<T>::accessor sparse_grid_3D<T>::get_accessor()
+{
+    return accessor(*this);
+}
+
+template <typename T>
+typename sparse_grid_3D<T>::const_accessor sparse_grid_3D<T>::get_accessor() const
+{
+    return const_accessor(*this);
+}
+
+namespace detail
+{
+    // Call f(p, value) on the active voxels of a leaf
+    template <typename Leaf, typename F> void sparse_grid_leaf_for_each_active(Leaf& l, F const& f)
+    {
+        for (size_t w = 0; w < l.active.size(); ++w) {
+            uint64_t const word = l.active[w];
+            if (word == 0)
+                continue;
+            for (size_t b = 0; b < 64; ++b)
+                if ((word >> b) & 1)
+                    f(l.voxel(64*w+b), l.value[64*w+b]);
+        }
+    }
+}
+
+template <typename T>
+template <typename F>
+void sparse_grid_3D<T>::for_each_active(F const& f)
+{
+    for (leaf& l : leaves)
+        detail::sparse_grid_leaf_for_each_active(l, f);
+}
+
+template <typename T>
+template <typename F>
+void sparse_grid_3D<T>::for_each_active(F const& f) const
+{
+    for (leaf const& l : leaves)
+        detail::sparse_grid_leaf_for_each_active(l, f);
+}
+
+template <typename T>
+template <typename F>
+void sparse_grid_3D<T>::parallel_for_each_leaf(F const& f)
+{
+    parallel_for(leaves.size(), [&](size_t k) { f(leaves[k]); }, 4);
+}
+
+template <typename T>
+template <typename F>
+void sparse_grid_3D<T>::parallel_for_each_active(F const& f)
+{
+    parallel_for_each_leaf([&](leaf& l) { detail::sparse_grid_leaf_for_each_active(l, f); });
+}
+
+
+
+template <typename Grid>
+sparse_grid_3D_accessor<Grid>::sparse_grid_3D_accessor(Grid& grid_arg)
+    :grid(&grid_arg), cached_leaf(nullptr), cached_internal_key(0), cached_internal(-1)
+{}
+
+template <typename Grid>
+typename sparse_grid_3D_accessor<Grid>::leaf_type* sparse_grid_3D_accessor<Grid>::find_leaf(int3 const& p)
+{
+    int const mask = ~((1 << Grid::leaf_log2) - 1);
+    if (cached_leaf != nullptr && cached_leaf->origin.x == (p.x & mask) && cached_leaf->origin.y == (p.y & mask) && cached_leaf->origin.z == (p.z & mask))
+        return cached_leaf;
+
+    uint64_t const key = Grid::root_key(p);
+    if (cached_internal < 0 || cached_internal_key != key) {
+        auto const it = grid->root.find(key);
+        if (it == grid->root.end())
+            return nullptr;
+        cached_internal_key = key;
+        cached_internal = it->second;
+    }
+
+    int const index = grid->internals[cached_internal].child[Grid::internal_offset(p)];
+    if (index < 0)
+        return nullptr;
+    cached_leaf = &grid->leaves[index];
+    return cached_leaf;
+}
+
+template <typename Grid>
+typename sparse_grid_3D_accessor<Grid>::value_type sparse_grid_3D_accessor<Grid>::value(int3 const& p)
+{
+    leaf_type* l = find_leaf(p);
+    return l == nullptr ? grid->background : l->value[Grid::leaf::offset(p)];
+}
+
+template <typename Grid>
+typename sparse_grid_3D_accessor<Grid>::value_type sparse_grid_3D_accessor<Grid>::value(int x, int y, int z)
+{
+    return value(int3{ x,y,z });
+}
+
+template <typename Grid>
+bool sparse_grid_3D_accessor<Grid>::is_active(int3 const& p)
+{
+    leaf_type* l = find_leaf(p);
+    return l != nullptr && l->is_active(Grid::leaf::offset(p));
+}
+
+template <typename Grid>
+void sparse_grid_3D_accessor<Grid>::set(int3 const& p, value_type const& value_arg)
+{
+    leaf_type* l = find_leaf(p);
+    if (l == nullptr) {
+        l = &grid->touch_leaf(p);
+        cached_leaf = l;
+    }
+    size_t const k = Grid::leaf::offset(p);
+    l->value[k] = value_arg;
+    l->set_active(k, true);
+}
+
+template <typename Grid>
+void sparse_grid_3D_accessor<Grid>::set(int x, int y, int z, value_type const& value_arg)
+{
+    set(int3{ x,y,z }, value_arg);
+}
+
+
+template <typename T> std::string type_str(sparse_grid_3D<T> const&)
+{
+    using vcl::type_str;
+    return "sparse_grid_3D<" + type_str(T()) + ">";
+}
+
+template <typename T> size_t size_in_memory(sparse_grid_3D<T> const& grid)
+{
+    using leaf = typename sparse_grid_3D<T>::leaf;
+    using internal_node = typename sparse_grid_3D<T>::internal_node;
+    size_t const root_entry = sizeof(std::pair<uint64_t const, int>) + 2*sizeof(void*); // node of the hash map and its bucket
+    return sizeof(grid) + grid.leaves.size()*sizeof(leaf) + grid.internals.capacity()*sizeof(internal_node) + grid.root.size()*root_entry;
+}
+
+}
@@ -0,0 +1,153 @@
+#include "benchmark_sparse_grid_3D.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/base/test/benchmark_timing.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	struct lcg
+	{
+		uint64_t state = 12345;
+		uint32_t operator()() { state = state*6364136223846793005ull + 1442695040888963407ull; return uint32_t(state >> 32); }
+	};
+
+	static double megabytes(size_t bytes)
+	{
+		return double(bytes) / (1024.0*1024.0);
+	}
+
+	// Signed distance to a sphere of radius R centered in the domain [0,N]^3, stored in a narrow band of +/- band voxels
+	static sparse_grid_3D<float> narrow_band_sphere(int N, float band)
+	{
+		float const R = 0.4f*N, c = 0.5f*N;
+		sparse_grid_3D<float> g(band);
+		auto a = g.get_accessor();
+		for (int z = 0; z < N; ++z) {
+			float const dz = z - c;
+			for (int y = 0; y < N; ++y) {
+				float const dy = y - c;
+				float const r2 = R*R - dy*dy - dz*dz; // x range close to the sphere from its squared radius
+				if (r2 < -2*R*band)
+					continue;
+				for (int x = 0; x < N; ++x) {
+					float const dx = x - c;
+					float const d = std::sqrt(dx*dx + dy*dy + dz*dz) - R;
+					if (std::abs(d) < band)
+						a.set(x, y, z, d);
+				}
+			}
+		}
+		return g;
+	}
+
+	// 7-point laplacian on the active voxels, reading the neighbors through Access (sparse grid, accessor, or dense grid)
+	template <typename Access> static float laplacian_active(sparse_grid_3D<float> const& g, Access& access)
+	{
+		float s = 0.0f;
+		g.for_each_active([&](int3 const& p, float const& v) {
+			s += access(p.x-1, p.y, p.z) + access(p.x+1, p.y, p.z) + access(p.x, p.y-1, p.z) + access(p.x, p.y+1, p.z)
+				+ access(p.x, p.y, p.z-1) + access(p.x, p.y, p.z+1) - 6*v;
+		});
+		return s;
+	}
+
+	static void benchmark_narrow_band(int N, bool with_dense, float& checksum)
+	{
+		float const band = 3.0f;
+		sparse_grid_3D<float> g;
+		double const t_build = timing([&]() { g = narrow_band_sphere(N, band); }, 1);
+		size_t const dense_bytes = size_t(N)*N*N*sizeof(float);
+
+		std::cout << "Narrow-band SDF of a sphere, domain " << N << "^3, band +/-" << band << " voxels" << std::endl;
+		std::cout << "  active voxels       : " << g.active_count() << " (" << 100.0*g.active_count()/(double(N)*N*N) << "% of the domain), " << g.leaf_count() << " leaves" << std::endl;
+		std::cout << "  memory sparse/dense : " << megabytes(size_in_memory(g)) << " MB / " << megabytes(dense_bytes) << " MB" << std::endl;
+		std::cout << "  build (accessor)    : " << t_build << " ms" << std::endl;
+
+		// Random access at voxels of the band
+		buffer<int3> queries;
+		{
+			buffer<int3> active;
+			g.for_each_active([&](int3 const& p, float const&) { active.push_back(p); });
+			lcg random;
+			size_t const N_query = 4*1024*1024;
+			queries.resize(N_query);
+			for (size_t k = 0; k < N_query; ++k)
+				queries[k] = active[random() % active.size()];
+		}
+		auto const& cg = g;
+		std::cout << "  random access " << queries.size()/(1024*1024) << "M queries" << std::endl;
+		std::cout << "    value()           : " << timing([&]() { for (int3 const& p : queries) checksum += cg.value(p); }, 3) << " ms" << std::endl;
+		std::cout << "    accessor          : " << timing([&]() { auto a = cg.get_accessor(); for (int3 const& p : queries) checksum += a.value(p); }, 3) << " ms" << std::endl;
+
+		// Neighborhood access (stencil) on the active voxels
+		std::cout << "  laplacian on the active voxels" << std::endl;
+		auto direct = [&](int x, int y, int z) { return cg.value(x, y, z); };
+		std::cout << "    value()           : " << timing([&]() { checksum += laplacian_active(g, direct); }, 3) << " ms" << std::endl;
+		std::cout << "    accessor          : " << timing([&]() { auto a = cg.get_accessor(); auto cached = [&](int x, int y, int z) { return a.value(x, y, z); }; checksum += laplacian_active(g, cached); }, 3) << " ms" << std::endl;
+
+		// Iteration over the active voxels
+		std::cout << "  sum of the band" << std::endl;
+		std::cout << "    for_each_active   : " << timing([&]() { float s = 0; g.for_each_active([&](int3 const&, float const& v) { s += v; }); checksum += s; }, 3) << " ms" << std::endl;
+
+		if (with_dense) {
+			grid_3D<float> dense = g.to_grid_3D({ 0,0,0 }, size_t3{ size_t(N), size_t(N), size_t(N) });
+			auto dense_access = [&](int x, int y, int z) { return dense.at_unsafe(size_t(x), size_t(y), size_t(z)); };
+			std::cout << "  dense grid_3D" << std::endl;
+			std::cout << "    random access     : " << timing([&]() { for (int3 const& p : queries) checksum += dense_access(p.x, p.y, p.z); }, 3) << " ms" << std::endl;
+			std::cout << "    laplacian         : " << timing([&]() { checksum += laplacian_active(g, dense_access); }, 3) << " ms" << std::endl;
+			std::cout << "    sum of the band   : " << timing([&]() {
+				float s = 0;
+				for (size_t k = 0; k < dense.data.size(); ++k)
+					if (std::abs(dense.data.at_unsafe(k)) < band)
+						s += dense.data.at_unsafe(k);
+				checksum += s;
+			}, 3) << " ms" << std::endl;
+		}
+	}
+
+	// Smoke density in a rising plume (cylinder along y) occupying a small part of the domain: decay of the density at each time step
+	static void benchmark_plume(int N, float& checksum)
+	{
+		float const radius = 0.08f*N, c = 0.5f*N;
+		grid_3D<float> dense(size_t3{ size_t(N), size_t(N), size_t(N) });
+		dense.fill(0.0f);
+		for (int z = 0; z < N; ++z)
+			for (int y = 0; y < 3*N/4; ++y)
+				for (int x = 0; x < N; ++x) {
+					float const r = std::sqrt((x-c)*(x-c) + (z-c)*(z-c)) * (1.0f + 0.5f*y/N);
+					if (r < radius)
+						dense(x, y, z) = 1.0f - r/radius + 0.01f;
+				}
+		sparse_grid_3D<float> g = sparse_grid_3D<float>::from_grid_3D(dense, 0.0f);
+
+		std::cout << "Smoke plume, domain " << N << "^3" << std::endl;
+		std::cout << "  active voxels       : " << g.active_count() << " (" << 100.0*g.active_count()/(double(N)*N*N) << "% of the domain), " << g.leaf_count() << " leaves" << std::endl;
+		std::cout << "  memory sparse/dense : " << megabytes(size_in_memory(g)) << " MB / " << megabytes(size_in_memory(dense.data)) << " MB" << std::endl;
+		std::cout << "  density decay (one step)" << std::endl;
+		std::cout << "    dense loop              : " << timing([&]() { for (float& v : dense) v *= 0.99f; checksum += dense(N/2, N/2, N/2); }, 5) << " ms" << std::endl;
+		std::cout << "    dense parallel_for_range: " << timing([&]() {
+			parallel_for_range(dense.size(), [&](size_t k_begin, size_t k_end) { for (size_t k = k_begin; k < k_end; ++k) dense.data.at_unsafe(k) *= 0.99f; });
+			checksum += dense(N/2, N/2, N/2);
+		}, 5) << " ms" << std::endl;
+		std::cout << "    for_each_active         : " << timing([&]() { g.for_each_active([](int3 const&, float& v) { v *= 0.99f; }); checksum += g.value(N/2, N/2, N/2); }, 5) << " ms" << std::endl;
+		std::cout << "    parallel_for_each_active: " << timing([&]() { g.parallel_for_each_active([](int3 const&, float& v) { v *= 0.99f; }); checksum += g.value(N/2, N/2, N/2); }, 5) << " ms" << std::endl;
+		std::cout << "    parallel_for_each_leaf  : " << timing([&]() { g.parallel_for_each_leaf([](sparse_grid_3D<float>::leaf& l) { for (float& v : l.value) v *= 0.99f; }); checksum += g.value(N/2, N/2, N/2); }, 5) << " ms" << std::endl;
+	}
+
+	void benchmark_sparse_grid_3D()
+	{
+		float checksum = 0.0f;
+		benchmark_narrow_band(256, true, checksum);
+		benchmark_narrow_band(1024, false, checksum);
+		benchmark_plume(256, checksum);
+		std::cout << "(checksum " << checksum << ")" << std::endl;
+	}
+}
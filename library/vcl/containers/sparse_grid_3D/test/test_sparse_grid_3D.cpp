@@ -0,0 +1,110 @@
+#include "test_sparse_grid_3D.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+
+#include <set>
+#include <tuple>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_sparse_grid_3D()
+	{
+		// Random access, background value and active state
+		{
+			sparse_grid_3D<float> g(3.0f);
+			assert_vcl_no_msg(g.leaf_count() == 0 && g.active_count() == 0);
+			assert_vcl_no_msg(is_equal(g.value(5, 6, 7), 3.0f));
+
+			g.set(5, 6, 7, 1.0f);
+			g.set(int3{ -1,-9,200 }, 2.0f);
+			g.set(4, 6, 7, 0.5f); // same leaf as (5,6,7)
+			assert_vcl_no_msg(g.leaf_count() == 2 && g.active_count() == 3);
+			assert_vcl_no_msg(is_equal(g.value(5, 6, 7), 1.0f) && is_equal(g.value(-1, -9, 200), 2.0f) && is_equal(g.value(4, 6, 7), 0.5f));
+			assert_vcl_no_msg(g.is_active(int3{ 5,6,7 }) && !g.is_active(int3{ 6,6,7 }) && is_equal(g.value(6, 6, 7), 3.0f));
+			assert_vcl_no_msg(g.find_leaf(int3{ -1,-9,200 })->origin.x == -8 && g.find_leaf(int3{ -1,-9,200 })->origin.y == -16);
+
+			g.deactivate(int3{ 5,6,7 });
+			assert_vcl_no_msg(!g.is_active(int3{ 5,6,7 }) && is_equal(g.value(5, 6, 7), 3.0f) && g.active_count() == 2);
+
+			int3 p_min, p_max;
+			g.active_bounding_box(p_min, p_max);
+			assert_vcl_no_msg(p_min.x == -1 && p_min.y == -9 && p_min.z == 7 && p_max.x == 4 && p_max.y == 6 && p_max.z == 200);
+
+			g.clear();
+			assert_vcl_no_msg(g.leaf_count() == 0 && g.active_count() == 0 && is_equal(g.value(-1, -9, 200), 3.0f));
+		}
+
+		// Accessor gives the same values as the direct access
+		{
+			sparse_grid_3D<int> g(-1);
+			auto a = g.get_accessor();
+			for (int z = -20; z < 20; z += 3)
+				for (int y = -20; y < 20; y += 2)
+					for (int x = -20; x < 20; ++x)
+						a.set(x, y, z, x + 100*y + 10000*z);
+
+			sparse_grid_3D<int> const& cg = g;
+			auto ca = cg.get_accessor();
+			for (int z = -25; z < 25; ++z)
+				for (int y = -25; y < 25; ++y)
+					for (int x = -25; x < 25; ++x) {
+						int const expected = (x >= -20 && x < 20 && y >= -20 && y < 20 && z >= -20 && z < 20 && (y+20)%2 == 0 && (z+20)%3 == 0) ? x + 100*y + 10000*z : -1;
+						assert_vcl_no_msg(ca.value(x, y, z) == expected && cg.value(x, y, z) == expected);
+						assert_vcl_no_msg(ca.is_active(int3{ x,y,z }) == (expected != -1));
+					}
+		}
+
+		// Iteration over the active voxels only, sequential and parallel
+		{
+			sparse_grid_3D<float> g(0.0f);
+			std::set<std::tuple<int, int, int>> expected;
+			for (int k = 0; k < 500; ++k) {
+				int3 const p = { (k*37)%301 - 150, (k*91)%157 - 20, (k*13)%64 };
+				g.set(p, 1.0f);
+				expected.insert(std::make_tuple(p.x, p.y, p.z));
+			}
+			assert_vcl_no_msg(g.active_count() == expected.size());
+
+			std::set<std::tuple<int, int, int>> visited;
+			g.for_each_active([&](int3 const& p, float& v) { visited.insert(std::make_tuple(p.x, p.y, p.z)); v = float(p.x); });
+			assert_vcl_no_msg(visited == expected);
+
+			g.parallel_for_each_active([](int3 const& p, float& v) { v += float(p.y); });
+			g.for_each_active([](int3 const& p, float& v) { assert_vcl_no_msg(is_equal(v, float(p.x + p.y))); });
+
+			g.parallel_for_each_leaf([](sparse_grid_3D<float>::leaf& l) { l.value.fill(2.0f); });
+			assert_vcl_no_msg(is_equal(g.value(std::get<0>(*expected.begin()), std::get<1>(*expected.begin()), std::get<2>(*expected.begin())), 2.0f));
+		}
+
+		// Conversion from and to grid_3D
+		{
+			grid_3D<float> dense(size_t3{ 20,11,9 });
+			dense.fill(0.0f);
+			dense(1, 2, 3) = 4.0f;
+			dense(19, 10, 8) = -1.0f;
+			dense(9, 0, 0) = 2.0f;
+
+			sparse_grid_3D<float> g = sparse_grid_3D<float>::from_grid_3D(dense, 0.0f, int3{ -10,0,0 });
+			assert_vcl_no_msg(g.active_count() == 3);
+			assert_vcl_no_msg(is_equal(g.value(-9, 2, 3), 4.0f) && is_equal(g.value(9, 10, 8), -1.0f) && is_equal(g.value(-1, 0, 0), 2.0f));
+
+			grid_3D<float> back = g.to_grid_3D(int3{ -10,0,0 }, dense.dimension);
+			assert_vcl_no_msg(is_equal(back, dense));
+
+			grid_3D<float> shifted = g.to_grid_3D(int3{ -9,2,3 }, size_t3{ 2,1,1 });
+			assert_vcl_no_msg(is_equal(shifted(0, 0, 0), 4.0f) && is_equal(shifted(1, 0, 0), 0.0f));
+		}
+
+		// Memory: a single voxel allocates a single leaf
+		{
+			sparse_grid_3D<float> g;
+			g.set(1000, 1000, 1000, 1.0f);
+			assert_vcl_no_msg(size_in_memory(g) < 64*1024);
+			assert_vcl_no_msg(type_str(g) == "sparse_grid_3D<float>");
+		}
+	}
+}
@@ -2,9 +2,12 @@
 
 #include "shading_parameters/shading_parameters.hpp"
 #include "mesh_drawable/mesh_drawable.hpp"
+#include "mesh_drawable_resource/mesh_drawable_resource.hpp"
 #include "mesh_wireframe_drawable/mesh_wireframe_drawable.hpp"
 #include "mesh_normal_drawable/mesh_normal_drawable.hpp"
 #include "curve_drawable/curve_drawable.hpp"
 #include "segments_drawable/segments_drawable.hpp"
+#include "points_drawable/points_drawable.hpp"
 #include "trajectory_drawable/trajectory_drawable.hpp"
-#include "hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
\ No newline at end of file
+#include "hierarchy_mesh_drawable/hierarchy_mesh_drawable.hpp"
+#include "terrain_drawable/terrain_drawable.hpp"
\ No newline at end of file
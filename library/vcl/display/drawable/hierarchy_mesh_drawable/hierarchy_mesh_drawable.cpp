@@ -1,26 +1,86 @@
 #include "vcl/base/base.hpp"
 #include "hierarchy_mesh_drawable.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace vcl
 {
 
-    static void assert_valid_hierarchy(hierarchy_mesh_drawable const& hierarchy);
+    static int resolve_parent_index(hierarchy_mesh_drawable const& hierarchy, size_t k);
+    static void resolve_hierarchy(hierarchy_mesh_drawable& hierarchy);
+    static mesh_drawable_handle node_geometry(hierarchy_mesh_drawable const& hierarchy, mesh_drawable const& drawable);
 
     void hierarchy_mesh_drawable::add(hierarchy_mesh_drawable_node const& node)
     {
+        if(parent_index.size()!=elements.size())
+            resolve_hierarchy(*this);
+
+        if(name_map.find(node.name)!=name_map.end()) {
+            std::cerr<<"Error: Hierarchy not valid - element ("<<node.name<<") is already defined in the hierarchy"<<std::endl;
+            abort();
+        }
+        if(elements.size()>0 && node.name==elements[0].name_parent) {
+            std::cerr<<"Error: Hierarchy not valid - name of the root node ("<<node.name<<") cannot be an element of the hierarchy"<<std::endl;
+            abort();
+        }
+
         name_map[node.name] = static_cast<int>(elements.size());
         elements.push_back(node);
-        assert_valid_hierarchy(*this);
+
+        // The parent is resolved once: the update only follows the stored indices
+        parent_index.push_back(resolve_parent_index(*this, elements.size()-1));
+        local_transform_cache.push_back(node.transform);
+        global_transform_cache.push_back(affine_rts());
+        dirty.push_back(1);
     }
+
     void hierarchy_mesh_drawable::add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, vec3 const& translate)
     {
-        hierarchy_mesh_drawable_node const node = {element, name, name_parent, affine_rts(rotation(),translate,1.0f)};
-        add(node);
+        add(element, name, name_parent, affine_rts(rotation(),translate,1.0f));
     }
     void hierarchy_mesh_drawable::add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, affine_rts const& transform)
     {
-        hierarchy_mesh_drawable_node const node = {element, name, name_parent, transform};
+        hierarchy_mesh_drawable_node node(node_geometry(*this, element), mesh_drawable_material(element), name, name_parent, transform);
+        node.element.transform = element.transform;
         add(node);
+        if(element.vao!=0)
+            vao_node_index[element.vao] = static_cast<int>(elements.size()-1);
+    }
+    void hierarchy_mesh_drawable::add(mesh_drawable_handle const& geometry, mesh_drawable_material const& material, std::string const& name, std::string const& name_parent, affine_rts const& transform)
+    {
+        hierarchy_mesh_drawable_node const node(geometry, material, name, name_parent, transform);
+        add(node);
+    }
+
+    void hierarchy_mesh_drawable::clear()
+    {
+        for(hierarchy_mesh_drawable_node& node : elements)
+            node.geometry.clear();
+
+        elements.clear();
+        name_map.clear();
+        vao_node_index.clear();
+        parent_index.clear();
+        local_transform_cache.clear();
+        global_transform_cache.clear();
+        dirty.clear();
+        updated_count = 0;
+    }
+
+    // Geometry of a node added from a mesh_drawable: a mesh_drawable added several times shares a single resource between its nodes.
+    //  All the ids of the last node added with the same VAO are compared, not only the VAO: OpenGL reuses the ids of deleted buffers.
+    //  As these resources don't own the buffers, a resource with the same ids is identical to a new one.
+    static mesh_drawable_handle node_geometry(hierarchy_mesh_drawable const& hierarchy, mesh_drawable const& drawable)
+    {
+        auto const it = hierarchy.vao_node_index.find(drawable.vao);
+        if(it!=hierarchy.vao_node_index.end()) {
+            mesh_drawable_handle const& geometry = hierarchy.elements[it->second].geometry;
+            if(!geometry.empty() && !geometry->owns_buffers && geometry->vao==drawable.vao
+                && geometry->number_triangles==drawable.number_triangles && geometry->vbo==drawable.vbo)
+                return geometry;
+        }
+        return mesh_drawable_handle(drawable);
     }
 
     hierarchy_mesh_drawable_node& hierarchy_mesh_drawable::operator[](const std::string& name)
@@ -56,107 +116,128 @@ namespace vcl
     }
 
 
+    int hierarchy_mesh_drawable::index(std::string const& name) const
+    {
+        auto it = name_map.find(name);
+        if(it==name_map.end())
+            return -1;
+        return it->second;
+    }
+
     void hierarchy_mesh_drawable::update_local_to_global_coordinates()
     {
+        updated_count = 0;
         if(elements.size()==0)
             return ;
 
-        assert_valid_hierarchy(*this);
+        // The elements were modified without add(): resolve the hierarchy again
+        if(parent_index.size()!=elements.size())
+            resolve_hierarchy(*this);
 
-        std::string const& name_root_parent = elements[0].name_parent;
+        const size_t N = elements.size();
+        int const* parent = parent_index.data.data();
+        affine_rts* local = local_transform_cache.data.data();
+        affine_rts* global = global_transform_cache.data.data();
+        unsigned char* is_dirty = dirty.data.data();
 
-        const size_t N = static_cast<int>(elements.size());
+        // Parents are stored before their children: a single pass propagates the changes down the subtrees
         for(size_t k=0; k<N; ++k)
         {
             hierarchy_mesh_drawable_node& element = elements[k];
+            int const k_parent = parent[k];
 
-            std::string const parent_name = element.name_parent;
+            bool const changed = std::memcmp(&element.transform, &local[k], sizeof(affine_rts))!=0;
+            bool const parent_dirty = k_parent>=0 && is_dirty[k_parent];
+            if( !(changed || parent_dirty || is_dirty[k]) )
+                continue;
 
-            // Case of root element (or same parent) - local = global
-            if( parent_name == name_root_parent ) {
-                element.global_transform = element.transform;
-            }
+            is_dirty[k] = 1;
+            local[k] = element.transform;
+
+            // Case of root element - local = global
+            if( k_parent<0 )
+                global[k] = local[k];
             // Else apply hierarchical transformation
             else
-            {
-                affine_rts const& local = element.transform;
-                affine_rts const& global_parent = (*this)[parent_name].global_transform;
+                global[k] = global[k_parent] * local[k];
 
-                element.global_transform = global_parent * local;
-            }
+            element.global_transform = global[k];
+            ++updated_count;
         }
-    }
 
+        std::fill(dirty.data.begin(), dirty.data.end(), static_cast<unsigned char>(0));
+    }
 
-    void assert_valid_hierarchy(hierarchy_mesh_drawable const& hierarchy)
-{
-    if(hierarchy.elements.size()==0)
-        return ;
 
+    int resolve_parent_index(hierarchy_mesh_drawable const& hierarchy, size_t k)
     {
-        // Check that elements and name_map have the same size
-        const size_t N1 = hierarchy.elements.size();
-        const size_t N2 = hierarchy.name_map.size();
-        if(N1!=N2) {
-            std::cerr<<"Error: Hierarchy not valid - Number of element ("<<N1<<") != Name_map.size() ("<<N2<<")"<<std::endl;
-            abort();
-        }
-    }
+        std::string const& name = hierarchy.elements[k].name;
+        std::string const& parent_name = hierarchy.elements[k].name_parent;
 
-    {
-        // Check that the name of the parent of root node doesn't belong to the hierarchy
-        const std::string root_name_parent = hierarchy.elements[0].name_parent;
-        const auto it = hierarchy.name_map.find(root_name_parent);
-        if(it!=hierarchy.name_map.end()) {
-            std::cerr<<"Error: Hierarchy not valid - name of the root node ("<<root_name_parent<<") cannot be an element of the hierarchy"<<std::endl;
+        // Case of root element (or same parent as the first root)
+        if( k==0 || parent_name==hierarchy.elements[0].name_parent )
+            return -1;
+
+        // Parents must be defined before their children
+        auto const it = hierarchy.name_map.find(parent_name);
+        if(it==hierarchy.name_map.end() || it->second<0 || size_t(it->second)>=k)
+        {
+            std::cerr<<"Error: Hierarchy not valid"<<std::endl;
+            std::cerr<<"Element ("<<name<<","<<k<<") has parent name ("<<parent_name<<") used before being defined"<<std::endl;
             abort();
         }
+        return it->second;
     }
 
+    void resolve_hierarchy(hierarchy_mesh_drawable& hierarchy)
     {
-        // Check that all names stored in map are designating the corresponding elements
-        for(const auto& e : hierarchy.name_map)
         {
-            const std::string& name = e.first;
-            const int index = e.second;
-
-            if(index>=int(hierarchy.elements.size()) || index<0)
-            {
-                std::cerr<<"Error: Hierarchy not valid - Incorrect index stored in name_map: "<<name<<";"<<index<<std::endl;
+            // Check that elements and name_map have the same size
+            const size_t N1 = hierarchy.elements.size();
+            const size_t N2 = hierarchy.name_map.size();
+            if(N1!=N2) {
+                std::cerr<<"Error: Hierarchy not valid - Number of element ("<<N1<<") != Name_map.size() ("<<N2<<")"<<std::endl;
                 abort();
             }
+        }
 
-            const hierarchy_mesh_drawable_node& designated_element = hierarchy.elements[index];
-            if(designated_element.name != name)
+        {
+            // Check that all names stored in map are designating the corresponding elements
+            for(const auto& e : hierarchy.name_map)
             {
-                std::cerr<<"Error: Hierarchy not valid - Incoherent name between map ("<<name<<";"<<index<<") and element ("<<designated_element.name<<") "<<std::endl;
-                abort();
+                const std::string& name = e.first;
+                const int index = e.second;
+
+                if(index>=int(hierarchy.elements.size()) || index<0)
+                {
+                    std::cerr<<"Error: Hierarchy not valid - Incorrect index stored in name_map: "<<name<<";"<<index<<std::endl;
+                    abort();
+                }
+
+                const hierarchy_mesh_drawable_node& designated_element = hierarchy.elements[index];
+                if(designated_element.name != name)
+                {
+                    std::cerr<<"Error: Hierarchy not valid - Incoherent name between map ("<<name<<";"<<index<<") and element ("<<designated_element.name<<") "<<std::endl;
+                    abort();
+                }
             }
         }
-    }
 
-    {
-        // Check that all parents are defined before their children (excepted for root parent)
-        std::set<std::string> parent_names_visited;
-        parent_names_visited.insert(hierarchy.elements[0].name_parent);
         const size_t N = hierarchy.elements.size();
+        if(N>0 && hierarchy.name_map.find(hierarchy.elements[0].name_parent)!=hierarchy.name_map.end()) {
+            std::cerr<<"Error: Hierarchy not valid - name of the root node ("<<hierarchy.elements[0].name_parent<<") cannot be an element of the hierarchy"<<std::endl;
+            abort();
+        }
+
+        hierarchy.parent_index.resize(N);
         for(size_t k=0; k<N; ++k)
-        {
-            const std::string& name = hierarchy.elements[k].name;
-            const std::string& parent_name = hierarchy.elements[k].name_parent;
-            if(parent_names_visited.find(parent_name)==parent_names_visited.end())
-            {
+            hierarchy.parent_index[k] = resolve_parent_index(hierarchy, k);
 
-                std::cerr<<"Error: Hierarchy not valid"<<std::endl;
-                std::cerr<<"Element ("<<name<<","<<k<<") has parent name ("<<parent_name<<") used before being defined"<<std::endl;
-                abort();
-            }
-            else
-                parent_names_visited.insert(name);
-        }
+        // All global transforms are recomputed at the next update
+        hierarchy.local_transform_cache.resize(N);
+        hierarchy.global_transform_cache.resize(N);
+        hierarchy.dirty.resize(N);
+        std::fill(hierarchy.dirty.data.begin(), hierarchy.dirty.data.end(), static_cast<unsigned char>(1));
     }
 
-
 }
-
-}
\ No newline at end of file
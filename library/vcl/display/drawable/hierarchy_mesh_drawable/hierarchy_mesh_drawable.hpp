@@ -1,6 +1,7 @@
 #pragma once
 
 #include "hierarchy_mesh_drawable_node/hierarchy_mesh_drawable_node.hpp"
+#include "vcl/containers/buffer/buffer.hpp"
 
 #include <map>
 #include <vector>
@@ -12,19 +13,44 @@ namespace vcl
 		std::map<std::string, int> name_map;
 		std::vector<hierarchy_mesh_drawable_node> elements;
 
+		/** Internal data - Index of the parent of each node in elements (-1 for the root nodes), resolved once in add()
+		*  Parents are always added before their children: elements are stored in topological order. */
+		buffer<int> parent_index;
+		/** Internal data - Local transforms used at the last update, and the corresponding global transforms (stored contiguously) */
+		buffer<affine_rts> local_transform_cache;
+		buffer<affine_rts> global_transform_cache;
+		/** Internal data - Nodes whose global transform must be recomputed at the next update (new nodes) */
+		buffer<unsigned char> dirty;
+		/** Internal data - Index of the last node added from a mesh_drawable with a given VAO id: a mesh_drawable added again shares the resource of this node
+		*  if all its buffer ids are the same (the ids of deleted buffers are reused by OpenGL) */
+		std::map<GLuint, int> vao_node_index;
+
 		// Add new node to the hierarchy
 		// Note: Parent node is expected to be already present in the hierarchy
 		// The name of each node must be unique in the hierarchy
+		// The parent is resolved once when the node is added (modifying name_parent afterwards has no effect)
 		void add(hierarchy_mesh_drawable_node const& node);
 		void add(mesh_drawable const& element, std::string const& name, std::string const& name_parent="global_frame", vec3 const& translate=vec3());
 		void add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, affine_rts const& transform);
+		// Add a node sharing the GPU buffers of geometry, with its own material
+		// Nodes added from a mesh_drawable refer to its buffers without owning them: the nodes added from the same mesh_drawable share a single resource
+		void add(mesh_drawable_handle const& geometry, mesh_drawable_material const& material, std::string const& name, std::string const& name_parent="global_frame", affine_rts const& transform=affine_rts());
+
+		// Remove all the nodes and release their geometry (the buffers of a mesh_drawable_handle are deleted once no other handle refers to them)
+		void clear();
 
 		// Get node by name
 		hierarchy_mesh_drawable_node& operator[](std::string const& name);
 		hierarchy_mesh_drawable_node const& operator[](std::string const& name) const;
 
 		// Fill global coordinates of the nodes - must be called before draw
+		// Only the nodes whose local transform changed since the last call, and their descendants, are recomputed
 		void update_local_to_global_coordinates();
+
+		// Index of a node in elements (-1 if the name doesn't belong to the hierarchy)
+		int index(std::string const& name) const;
+		// Number of global transforms recomputed by the last call to update_local_to_global_coordinates
+		size_t updated_count = 0;
 	};
 
 
@@ -4,17 +4,36 @@
 
 namespace vcl {
 
+hierarchy_mesh_drawable_element::hierarchy_mesh_drawable_element()
+    :mesh_drawable_material(), transform()
+{}
+
+hierarchy_mesh_drawable_element::hierarchy_mesh_drawable_element(mesh_drawable const& drawable)
+    :mesh_drawable_material(drawable), transform(drawable.transform)
+{}
+
+hierarchy_mesh_drawable_element::hierarchy_mesh_drawable_element(mesh_drawable_material const& material)
+    :mesh_drawable_material(material), transform()
+{}
+
 hierarchy_mesh_drawable_node::hierarchy_mesh_drawable_node()
-    :element(), name("undefined"), name_parent("global_frame"), transform(), global_transform()
+    :geometry(), element(), name("undefined"), name_parent("global_frame"), transform(), global_transform()
 {}
 
 hierarchy_mesh_drawable_node::hierarchy_mesh_drawable_node(mesh_drawable const& element_arg,
 							                            std::string const& name_arg,
 							                            std::string const& name_parent_arg,
 							                            affine_rts const& transform_arg)
-:element(element_arg), name(name_arg), name_parent(name_parent_arg), transform(transform_arg), global_transform()
+:geometry(element_arg), element(element_arg), name(name_arg), name_parent(name_parent_arg), transform(transform_arg), global_transform()
 {}
 
+hierarchy_mesh_drawable_node::hierarchy_mesh_drawable_node(mesh_drawable_handle const& geometry_arg,
+							                            mesh_drawable_material const& material_arg,
+							                            std::string const& name_arg,
+							                            std::string const& name_parent_arg,
+							                            affine_rts const& transform_arg)
+:geometry(geometry_arg), element(material_arg), name(name_arg), name_parent(name_parent_arg), transform(transform_arg), global_transform()
+{}
 
 
 
@@ -1,10 +1,25 @@
 #pragma once
 
 #include "vcl/display/drawable/mesh_drawable/mesh_drawable.hpp"
+#include "vcl/display/drawable/mesh_drawable_resource/mesh_drawable_resource.hpp"
 #include "vcl/math/affine/affine_rts/affine_rts.hpp"
 
 namespace vcl
 {
+/** Uniform parameters of a node: material of its geometry, and transform of the geometry in the node frame
+*  The member keeps the name and the fields of the mesh_drawable previously stored in each node: node.element.shading, .texture, .shader and .transform are modified as before.
+*  The GPU buffers (vao, vbo, number_triangles) are in node.geometry. */
+struct hierarchy_mesh_drawable_element : mesh_drawable_material
+{
+	hierarchy_mesh_drawable_element();
+	// Material and transform of a mesh_drawable
+	explicit hierarchy_mesh_drawable_element(mesh_drawable const& drawable);
+	// Material with an identity transform
+	explicit hierarchy_mesh_drawable_element(mesh_drawable_material const& material);
+
+	affine_rts transform;
+};
+
 struct hierarchy_mesh_drawable_node
 {
 	hierarchy_mesh_drawable_node();
@@ -14,9 +29,16 @@ struct hierarchy_mesh_drawable_node
 									const std::string& name_parent="global_frame",
 									const affine_rts& transform = affine_rts());
 
+	hierarchy_mesh_drawable_node(const mesh_drawable_handle& geometry,
+									const mesh_drawable_material& material,
+									const std::string& name,
+									const std::string& name_parent="global_frame",
+									const affine_rts& transform = affine_rts());
 
 
-	mesh_drawable element; // the visual element
+	// The visual element: GPU buffers (possibly shared with other nodes), and uniform parameters specific to this node
+	mesh_drawable_handle geometry;
+	hierarchy_mesh_drawable_element element;
 
 	std::string name;        // name of the current node
 	std::string name_parent; // name of the parent node
@@ -30,27 +52,16 @@ struct hierarchy_mesh_drawable_node
 template <typename SCENE>
 void draw(hierarchy_mesh_drawable_node const& node, SCENE const& scene)
 {
-	// copy of the mesh drawable (lightweight element) - to preserve its uniform parameters
-	mesh_drawable visual_element = node.element;
-
-	// Update local uniform values (and combine them with uniform already stored in the mesh)
-	visual_element.transform = node.global_transform * visual_element.transform;
-
-	if(visual_element.shader!=0)
-		draw(visual_element, scene);
+	// Combine the global transform of the node with the transform of its geometry
+	if(node.element.shader!=0 && !node.geometry.empty())
+		draw(*node.geometry, node.element, node.global_transform * node.element.transform, scene);
 }
 
 template <typename SCENE>
 void draw_wireframe(hierarchy_mesh_drawable_node const& node, SCENE const& scene, vec3 const& color={0,0,1})
 {
-	// copy of the mesh drawable (lightweight element) - to preserve its uniform parameters
-	mesh_drawable visual_element = node.element;
-
-	// Update local uniform values (and combine them with uniform already stored in the mesh)
-	visual_element.transform = node.global_transform * visual_element.transform;
-
-	if(visual_element.shader!=0)
-		draw_wireframe(visual_element, scene, color);
+	if(node.element.shader!=0 && !node.geometry.empty())
+		draw_wireframe(*node.geometry, node.element, node.global_transform * node.element.transform, scene, color);
 }
 
-}
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "benchmark_hierarchy_mesh_drawable.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../hierarchy_mesh_drawable.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Previous update: validation of the hierarchy (std::set of the names) and search of each parent by name at every call
+	static void update_reference(hierarchy_mesh_drawable& hierarchy)
+	{
+		std::set<std::string> parent_names_visited;
+		parent_names_visited.insert(hierarchy.elements[0].name_parent);
+		for (size_t k = 0; k < hierarchy.elements.size(); ++k) {
+			assert_vcl_no_msg(parent_names_visited.find(hierarchy.elements[k].name_parent) != parent_names_visited.end());
+			parent_names_visited.insert(hierarchy.elements[k].name);
+		}
+
+		std::string const& name_root_parent = hierarchy.elements[0].name_parent;
+		for (size_t k = 0; k < hierarchy.elements.size(); ++k) {
+			hierarchy_mesh_drawable_node& element = hierarchy.elements[k];
+			if (element.name_parent == name_root_parent)
+				element.global_transform = element.transform;
+			else
+				element.global_transform = hierarchy[element.name_parent].global_transform * element.transform;
+		}
+	}
+
+	// Previous node: full copy of the mesh_drawable in each node
+	struct hierarchy_node_reference
+	{
+		mesh_drawable element;
+		std::string name;
+		std::string name_parent;
+		affine_rts transform;
+		affine_rts global_transform;
+	};
+
+	// Heap memory used by the std::map of VBO ids of a mesh_drawable (estimated: node of a red-black tree = 4 pointers/color + value)
+	static size_t vbo_map_memory(std::map<std::string, GLuint> const& vbo)
+	{
+		return vbo.size() * (4*sizeof(void*) + sizeof(std::pair<const std::string, GLuint>));
+	}
+
+	// Distinct resources used by the nodes of a hierarchy, and heap memory of the nodes and of these resources
+	static size_t hierarchy_memory(hierarchy_mesh_drawable const& hierarchy, size_t& resource_count)
+	{
+		std::set<mesh_drawable_resource const*> resources;
+		size_t memory = hierarchy.elements.size()*sizeof(hierarchy_mesh_drawable_node);
+		for (auto const& node : hierarchy.elements)
+			if (!node.geometry.empty() && resources.insert(node.geometry.resource.get()).second)
+				memory += sizeof(mesh_drawable_resource) + vbo_map_memory(node.geometry->vbo);
+		resource_count = resources.size();
+		return memory;
+	}
+
+	// Construction of a hierarchy of N nodes with hierarchy.add(mesh_drawable, name, parent) (the call used by the scenes), using N_geometry mesh_drawable
+	static void benchmark_node_construction(int N, int N_geometry)
+	{
+		int const N_repeat = 20;
+
+		// Geometries already sent to the GPU (arbitrary ids: no OpenGL call is made)
+		std::vector<mesh_drawable> elements(N_geometry);
+		for (int g = 0; g < N_geometry; ++g) {
+			elements[g].vao = g+1;
+			for (char const* name : { "position","normal","color","uv","index" })
+				elements[g].vbo[name] = GLuint(10*g) + GLuint(elements[g].vbo.size()+1);
+			elements[g].shader = 1;
+			elements[g].texture = 1;
+		}
+		std::vector<std::string> names(N);
+		for (int k = 0; k < N; ++k)
+			names[k] = "node_"+str(k);
+
+		double time_reference = 0, time_add = 0;
+		size_t memory_reference = 0, memory_add = 0, resource_count = 0;
+		for (int r = 0; r < N_repeat; ++r)
+		{
+			// Previous storage: name map and copy of the mesh_drawable in each node
+			auto const t0 = std::chrono::high_resolution_clock::now();
+			std::map<std::string, int> name_map_reference;
+			std::vector<hierarchy_node_reference> nodes_reference;
+			for (int k = 0; k < N; ++k) {
+				name_map_reference[names[k]] = k;
+				nodes_reference.push_back({ elements[k%N_geometry], names[k], "global_frame", affine_rts(), affine_rts() });
+			}
+			auto const t1 = std::chrono::high_resolution_clock::now();
+			hierarchy_mesh_drawable hierarchy;
+			for (int k = 0; k < N; ++k)
+				hierarchy.add(elements[k%N_geometry], names[k]);
+			auto const t2 = std::chrono::high_resolution_clock::now();
+
+			time_reference += std::chrono::duration<double, std::milli>(t1-t0).count() / N_repeat;
+			time_add += std::chrono::duration<double, std::milli>(t2-t1).count() / N_repeat;
+
+			if (r == 0) {
+				for (auto const& node : nodes_reference)
+					memory_reference += sizeof(node) + vbo_map_memory(node.element.vbo);
+				memory_add = hierarchy_memory(hierarchy, resource_count);
+			}
+		}
+
+		std::cout << "hierarchy.add(mesh_drawable) of " << N << " nodes using " << N_geometry << " mesh_drawable (" << resource_count << " resources), copy of mesh_drawable vs shared resource:" << std::endl;
+		std::cout << "  Time   : " << time_reference << " ms vs " << time_add << " ms" << std::endl;
+		std::cout << "  Memory : " << memory_reference/N << " bytes/node vs " << memory_add/N << " bytes/node (" << sizeof(hierarchy_node_reference) << " vs " << sizeof(hierarchy_mesh_drawable_node) << " bytes without the VBO map)" << std::endl;
+	}
+
+	template <typename F>
+	static double time_ms(int N_frame, F const& f)
+	{
+		auto const t0 = std::chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < N_frame; ++frame)
+			f(frame);
+		auto const t1 = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(t1-t0).count() / N_frame;
+	}
+
+	void benchmark_hierarchy_mesh_drawable()
+	{
+		// Skeleton of 10k joints: 100 chains of 100 joints attached to a root joint
+		int const N_chain = 100;
+		int const N_joint = 100;
+		int const N_frame = 50;
+
+		hierarchy_mesh_drawable hierarchy;
+		auto const t0 = std::chrono::high_resolution_clock::now();
+		hierarchy.add(mesh_drawable(), "root");
+		for (int c = 0; c < N_chain; ++c) {
+			for (int j = 0; j < N_joint; ++j) {
+				std::string const name_parent = (j == 0) ? "root" : "joint_"+str(c)+"_"+str(j-1);
+				hierarchy.add(mesh_drawable(), "joint_"+str(c)+"_"+str(j), name_parent, vec3{ 0.1f,0,0 });
+			}
+		}
+		auto const t1 = std::chrono::high_resolution_clock::now();
+		size_t const N = hierarchy.elements.size();
+		std::cout << "Skeleton with " << N << " nodes, built in " << std::chrono::duration<double, std::milli>(t1-t0).count() << " ms" << std::endl;
+
+		// Animation of all the joints
+		auto const animate_all = [&](int frame) {
+			for (size_t k = 1; k < N; ++k)
+				hierarchy.elements[k].transform.rotate = rotation({ 0,0,1 }, 0.01f*frame + 0.001f*k);
+		};
+		double const t_all_reference = time_ms(N_frame, [&](int frame) { animate_all(frame); update_reference(hierarchy); });
+		double const t_all = time_ms(N_frame, [&](int frame) { animate_all(frame+N_frame); hierarchy.update_local_to_global_coordinates(); });
+		size_t const updated_all = hierarchy.updated_count;
+
+		// Animation of the last 10 joints of a single chain (e.g. a hand)
+		auto const animate_hand = [&](int frame) {
+			for (int j = N_joint-10; j < N_joint; ++j)
+				hierarchy["joint_0_"+str(j)].transform.rotate = rotation({ 0,0,1 }, 0.01f*frame + 0.1f*j);
+		};
+		double const t_hand_reference = time_ms(N_frame, [&](int frame) { animate_hand(frame); update_reference(hierarchy); });
+		double const t_hand = time_ms(N_frame, [&](int frame) { animate_hand(frame+N_frame); hierarchy.update_local_to_global_coordinates(); });
+		size_t const updated_hand = hierarchy.updated_count;
+
+		// Static pose
+		double const t_static_reference = time_ms(N_frame, [&](int) { update_reference(hierarchy); });
+		double const t_static = time_ms(N_frame, [&](int) { hierarchy.update_local_to_global_coordinates(); });
+
+		std::cout << "Time per frame (animation + update), name lookup vs parent indices:" << std::endl;
+		std::cout << "  All joints animated : " << t_all_reference << " ms vs " << t_all << " ms (" << updated_all << " nodes updated)" << std::endl;
+		std::cout << "  10 joints animated  : " << t_hand_reference << " ms vs " << t_hand << " ms (" << updated_hand << " nodes updated)" << std::endl;
+		std::cout << "  Static pose         : " << t_static_reference << " ms vs " << t_static << " ms (" << hierarchy.updated_count << " nodes updated)" << std::endl;
+
+		benchmark_node_construction(10000, 5);
+		benchmark_node_construction(1000, 1000);
+	}
+}
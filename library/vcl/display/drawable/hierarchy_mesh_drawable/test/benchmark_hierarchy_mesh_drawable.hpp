@@ -0,0 +1,6 @@
+#pragma once
+
+namespace vcl_test
+{
+	void benchmark_hierarchy_mesh_drawable();
+}
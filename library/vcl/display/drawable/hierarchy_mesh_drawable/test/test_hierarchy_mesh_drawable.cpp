@@ -0,0 +1,196 @@
+#include "test_hierarchy_mesh_drawable.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../hierarchy_mesh_drawable.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Global transform of the node k computed by composition of the transforms along the path to the root
+	static affine_rts global_reference(hierarchy_mesh_drawable const& hierarchy, buffer<int> const& parent, int k)
+	{
+		affine_rts T = hierarchy.elements[k].transform;
+		for (int p = parent[k]; p >= 0; p = parent[p])
+			T = hierarchy.elements[p].transform * T;
+		return T;
+	}
+
+	static bool is_equal(affine_rts const& a, affine_rts const& b)
+	{
+		float const eps = 1e-4f;
+		for (int c = 0; c < 4; ++c)
+			if (std::abs(a.rotate.data[c]-b.rotate.data[c]) > eps) return false;
+		for (int c = 0; c < 3; ++c)
+			if (std::abs(a.translate[c]-b.translate[c]) > eps) return false;
+		return std::abs(a.scale-b.scale) < eps;
+	}
+
+	static void check_global_transforms(hierarchy_mesh_drawable const& hierarchy, buffer<int> const& parent)
+	{
+		for (size_t k = 0; k < hierarchy.elements.size(); ++k)
+			assert_vcl_no_msg( is_equal(hierarchy.elements[k].global_transform, global_reference(hierarchy, parent, int(k))) );
+	}
+
+	// Nodes added from a mesh_drawable refer to its buffers without owning them, and keep their own material
+	static void test_node_geometry()
+	{
+		// The buffers are not used without draw: arbitrary ids are enough
+		mesh_drawable element;
+		element.vao = 7;
+		element.vbo["index"] = 3;
+		element.number_triangles = 12;
+		element.shader = 1;
+		element.transform.translate = { 0,0,1 };
+
+		hierarchy_mesh_drawable hierarchy;
+		hierarchy.add(element, "a");
+		hierarchy.add(element, "b", "a", vec3{ 1,0,0 });
+		hierarchy.add(hierarchy_mesh_drawable_node(element, "c", "a"));
+		hierarchy.add(mesh_drawable(), "empty", "a");
+
+		for (std::string const name : { "a","b","c" }) {
+			mesh_drawable_handle const& geometry = hierarchy[name].geometry;
+			assert_vcl_no_msg( !geometry.empty() && geometry->vao == 7 && geometry->number_triangles == 12 && geometry->owns_buffers == false );
+		}
+		assert_vcl_no_msg( hierarchy["empty"].geometry.empty() );
+		// The same mesh_drawable added twice: one resource shared by the two nodes
+		assert_vcl_no_msg( hierarchy["a"].geometry.resource == hierarchy["b"].geometry.resource && hierarchy["a"].geometry.use_count() == 2 );
+		assert_vcl_no_msg( hierarchy["b"].element.transform.translate.z == 1.0f );
+		assert_vcl_no_msg( hierarchy["c"].element.transform.translate.z == 1.0f );
+
+		// A new mesh_drawable reusing the VAO id of a deleted one gets its own buffers (no stale geometry)
+		mesh_drawable element_reused = element;
+		element_reused.vbo["index"] = 4;
+		element_reused.number_triangles = 30;
+		hierarchy.add(element_reused, "reused", "a");
+		assert_vcl_no_msg( hierarchy["reused"].geometry->number_triangles == 30 && hierarchy["reused"].geometry->vbo.at("index") == 4 );
+		assert_vcl_no_msg( hierarchy["a"].geometry->number_triangles == 12 && hierarchy["reused"].geometry.resource != hierarchy["a"].geometry.resource );
+
+		// Material override of a single node, through the same member as the mesh_drawable previously stored in the node
+		hierarchy["b"].element.shading.color = { 1,0,0 };
+		assert_vcl_no_msg( hierarchy["a"].element.shading.color.y == 1.0f );
+		assert_vcl_no_msg( hierarchy["b"].element.shading.color.y == 0.0f );
+		assert_vcl_no_msg( hierarchy["b"].element.shader == 1 );
+		hierarchy["b"].element.texture = 5;
+		hierarchy["b"].element.transform.scale = 2.0f;
+		assert_vcl_no_msg( hierarchy["a"].element.texture != 5 && hierarchy["a"].element.transform.scale == 1.0f );
+	}
+
+	// OpenGL functions replaced during test_release to record the deleted buffers (no OpenGL context in the tests)
+	static std::vector<GLuint> deleted_buffers;
+	static std::vector<GLuint> deleted_vao;
+	static void APIENTRY record_delete_buffers(GLsizei n, GLuint const* ids) { deleted_buffers.insert(deleted_buffers.end(), ids, ids+n); }
+	static void APIENTRY record_delete_vertex_arrays(GLsizei n, GLuint const* ids) { deleted_vao.insert(deleted_vao.end(), ids, ids+n); }
+	static GLenum APIENTRY no_error() { return GL_NO_ERROR; }
+
+	// Buffers shared explicitly with a mesh_drawable_handle are deleted once, when the last reference is cleared
+	static void test_release()
+	{
+		PFNGLDELETEBUFFERSPROC const delete_buffers = glad_glDeleteBuffers;
+		PFNGLDELETEVERTEXARRAYSPROC const delete_vertex_arrays = glad_glDeleteVertexArrays;
+		PFNGLGETERRORPROC const get_error = glad_glGetError;
+		glad_glDeleteBuffers = record_delete_buffers;
+		glad_glDeleteVertexArrays = record_delete_vertex_arrays;
+		glad_glGetError = no_error;
+		deleted_buffers.clear();
+		deleted_vao.clear();
+
+		mesh_drawable_handle geometry;
+		geometry.resource = std::make_shared<mesh_drawable_resource>();
+		geometry.resource->vao = 11;
+		geometry.resource->vbo["position"] = 12;
+		geometry.resource->vbo["index"] = 13;
+		geometry.resource->number_triangles = 2;
+
+		mesh_drawable element;
+		element.vao = 21;
+		element.vbo["index"] = 22;
+
+		hierarchy_mesh_drawable hierarchy;
+		hierarchy.add(geometry, mesh_drawable_material(), "a");
+		hierarchy.add(geometry, mesh_drawable_material(), "b", "a");
+		hierarchy.add(geometry, mesh_drawable_material(), "c", "b");
+		hierarchy.add(element, "d", "a");
+		assert_vcl_no_msg( geometry.use_count() == 4 && hierarchy["b"].geometry.resource == geometry.resource );
+
+		// Other references remain: nothing is deleted
+		geometry.clear();
+		hierarchy["c"].geometry.clear();
+		assert_vcl_no_msg( deleted_buffers.empty() && deleted_vao.empty() );
+		assert_vcl_no_msg( hierarchy["a"].geometry.use_count() == 2 );
+
+		// Last references: the buffers of the handle are deleted once, the buffers of the mesh_drawable are left to its own clear()
+		hierarchy.clear();
+		assert_vcl_no_msg( hierarchy.elements.empty() && hierarchy.name_map.empty() && hierarchy.index("a") == -1 );
+		assert_vcl_no_msg( deleted_vao.size() == 1 && deleted_vao[0] == 11 );
+		assert_vcl_no_msg( deleted_buffers.size() == 2 && std::count(deleted_buffers.begin(), deleted_buffers.end(), 12) == 1 && std::count(deleted_buffers.begin(), deleted_buffers.end(), 13) == 1 );
+
+		// The hierarchy can be filled again after clear()
+		hierarchy.add(element, "a");
+		hierarchy.update_local_to_global_coordinates();
+		assert_vcl_no_msg( hierarchy.updated_count == 1 );
+
+		glad_glDeleteBuffers = delete_buffers;
+		glad_glDeleteVertexArrays = delete_vertex_arrays;
+		glad_glGetError = get_error;
+	}
+
+	void test_hierarchy_mesh_drawable()
+	{
+		test_node_geometry();
+		test_release();
+
+		// Tree where the parent of node k is node (k-1)/3, with two root nodes
+		int const N = 121;
+		hierarchy_mesh_drawable hierarchy;
+		buffer<int> parent;
+		for (int k = 0; k < N; ++k)
+		{
+			std::string const name_parent = (k < 2) ? "global_frame" : "node"+str((k-1)/3);
+			affine_rts const T(rotation({ 0,0,1 }, 0.1f*k), { 0.5f,0.1f*(k%3),0.0f }, 1.0f);
+			hierarchy.add(mesh_drawable(), "node"+str(k), name_parent, T);
+			parent.push_back(k < 2 ? -1 : (k-1)/3);
+		}
+		assert_vcl_no_msg( hierarchy.parent_index.size() == size_t(N) );
+		for (int k = 0; k < N; ++k)
+			assert_vcl_no_msg( hierarchy.parent_index[k] == parent[k] );
+		assert_vcl_no_msg( hierarchy.index("node4") == 4 );
+		assert_vcl_no_msg( hierarchy.index("unknown") == -1 );
+
+		// First update: all the nodes are computed
+		hierarchy.update_local_to_global_coordinates();
+		assert_vcl_no_msg( hierarchy.updated_count == size_t(N) );
+		check_global_transforms(hierarchy, parent);
+
+		// No modification: nothing is recomputed
+		hierarchy.update_local_to_global_coordinates();
+		assert_vcl_no_msg( hierarchy.updated_count == 0 );
+
+		// Modification of node 13: only its subtree (13, 40, 41, 42) is recomputed
+		hierarchy["node13"].transform.rotate = rotation({ 1,0,0 }, 0.7f);
+		hierarchy.update_local_to_global_coordinates();
+		assert_vcl_no_msg( hierarchy.updated_count == 4 );
+		check_global_transforms(hierarchy, parent);
+
+		// Modification of a root node and of a leaf node
+		hierarchy["node1"].transform.translate = { 0,0,2 };
+		hierarchy["node100"].transform.scale = 2.0f;
+		hierarchy.update_local_to_global_coordinates();
+		assert_vcl_no_msg( hierarchy.updated_count == (1+3+9+27)+1 ); // subtree of node 1, and node 100
+		check_global_transforms(hierarchy, parent);
+
+		// Nodes added after an update are computed at the next update
+		hierarchy.add(mesh_drawable(), "extra", "node0", affine_rts(rotation(), { 1,0,0 }, 1.0f));
+		parent.push_back(0);
+		hierarchy.update_local_to_global_coordinates();
+		assert_vcl_no_msg( hierarchy.updated_count == 1 );
+		check_global_transforms(hierarchy, parent);
+	}
+}
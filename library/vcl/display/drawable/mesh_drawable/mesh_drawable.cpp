@@ -9,11 +9,11 @@ namespace vcl
 
 
 	mesh_drawable::mesh_drawable()
-		:vbo(), vao(0), shader(0), texture(0), transform(), shading()
+		:vbo(), vao(0), number_vertex(0), shader(0), texture(0), transform(), shading()
 	{}
 
 	mesh_drawable::mesh_drawable(mesh const& data_to_send, GLuint shader_arg, GLuint texture_arg, GLuint draw_type)
-		:vbo(), vao(0), shader(shader_arg), texture(texture_arg), transform(), shading()
+		:vbo(), vao(0), number_vertex(0), shader(shader_arg), texture(texture_arg), transform(), shading()
 	{
 		// Sanity check OpenGL
 		opengl_check;
@@ -27,8 +27,9 @@ namespace vcl
 		opengl_create_gl_buffer_data(GL_ARRAY_BUFFER, vbo["uv"], data_to_send.uv, draw_type);
 		opengl_create_gl_buffer_data(GL_ELEMENT_ARRAY_BUFFER, vbo["index"], data_to_send.connectivity, draw_type);
 
-		// Store number of triangles
+		// Store number of triangles and vertices
 		number_triangles = static_cast<GLuint>(data_to_send.connectivity.size());
+		number_vertex = static_cast<GLuint>(data_to_send.position.size());
 
 		// Generate VAO
 		glGenVertexArrays(1,&vao); opengl_check
@@ -43,26 +44,85 @@ namespace vcl
 
 	mesh_drawable& mesh_drawable::update_position(buffer<vec3> const& new_position)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER,vbo["position"]); opengl_check;
-		glBufferSubData(GL_ARRAY_BUFFER,0,size_in_memory(new_position),ptr(new_position));  opengl_check;
-		return *this;
+		return update_position(new_position, 0);
 	}
 	mesh_drawable& mesh_drawable::update_normal(buffer<vec3> const& new_normals)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER,vbo["normal"]); opengl_check;
-		glBufferSubData(GL_ARRAY_BUFFER,0,size_in_memory(new_normals),ptr(new_normals));  opengl_check;
-		return *this;
+		return update_normal(new_normals, 0);
 	}
 	mesh_drawable& mesh_drawable::update_color(buffer<vec3> const& new_color)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER,vbo["color"]); opengl_check;
-		glBufferSubData(GL_ARRAY_BUFFER,0,size_in_memory(new_color),ptr(new_color));  opengl_check;
-		return *this;
+		return update_color(new_color, 0);
 	}
 	mesh_drawable& mesh_drawable::update_uv(buffer<vec2> const& new_uv)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER,vbo["uv"]); opengl_check;
-		glBufferSubData(GL_ARRAY_BUFFER,0,size_in_memory(new_uv),ptr(new_uv));  opengl_check;
+		return update_uv(new_uv, 0);
+	}
+	mesh_drawable& mesh_drawable::update_position(buffer_view<vec3 const> new_position, size_t offset)
+	{
+		assert_vcl(offset+new_position.size() <= number_vertex, "Partial update of the position ["+str(offset)+","+str(offset+new_position.size())+"[ outside of the "+str(number_vertex)+" vertices");
+		if (!new_position.empty())
+			opengl_update_gl_subbuffer_data(vbo["position"], new_position, offset*sizeof(vec3));
+		return *this;
+	}
+	mesh_drawable& mesh_drawable::update_normal(buffer_view<vec3 const> new_normal, size_t offset)
+	{
+		assert_vcl(offset+new_normal.size() <= number_vertex, "Partial update of the normal ["+str(offset)+","+str(offset+new_normal.size())+"[ outside of the "+str(number_vertex)+" vertices");
+		if (!new_normal.empty())
+			opengl_update_gl_subbuffer_data(vbo["normal"], new_normal, offset*sizeof(vec3));
+		return *this;
+	}
+	mesh_drawable& mesh_drawable::update_color(buffer_view<vec3 const> new_color, size_t offset)
+	{
+		assert_vcl(offset+new_color.size() <= number_vertex, "Partial update of the color ["+str(offset)+","+str(offset+new_color.size())+"[ outside of the "+str(number_vertex)+" vertices");
+		if (!new_color.empty())
+			opengl_update_gl_subbuffer_data(vbo["color"], new_color, offset*sizeof(vec3));
+		return *this;
+	}
+	mesh_drawable& mesh_drawable::update_uv(buffer_view<vec2 const> new_uv, size_t offset)
+	{
+		assert_vcl(offset+new_uv.size() <= number_vertex, "Partial update of the uv ["+str(offset)+","+str(offset+new_uv.size())+"[ outside of the "+str(number_vertex)+" vertices");
+		if (!new_uv.empty())
+			opengl_update_gl_subbuffer_data(vbo["uv"], new_uv, offset*sizeof(vec2));
+		return *this;
+	}
+
+	// Send the rows of the region to the buffer vbo_id
+	template <typename T>
+	static void opengl_update_grid_region(GLuint vbo_id, buffer_view<T const> data, mesh_grid_region const& region, int Nv)
+	{
+		if (region.empty())
+			return;
+		assert_vcl(region.kv_max < Nv && size_t(region.ku_max+1)*Nv <= data.size(), "Region outside of the grid");
+
+		glBindBuffer(GL_ARRAY_BUFFER, vbo_id); opengl_check;
+		GLsizeiptr const element_size = sizeof(T);
+		if (region.kv_min==0 && region.kv_max==Nv-1) {
+			size_t const first = size_t(region.ku_min)*Nv;
+			size_t const count = size_t(region.ku_max-region.ku_min+1)*Nv;
+			glBufferSubData(GL_ARRAY_BUFFER, first*element_size, count*element_size, &data[first]); opengl_check;
+			return;
+		}
+		size_t const count = size_t(region.kv_max-region.kv_min+1);
+		for (int ku = region.ku_min; ku <= region.ku_max; ++ku) {
+			size_t const first = region.kv_min + size_t(Nv)*ku;
+			glBufferSubData(GL_ARRAY_BUFFER, first*element_size, count*element_size, &data[first]); opengl_check;
+		}
+	}
+
+	mesh_drawable& mesh_drawable::update_position(buffer_view<vec3 const> new_position, mesh_grid_region const& region, int Nv)
+	{
+		opengl_update_grid_region(vbo["position"], new_position, region, Nv);
+		return *this;
+	}
+	mesh_drawable& mesh_drawable::update_normal(buffer_view<vec3 const> new_normal, mesh_grid_region const& region, int Nv)
+	{
+		opengl_update_grid_region(vbo["normal"], new_normal, region, Nv);
+		return *this;
+	}
+	mesh_drawable& mesh_drawable::update_color(buffer_view<vec3 const> new_color, mesh_grid_region const& region, int Nv)
+	{
+		opengl_update_grid_region(vbo["color"], new_color, region, Nv);
 		return *this;
 	}
 
@@ -77,6 +137,7 @@ namespace vcl
 		opengl_check;
 		
 		number_triangles = 0;
+		number_vertex = 0;
 		shader = 0;
 		texture = 0;
 		transform = affine_rts();
@@ -19,6 +19,8 @@ namespace vcl
 		GLuint vao;
 
 		GLuint number_triangles;
+		// Number of vertices stored in the vbo of position, normal, color and uv
+		GLuint number_vertex;
 		GLuint shader;
 		GLuint texture;
 
@@ -35,6 +37,19 @@ namespace vcl
 		mesh_drawable& update_normal(buffer<vec3> const& new_normal);
 		mesh_drawable& update_color(buffer<vec3> const& new_color);
 		mesh_drawable& update_uv(buffer<vec2> const& new_uv);
+
+		// Update the vertices [offset, offset+N-1] from a view on N elements (ex. a subview of a larger buffer, or data mapped from a file), without copy on the CPU
+		//  The vbo must store at least offset+N vertices.
+		mesh_drawable& update_position(buffer_view<vec3 const> new_position, size_t offset);
+		mesh_drawable& update_normal(buffer_view<vec3 const> new_normal, size_t offset);
+		mesh_drawable& update_color(buffer_view<vec3 const> new_color, size_t offset);
+		mesh_drawable& update_uv(buffer_view<vec2 const> new_uv, size_t offset);
+
+		// Partial update of a grid mesh (see mesh_grid_region): only the vertices of the region are sent to the GPU, with one glBufferSubData per row of Nv vertices
+		//  (a single call when the region spans complete rows)
+		mesh_drawable& update_position(buffer_view<vec3 const> new_position, mesh_grid_region const& region, int Nv);
+		mesh_drawable& update_normal(buffer_view<vec3 const> new_normal, mesh_grid_region const& region, int Nv);
+		mesh_drawable& update_color(buffer_view<vec3 const> new_color, mesh_grid_region const& region, int Nv);
 	};
 
 	template <typename SCENE>
@@ -42,6 +57,15 @@ namespace vcl
 
 	template <typename SCENE>
 	void draw_wireframe(mesh_drawable const& drawable, SCENE const& scene, vec3 const& color={0,0,1});
+
+	namespace detail
+	{
+		// Draw calls shared by mesh_drawable and mesh_drawable_resource (buffers and uniform parameters given separately)
+		template <typename SCENE>
+		void draw_mesh(GLuint vao, std::map<std::string, GLuint> const& vbo, GLuint number_triangles, GLuint shader, GLuint texture, shading_parameters_phong const& shading, affine_rts const& transform, SCENE const& scene);
+		template <typename SCENE>
+		void draw_mesh_wireframe(GLuint vao, std::map<std::string, GLuint> const& vbo, GLuint number_triangles, GLuint shader, GLuint texture, shading_parameters_phong const& shading, affine_rts const& transform, SCENE const& scene, vec3 const& color);
+	}
 }
 
 
@@ -49,27 +73,39 @@ namespace vcl
 {
 	template <typename SCENE>
 	void draw(mesh_drawable const& drawable, SCENE const& scene)
+	{
+		detail::draw_mesh(drawable.vao, drawable.vbo, drawable.number_triangles, drawable.shader, drawable.texture, drawable.shading, drawable.transform, scene);
+	}
+
+	template <typename SCENE>
+	void draw_wireframe(mesh_drawable const& drawable, SCENE const& scene, vec3 const& color)
+	{
+		detail::draw_mesh_wireframe(drawable.vao, drawable.vbo, drawable.number_triangles, drawable.shader, drawable.texture, drawable.shading, drawable.transform, scene, color);
+	}
+
+	template <typename SCENE>
+	void detail::draw_mesh(GLuint vao, std::map<std::string, GLuint> const& vbo, GLuint number_triangles, GLuint shader, GLuint texture, shading_parameters_phong const& shading, affine_rts const& transform, SCENE const& scene)
 	{
 		// Setup shader
-		assert_vcl(drawable.shader!=0, "Try to draw mesh_drawable without shader");
-		assert_vcl(drawable.texture!=0, "Try to draw mesh_drawable without texture");
-		glUseProgram(drawable.shader); opengl_check;
+		assert_vcl(shader!=0, "Try to draw mesh_drawable without shader");
+		assert_vcl(texture!=0, "Try to draw mesh_drawable without texture");
+		glUseProgram(shader); opengl_check;
 
 		// Send uniforms for this shader
-		opengl_uniform(drawable.shader, scene);
-		opengl_uniform(drawable.shader, drawable.shading);
-		opengl_uniform(drawable.shader, "model", drawable.transform.matrix());
+		opengl_uniform(shader, scene);
+		opengl_uniform(shader, shading);
+		opengl_uniform(shader, "model", transform.matrix());
 
 		// Set texture
 		glActiveTexture(GL_TEXTURE0); opengl_check;
-		glBindTexture(GL_TEXTURE_2D, drawable.texture); opengl_check;
-		opengl_uniform(drawable.shader, "image_texture", 0);  opengl_check;
+		glBindTexture(GL_TEXTURE_2D, texture); opengl_check;
+		opengl_uniform(shader, "image_texture", 0);  opengl_check;
 		
 		// Call draw function
-		assert_vcl(drawable.number_triangles>0, "Try to draw mesh_drawable with 0 triangles"); opengl_check;
-		glBindVertexArray(drawable.vao);   opengl_check;
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawable.vbo.at("index")); opengl_check;
-		glDrawElements(GL_TRIANGLES, GLsizei(drawable.number_triangles*3), GL_UNSIGNED_INT, nullptr); opengl_check;
+		assert_vcl(number_triangles>0, "Try to draw mesh_drawable with 0 triangles"); opengl_check;
+		glBindVertexArray(vao);   opengl_check;
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo.at("index")); opengl_check;
+		glDrawElements(GL_TRIANGLES, GLsizei(number_triangles*3), GL_UNSIGNED_INT, nullptr); opengl_check;
 
 		// Clean buffers
 		glBindVertexArray(0);
@@ -77,16 +113,16 @@ namespace vcl
 	}
 
 	template <typename SCENE>
-	void draw_wireframe(mesh_drawable const& drawable, SCENE const& scene, vec3 const& color)
+	void detail::draw_mesh_wireframe(GLuint vao, std::map<std::string, GLuint> const& vbo, GLuint number_triangles, GLuint shader, GLuint texture, shading_parameters_phong const& shading, affine_rts const& transform, SCENE const& scene, vec3 const& color)
 	{
-		mesh_drawable wireframe = drawable;
-		wireframe.shading.phong = {1.0f,0.0f,0.0f,64.0f};
-		wireframe.shading.color = color;
-		wireframe.shading.use_texture = false;
+		shading_parameters_phong wireframe = shading;
+		wireframe.phong = {1.0f,0.0f,0.0f,64.0f};
+		wireframe.color = color;
+		wireframe.use_texture = false;
 		glPolygonMode( GL_FRONT_AND_BACK, GL_LINE );
 		glEnable(GL_POLYGON_OFFSET_LINE);
 		glPolygonOffset(-1.0, 1.0);
-		draw(wireframe, scene);
+		draw_mesh(vao, vbo, number_triangles, shader, texture, wireframe, transform, scene);
 		glDisable(GL_POLYGON_OFFSET_LINE);
 		glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
 	}
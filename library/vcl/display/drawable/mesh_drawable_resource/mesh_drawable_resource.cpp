@@ -0,0 +1,82 @@
+#include "mesh_drawable_resource.hpp"
+
+#include "vcl/base/base.hpp"
+
+namespace vcl
+{
+	void mesh_drawable_resource::clear()
+	{
+		for(auto& buffer : vbo)
+			glDeleteBuffers(1, &(buffer.second) );
+		vbo.clear();
+
+		glDeleteVertexArrays(1, &vao);
+		vao = 0;
+		opengl_check;
+
+		number_triangles = 0;
+	}
+
+
+	mesh_drawable_handle::mesh_drawable_handle()
+		:resource()
+	{}
+
+	mesh_drawable_handle::mesh_drawable_handle(mesh const& data_to_send, GLuint draw_type)
+		:resource()
+	{
+		// The buffers are created by mesh_drawable, and then owned by the handle
+		mesh_drawable const drawable(data_to_send, 0, 0, draw_type);
+		resource = std::make_shared<mesh_drawable_resource>();
+		resource->vbo = drawable.vbo;
+		resource->vao = drawable.vao;
+		resource->number_triangles = drawable.number_triangles;
+	}
+
+	mesh_drawable_handle::mesh_drawable_handle(mesh_drawable const& drawable)
+		:resource()
+	{
+		if(drawable.vao==0)
+			return;
+		resource = std::make_shared<mesh_drawable_resource>();
+		resource->vbo = drawable.vbo;
+		resource->vao = drawable.vao;
+		resource->number_triangles = drawable.number_triangles;
+		resource->owns_buffers = false;
+	}
+
+	bool mesh_drawable_handle::empty() const
+	{
+		return resource==nullptr;
+	}
+	long mesh_drawable_handle::use_count() const
+	{
+		return resource.use_count();
+	}
+	mesh_drawable_resource const& mesh_drawable_handle::operator*() const
+	{
+		assert_vcl(resource!=nullptr, "Empty mesh_drawable_handle");
+		return *resource;
+	}
+	mesh_drawable_resource const* mesh_drawable_handle::operator->() const
+	{
+		assert_vcl(resource!=nullptr, "Empty mesh_drawable_handle");
+		return resource.get();
+	}
+
+	void mesh_drawable_handle::clear()
+	{
+		if(resource!=nullptr && resource.use_count()==1 && resource->owns_buffers)
+			resource->clear();
+		resource.reset();
+	}
+
+
+	mesh_drawable_material::mesh_drawable_material()
+		:shader(mesh_drawable::default_shader), texture(mesh_drawable::default_texture), shading()
+	{}
+
+	mesh_drawable_material::mesh_drawable_material(mesh_drawable const& drawable)
+		:shader(drawable.shader), texture(drawable.texture), shading(drawable.shading)
+	{}
+}
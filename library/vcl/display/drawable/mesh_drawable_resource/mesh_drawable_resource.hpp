@@ -0,0 +1,79 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include "vcl/display/opengl/opengl.hpp"
+#include "vcl/shape/mesh/mesh.hpp"
+#include "vcl/display/drawable/shading_parameters/shading_parameters.hpp"
+#include "vcl/display/drawable/mesh_drawable/mesh_drawable.hpp"
+
+namespace vcl
+{
+	/** GPU buffers of a mesh (VBO and VAO), without any uniform parameter */
+	struct mesh_drawable_resource
+	{
+		std::map<std::string, GLuint> vbo;
+		GLuint vao = 0;
+		GLuint number_triangles = 0;
+		/** False if the buffers belong to a mesh_drawable: they are then deleted by the clear() of this mesh_drawable, not by the handles */
+		bool owns_buffers = true;
+
+		void clear();
+	};
+
+	/** Reference-counted handle on a mesh_drawable_resource: the copies of a handle share the same GPU buffers.
+	* As for mesh_drawable, the buffers are not released in the destructor (the OpenGL context may already be destroyed):
+	*  clear() releases the reference, and the last handle to be cleared deletes the buffers (if the handle owns them). */
+	struct mesh_drawable_handle
+	{
+		mesh_drawable_handle();
+		// Send mesh data to GPU
+		explicit mesh_drawable_handle(mesh const& data_to_send, GLuint draw_type=GL_DYNAMIC_DRAW);
+		// Refer to the buffers already sent by a mesh_drawable without owning them: they remain deleted by the clear() of the mesh_drawable
+		explicit mesh_drawable_handle(mesh_drawable const& drawable);
+
+		std::shared_ptr<mesh_drawable_resource> resource;
+
+		bool empty() const;
+		long use_count() const;
+		mesh_drawable_resource const& operator*() const;
+		mesh_drawable_resource const* operator->() const;
+
+		void clear();
+	};
+
+	/** Uniform parameters of a mesh: can differ between the drawables sharing the same mesh_drawable_handle */
+	struct mesh_drawable_material
+	{
+		mesh_drawable_material();
+		// Shader, texture and shading of a mesh_drawable
+		explicit mesh_drawable_material(mesh_drawable const& drawable);
+
+		GLuint shader;
+		GLuint texture;
+		shading_parameters_phong shading;
+	};
+
+	template <typename SCENE>
+	void draw(mesh_drawable_resource const& geometry, mesh_drawable_material const& material, affine_rts const& transform, SCENE const& scene);
+
+	template <typename SCENE>
+	void draw_wireframe(mesh_drawable_resource const& geometry, mesh_drawable_material const& material, affine_rts const& transform, SCENE const& scene, vec3 const& color={0,0,1});
+}
+
+
+namespace vcl
+{
+	template <typename SCENE>
+	void draw(mesh_drawable_resource const& geometry, mesh_drawable_material const& material, affine_rts const& transform, SCENE const& scene)
+	{
+		detail::draw_mesh(geometry.vao, geometry.vbo, geometry.number_triangles, material.shader, material.texture, material.shading, transform, scene);
+	}
+
+	template <typename SCENE>
+	void draw_wireframe(mesh_drawable_resource const& geometry, mesh_drawable_material const& material, affine_rts const& transform, SCENE const& scene, vec3 const& color)
+	{
+		detail::draw_mesh_wireframe(geometry.vao, geometry.vbo, geometry.number_triangles, material.shader, material.texture, material.shading, transform, scene, color);
+	}
+}
@@ -0,0 +1,62 @@
+#include "vcl/base/base.hpp"
+#include "points_drawable.hpp"
+
+namespace vcl
+{
+	GLuint points_drawable::default_shader = 0;
+
+	points_drawable::points_drawable()
+		:vbo_position(0), vao(0), number_position(0), capacity(0), shader(0), transform(), color({0,0,0}), radius(0.01f)
+	{}
+
+	points_drawable::points_drawable(buffer<vec3> const& position, GLuint shader, GLuint draw_type)
+		:vbo_position(0), vao(0), number_position(0), capacity(0), shader(shader), transform(), color({0.2f,0.4f,1.0f}), radius(0.01f)
+	{
+		opengl_create_gl_buffer_data(GL_ARRAY_BUFFER, vbo_position, position, draw_type);
+		number_position = static_cast<GLuint>(position.size());
+		capacity = number_position;
+
+		glGenVertexArrays(1,&vao); opengl_check
+		glBindVertexArray(vao);    opengl_check
+		opengl_set_vertex_attribute(vbo_position, 0, 3, GL_FLOAT);
+		glBindVertexArray(0);      opengl_check
+	}
+
+	void points_drawable::update(buffer_view<vec3 const> new_position)
+	{
+		GLuint const N = static_cast<GLuint>(new_position.size());
+		if (N > capacity) {
+			glBindBuffer(GL_ARRAY_BUFFER, vbo_position);                                                        opengl_check;
+			glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(size_in_memory(new_position)), ptr(new_position), GL_DYNAMIC_DRAW); opengl_check;
+			glBindBuffer(GL_ARRAY_BUFFER, 0);                                                                   opengl_check;
+			capacity = N;
+		}
+		else if (N > 0)
+			opengl_update_gl_subbuffer_data(vbo_position, new_position);
+		number_position = N;
+	}
+
+	void points_drawable::update(buffer_view<vec3 const> new_position, size_t offset)
+	{
+		assert_vcl(offset+new_position.size() <= number_position, "Partial update of the positions ["+str(offset)+","+str(offset+new_position.size())+"[ outside of the "+str(number_position)+" points");
+		if (!new_position.empty())
+			opengl_update_gl_subbuffer_data(vbo_position, new_position, offset*sizeof(vec3));
+	}
+
+	void points_drawable::clear()
+	{
+		glDeleteBuffers(1, &vbo_position);
+		vbo_position = 0;
+
+		glDeleteVertexArrays(1, &vao);
+		vao = 0;
+		opengl_check;
+
+		number_position = 0;
+		capacity = 0;
+		shader = 0;
+		transform = affine_rts();
+		color = {0,0,0};
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "vcl/display/opengl/opengl.hpp"
+#include "vcl/containers/containers.hpp"
+
+namespace vcl
+{
+	// Display a set of points as shaded spheres (point sprites) - a single draw call for all the points
+	//  Expects a shader similar to opengl_shader_preset("points_vertex"/"points_fragment")
+	struct points_drawable
+	{
+		points_drawable();
+		// Send the positions to GPU. Set also shader.
+		explicit points_drawable(buffer<vec3> const& position, GLuint shader=default_shader, GLuint draw_type=GL_DYNAMIC_DRAW);
+
+		GLuint vbo_position;
+		GLuint vao;
+
+		GLuint number_position;
+		GLuint capacity;        // Number of positions that can be stored in the current GPU buffer
+		GLuint shader;
+
+		// Uniform
+		affine_rts transform;
+		vec3 color;
+		float radius;           // Radius of the spheres in world coordinates
+
+		static GLuint default_shader;
+
+		void clear();
+		// Update the positions. The number of points may change (the GPU buffer is reallocated only when its capacity is exceeded).
+		void update(buffer_view<vec3 const> new_position);
+		// Update the positions [offset, offset+N-1] from a view on N positions, the number of points is unchanged (offset+N must not exceed it)
+		void update(buffer_view<vec3 const> new_position, size_t offset);
+	};
+}
+
+
+namespace vcl
+{
+	template <typename SCENE>
+	void draw(points_drawable const& drawable, SCENE const& scene)
+	{
+		if (drawable.number_position==0)
+			return;
+
+		// Setup shader
+		assert_vcl(drawable.shader!=0, "Try to draw points_drawable without shader");
+		glUseProgram(drawable.shader); opengl_check;
+
+		// The size of the sprites depends on the height of the viewport
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport); opengl_check;
+
+		// Send uniforms for this shader
+		opengl_uniform(drawable.shader, scene);
+		opengl_uniform(drawable.shader, "color", drawable.color);
+		opengl_uniform(drawable.shader, "radius", drawable.radius);
+		opengl_uniform(drawable.shader, "viewport_height", float(viewport[3]));
+		opengl_uniform(drawable.shader, "model", drawable.transform.matrix());
+
+		// Call draw function
+		glEnable(GL_PROGRAM_POINT_SIZE); opengl_check;
+		glBindVertexArray(drawable.vao); opengl_check;
+		glDrawArrays(GL_POINTS, 0, drawable.number_position); opengl_check;
+
+		// Clean buffers
+		glBindVertexArray(0);
+	}
+}
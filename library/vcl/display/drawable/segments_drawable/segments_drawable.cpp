@@ -25,6 +25,13 @@ namespace vcl
 		opengl_update_gl_subbuffer_data(vbo_position, new_position);
 	}
 
+	void segments_drawable::update(buffer_view<vec3 const> new_position, size_t offset)
+	{
+		assert_vcl(offset+new_position.size() <= number_position, "Partial update of the positions ["+str(offset)+","+str(offset+new_position.size())+"[ outside of the "+str(number_position)+" segment vertices");
+		if (!new_position.empty())
+			opengl_update_gl_subbuffer_data(vbo_position, new_position, offset*sizeof(vec3));
+	}
+
 	void segments_drawable::clear()
 	{
 		glDeleteBuffers(1, &vbo_position ); 
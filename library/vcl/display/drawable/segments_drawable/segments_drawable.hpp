@@ -26,6 +26,8 @@ namespace vcl
 
 		void clear();
 		void update(buffer<vec3> const& new_position);
+		// Update the positions [offset, offset+N-1] from a view on N positions (the vbo must store at least offset+N positions)
+		void update(buffer_view<vec3 const> new_position, size_t offset);
 	};
 }
 
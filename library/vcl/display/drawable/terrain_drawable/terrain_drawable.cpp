@@ -0,0 +1,134 @@
+#include "terrain_drawable.hpp"
+
+#include "vcl/base/base.hpp"
+
+#include <algorithm>
+#include <set>
+
+namespace vcl
+{
+	terrain_drawable::terrain_drawable()
+		:parameters(), shader(0), texture(0), shading()
+	{}
+
+	terrain_drawable::terrain_drawable(terrain_parameters const& parameters_arg, GLuint shader_arg, GLuint texture_arg, size_t thread_count)
+		:parameters(parameters_arg), shader(shader_arg), texture(texture_arg), shading()
+	{
+		generator = std::make_unique<terrain_generator>(parameters, thread_count);
+	}
+
+	void terrain_drawable::upload(terrain_chunk const& chunk)
+	{
+		lru.push_front(chunk.key);
+		resident_chunk& element = resident[chunk.key];
+		element.drawable = mesh_drawable(chunk.shape, shader, texture, GL_STATIC_DRAW);
+		element.drawable.shading = shading;
+		element.lru_position = lru.begin();
+	}
+
+	// Add to visible the chunks covering the region of key. Return true if the region is entirely covered.
+	bool terrain_drawable::add_visible(terrain_chunk_key const& key, vec3 const& p)
+	{
+		bool const is_resident = resident.count(key) > 0;
+		if (!terrain_chunk_subdivide(parameters, key, p)) {
+			if (is_resident)
+				visible.push_back(key);
+			return is_resident;
+		}
+
+		size_t const start = visible.size();
+		bool complete = true;
+		for (int b = 0; b < 2; ++b)
+			for (int a = 0; a < 2; ++a)
+				complete = add_visible(terrain_chunk_child(key, a, b), p) && complete;
+		if (!complete && is_resident) {
+			// Some finer chunks are missing: display the coarser chunk instead
+			visible.resize(start);
+			visible.push_back(key);
+			return true;
+		}
+		return complete;
+	}
+
+	void terrain_drawable::update(vec3 const& p)
+	{
+		assert_vcl(generator!=nullptr, "terrain_drawable must be initialized with its parameters before update");
+
+		// Request the missing chunks (coarsest fallback first, then the selected chunks from the coarsest to the finest)
+		buffer<terrain_chunk_key> const selection = terrain_select_lod(parameters, p);
+		std::set<terrain_chunk_key> needed;
+		buffer<terrain_chunk_key> requests;
+		for (terrain_chunk_key const& key : selection) {
+			terrain_chunk_key root = key;
+			while (root.level < parameters.level_count-1)
+				root = terrain_chunk_parent(root);
+			if (needed.insert(root).second)
+				requests.push_back(root);
+		}
+		for (terrain_chunk_key const& key : selection)
+			if (needed.insert(key).second)
+				requests.push_back(key);
+
+		std::set<terrain_chunk_key> ready_keys;
+		for (terrain_chunk const& chunk : ready)
+			ready_keys.insert(chunk.key);
+		generator->cancel_requests_except(needed);
+		for (terrain_chunk_key const& key : requests)
+			if (resident.count(key)==0 && ready_keys.count(key)==0)
+				generator->request(key);
+
+		// Send the generated chunks to the GPU within the budget of the frame
+		for (terrain_chunk& chunk : generator->collect())
+			ready.push_back(std::move(chunk));
+		uploaded_last_frame = 0;
+		while (!ready.empty() && uploaded_last_frame < upload_per_frame) {
+			terrain_chunk const& chunk = ready.front();
+			if (needed.count(chunk.key) && resident.count(chunk.key)==0) {
+				upload(chunk);
+				++uploaded_last_frame;
+			}
+			ready.pop_front();
+		}
+		uploaded_total += uploaded_last_frame;
+
+		// Chunks to display
+		visible.clear();
+		for (terrain_chunk_key const& root : terrain_lod_roots(parameters, p))
+			add_visible(root, p);
+		for (terrain_chunk_key const& key : visible) {
+			resident_chunk& element = resident.at(key);
+			lru.splice(lru.begin(), lru, element.lru_position);
+		}
+
+		// Evict the least recently displayed chunks (never the visible ones, which are at the front of the list)
+		size_t const capacity = std::max(cache_capacity, visible.size());
+		while (resident.size() > capacity) {
+			terrain_chunk_key const key = lru.back();
+			lru.pop_back();
+			resident.at(key).drawable.clear();
+			resident.erase(key);
+			++evicted_total;
+		}
+	}
+
+	void terrain_drawable::clear()
+	{
+		generator.reset();
+		for (auto& element : resident)
+			element.second.drawable.clear();
+		resident.clear();
+		lru.clear();
+		ready.clear();
+		visible.clear();
+	}
+
+	size_t terrain_drawable::resident_count() const
+	{
+		return resident.size();
+	}
+
+	size_t terrain_drawable::pending_count() const
+	{
+		return (generator ? generator->pending() : 0) + ready.size();
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "vcl/shape/terrain/terrain.hpp"
+#include "vcl/display/drawable/mesh_drawable/mesh_drawable.hpp"
+
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+
+namespace vcl
+{
+	/** Large terrain displayed as a set of chunks of varying levels of details (see terrain_parameters)
+	* At each call of update(camera_position):
+	* - The chunks to display are selected with terrain_select_lod, and the missing ones are requested to the background generator.
+	*   The coarsest chunk above each of them is also requested: it is displayed until the finer chunks are available.
+	* - At most upload_per_frame of the generated chunks are sent to the GPU (the other ones wait for the next frames).
+	* - The chunks displayed at this frame are stored in visible: a region is displayed with a coarser chunk as long as one of its finer chunks is not on the GPU.
+	* - Chunks on the GPU are kept in a cache of cache_capacity chunks: the least recently displayed chunks are deleted first. */
+	struct terrain_drawable
+	{
+		terrain_drawable();
+		/** Start the background generation of the chunks (thread_count as in terrain_generator). The chunks are sent to the GPU during update(). */
+		explicit terrain_drawable(terrain_parameters const& parameters, GLuint shader=mesh_drawable::default_shader, GLuint texture=mesh_drawable::default_texture, size_t thread_count=0);
+
+		terrain_parameters parameters;
+		size_t upload_per_frame = 4;
+		size_t cache_capacity = 512;
+
+		GLuint shader;
+		GLuint texture;
+		shading_parameters_phong shading; // Shading of the chunks (applied when a chunk is sent to the GPU)
+
+		/** Update the chunks for the camera position p (main thread) */
+		void update(vec3 const& p);
+		/** Delete all chunks from the GPU and stop the generator */
+		void clear();
+
+		/** Chunks displayed by draw */
+		buffer<terrain_chunk_key> visible;
+
+		/** Statistics */
+		size_t uploaded_last_frame = 0;
+		size_t uploaded_total = 0;
+		size_t evicted_total = 0;
+		size_t resident_count() const;
+		size_t pending_count() const;
+
+		/** Internal data */
+		struct resident_chunk
+		{
+			mesh_drawable drawable;
+			std::list<terrain_chunk_key>::iterator lru_position;
+		};
+		std::unique_ptr<terrain_generator> generator;
+		std::map<terrain_chunk_key, resident_chunk> resident;
+		std::list<terrain_chunk_key> lru; // Chunks on the GPU, from the most recently displayed to the least recently displayed
+		std::deque<terrain_chunk> ready;  // Generated chunks waiting to be sent to the GPU
+
+		void upload(terrain_chunk const& chunk);
+		bool add_visible(terrain_chunk_key const& key, vec3 const& p);
+	};
+
+	template <typename SCENE>
+	void draw(terrain_drawable const& terrain, SCENE const& scene)
+	{
+		for (terrain_chunk_key const& key : terrain.visible)
+			draw(terrain.resident.at(key).drawable, scene);
+	}
+
+	template <typename SCENE>
+	void draw_wireframe(terrain_drawable const& terrain, SCENE const& scene, vec3 const& color={0,0,1})
+	{
+		for (terrain_chunk_key const& key : terrain.visible)
+			draw_wireframe(terrain.resident.at(key).drawable, scene, color);
+	}
+}
@@ -11,6 +11,10 @@ namespace vcl
 	template <typename T>
 	void opengl_update_gl_subbuffer_data(GLuint vbo, T const& element);
 
+	// Update a part of the buffer vbo starting at offset_in_bytes (the buffer must be large enough to store element after this offset)
+	template <typename T>
+	void opengl_update_gl_subbuffer_data(GLuint vbo, T const& element, size_t offset_in_bytes);
+
 	template <typename T>
 	void opengl_create_array_buffer_data(GLuint& vbo, T const& element, GLenum draw_type = GL_DYNAMIC_DRAW);
 
@@ -42,4 +46,11 @@ namespace vcl
 		glBindBuffer(GL_ARRAY_BUFFER, vbo);                                        opengl_check;
 		glBufferSubData(GL_ARRAY_BUFFER, 0, size_in_memory(element), ptr(element));  opengl_check;
 	}
+
+	template <typename T>
+	void opengl_update_gl_subbuffer_data(GLuint vbo, T const& element, size_t offset_in_bytes)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);                                                               opengl_check;
+		glBufferSubData(GL_ARRAY_BUFFER, GLintptr(offset_in_bytes), size_in_memory(element), ptr(element)); opengl_check;
+	}
 }
\ No newline at end of file
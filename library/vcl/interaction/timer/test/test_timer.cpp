@@ -0,0 +1,61 @@
+#include "test_timer.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../timer_fixed_step/timer_fixed_step.hpp"
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_timer()
+	{
+		// Fixed steps with a fake clock: the number of steps follows the elapsed time independently of the frame duration
+		{
+			timer_fixed_step timer(1/64.0f, 8);
+			int counter = 0;
+			float t_simulated = 0;
+			auto const simulate = [&](float dt) { ++counter; t_simulated += dt; };
+
+			assert_vcl_no_msg(timer.update(2.5f/64, simulate) == 2);
+			assert_vcl_no_msg(is_equal(timer.alpha, 0.5f));
+			assert_vcl_no_msg(timer.update(0.5f/64, simulate) == 1);
+			assert_vcl_no_msg(is_equal(timer.alpha, 0.0f));
+			assert_vcl_no_msg(timer.update(0.25f/64, simulate) == 0);
+
+			for (int k = 0; k < 100; ++k)
+				timer.update(0.016f, simulate);
+			assert_vcl_no_msg(counter == timer.step_total);
+			assert_vcl_no_msg(std::abs(t_simulated + timer.accumulator - timer.t) < 1e-3f);
+			assert_vcl_no_msg(timer.step_dropped == 0);
+		}
+
+		// Spiral of death: a long frame is clamped to max_step_per_frame steps and the late time is dropped
+		{
+			timer_fixed_step timer(0.01f, 4);
+			int counter = 0;
+			int const N = timer.update(1.0f, [&](float) { ++counter; });
+			assert_vcl_no_msg(N == 4 && counter == 4);
+			assert_vcl_no_msg(timer.step_dropped == 96);
+			assert_vcl_no_msg(timer.accumulator < timer.step);
+		}
+
+		// Scale and stop
+		{
+			timer_fixed_step timer(1/64.0f);
+			timer.scale = 0.5f;
+			assert_vcl_no_msg(timer.update(4/64.0f, [](float) {}) == 2);
+			timer.stop();
+			assert_vcl_no_msg(timer.update(1.0f, [](float) {}) == 0);
+		}
+
+		// Interpolation of the display between the two last states
+		{
+			timer_fixed_step timer(0.5f);
+			timer.update(0.625f, [](float) {});
+			assert_vcl_no_msg(is_equal(timer.interpolate(1.0f, 2.0f), 1.25f));
+			buffer<vec3> result;
+			timer.interpolate(buffer<vec3>{ {0,0,0},{1,1,1} }, buffer<vec3>{ {4,0,0},{1,1,1} }, result);
+			assert_vcl_no_msg(is_equal(result[0], vec3{ 1,0,0 }) && is_equal(result[1], vec3{ 1,1,1 }));
+		}
+	}
+}
\ No newline at end of file
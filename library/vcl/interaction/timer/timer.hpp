@@ -3,4 +3,5 @@
 #include "timer_basic/timer_basic.hpp"
 #include "timer_event_periodic/timer_event_periodic.hpp"
 #include "timer_fps/timer_fps.hpp"
-#include "timer_interval/timer_interval.hpp"
\ No newline at end of file
+#include "timer_interval/timer_interval.hpp"
+#include "timer_fixed_step/timer_fixed_step.hpp"
\ No newline at end of file
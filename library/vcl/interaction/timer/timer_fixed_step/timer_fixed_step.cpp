@@ -0,0 +1,82 @@
+#include "timer_fixed_step.hpp"
+
+#include "vcl/base/base.hpp"
+
+#include <GLFW/glfw3.h>
+#include <chrono>
+
+namespace vcl
+{
+	timer_fixed_step::timer_fixed_step(float step_arg, int max_step_per_frame_arg)
+		:timer_basic(), step(step_arg), max_step_per_frame(max_step_per_frame_arg), accumulator(0), alpha(0)
+	{
+		reset_statistics();
+	}
+
+	int timer_fixed_step::update(std::function<void(float dt)> const& simulate)
+	{
+		if (!running)
+			return update(0.0f, simulate);
+
+		float const time_current = static_cast<float>(glfwGetTime());
+		float const dt_frame = time_current - time_previous;
+		time_previous = time_current;
+		return update(dt_frame, simulate);
+	}
+
+	int timer_fixed_step::update(float dt_frame, std::function<void(float dt)> const& simulate)
+	{
+		assert_vcl(step>0, "The time step of timer_fixed_step must be >0");
+		assert_vcl(max_step_per_frame>0, "timer_fixed_step requires max_step_per_frame>0");
+
+		if (running) {
+			accumulator += scale*dt_frame;
+			t += scale*dt_frame;
+		}
+
+		int N_step = static_cast<int>(accumulator/step);
+		if (N_step > max_step_per_frame) {
+			// The simulation cannot catch up with real time: the late steps are dropped
+			step_dropped += N_step - max_step_per_frame;
+			accumulator -= (N_step - max_step_per_frame)*step;
+			N_step = max_step_per_frame;
+		}
+
+		for (int k = 0; k < N_step; ++k)
+		{
+			auto const t0 = std::chrono::steady_clock::now();
+			simulate(step);
+			auto const t1 = std::chrono::steady_clock::now();
+
+			step_time_last = std::chrono::duration<float>(t1-t0).count();
+			step_time_max = std::max(step_time_max, step_time_last);
+			++step_total;
+			step_time_average += (step_time_last - step_time_average) / step_total;
+		}
+		accumulator -= N_step*step;
+		accumulator = std::max(accumulator, 0.0f);
+
+		alpha = std::min(accumulator/step, 1.0f);
+		step_last_frame = N_step;
+		return N_step;
+	}
+
+	void timer_fixed_step::interpolate(buffer<vec3> const& previous, buffer<vec3> const& current, buffer<vec3>& result) const
+	{
+		size_t const N = current.size();
+		assert_vcl(previous.size()==N, "Interpolation between buffers of different sizes ("+str(previous.size())+","+str(N)+")");
+		result.resize(N);
+		for (size_t k = 0; k < N; ++k)
+			result.data[k] = (1.0f-alpha)*previous.data[k] + alpha*current.data[k];
+	}
+
+	void timer_fixed_step::reset_statistics()
+	{
+		step_last_frame = 0;
+		step_total = 0;
+		step_dropped = 0;
+		step_time_last = 0;
+		step_time_average = 0;
+		step_time_max = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../timer_basic/timer_basic.hpp"
+#include "vcl/containers/containers.hpp"
+
+#include <functional>
+
+namespace vcl
+{
+	/** Scheduler running a simulation with a fixed time step, independently of the frame rate
+	*
+	* At each frame, the elapsed (scaled) time is added to an accumulator, and the simulation function is called once per fixed step contained in the accumulator.
+	* - The number of steps per frame is limited to max_step_per_frame: when the simulation is slower than real time, the remaining time is dropped (avoid the "spiral of death").
+	* - The remaining fraction of step, alpha in [0,1), is used to interpolate the display between the two last simulated states.
+	*
+	* Usage:
+	*   timer_fixed_step timer(1/120.0f);
+	*   timer.update([&](float dt){ previous = position; simulate(dt); });
+	*   display( timer.interpolate(previous, position) );
+	*
+	* update(dt_frame, ...) can be called directly with a given elapsed time (e.g. with a fake clock in tests) instead of reading the GLFW time. */
+	class timer_fixed_step
+		: public timer_basic
+	{
+	public:
+		timer_fixed_step(float step=1/60.0f, int max_step_per_frame=8);
+
+		/** Call simulate(step) as many times as needed to catch up with the elapsed time. Return the number of steps. */
+		int update(std::function<void(float dt)> const& simulate);
+		/** Same as update(simulate), but with an explicit elapsed time dt_frame (scaled by the timer scale) */
+		int update(float dt_frame, std::function<void(float dt)> const& simulate);
+
+		/** Interpolation (1-alpha) previous + alpha current between the two last simulated states */
+		template <typename T> T interpolate(T const& previous, T const& current) const;
+		void interpolate(buffer<vec3> const& previous, buffer<vec3> const& current, buffer<vec3>& result) const;
+
+		/** Duration of a simulation step */
+		float step;
+		/** Maximal number of steps per frame */
+		int max_step_per_frame;
+		/** Remaining time not yet simulated, and its ratio with respect to the step in [0,1) */
+		float accumulator;
+		float alpha;
+
+		/** Statistics */
+		int step_last_frame;         // Number of steps during the last frame
+		long long step_total;        // Total number of steps
+		long long step_dropped;      // Total number of steps skipped due to the max_step_per_frame limit
+		float step_time_last;        // Duration (in seconds, wall-clock time) of the last step
+		float step_time_average;     // Average duration of the steps
+		float step_time_max;         // Maximal duration of a step
+		void reset_statistics();
+	};
+
+	template <typename T> T timer_fixed_step::interpolate(T const& previous, T const& current) const
+	{
+		return (1.0f-alpha)*previous + alpha*current;
+	}
+}
\ No newline at end of file
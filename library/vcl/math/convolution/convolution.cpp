@@ -0,0 +1,44 @@
+#include "convolution.hpp"
+
+#include <cmath>
+
+namespace vcl
+{
+	buffer<float> kernel_gaussian(float sigma)
+	{
+		assert_vcl(sigma > 0, "Gaussian kernel with sigma=" + str(sigma));
+		int const r = int(std::ceil(3*sigma));
+		buffer<float> kernel(2*r+1);
+		float sum = 0.0f;
+		for (int k = -r; k <= r; ++k) {
+			kernel[k+r] = std::exp(-float(k*k) / (2*sigma*sigma));
+			sum += kernel[k+r];
+		}
+		for (float& w : kernel)
+			w /= sum;
+		return kernel;
+	}
+
+	buffer<float> kernel_box(size_t radius)
+	{
+		buffer<float> kernel(2*radius+1);
+		kernel.fill(1.0f / float(2*radius+1));
+		return kernel;
+	}
+
+	stencil_2D stencil_laplacian_2D()
+	{
+		stencil_2D stencil;
+		stencil.offset = { {0,0}, {-1,0}, {1,0}, {0,-1}, {0,1} };
+		stencil.weight = { -4.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+		return stencil;
+	}
+
+	stencil_3D stencil_laplacian_3D()
+	{
+		stencil_3D stencil;
+		stencil.offset = { {0,0,0}, {-1,0,0}, {1,0,0}, {0,-1,0}, {0,1,0}, {0,0,-1}, {0,0,1} };
+		stencil.weight = { -6.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+		return stencil;
+	}
+}
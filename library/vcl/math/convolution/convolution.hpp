@@ -0,0 +1,348 @@
+#pragma once
+
+#include "vcl/base/base.hpp"
+#include "vcl/containers/containers.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/* Convolutions and stencils on grid_2D and grid_3D (row-major layout)
+*  - convolve_separable: 1D kernel applied successively along each axis (ex. gaussian blur, box filter) - cost in O(kernel size) per element instead of O(kernel size^dimension).
+*  - convolve: small stencil given as offsets and weights (ex. laplacian, sharpening).
+*  - apply_stencil: any function of the neighborhood of each element (ex. min_filter / max_filter for morphological erosion / dilation).
+*  - The values outside of the grid are given by the boundary policy: clamp (nearest element), wrap (periodic grid), zero (T()).
+*
+*  The rows of the output are distributed over the threads (see base/parallel).
+*  For grids of float, vec2, vec3 and vec4 - such as the images grid_2D<vec3> from convert(image_raw, grid_2D<vec3>&) - the inner loops are weighted sums of whole rows
+*  computed with the vectorized kernel axpy of buffer_kernels (SSE/AVX). Other element types use a generic loop requiring T += float * T.
+*
+*  Ex. grid_2D<float> height = ...;
+*      grid_2D<float> smooth, laplacian;
+*      convolve_separable(height, smooth, kernel_gaussian(2.0f));
+*      convolve(height, laplacian, stencil_laplacian_2D());
+*/
+
+namespace vcl
+{
+    /** Values outside of the grid */
+    enum class boundary_policy { clamp, wrap, zero };
+
+    /** 1D kernels of odd size 2r+1: weight[r+k] is applied to the element at offset k */
+    buffer<float> kernel_gaussian(float sigma);  // radius ceil(3 sigma), weights summing to 1
+    buffer<float> kernel_box(size_t radius);     // 2r+1 weights equal to 1/(2r+1)
+
+    /** Stencils: weight[k] is applied to the element at offset[k] */
+    struct stencil_2D { buffer<int2> offset; buffer<float> weight; };
+    struct stencil_3D { buffer<int3> offset; buffer<float> weight; };
+    stencil_2D stencil_laplacian_2D(); // 5 points
+    stencil_3D stencil_laplacian_3D(); // 7 points
+
+    /** Read-only access to the neighbors of an element in apply_stencil: n(dx,dy) or n(dx,dy,dz), with |dx|,|dy|,|dz| <= radius */
+    template <typename T>
+    struct stencil_neighborhood
+    {
+        T const* center;
+        std::ptrdiff_t stride_y;
+        std::ptrdiff_t stride_z;
+
+        T const& operator()(int dx, int dy) const { return center[dx + stride_y*dy]; }
+        T const& operator()(int dx, int dy, int dz) const { return center[dx + stride_y*dy + stride_z*dz]; }
+    };
+
+
+    /** out = in convolved along x by kernel_x, then along y by kernel_y (resp. z by kernel_z)
+     * out is resized to the dimension of in, and must be a different grid. */
+    template <typename T, typename A1, typename A2>
+    void convolve_separable(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, buffer<float> const& kernel_x, buffer<float> const& kernel_y, boundary_policy boundary = boundary_policy::clamp);
+    template <typename T, typename A1, typename A2>
+    void convolve_separable(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, buffer<float> const& kernel, boundary_policy boundary = boundary_policy::clamp);
+    template <typename T, typename A1, typename A2>
+    void convolve_separable(grid_3D<T, A1, layout_row_major> const& in, grid_3D<T, A2, layout_row_major>& out, buffer<float> const& kernel_x, buffer<float> const& kernel_y, buffer<float> const& kernel_z, boundary_policy boundary = boundary_policy::clamp);
+    template <typename T, typename A1, typename A2>
+    void convolve_separable(grid_3D<T, A1, layout_row_major> const& in, grid_3D<T, A2, layout_row_major>& out, buffer<float> const& kernel, boundary_policy boundary = boundary_policy::clamp);
+
+    /** out(p) = sum_k stencil.weight[k] * in(p + stencil.offset[k]) */
+    template <typename T, typename A1, typename A2>
+    void convolve(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, stencil_2D const& stencil, boundary_policy boundary = boundary_policy::clamp);
+    template <typename T, typename A1, typename A2>
+    void convolve(grid_3D<T, A1, layout_row_major> const& in, grid_3D<T, A2, layout_row_major>& out, stencil_3D const& stencil, boundary_policy boundary = boundary_policy::clamp);
+
+    /** out(p) = f(n) where n is the stencil_neighborhood<T> of in around p, up to the given radius
+     * f is called concurrently from several threads. */
+    template <typename T, typename A1, typename A2, typename F>
+    void apply_stencil(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, int radius, F const& f, boundary_policy boundary = boundary_policy::clamp);
+    template <typename T, typename A1, typename A2, typename F>
+    void apply_stencil(grid_3D<T, A1, layout_row_major> const& in, grid_3D<T, A2, layout_row_major>& out, int radius, F const& f, boundary_policy boundary = boundary_policy::clamp);
+
+    /** Minimal (erosion) and maximal (dilation) value in the square of side 2r+1 around each element - scalar grids */
+    template <typename T, typename A1, typename A2>
+    void min_filter(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, int radius, boundary_policy boundary = boundary_policy::clamp);
+    template <typename T, typename A1, typename A2>
+    void max_filter(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, int radius, boundary_policy boundary = boundary_policy::clamp);
+}
+
+
+
+namespace vcl
+{
+    namespace detail
+    {
+        // Index in [0,N) of the element k given the boundary policy (-1 for an element with the value zero)
+        inline int boundary_index(int k, int N, boundary_policy boundary)
+        {
+            if (k >= 0 && k < N)
+                return k;
+            if (boundary == boundary_policy::clamp)
+                return k < 0 ? 0 : N-1;
+            if (boundary == boundary_policy::wrap) {
+                int const m = k % N;
+                return m < 0 ? m+N : m;
+            }
+            return -1;
+        }
+
+        // y[k] += a * x[k] for k in [0,n) - vectorized for float, vec2, vec3 and vec4
+        template <typename T> void convolution_axpy(float a, T const* x, T* y, size_t n)
+        {
+            for (size_t k = 0; k < n; ++k)
+                y[k] += a * x[k];
+        }
+        inline void convolution_axpy(float a, float const* x, float* y, size_t n) { kernel_axpy(a, x, y, n); }
+        inline void convolution_axpy(float a, vec2 const* x, vec2* y, size_t n) { kernel_axpy(a, &x[0].x, &y[0].x, 2*n); }
+        inline void convolution_axpy(float a, vec3 const* x, vec3* y, size_t n) { kernel_axpy(a, &x[0].x, &y[0].x, 3*n); }
+        inline void convolution_axpy(float a, vec4 const* x, vec4* y, size_t n) { kernel_axpy(a, &x[0].x, &y[0].x, 4*n); }
+
+        // Number of rows of Nx elements per task of the parallel loops
+        inline size_t convolution_grain(size_t Nx)
+        {
+            return std::max<size_t>(1, 8192 / std::max<size_t>(1, Nx));
+        }
+
+        inline int kernel_radius(buffer<float> const& kernel)
+        {
+            assert_vcl(kernel.size()%2 == 1, "Convolution kernel of odd size expected (size " + str(kernel.size()) + ")");
+            return int(kernel.size()/2);
+        }
+
+        // Copy of the row of N elements with r elements on each side given by the boundary policy
+        template <typename T> void pad_row(T const* row, int N, int r, boundary_policy boundary, T* padded)
+        {
+            for (int k = -r; k < 0; ++k) {
+                int const idx = boundary_index(k, N, boundary);
+                padded[k+r] = idx < 0 ? T() : row[idx];
+            }
+            std::copy(row, row+N, padded+r);
+            for (int k = N; k < N+r; ++k) {
+                int const idx = boundary_index(k, N, boundary);
+                padded[k+r] = idx < 0 ? T() : row[idx];
+            }
+        }
+
+        // Convolution along x of N_row contiguous rows of Nx elements
+        template <typename T> void convolve_along_x(T const* in, T* out, size_t Nx, size_t N_row, buffer<float> const& kernel, boundary_policy boundary)
+        {
+            int const r = kernel_radius(kernel);
+            parallel_for_range(N_row, [=, &kernel](size_t k_begin, size_t k_end) {
+                std::vector<T> padded(Nx + 2*r);
+                for (size_t k = k_begin; k < k_end; ++k) {
+                    T* out_row = out + k*Nx;
+                    pad_row(in + k*Nx, int(Nx), r, boundary, padded.data());
+                    std::fill(out_row, out_row+Nx, T());
+                    for (int j = 0; j <= 2*r; ++j)
+                        if (kernel.at_unsafe(j) != 0.0f)
+                            convolution_axpy(kernel.at_unsafe(j), padded.data()+j, out_row, Nx);
+                }
+            }, convolution_grain(Nx));
+        }
+
+        // Convolution along an axis of N_axis rows of Nx contiguous elements separated by axis_stride elements, repeated for N_outer blocks separated by outer_stride elements
+        //  ex. along y in 2D: axis_stride=Nx, N_axis=Ny, N_outer=1 ; along z in 3D: the slices z are rows of Nx*Ny elements, axis_stride=Nx*Ny, N_axis=Nz, N_outer=1
+        template <typename T> void convolve_along_axis(T const* in, T* out, size_t Nx, size_t N_axis, size_t axis_stride, size_t N_outer, size_t outer_stride, buffer<float> const& kernel, boundary_policy boundary)
+        {
+            int const r = kernel_radius(kernel);
+            parallel_for_range(N_outer*N_axis, [=, &kernel](size_t k_begin, size_t k_end) {
+                for (size_t k = k_begin; k < k_end; ++k) {
+                    size_t const outer = k / N_axis;
+                    int const a = int(k % N_axis);
+                    T* out_row = out + outer*outer_stride + a*axis_stride;
+                    std::fill(out_row, out_row+Nx, T());
+                    for (int j = 0; j <= 2*r; ++j) {
+                        int const idx = boundary_index(a+j-r, int(N_axis), boundary);
+                        if (idx >= 0 && kernel.at_unsafe(j) != 0.0f)
+                            convolution_axpy(kernel.at_unsafe(j), in + outer*outer_stride + idx*axis_stride, out_row, Nx);
+                    }
+                }
+            }, convolution_grain(Nx));
+        }
+
+        // Copy of the grid (Nx,Ny,Nz) with r[d] elements on each side along each axis given by the boundary policy
+        template <typename T> std::vector<T> pad_grid(T const* in, int3 const& N, int3 const& r, boundary_policy boundary)
+        {
+            int3 const Np = { N.x+2*r.x, N.y+2*r.y, N.z+2*r.z };
+            std::vector<T> padded(size_t(Np.x)*Np.y*Np.z);
+            parallel_for_range(size_t(Np.y)*Np.z, [&](size_t k_begin, size_t k_end) {
+                for (size_t k = k_begin; k < k_end; ++k) {
+                    int const yp = int(k % Np.y), zp = int(k / Np.y);
+                    T* row = padded.data() + k*Np.x;
+                    int const y = boundary_index(yp - r.y, N.y, boundary);
+                    int const z = boundary_index(zp - r.z, N.z, boundary);
+                    if (y < 0 || z < 0)
+                        std::fill(row, row+Np.x, T());
+                    else
+                        pad_row(in + (size_t(z)*N.y + y)*N.x, N.x, r.x, boundary, row);
+                }
+            }, convolution_grain(Np.x));
+            return padded;
+        }
+
+        // out(p) = sum_k weight[k] * in(p + offset[k]) on the grid (Nx,Ny,Nz)
+        template <typename T> void convolve_stencil(T const* in, T* out, int3 const& N, buffer<int3> const& offset, buffer<float> const& weight, boundary_policy boundary)
+        {
+            assert_vcl(offset.size() == weight.size(), "Stencil with " + str(offset.size()) + " offsets and " + str(weight.size()) + " weights");
+            int3 r = { 0,0,0 };
+            for (int3 const& o : offset)
+                r = { std::max(r.x, std::abs(o.x)), std::max(r.y, std::abs(o.y)), std::max(r.z, std::abs(o.z)) };
+
+            // Rows padded along x only: the rows along y and z are selected with the boundary policy
+            std::vector<T> const padded = pad_grid(in, N, int3{ r.x,0,0 }, boundary);
+            size_t const Npx = size_t(N.x + 2*r.x);
+            parallel_for_range(size_t(N.y)*N.z, [&](size_t k_begin, size_t k_end) {
+                for (size_t k = k_begin; k < k_end; ++k) {
+                    int const y = int(k % N.y), z = int(k / N.y);
+                    T* out_row = out + k*N.x;
+                    std::fill(out_row, out_row+N.x, T());
+                    for (size_t s = 0; s < offset.size(); ++s) {
+                        int3 const& o = offset.at_unsafe(s);
+                        int const ys = boundary_index(y + o.y, N.y, boundary);
+                        int const zs = boundary_index(z + o.z, N.z, boundary);
+                        if (ys >= 0 && zs >= 0)
+                            convolution_axpy(weight.at_unsafe(s), padded.data() + (size_t(zs)*N.y + ys)*Npx + r.x + o.x, out_row, size_t(N.x));
+                    }
+                }
+            }, convolution_grain(size_t(N.x)));
+        }
+
+        // out(p) = f(neighborhood of p) on the grid (Nx,Ny,Nz)
+        template <typename T, typename F> void apply_stencil(T const* in, T* out, int3 const& N, int3 const& r, F const& f, boundary_policy boundary)
+        {
+            std::vector<T> const padded = pad_grid(in, N, r, boundary);
+            int3 const Np = { N.x+2*r.x, N.y+2*r.y, N.z+2*r.z };
+            parallel_for_range(size_t(N.y)*N.z, [&](size_t k_begin, size_t k_end) {
+                stencil_neighborhood<T> n = { nullptr, std::ptrdiff_t(Np.x), std::ptrdiff_t(Np.x)*Np.y };
+                for (size_t k = k_begin; k < k_end; ++k) {
+                    int const y = int(k % N.y), z = int(k / N.y);
+                    T const* center_row = padded.data() + (size_t(z+r.z)*Np.y + (y+r.y))*Np.x + r.x;
+                    T* out_row = out + k*N.x;
+                    for (int x = 0; x < N.x; ++x) {
+                        n.center = center_row + x;
+                        out_row[x] = f(n);
+                    }
+                }
+            }, convolution_grain(size_t(N.x)));
+        }
+
+        // Resize out to the dimension of in - returns false if there is no element to compute
+        template <typename GridIn, typename GridOut> bool convolution_prepare(GridIn const& in, GridOut& out)
+        {
+            assert_vcl(static_cast<void const*>(&in) != static_cast<void const*>(&out), "The input and output grids of a convolution must be different");
+            out.resize(in.dimension);
+            return in.size() > 0;
+        }
+    }
+
+
+    template <typename T, typename A1, typename A2>
+    void convolve_separable(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, buffer<float> const& kernel_x, buffer<float> const& kernel_y, boundary_policy boundary)
+    {
+        if (detail::convolution_prepare(in, out) == false)
+            return;
+        size_t const Nx = in.dimension.x, Ny = in.dimension.y;
+        grid_2D<T> tmp(in.dimension);
+        detail::convolve_along_x(in.data.data.data(), tmp.data.data.data(), Nx, Ny, kernel_x, boundary);
+        detail::convolve_along_axis(tmp.data.data.data(), out.data.data.data(), Nx, Ny, Nx, 1, 0, kernel_y, boundary);
+    }
+
+    template <typename T, typename A1, typename A2>
+    void convolve_separable(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, buffer<float> const& kernel, boundary_policy boundary)
+    {
+        convolve_separable(in, out, kernel, kernel, boundary);
+    }
+
+    template <typename T, typename A1, typename A2>
+    void convolve_separable(grid_3D<T, A1, layout_row_major> const& in, grid_3D<T, A2, layout_row_major>& out, buffer<float> const& kernel_x, buffer<float> const& kernel_y, buffer<float> const& kernel_z, boundary_policy boundary)
+    {
+        if (detail::convolution_prepare(in, out) == false)
+            return;
+        size_t const Nx = in.dimension.x, Ny = in.dimension.y, Nz = in.dimension.z;
+        grid_3D<T> tmp(in.dimension);
+        detail::convolve_along_x(in.data.data.data(), out.data.data.data(), Nx, Ny*Nz, kernel_x, boundary);
+        detail::convolve_along_axis(out.data.data.data(), tmp.data.data.data(), Nx, Ny, Nx, Nz, Nx*Ny, kernel_y, boundary);
+        detail::convolve_along_axis(tmp.data.data.data(), out.data.data.data(), Nx*Ny, Nz, Nx*Ny, 1, 0, kernel_z, boundary);
+    }
+
+    template <typename T, typename A1, typename A2>
+    void convolve_separable(grid_3D<T, A1, layout_row_major> const& in, grid_3D<T, A2, layout_row_major>& out, buffer<float> const& kernel, boundary_policy boundary)
+    {
+        convolve_separable(in, out, kernel, kernel, kernel, boundary);
+    }
+
+    template <typename T, typename A1, typename A2>
+    void convolve(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, stencil_2D const& stencil, boundary_policy boundary)
+    {
+        if (detail::convolution_prepare(in, out) == false)
+            return;
+        buffer<int3> offset(stencil.offset.size());
+        for (size_t k = 0; k < offset.size(); ++k)
+            offset[k] = { stencil.offset[k].x, stencil.offset[k].y, 0 };
+        detail::convolve_stencil(in.data.data.data(), out.data.data.data(), int3{ int(in.dimension.x), int(in.dimension.y), 1 }, offset, stencil.weight, boundary);
+    }
+
+    template <typename T, typename A1, typename A2>
+    void convolve(grid_3D<T, A1, layout_row_major> const& in, grid_3D<T, A2, layout_row_major>& out, stencil_3D const& stencil, boundary_policy boundary)
+    {
+        if (detail::convolution_prepare(in, out) == false)
+            return;
+        detail::convolve_stencil(in.data.data.data(), out.data.data.data(), int3{ int(in.dimension.x), int(in.dimension.y), int(in.dimension.z) }, stencil.offset, stencil.weight, boundary);
+    }
+
+    template <typename T, typename A1, typename A2, typename F>
+    void apply_stencil(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, int radius, F const& f, boundary_policy boundary)
+    {
+        if (detail::convolution_prepare(in, out) == false)
+            return;
+        detail::apply_stencil(in.data.data.data(), out.data.data.data(), int3{ int(in.dimension.x), int(in.dimension.y), 1 }, int3{ radius, radius, 0 }, f, boundary);
+    }
+
+    template <typename T, typename A1, typename A2, typename F>
+    void apply_stencil(grid_3D<T, A1, layout_row_major> const& in, grid_3D<T, A2, layout_row_major>& out, int radius, F const& f, boundary_policy boundary)
+    {
+        if (detail::convolution_prepare(in, out) == false)
+            return;
+        detail::apply_stencil(in.data.data.data(), out.data.data.data(), int3{ int(in.dimension.x), int(in.dimension.y), int(in.dimension.z) }, int3{ radius, radius, radius }, f, boundary);
+    }
+
+    template <typename T, typename A1, typename A2>
+    void min_filter(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, int radius, boundary_policy boundary)
+    {
+        apply_stencil(in, out, radius, [radius](stencil_neighborhood<T> const& n) {
+            T value = n(0, 0);
+            for (int dy = -radius; dy <= radius; ++dy)
+                for (int dx = -radius; dx <= radius; ++dx)
+                    value = std::min(value, n(dx, dy));
+            return value;
+        }, boundary);
+    }
+
+    template <typename T, typename A1, typename A2>
+    void max_filter(grid_2D<T, A1, layout_row_major> const& in, grid_2D<T, A2, layout_row_major>& out, int radius, boundary_policy boundary)
+    {
+        apply_stencil(in, out, radius, [radius](stencil_neighborhood<T> const& n) {
+            T value = n(0, 0);
+            for (int dy = -radius; dy <= radius; ++dy)
+                for (int dx = -radius; dx <= radius; ++dx)
+                    value = std::max(value, n(dx, dy));
+            return value;
+        }, boundary);
+    }
+}
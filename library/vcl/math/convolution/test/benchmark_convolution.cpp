@@ -0,0 +1,96 @@
+#include "benchmark_convolution.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+#include "vcl/base/test/benchmark_timing.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Blur written directly with the bounds-checked operator()(x,y) and clamped indices: separable passes along x then y
+	template <typename T> static void blur_hand_written(grid_2D<T> const& in, grid_2D<T>& out, buffer<float> const& kernel)
+	{
+		int const Nx = int(in.dimension.x), Ny = int(in.dimension.y), r = int(kernel.size()/2);
+		grid_2D<T> tmp(in.dimension);
+		out.resize(in.dimension);
+		for (int y = 0; y < Ny; ++y)
+			for (int x = 0; x < Nx; ++x) {
+				T s = T();
+				for (int j = -r; j <= r; ++j)
+					s += kernel[j+r] * in(std::min(std::max(x+j, 0), Nx-1), y);
+				tmp(x, y) = s;
+			}
+		for (int y = 0; y < Ny; ++y)
+			for (int x = 0; x < Nx; ++x) {
+				T s = T();
+				for (int j = -r; j <= r; ++j)
+					s += kernel[j+r] * tmp(x, std::min(std::max(y+j, 0), Ny-1));
+				out(x, y) = s;
+			}
+	}
+
+	static void laplacian_hand_written(grid_2D<float> const& in, grid_2D<float>& out)
+	{
+		int const Nx = int(in.dimension.x), Ny = int(in.dimension.y);
+		out.resize(in.dimension);
+		for (int y = 0; y < Ny; ++y)
+			for (int x = 0; x < Nx; ++x)
+				out(x, y) = in(std::max(x-1, 0), y) + in(std::min(x+1, Nx-1), y) + in(x, std::max(y-1, 0)) + in(x, std::min(y+1, Ny-1)) - 4*in(x, y);
+	}
+
+	// Time f with the given instruction set and number of threads
+	template <typename F> static void benchmark_configurations(std::string const& name, F const& f, int N_repeat)
+	{
+		simd_level const level = simd_level_supported();
+		std::cout << "  " << name << std::endl;
+		parallel_set_thread_count(1);
+		simd_level_set(simd_level::scalar);
+		std::cout << "    scalar, 1 thread          : " << timing(f, N_repeat) << " ms" << std::endl;
+		simd_level_set(level);
+		std::cout << "    " << str(level) << ", 1 thread             : " << timing(f, N_repeat) << " ms" << std::endl;
+		parallel_set_thread_count(0);
+		std::cout << "    " << str(level) << ", " << parallel_thread_count() << " threads            : " << timing(f, N_repeat) << " ms" << std::endl;
+	}
+
+	void benchmark_convolution()
+	{
+		float checksum = 0.0f;
+		size_t const N = 2048;
+
+		grid_2D<float> height(N, N), height_out;
+		for (size_t k = 0; k < height.size(); ++k)
+			height[k] = float((k*7919) % 101);
+		grid_2D<vec3> image(N, N), image_out;
+		for (size_t k = 0; k < image.size(); ++k)
+			image[k] = { float(k%13), float(k%17), float(k%19) };
+		buffer<float> const gaussian = kernel_gaussian(2.0f);
+
+		std::cout << "Gaussian blur (sigma=2, " << gaussian.size() << " taps) of grid_2D<float> " << N << "x" << N << std::endl;
+		std::cout << "  hand-written operator()     : " << timing([&]() { blur_hand_written(height, height_out, gaussian); checksum += height_out(1, 1); }, 3) << " ms" << std::endl;
+		benchmark_configurations("convolve_separable", [&]() { convolve_separable(height, height_out, gaussian); checksum += height_out(1, 1); }, 5);
+
+		std::cout << "Gaussian blur of grid_2D<vec3> image " << N << "x" << N << std::endl;
+		std::cout << "  hand-written operator()     : " << timing([&]() { blur_hand_written(image, image_out, gaussian); checksum += image_out(1, 1).x; }, 3) << " ms" << std::endl;
+		benchmark_configurations("convolve_separable", [&]() { convolve_separable(image, image_out, gaussian); checksum += image_out(1, 1).x; }, 5);
+
+		std::cout << "Laplacian of grid_2D<float> " << N << "x" << N << std::endl;
+		std::cout << "  hand-written operator()     : " << timing([&]() { laplacian_hand_written(height, height_out); checksum += height_out(1, 1); }, 5) << " ms" << std::endl;
+		benchmark_configurations("convolve (5-point stencil)", [&]() { convolve(height, height_out, stencil_laplacian_2D()); checksum += height_out(1, 1); }, 5);
+
+		std::cout << "Erosion (min filter 3x3) of grid_2D<float> " << N << "x" << N << std::endl;
+		benchmark_configurations("min_filter", [&]() { min_filter(height, height_out, 1); checksum += height_out(1, 1); }, 5);
+
+		grid_3D<float> volume(size_t3{ 256,256,256 }), volume_out;
+		for (size_t k = 0; k < volume.size(); ++k)
+			volume[k] = float(k % 23);
+		std::cout << "Gaussian blur of grid_3D<float> 256^3" << std::endl;
+		benchmark_configurations("convolve_separable", [&]() { convolve_separable(volume, volume_out, gaussian); checksum += volume_out(1, 1, 1); }, 3);
+
+		std::cout << "(checksum " << checksum << ")" << std::endl;
+	}
+}
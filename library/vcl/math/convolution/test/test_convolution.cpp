@@ -0,0 +1,178 @@
+#include "test_convolution.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/containers/containers.hpp"
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Value of the element k of a row of N elements given the boundary policy (reference implementation)
+	template <typename T, typename Get> static T reference_value(int x, int y, int z, int3 const& N, boundary_policy boundary, Get const& get)
+	{
+		int const p[3] = { x,y,z };
+		int q[3];
+		int const n[3] = { N.x, N.y, N.z };
+		for (int d = 0; d < 3; ++d) {
+			q[d] = p[d];
+			if (q[d] < 0 || q[d] >= n[d]) {
+				if (boundary == boundary_policy::zero)
+					return T();
+				if (boundary == boundary_policy::clamp)
+					q[d] = q[d] < 0 ? 0 : n[d]-1;
+				else
+					q[d] = ((q[d] % n[d]) + n[d]) % n[d];
+			}
+		}
+		return get(q[0], q[1], q[2]);
+	}
+
+	template <typename T> static grid_2D<T> reference_convolve(grid_2D<T> const& in, buffer<float> const& kx, buffer<float> const& ky, boundary_policy boundary)
+	{
+		int3 const N = { int(in.dimension.x), int(in.dimension.y), 1 };
+		int const rx = int(kx.size()/2), ry = int(ky.size()/2);
+		grid_2D<T> out(in.dimension);
+		for (int y = 0; y < N.y; ++y)
+			for (int x = 0; x < N.x; ++x) {
+				T s = T();
+				for (int j = -ry; j <= ry; ++j)
+					for (int i = -rx; i <= rx; ++i)
+						s += kx[i+rx] * ky[j+ry] * reference_value<T>(x+i, y+j, 0, N, boundary, [&](int a, int b, int) { return in(a, b); });
+				out(x, y) = s;
+			}
+		return out;
+	}
+
+	void test_convolution()
+	{
+		boundary_policy const boundaries[3] = { boundary_policy::clamp, boundary_policy::wrap, boundary_policy::zero };
+
+		// Kernels
+		{
+			buffer<float> const g = kernel_gaussian(1.5f);
+			assert_vcl_no_msg(g.size() == 11 && is_equal(sum(g), 1.0f) && is_equal(g[4], g[6]) && g[5] > g[4]);
+			buffer<float> const b = kernel_box(2);
+			assert_vcl_no_msg(b.size() == 5 && is_equal(b[0], 0.2f) && is_equal(b[4], 0.2f));
+		}
+
+		// Separable convolution of a scalar grid compared to the direct 2D sum, for each boundary policy
+		{
+			grid_2D<float> in(23, 7); // kernel larger than the grid along y
+			for (size_t k = 0; k < in.size(); ++k)
+				in[k] = float((k*37) % 11) - 5.0f;
+			buffer<float> const kx = { 0.1f, 0.2f, 0.4f, 0.2f, 0.1f };
+			buffer<float> const ky = kernel_gaussian(3.0f);
+
+			for (boundary_policy boundary : boundaries) {
+				grid_2D<float> out;
+				convolve_separable(in, out, kx, ky, boundary);
+				grid_2D<float> const expected = reference_convolve(in, kx, ky, boundary);
+				assert_vcl_no_msg(out.dimension.x == 23 && out.dimension.y == 7);
+				for (size_t k = 0; k < out.size(); ++k)
+					assert_vcl_no_msg(std::abs(out[k] - expected[k]) < 1e-4f);
+			}
+		}
+
+		// Images grid_2D<vec3> (vectorized path) and generic types (double)
+		{
+			grid_2D<vec3> image(17, 9);
+			grid_2D<double> value(17, 9);
+			for (size_t k = 0; k < image.size(); ++k) {
+				image[k] = { float(k%5), float(k%3), float(k%7) };
+				value[k] = double(k%5);
+			}
+			buffer<float> const kernel = kernel_box(1);
+
+			grid_2D<vec3> blur;
+			convolve_separable(image, blur, kernel, boundary_policy::wrap);
+			grid_2D<vec3> const expected = reference_convolve(image, kernel, kernel, boundary_policy::wrap);
+			for (size_t k = 0; k < blur.size(); ++k)
+				assert_vcl_no_msg(norm(blur[k] - expected[k]) < 1e-4f);
+
+			grid_2D<double> blur_value;
+			convolve_separable(value, blur_value, kernel, boundary_policy::wrap);
+			for (size_t k = 0; k < blur_value.size(); ++k)
+				assert_vcl_no_msg(std::abs(blur_value[k] - double(expected[k].x)) < 1e-4);
+		}
+
+		// Stencil: laplacian of a quadratic function is constant inside the grid
+		{
+			grid_2D<float> f(12, 10);
+			for (size_t y = 0; y < 10; ++y)
+				for (size_t x = 0; x < 12; ++x)
+					f(x, y) = float(x*x + 2*y*y);
+			grid_2D<float> laplacian;
+			convolve(f, laplacian, stencil_laplacian_2D());
+			for (size_t y = 1; y < 9; ++y)
+				for (size_t x = 1; x < 11; ++x)
+					assert_vcl_no_msg(is_equal(laplacian(x, y), 6.0f));
+			assert_vcl_no_msg(is_equal(laplacian(0, 5), f(1, 5) - f(0, 5) + f(0, 4) + f(0, 6) - 2*f(0, 5))); // clamp: f(-1,5) = f(0,5)
+
+			grid_3D<float> g(size_t3{ 6,5,4 });
+			for (size_t z = 0; z < 4; ++z)
+				for (size_t y = 0; y < 5; ++y)
+					for (size_t x = 0; x < 6; ++x)
+						g(x, y, z) = float(x*x + y*y + 3*z*z);
+			grid_3D<float> laplacian_3D;
+			convolve(g, laplacian_3D, stencil_laplacian_3D(), boundary_policy::zero);
+			assert_vcl_no_msg(is_equal(laplacian_3D(2, 2, 2), 10.0f));
+			assert_vcl_no_msg(is_equal(laplacian_3D(0, 0, 0), g(1, 0, 0) + g(0, 1, 0) + g(0, 0, 1) - 6*g(0, 0, 0)));
+
+			// Non symmetric stencil: shift by (-2,1) with wrap
+			stencil_2D shift;
+			shift.offset = { {-2,1} };
+			shift.weight = { 1.0f };
+			grid_2D<float> shifted;
+			convolve(f, shifted, shift, boundary_policy::wrap);
+			assert_vcl_no_msg(is_equal(shifted(0, 9), f(10, 0)) && is_equal(shifted(5, 3), f(3, 4)));
+		}
+
+		// Separable convolution in 3D compared to the direct sum
+		{
+			grid_3D<float> in(size_t3{ 9,6,5 });
+			for (size_t k = 0; k < in.size(); ++k)
+				in[k] = float((k*13) % 7);
+			buffer<float> const kx = kernel_box(1), ky = { 0.25f, 0.5f, 0.25f }, kz = kernel_gaussian(0.8f);
+			int3 const N = { 9,6,5 };
+			for (boundary_policy boundary : boundaries) {
+				grid_3D<float> out;
+				convolve_separable(in, out, kx, ky, kz, boundary);
+				for (int z = 0; z < N.z; ++z)
+					for (int y = 0; y < N.y; ++y)
+						for (int x = 0; x < N.x; ++x) {
+							float s = 0.0f;
+							for (int k = -3; k <= 3; ++k)
+								for (int j = -1; j <= 1; ++j)
+									for (int i = -1; i <= 1; ++i)
+										s += kx[i+1]*ky[j+1]*kz[k+3] * reference_value<float>(x+i, y+j, z+k, N, boundary, [&](int a, int b, int c) { return in(a, b, c); });
+							assert_vcl_no_msg(std::abs(out(x, y, z) - s) < 1e-4f);
+						}
+			}
+		}
+
+		// Generic stencil function: erosion, dilation and a median-like filter
+		{
+			grid_2D<float> h(8, 6);
+			h.fill(1.0f);
+			h(3, 2) = 5.0f;
+			h(6, 4) = -2.0f;
+
+			grid_2D<float> eroded, dilated;
+			min_filter(h, eroded, 1);
+			max_filter(h, dilated, 1);
+			assert_vcl_no_msg(is_equal(eroded(5, 3), -2.0f) && is_equal(eroded(7, 5), -2.0f) && is_equal(eroded(3, 2), 1.0f) && is_equal(eroded(0, 0), 1.0f));
+			assert_vcl_no_msg(is_equal(dilated(2, 1), 5.0f) && is_equal(dilated(4, 3), 5.0f) && is_equal(dilated(5, 2), 1.0f) && is_equal(dilated(6, 4), 1.0f));
+
+			grid_2D<float> count;
+			apply_stencil(h, count, 2, [](stencil_neighborhood<float> const& n) {
+				float c = 0.0f;
+				for (int dy = -2; dy <= 2; ++dy)
+					for (int dx = -2; dx <= 2; ++dx)
+						c += n(dx, dy) > 2.0f ? 1.0f : 0.0f;
+				return c;
+			}, boundary_policy::wrap);
+			assert_vcl_no_msg(is_equal(count(1, 0), 1.0f) && is_equal(count(6, 2), 0.0f) && is_equal(sum(count.data), 25.0f));
+		}
+	}
+}
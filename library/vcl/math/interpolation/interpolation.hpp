@@ -8,37 +8,55 @@ namespace vcl
     * - value: grid_2D - coordinates assumed to be its indices
     * - (x,y): coordinates assumed to be \in [0,value.dimension.x-1] X [0,value.dimension.y]
     */
-    template <typename T>
-    T interpolation_bilinear(grid_2D<T> const& value, float x, float y);
+    template <typename T, typename Allocator, typename Layout>
+    T interpolation_bilinear(grid_2D<T, Allocator, Layout> const& value, float x, float y);
+    /** Version on a view (ex. a subview of a larger grid: the coordinates are relative to the view)
+    * The coordinates are checked with the policy of the view, the four values are then read without bound checking */
+    template <typename T, typename Check>
+    T interpolation_bilinear(grid_2D_view<T const, Check> const& value, float x, float y);
 }
 
 namespace vcl
 {
-    template <typename T>
-    T interpolation_bilinear(grid_2D<T> const& value, float x, float y)
+    namespace detail
     {
-	    int const x0 = int(std::floor(x));
-        int const y0 = int(std::floor(y));
-        int const x1 = x0+1;
-        int const y1 = y0+1;
-
-	    assert_vcl_no_msg(x0>=0 && x0<value.dimension.x);
-	    assert_vcl_no_msg(x1>=0 && x1<value.dimension.x);
-	    assert_vcl_no_msg(y0>=0 && y0<value.dimension.y);
-	    assert_vcl_no_msg(y1>=0 && y1<value.dimension.y);
-
-	    float const dx = x-x0;
-        float const dy = y-y0;
-
-	    assert_vcl_no_msg(dx>=0 && dx<1);
-        assert_vcl_no_msg(dy>=0 && dy<1);
+        // Bilinear interpolation on a grid_2D or a grid_2D_view (any type providing dimension and at_unsafe(x,y))
+        template <typename T, typename Check, typename Grid>
+        T interpolation_bilinear(Grid const& value, float x, float y)
+        {
+	        int const x0 = int(std::floor(x));
+            int const y0 = int(std::floor(y));
+            int const x1 = x0+1;
+            int const y1 = y0+1;
+
+	        if (Check::enabled && (x0<0 || size_t(x1)>=value.dimension.x || y0<0 || size_t(y1)>=value.dimension.y))
+	            error_vcl("Bilinear interpolation at ("+str(x)+","+str(y)+") outside of a grid of dimension "+str(value.dimension));
+
+	        float const dx = x-x0;
+            float const dy = y-y0;
+
+	        assert_vcl_no_msg(dx>=0 && dx<1);
+            assert_vcl_no_msg(dy>=0 && dy<1);
+
+            T const v =
+                    (1-dx)*(1-dy)*value.at_unsafe(x0,y0) +
+                    (1-dx)*dy*value.at_unsafe(x0,y1) +
+                    dx*(1-dy)*value.at_unsafe(x1,y0) +
+                    dx*dy*value.at_unsafe(x1,y1);
+
+	        return v;
+        }
+    }
 
-        T const v =
-                (1-dx)*(1-dy)*value(x0,y0) +
-                (1-dx)*dy*value(x0,y1) +
-                dx*(1-dy)*value(x1,y0) +
-                dx*dy*value(x1,y1);
+    template <typename T, typename Allocator, typename Layout>
+    T interpolation_bilinear(grid_2D<T, Allocator, Layout> const& value, float x, float y)
+    {
+        return detail::interpolation_bilinear<T, bounds_check_default>(value, x, y);
+    }
 
-	    return v;
+    template <typename T, typename Check>
+    T interpolation_bilinear(grid_2D_view<T const, Check> const& value, float x, float y)
+    {
+        return detail::interpolation_bilinear<T, Check>(value, x, y);
     }
 }
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include "matrix/matrix.hpp"
 #include "vec_mat/vec_mat.hpp"
 #include "quaternion/quaternion.hpp"
+#include "quaternion/quaternion_batch.hpp"
 #include "rotation/rotation.hpp"
 #include "affine/affine.hpp"
 #include "frame/frame.hpp"
 #include "projection/projection.hpp"
 #include "interpolation/interpolation.hpp"
+#include "convolution/convolution.hpp"
+#include "random/random.hpp"
@@ -0,0 +1,287 @@
+#include "quaternion_batch.hpp"
+
+#include "vcl/base/base.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#define VCL_QUATERNION_SSE
+#endif
+
+namespace vcl
+{
+	// Coefficients of the polynomial approximation of slerp (D. Eberly, "A fast and accurate algorithm for computing SLERP")
+	//  u[i] = 1/((i+1)(2i+3)), v[i] = (i+1)/(2i+3), and the last term is scaled by mu to compensate the truncation of the series.
+	//  12 terms with mu=1.89372 give a maximal error of 7e-7 on the coefficients (8 terms as in the article give 2e-5).
+	static int const slerp_terms = 12;
+	static float const slerp_mu = 1.89372f;
+	static float slerp_coefficient_u(int i) { return (i==slerp_terms-1 ? slerp_mu : 1.0f) / ((i+1)*(2*i+3)); }
+	static float slerp_coefficient_v(int i) { return (i==slerp_terms-1 ? slerp_mu : 1.0f) * (i+1) / (2*i+3); }
+	static float const slerp_u[slerp_terms] = { slerp_coefficient_u(0), slerp_coefficient_u(1), slerp_coefficient_u(2), slerp_coefficient_u(3), slerp_coefficient_u(4), slerp_coefficient_u(5),
+	                                            slerp_coefficient_u(6), slerp_coefficient_u(7), slerp_coefficient_u(8), slerp_coefficient_u(9), slerp_coefficient_u(10), slerp_coefficient_u(11) };
+	static float const slerp_v[slerp_terms] = { slerp_coefficient_v(0), slerp_coefficient_v(1), slerp_coefficient_v(2), slerp_coefficient_v(3), slerp_coefficient_v(4), slerp_coefficient_v(5),
+	                                            slerp_coefficient_v(6), slerp_coefficient_v(7), slerp_coefficient_v(8), slerp_coefficient_v(9), slerp_coefficient_v(10), slerp_coefficient_v(11) };
+
+
+	// Scalar kernels (remaining elements)
+
+	static inline quaternion multiply_scalar(quaternion const& a, quaternion const& b)
+	{
+		return quaternion{
+			a.x*b.w + a.w*b.x + a.y*b.z - a.z*b.y,
+			a.y*b.w + a.w*b.y + a.z*b.x - a.x*b.z,
+			a.z*b.w + a.w*b.z + a.x*b.y - a.y*b.x,
+			a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z };
+	}
+
+	// p + w t + v x t, with t = 2 v x p
+	static inline vec3 rotate_scalar(quaternion const& q, vec3 const& p)
+	{
+		float const tx = 2*(q.y*p.z - q.z*p.y);
+		float const ty = 2*(q.z*p.x - q.x*p.z);
+		float const tz = 2*(q.x*p.y - q.y*p.x);
+		return { p.x + q.w*tx + q.y*tz - q.z*ty, p.y + q.w*ty + q.z*tx - q.x*tz, p.z + q.w*tz + q.x*ty - q.y*tx };
+	}
+
+	static inline quaternion normalize_scalar(quaternion const& q)
+	{
+		float const inv = 1.0f/std::sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+		return quaternion{ q.x*inv, q.y*inv, q.z*inv, q.w*inv };
+	}
+
+	static inline mat3 matrix_scalar(quaternion const& q)
+	{
+		float const x = q.x, y = q.y, z = q.z, w = q.w;
+		return mat3{
+			1-2*(y*y+z*z), 2*(x*y-w*z), 2*(x*z+w*y),
+			2*(x*y+w*z), 1-2*(x*x+z*z), 2*(y*z-w*x),
+			2*(x*z-w*y), 2*(y*z+w*x), 1-2*(x*x+y*y) };
+	}
+
+	static inline quaternion slerp_scalar(quaternion const& a, quaternion b, float t)
+	{
+		float x = a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w;
+		if (x < 0) {
+			x = -x;
+			b = quaternion{ -b.x, -b.y, -b.z, -b.w };
+		}
+		float const xm1 = x-1;
+		float const d = 1-t;
+		float cT = 1, cD = 1;
+		for (int i = slerp_terms-1; i >= 0; --i) {
+			cT = 1 + (slerp_u[i]*t*t - slerp_v[i])*xm1*cT;
+			cD = 1 + (slerp_u[i]*d*d - slerp_v[i])*xm1*cD;
+		}
+		cT *= t;
+		cD *= d;
+		return quaternion{ cD*a.x + cT*b.x, cD*a.y + cT*b.y, cD*a.z + cT*b.z, cD*a.w + cT*b.w };
+	}
+
+
+#ifdef VCL_QUATERNION_SSE
+	// Load 4 quaternions and transpose them: one register per component
+	static inline void load_transpose(quaternion const* q, __m128& x, __m128& y, __m128& z, __m128& w)
+	{
+		x = _mm_loadu_ps(&q[0].x);
+		y = _mm_loadu_ps(&q[1].x);
+		z = _mm_loadu_ps(&q[2].x);
+		w = _mm_loadu_ps(&q[3].x);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+	}
+	static inline void transpose_store(__m128 x, __m128 y, __m128 z, __m128 w, quaternion* q)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(&q[0].x, x);
+		_mm_storeu_ps(&q[1].x, y);
+		_mm_storeu_ps(&q[2].x, z);
+		_mm_storeu_ps(&q[3].x, w);
+	}
+
+	static inline __m128 madd(__m128 a, __m128 b, __m128 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+	static inline __m128 msub(__m128 a, __m128 b, __m128 c) { return _mm_sub_ps(_mm_mul_ps(a, b), c); }
+
+	static inline void multiply_sse(__m128 ax, __m128 ay, __m128 az, __m128 aw, __m128 bx, __m128 by, __m128 bz, __m128 bw, __m128& x, __m128& y, __m128& z, __m128& w)
+	{
+		x = _mm_sub_ps(madd(ax, bw, madd(aw, bx, _mm_mul_ps(ay, bz))), _mm_mul_ps(az, by));
+		y = _mm_sub_ps(madd(ay, bw, madd(aw, by, _mm_mul_ps(az, bx))), _mm_mul_ps(ax, bz));
+		z = _mm_sub_ps(madd(az, bw, madd(aw, bz, _mm_mul_ps(ax, by))), _mm_mul_ps(ay, bx));
+		w = _mm_sub_ps(_mm_sub_ps(msub(aw, bw, _mm_mul_ps(ax, bx)), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+	}
+#endif
+
+
+	void quaternion_batch_multiply(buffer<quaternion> const& a, buffer<quaternion> const& b, buffer<quaternion>& out)
+	{
+		size_t const N = a.size();
+		assert_vcl(b.size()==N, "Quaternion buffers must have the same size");
+		out.resize(N);
+		quaternion const* pa = a.data.data();
+		quaternion const* pb = b.data.data();
+		quaternion* po = out.data.data();
+
+		size_t k = 0;
+#ifdef VCL_QUATERNION_SSE
+		for (; k+4 <= N; k += 4) {
+			__m128 ax, ay, az, aw, bx, by, bz, bw, x, y, z, w;
+			load_transpose(pa+k, ax, ay, az, aw);
+			load_transpose(pb+k, bx, by, bz, bw);
+			multiply_sse(ax, ay, az, aw, bx, by, bz, bw, x, y, z, w);
+			transpose_store(x, y, z, w, po+k);
+		}
+#endif
+		for (; k < N; ++k)
+			po[k] = multiply_scalar(pa[k], pb[k]);
+	}
+
+	void quaternion_batch_rotate(buffer<quaternion> const& q, buffer<vec3> const& p, buffer<vec3>& out)
+	{
+		size_t const N = q.size();
+		assert_vcl(p.size()==N, "Quaternion and vector buffers must have the same size");
+		out.resize(N);
+		quaternion const* pq = q.data.data();
+		vec3 const* pp = p.data.data();
+		vec3* po = out.data.data();
+
+		size_t k = 0;
+#ifdef VCL_QUATERNION_SSE
+		__m128 const two = _mm_set1_ps(2.0f);
+		for (; k+4 <= N; k += 4) {
+			__m128 qx, qy, qz, qw;
+			load_transpose(pq+k, qx, qy, qz, qw);
+			vec3 const* v = pp+k;
+			__m128 const px = _mm_set_ps(v[3].x, v[2].x, v[1].x, v[0].x);
+			__m128 const py = _mm_set_ps(v[3].y, v[2].y, v[1].y, v[0].y);
+			__m128 const pz = _mm_set_ps(v[3].z, v[2].z, v[1].z, v[0].z);
+
+			__m128 const tx = _mm_mul_ps(two, msub(qy, pz, _mm_mul_ps(qz, py)));
+			__m128 const ty = _mm_mul_ps(two, msub(qz, px, _mm_mul_ps(qx, pz)));
+			__m128 const tz = _mm_mul_ps(two, msub(qx, py, _mm_mul_ps(qy, px)));
+			__m128 const rx = _mm_sub_ps(madd(qw, tx, madd(qy, tz, px)), _mm_mul_ps(qz, ty));
+			__m128 const ry = _mm_sub_ps(madd(qw, ty, madd(qz, tx, py)), _mm_mul_ps(qx, tz));
+			__m128 const rz = _mm_sub_ps(madd(qw, tz, madd(qx, ty, pz)), _mm_mul_ps(qy, tx));
+
+			float x[4], y[4], z[4];
+			_mm_storeu_ps(x, rx);
+			_mm_storeu_ps(y, ry);
+			_mm_storeu_ps(z, rz);
+			for (int i = 0; i < 4; ++i)
+				po[k+i] = { x[i], y[i], z[i] };
+		}
+#endif
+		for (; k < N; ++k)
+			po[k] = rotate_scalar(pq[k], pp[k]);
+	}
+
+	void quaternion_batch_normalize(buffer<quaternion>& q)
+	{
+		size_t const N = q.size();
+		quaternion* pq = q.data.data();
+
+		size_t k = 0;
+#ifdef VCL_QUATERNION_SSE
+		__m128 const one = _mm_set1_ps(1.0f);
+		for (; k+4 <= N; k += 4) {
+			__m128 x, y, z, w;
+			load_transpose(pq+k, x, y, z, w);
+			__m128 const n2 = madd(x, x, madd(y, y, madd(z, z, _mm_mul_ps(w, w))));
+			__m128 const inv = _mm_div_ps(one, _mm_sqrt_ps(n2));
+			transpose_store(_mm_mul_ps(x, inv), _mm_mul_ps(y, inv), _mm_mul_ps(z, inv), _mm_mul_ps(w, inv), pq+k);
+		}
+#endif
+		for (; k < N; ++k)
+			pq[k] = normalize_scalar(pq[k]);
+	}
+
+	void quaternion_batch_matrix(buffer<quaternion> const& q, buffer<mat3>& out)
+	{
+		size_t const N = q.size();
+		out.resize(N);
+		quaternion const* pq = q.data.data();
+
+		size_t k = 0;
+#ifdef VCL_QUATERNION_SSE
+		__m128 const one = _mm_set1_ps(1.0f);
+		__m128 const two = _mm_set1_ps(2.0f);
+		for (; k+4 <= N; k += 4) {
+			__m128 x, y, z, w;
+			load_transpose(pq+k, x, y, z, w);
+			__m128 const xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+			__m128 const xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+			__m128 const wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+			float m[9][4];
+			_mm_storeu_ps(m[0], _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))));
+			_mm_storeu_ps(m[1], _mm_mul_ps(two, _mm_sub_ps(xy, wz)));
+			_mm_storeu_ps(m[2], _mm_mul_ps(two, _mm_add_ps(xz, wy)));
+			_mm_storeu_ps(m[3], _mm_mul_ps(two, _mm_add_ps(xy, wz)));
+			_mm_storeu_ps(m[4], _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))));
+			_mm_storeu_ps(m[5], _mm_mul_ps(two, _mm_sub_ps(yz, wx)));
+			_mm_storeu_ps(m[6], _mm_mul_ps(two, _mm_sub_ps(xz, wy)));
+			_mm_storeu_ps(m[7], _mm_mul_ps(two, _mm_add_ps(yz, wx)));
+			_mm_storeu_ps(m[8], _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))));
+			for (int i = 0; i < 4; ++i)
+				out[k+i] = mat3{ m[0][i], m[1][i], m[2][i], m[3][i], m[4][i], m[5][i], m[6][i], m[7][i], m[8][i] };
+		}
+#endif
+		for (; k < N; ++k)
+			out[k] = matrix_scalar(pq[k]);
+	}
+
+	// alpha_stride = 0: same alpha for all the elements
+	static void slerp_batch(quaternion const* pa, quaternion const* pb, float const* alpha, size_t alpha_stride, quaternion* po, size_t N)
+	{
+		size_t k = 0;
+#ifdef VCL_QUATERNION_SSE
+		__m128 const one = _mm_set1_ps(1.0f);
+		__m128 const sign_bit = _mm_set1_ps(-0.0f);
+		for (; k+4 <= N; k += 4) {
+			__m128 ax, ay, az, aw, bx, by, bz, bw;
+			load_transpose(pa+k, ax, ay, az, aw);
+			load_transpose(pb+k, bx, by, bz, bw);
+			__m128 const t = (alpha_stride==0) ? _mm_set1_ps(alpha[0]) : _mm_loadu_ps(alpha+k);
+
+			// Shortest arc: flip b when the dot product is negative
+			__m128 x = madd(ax, bx, madd(ay, by, madd(az, bz, _mm_mul_ps(aw, bw))));
+			__m128 const sign = _mm_and_ps(x, sign_bit);
+			x = _mm_xor_ps(x, sign);
+			bx = _mm_xor_ps(bx, sign); by = _mm_xor_ps(by, sign); bz = _mm_xor_ps(bz, sign); bw = _mm_xor_ps(bw, sign);
+
+			__m128 const xm1 = _mm_sub_ps(x, one);
+			__m128 const d = _mm_sub_ps(one, t);
+			__m128 const t2 = _mm_mul_ps(t, t);
+			__m128 const d2 = _mm_mul_ps(d, d);
+			__m128 cT = one, cD = one;
+			for (int i = slerp_terms-1; i >= 0; --i) {
+				__m128 const u = _mm_set1_ps(slerp_u[i]);
+				__m128 const v = _mm_set1_ps(slerp_v[i]);
+				cT = madd(_mm_mul_ps(msub(u, t2, v), xm1), cT, one);
+				cD = madd(_mm_mul_ps(msub(u, d2, v), xm1), cD, one);
+			}
+			cT = _mm_mul_ps(cT, t);
+			cD = _mm_mul_ps(cD, d);
+
+			transpose_store(madd(cD, ax, _mm_mul_ps(cT, bx)), madd(cD, ay, _mm_mul_ps(cT, by)), madd(cD, az, _mm_mul_ps(cT, bz)), madd(cD, aw, _mm_mul_ps(cT, bw)), po+k);
+		}
+#endif
+		for (; k < N; ++k)
+			po[k] = slerp_scalar(pa[k], pb[k], alpha[k*alpha_stride]);
+	}
+
+	void quaternion_batch_slerp(buffer<quaternion> const& a, buffer<quaternion> const& b, float alpha, buffer<quaternion>& out)
+	{
+		size_t const N = a.size();
+		assert_vcl(b.size()==N, "Quaternion buffers must have the same size");
+		out.resize(N);
+		slerp_batch(a.data.data(), b.data.data(), &alpha, 0, out.data.data(), N);
+	}
+
+	void quaternion_batch_slerp(buffer<quaternion> const& a, buffer<quaternion> const& b, buffer<float> const& alpha, buffer<quaternion>& out)
+	{
+		size_t const N = a.size();
+		assert_vcl(b.size()==N && alpha.size()==N, "Quaternion and alpha buffers must have the same size");
+		out.resize(N);
+		slerp_batch(a.data.data(), b.data.data(), alpha.data.data(), 1, out.data.data(), N);
+	}
+}
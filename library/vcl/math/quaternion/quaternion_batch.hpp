@@ -0,0 +1,27 @@
+#pragma once
+
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/quaternion/quaternion.hpp"
+#include "vcl/math/matrix/matrix.hpp"
+
+/* Batched operations on buffers of quaternions (animation and skinning workloads)
+*  - Quaternions are loaded 4 by 4 and transposed to one SSE register per component (x,y,z,w): each kernel processes 4 quaternions at once.
+*  - The remaining elements (and builds without SSE) use the same formulas on scalars.
+*  - The quaternions are expected to be unit quaternions (rotations), excepted for quaternion_batch_normalize. */
+
+namespace vcl
+{
+	/** out[k] = a[k] * b[k] */
+	void quaternion_batch_multiply(buffer<quaternion> const& a, buffer<quaternion> const& b, buffer<quaternion>& out);
+	/** out[k] = rotation of p[k] by q[k] */
+	void quaternion_batch_rotate(buffer<quaternion> const& q, buffer<vec3> const& p, buffer<vec3>& out);
+	/** q[k] = q[k]/|q[k]| */
+	void quaternion_batch_normalize(buffer<quaternion>& q);
+	/** out[k] = rotation matrix of q[k] */
+	void quaternion_batch_matrix(buffer<quaternion> const& q, buffer<mat3>& out);
+
+	/** out[k] = slerp(a[k], b[k], alpha) along the shortest arc
+	*  Uses the polynomial approximation of the slerp coefficients by D. Eberly (no trigonometric function, error < 1e-6 on the coefficients) */
+	void quaternion_batch_slerp(buffer<quaternion> const& a, buffer<quaternion> const& b, float alpha, buffer<quaternion>& out);
+	void quaternion_batch_slerp(buffer<quaternion> const& a, buffer<quaternion> const& b, buffer<float> const& alpha, buffer<quaternion>& out);
+}
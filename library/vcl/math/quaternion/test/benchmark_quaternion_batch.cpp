@@ -0,0 +1,60 @@
+#include "benchmark_quaternion_batch.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/rotation/rotation.hpp"
+#include "../quaternion_batch.hpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	template <typename F>
+	static double time_ms(int N_repeat, F const& f)
+	{
+		auto const t0 = std::chrono::steady_clock::now();
+		for (int r = 0; r < N_repeat; ++r)
+			f();
+		auto const t1 = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(t1-t0).count() / N_repeat;
+	}
+
+	void benchmark_quaternion_batch()
+	{
+		size_t const N = 1000000;
+		int const N_repeat = 10;
+
+		buffer<quaternion> a(N), b(N), q(N);
+		buffer<vec3> p(N), p_out(N);
+		buffer<mat3> M(N);
+		for (size_t k = 0; k < N; ++k) {
+			a[k] = normalize(quaternion(rand_interval(-1,1), rand_interval(-1,1), rand_interval(-1,1), rand_interval(-1,1)));
+			b[k] = normalize(quaternion(rand_interval(-1,1), rand_interval(-1,1), rand_interval(-1,1), rand_interval(-1,1)));
+			p[k] = { rand_interval(), rand_interval(), rand_interval() };
+		}
+
+		std::cout << "Batched quaternion operations on " << N << " elements (ms), scalar rotation/quaternion operators vs batch kernels:" << std::endl;
+
+		double const t_multiply = time_ms(N_repeat, [&]() { for (size_t k = 0; k < N; ++k) q[k] = a[k]*b[k]; });
+		double const t_multiply_batch = time_ms(N_repeat, [&]() { quaternion_batch_multiply(a, b, q); });
+		std::cout << "  multiply  : " << t_multiply << " vs " << t_multiply_batch << std::endl;
+
+		double const t_rotate = time_ms(N_repeat, [&]() { for (size_t k = 0; k < N; ++k) p_out[k] = rotation(a[k])*p[k]; });
+		double const t_rotate_batch = time_ms(N_repeat, [&]() { quaternion_batch_rotate(a, p, p_out); });
+		std::cout << "  rotate    : " << t_rotate << " vs " << t_rotate_batch << std::endl;
+
+		double const t_normalize = time_ms(N_repeat, [&]() { for (size_t k = 0; k < N; ++k) q[k] = normalize(a[k]); });
+		double const t_normalize_batch = time_ms(N_repeat, [&]() { q = a; quaternion_batch_normalize(q); });
+		std::cout << "  normalize : " << t_normalize << " vs " << t_normalize_batch << " (including a copy)" << std::endl;
+
+		double const t_matrix = time_ms(N_repeat, [&]() { for (size_t k = 0; k < N; ++k) M[k] = rotation(a[k]).matrix(); });
+		double const t_matrix_batch = time_ms(N_repeat, [&]() { quaternion_batch_matrix(a, M); });
+		std::cout << "  matrix    : " << t_matrix << " vs " << t_matrix_batch << std::endl;
+
+		double const t_slerp = time_ms(N_repeat, [&]() { for (size_t k = 0; k < N; ++k) q[k] = rotation::slerp(rotation(a[k]), rotation(b[k]), 0.3f).data; });
+		double const t_slerp_batch = time_ms(N_repeat, [&]() { quaternion_batch_slerp(a, b, 0.3f, q); });
+		std::cout << "  slerp     : " << t_slerp << " vs " << t_slerp_batch << std::endl;
+	}
+}
@@ -0,0 +1,80 @@
+#include "test_quaternion_batch.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/math/rotation/rotation.hpp"
+#include "../quaternion_batch.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	static quaternion random_unit_quaternion()
+	{
+		return normalize(quaternion(rand_interval(-1,1), rand_interval(-1,1), rand_interval(-1,1), rand_interval(-1,1)));
+	}
+
+	static float distance(quaternion const& a, quaternion const& b)
+	{
+		return std::max(std::max(std::abs(a.x-b.x), std::abs(a.y-b.y)), std::max(std::abs(a.z-b.z), std::abs(a.w-b.w)));
+	}
+
+	void test_quaternion_batch()
+	{
+		// Sizes that are not multiple of 4 check the remaining elements
+		for (size_t N : { size_t(0), size_t(3), size_t(4), size_t(37) })
+		{
+			buffer<quaternion> a(N), b(N);
+			buffer<vec3> p(N);
+			buffer<float> alpha(N);
+			for (size_t k = 0; k < N; ++k) {
+				a[k] = random_unit_quaternion();
+				b[k] = random_unit_quaternion();
+				p[k] = { rand_interval(-2,2), rand_interval(-2,2), rand_interval(-2,2) };
+				alpha[k] = rand_interval();
+			}
+			// Include identical and opposite quaternions for slerp
+			if (N > 2) {
+				b[0] = a[0];
+				b[1] = -1.0f*a[1];
+			}
+
+			buffer<quaternion> product;
+			quaternion_batch_multiply(a, b, product);
+			for (size_t k = 0; k < N; ++k)
+				assert_vcl_no_msg( distance(product[k], a[k]*b[k]) < 1e-6f );
+
+			buffer<vec3> rotated;
+			quaternion_batch_rotate(a, p, rotated);
+			for (size_t k = 0; k < N; ++k)
+				assert_vcl_no_msg( norm(rotated[k] - rotation(a[k])*p[k]) < 1e-5f );
+
+			buffer<mat3> matrix;
+			quaternion_batch_matrix(a, matrix);
+			for (size_t k = 0; k < N; ++k)
+				assert_vcl_no_msg( norm(matrix[k]*p[k] - rotation(a[k])*p[k]) < 1e-5f );
+
+			buffer<quaternion> scaled = a;
+			for (size_t k = 0; k < N; ++k)
+				scaled[k] = (0.5f+k)*scaled[k];
+			quaternion_batch_normalize(scaled);
+			for (size_t k = 0; k < N; ++k)
+				assert_vcl_no_msg( distance(scaled[k], a[k]) < 1e-6f );
+
+			// Polynomial slerp compared to the trigonometric slerp (as rotations: q and -q are equivalent)
+			buffer<quaternion> interpolated;
+			quaternion_batch_slerp(a, b, alpha, interpolated);
+			for (size_t k = 0; k < N; ++k) {
+				quaternion const expected = rotation::slerp(rotation(a[k]), rotation(b[k]), alpha[k]).data;
+				assert_vcl_no_msg( std::min(distance(interpolated[k], expected), distance(interpolated[k], -1.0f*expected)) < 1e-5f );
+			}
+			quaternion_batch_slerp(a, b, 0.25f, interpolated);
+			for (size_t k = 0; k < N; ++k) {
+				quaternion const expected = rotation::slerp(rotation(a[k]), rotation(b[k]), 0.25f).data;
+				assert_vcl_no_msg( std::min(distance(interpolated[k], expected), distance(interpolated[k], -1.0f*expected)) < 1e-5f );
+			}
+		}
+	}
+}
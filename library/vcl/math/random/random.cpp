@@ -0,0 +1,26 @@
+#include "random.hpp"
+
+namespace vcl
+{
+	static_assert(sizeof(vec3)==3*sizeof(float), "Random fill expects vec3 to be stored as 3 contiguous floats");
+
+	void fill_uniform(buffer<float>& values, rand_generator& generator, float value_min, float value_max)
+	{
+		generator.fill_uniform(values.data.data(), values.size(), value_min, value_max);
+	}
+	void fill_uniform(buffer<vec3>& values, rand_generator& generator, float value_min, float value_max)
+	{
+		if (values.size() > 0)
+			generator.fill_uniform(&values.data[0].x, 3*values.size(), value_min, value_max);
+	}
+
+	void fill_normal(buffer<float>& values, rand_generator& generator, float mean, float standard_deviation)
+	{
+		generator.fill_normal(values.data.data(), values.size(), mean, standard_deviation);
+	}
+	void fill_normal(buffer<vec3>& values, rand_generator& generator, float mean, float standard_deviation)
+	{
+		if (values.size() > 0)
+			generator.fill_normal(&values.data[0].x, 3*values.size(), mean, standard_deviation);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "vcl/containers/containers.hpp"
+
+namespace vcl
+{
+	/** Fill a buffer with random values using a counter-based generator (see rand_generator)
+	* The values are computed in parallel and only depend on the state of the generator (seed, stream, counter), not on the number of threads.
+	* For buffer<vec3>, the components are filled in the order (x0,y0,z0,x1,y1,z1,...). */
+	void fill_uniform(buffer<float>& values, rand_generator& generator, float value_min=0.0f, float value_max=1.0f);
+	void fill_uniform(buffer<vec3>& values, rand_generator& generator, float value_min=0.0f, float value_max=1.0f);
+	void fill_normal(buffer<float>& values, rand_generator& generator, float mean=0.0f, float standard_deviation=1.0f);
+	void fill_normal(buffer<vec3>& values, rand_generator& generator, float mean=0.0f, float standard_deviation=1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "benchmark_random.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../random.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void benchmark_random()
+	{
+		size_t const N = 10000000;
+		buffer<float> v; v.resize(N);
+		std::cout << "Random generation of " << N << " floats, " << parallel_thread_count() << " threads" << std::endl;
+
+		{
+			// Reference: single shared engine as used previously by rand_interval
+			std::default_random_engine engine(0);
+			std::uniform_real_distribution<float> distribution(0, 1);
+			auto const t0 = std::chrono::steady_clock::now();
+			for (size_t k = 0; k < N; ++k)
+				v.data[k] = distribution(engine);
+			auto const t1 = std::chrono::steady_clock::now();
+			std::cout << "  std::default_random_engine : " << std::chrono::duration<double, std::milli>(t1-t0).count() << " ms" << std::endl;
+		}
+		{
+			auto const t0 = std::chrono::steady_clock::now();
+			for (size_t k = 0; k < N; ++k)
+				v.data[k] = rand_interval();
+			auto const t1 = std::chrono::steady_clock::now();
+			std::cout << "  rand_interval              : " << std::chrono::duration<double, std::milli>(t1-t0).count() << " ms" << std::endl;
+		}
+		{
+			rand_generator generator(0);
+			auto const t0 = std::chrono::steady_clock::now();
+			fill_uniform(v, generator);
+			auto const t1 = std::chrono::steady_clock::now();
+			std::cout << "  fill_uniform               : " << std::chrono::duration<double, std::milli>(t1-t0).count() << " ms" << std::endl;
+		}
+		{
+			rand_generator generator(0);
+			auto const t0 = std::chrono::steady_clock::now();
+			fill_normal(v, generator);
+			auto const t1 = std::chrono::steady_clock::now();
+			std::cout << "  fill_normal                : " << std::chrono::duration<double, std::milli>(t1-t0).count() << " ms" << std::endl;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "test_random.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../random.hpp"
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_random()
+	{
+		// Known answers of Philox4x32-10 (Random123 test vectors)
+		{
+			unsigned int r[4];
+			philox4x32(0, 0, 0, r);
+			assert_vcl_no_msg(r[0]==0x6627e8d5u && r[1]==0xe169c58du && r[2]==0xbc57ac4cu && r[3]==0x9b00dbd8u);
+			philox4x32(~0ull, ~0ull, ~0ull, r);
+			assert_vcl_no_msg(r[0]==0x408f276du && r[1]==0x41c83b0eu && r[2]==0xa20bc7c6u && r[3]==0x6d5451fdu);
+		}
+
+		// Bulk fill gives the same values as the sequential calls, and continues the same sequence
+		{
+			rand_generator a(42, 7), b(42, 7);
+			buffer<float> v; v.resize(1003);
+			fill_uniform(v, a, -1.0f, 2.0f);
+			for (size_t k = 0; k < v.size(); ++k)
+				assert_vcl_no_msg(v[k] == b.uniform(-1.0f, 2.0f));
+			b.uint32(); // complete the last block (1003 = 4*250 + 3)
+			assert_vcl_no_msg(a.uint32() == b.uint32());
+		}
+
+		// Bulk fill does not depend on the number of threads
+		{
+			size_t const thread_count = parallel_thread_count();
+			buffer<vec3> v1; v1.resize(100000);
+			buffer<vec3> v4; v4.resize(100000);
+			rand_generator g1(3), g4(3);
+			parallel_set_thread_count(1);
+			fill_normal(v1, g1);
+			parallel_set_thread_count(4);
+			fill_normal(v4, g4);
+			parallel_set_thread_count(thread_count);
+			for (size_t k = 0; k < v1.size(); ++k)
+				assert_vcl_no_msg(v1[k].x==v4[k].x && v1[k].y==v4[k].y && v1[k].z==v4[k].z);
+		}
+
+		// Statistics of the distributions, independent streams
+		{
+			size_t const N = 1000000;
+			buffer<float> u; u.resize(N);
+			buffer<float> n; n.resize(N);
+			rand_generator g(1);
+			fill_uniform(u, g);
+			fill_normal(n, g, 1.0f, 2.0f);
+
+			double u_mean = 0, n_mean = 0, n_var = 0;
+			for (size_t k = 0; k < N; ++k) {
+				assert_vcl_no_msg(u[k]>=0.0f && u[k]<1.0f);
+				u_mean += u[k]/N;
+				n_mean += n[k]/N;
+			}
+			for (size_t k = 0; k < N; ++k)
+				n_var += (n[k]-n_mean)*(n[k]-n_mean)/N;
+			assert_vcl_no_msg(std::abs(u_mean-0.5) < 0.005);
+			assert_vcl_no_msg(std::abs(n_mean-1.0) < 0.01);
+			assert_vcl_no_msg(std::abs(n_var-4.0) < 0.05);
+
+			rand_generator s0(1, 0), s1(1, 1);
+			int equal = 0;
+			for (int k = 0; k < 1000; ++k)
+				equal += (s0.uint32() == s1.uint32());
+			assert_vcl_no_msg(equal < 2);
+		}
+
+		// Upper bound excluded even when value_min + (value_max-value_min)*u rounds up to value_max
+		{
+			size_t const N = 1000000;
+			float const upper = std::nextafter(1001.0f, 1000.0f);
+			buffer<float> v; v.resize(N);
+			rand_generator a(5), b(5);
+			fill_uniform(v, a, 1000.0f, 1001.0f);
+			size_t count_upper = 0;
+			for (size_t k = 0; k < N; ++k) {
+				assert_vcl_no_msg(v[k]>=1000.0f && v[k]<1001.0f);
+				count_upper += (v[k]==upper);
+			}
+			assert_vcl_no_msg(count_upper > 0); // rounding case reached and clamped
+			for (size_t k = 0; k < N; ++k) {
+				float const x = b.uniform(1000.0f, 1001.0f);
+				assert_vcl_no_msg(x == v[k]);
+			}
+			for (size_t k = 0; k < N; ++k) {
+				float const x = rand_interval(2.0f, 3.0f);
+				assert_vcl_no_msg(x>=2.0f && x<3.0f);
+			}
+		}
+
+		// rand_interval can be called from several threads
+		{
+			size_t const thread_count = parallel_thread_count();
+			parallel_set_thread_count(4);
+			buffer<float> v; v.resize(10000);
+			float* p = v.data.data();
+			parallel_for(v.size(), [=](size_t k) { p[k] = rand_interval(2.0f, 3.0f); }, 100);
+			parallel_set_thread_count(thread_count);
+			for (float x : v)
+				assert_vcl_no_msg(x>=2.0f && x<3.0f);
+		}
+	}
+}
\ No newline at end of file
@@ -183,7 +183,76 @@ namespace vcl
 		return rotation{ q };
 	}
 
-	//rotation rotation::slerp(rotation const& r1, rotation const& r2, float const alpha);
+	rotation rotation::nlerp(rotation const& r1, rotation const& r2, float const alpha)
+	{
+		return lerp(r1, r2, alpha);
+	}
+
+	// Spherical interpolation of unit quaternions (q2 is flipped to follow the shortest arc)
+	static quaternion quaternion_slerp(quaternion const& q1, quaternion q2, float alpha)
+	{
+		float d = dot(q1,q2);
+		if(d<0) {
+			q2 *= -1.0f;
+			d = -d;
+		}
+
+		// Almost identical rotations: the normalized linear interpolation avoids the division by sin(theta)
+		if(d>0.9995f) {
+			quaternion const q = (1.0f-alpha)*q1 + alpha*q2;
+			return q / norm(q);
+		}
+
+		float const theta = std::acos(d);
+		float const inv_sin = 1.0f/std::sin(theta);
+		return (std::sin((1.0f-alpha)*theta)*inv_sin)*q1 + (std::sin(alpha*theta)*inv_sin)*q2;
+	}
+
+	rotation rotation::slerp(rotation const& r1, rotation const& r2, float const alpha)
+	{
+		return rotation{ quaternion_slerp(r1.data, r2.data, alpha) };
+	}
+
+	// Logarithm and exponential of unit quaternions: q = (sin(theta) v, cos(theta)) <-> (theta v, 0)
+	static quaternion quaternion_log(quaternion const& q)
+	{
+		float const s = std::sqrt(q.x*q.x + q.y*q.y + q.z*q.z);
+		if(s<1e-8f)
+			return quaternion(0,0,0,0);
+		float const theta = std::atan2(s, q.w);
+		return quaternion(theta/s*q.x, theta/s*q.y, theta/s*q.z, 0);
+	}
+	static quaternion quaternion_exp(quaternion const& q)
+	{
+		float const theta = std::sqrt(q.x*q.x + q.y*q.y + q.z*q.z);
+		if(theta<1e-8f)
+			return quaternion(q.x,q.y,q.z,1.0f);
+		float const s = std::sin(theta)/theta;
+		return quaternion(s*q.x, s*q.y, s*q.z, std::cos(theta));
+	}
+
+	// Inner control point of squad at q1: q1 exp( -(log(q1^-1 q2) + log(q1^-1 q0))/4 )
+	static quaternion squad_control_point(quaternion const& q0, quaternion const& q1, quaternion const& q2)
+	{
+		quaternion const q1_inv = conjugate(q1);
+		quaternion const l = quaternion_log(q1_inv*q2) + quaternion_log(q1_inv*q0);
+		return q1 * quaternion_exp(-0.25f*l);
+	}
+
+	rotation rotation::squad(rotation const& r0, rotation const& r1, rotation const& r2, rotation const& r3, float const alpha)
+	{
+		// Neighbors in the same hemisphere to follow the shortest arcs
+		quaternion const& q1 = r1.data;
+		quaternion const q0 = dot(r0.data,q1)<0 ? -1.0f*r0.data : r0.data;
+		quaternion const q2 = dot(r2.data,q1)<0 ? -1.0f*r2.data : r2.data;
+		quaternion const q3 = dot(r3.data,q2)<0 ? -1.0f*r3.data : r3.data;
+
+		quaternion const s1 = squad_control_point(q0, q1, q2);
+		quaternion const s2 = squad_control_point(q1, q2, q3);
+
+		quaternion const q = quaternion_slerp(quaternion_slerp(q1,q2,alpha), quaternion_slerp(s1,s2,alpha), 2*alpha*(1-alpha));
+		return rotation{ normalize(q) };
+	}
 
 	rotation inverse(rotation const& r)
 	{
@@ -47,10 +47,13 @@ namespace vcl
 		static quaternion axis_angle_to_quaternion(vec3 const& axis, float angle);
 		static void quaternion_to_axis_angle(quaternion const& q, vec3& axis, float& angle);
 
-		// Linear interpolation of rotation
+		// Linear interpolation of rotation (normalized linear interpolation of the quaternions)
 		static rotation lerp(rotation const& r1, rotation const& r2, float const alpha);
-		// Spherical Linear interpolation of rotation
-		//static rotation slerp(rotation const& r1, rotation const& r2, float const alpha);
+		static rotation nlerp(rotation const& r1, rotation const& r2, float const alpha);
+		// Spherical Linear interpolation of rotation (constant angular velocity along the shortest arc)
+		static rotation slerp(rotation const& r1, rotation const& r2, float const alpha);
+		// Spherical cubic interpolation between r1 and r2 (alpha \in [0,1]), using the neighboring rotations r0 and r3 to get a smooth angular velocity
+		static rotation squad(rotation const& r0, rotation const& r1, rotation const& r2, rotation const& r3, float const alpha);
 
 	};
 
@@ -3,6 +3,7 @@
 #include "vcl/base/base.hpp"
 #include "../rotation.hpp"
 
+#include <cmath>
 #include <iostream>
 using namespace vcl;
 
@@ -47,7 +48,39 @@ namespace vcl_test
 
 		}
 
+		// Interpolation of rotations
+		{
+			rotation const r1 = rotation(normalize(vec3{1,2,3}), 0.4f);
+			rotation const r2 = rotation(normalize(vec3{-1,0,2}), 2.5f);
+			rotation const r12 = inverse(r1)*r2;
+			vec3 axis; float angle;
+			r12.axis_angle(axis, angle);
+			if(angle>pi) angle = 2*pi-angle;
 
+			// slerp: constant angular velocity along the shortest arc, nlerp: same end points and middle
+			for (int k = 0; k <= 8; ++k) {
+				float const alpha = k/8.0f;
+				rotation const r = rotation::slerp(r1, r2, alpha);
+				vec3 axis_k; float angle_k;
+				(inverse(r1)*r).axis_angle(axis_k, angle_k);
+				if(angle_k>pi) angle_k = 2*pi-angle_k;
+				assert_vcl_no_msg( std::abs(angle_k - alpha*angle) < 1e-3f );
+			}
+			assert_vcl_no_msg( is_equal(rotation::nlerp(r1,r2,0.5f)*vec3{1,0,0}, rotation::slerp(r1,r2,0.5f)*vec3{1,0,0}) );
+			// Quaternions of opposite signs represent the same rotation
+			assert_vcl_no_msg( is_equal(rotation::slerp(r1, rotation(-1.0f*r2.data), 0.3f)*vec3{0,1,0}, rotation::slerp(r1,r2,0.3f)*vec3{0,1,0}) );
 
+			// squad interpolates the key rotations, and is equal to slerp for keys along a single rotation axis at constant speed
+			rotation const r0 = rotation(normalize(vec3{0,1,1}), -0.3f);
+			rotation const r3 = rotation(normalize(vec3{1,1,0}), 1.0f);
+			assert_vcl_no_msg( is_equal(rotation::squad(r0,r1,r2,r3,0.0f)*vec3{1,0,0}, r1*vec3{1,0,0}) );
+			assert_vcl_no_msg( is_equal(rotation::squad(r0,r1,r2,r3,1.0f)*vec3{1,0,0}, r2*vec3{1,0,0}) );
+			vec3 const z = {0,0,1};
+			for (int k = 0; k <= 8; ++k) {
+				float const alpha = k/8.0f;
+				rotation const r = rotation::squad(rotation(z,0.0f), rotation(z,0.5f), rotation(z,1.0f), rotation(z,1.5f), alpha);
+				assert_vcl_no_msg( is_equal(r*vec3{1,0,0}, rotation(z,0.5f+0.5f*alpha)*vec3{1,0,0}) );
+			}
+		}
 	}
 }
\ No newline at end of file
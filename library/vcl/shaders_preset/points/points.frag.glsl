@@ -0,0 +1,19 @@
+std::string s = R"(
+#version 330 core
+
+layout(location=0) out vec4 FragColor;
+uniform vec3 color = vec3(0.2, 0.4, 1.0); // Uniform color of the spheres
+
+void main()
+{
+	// Discard the pixels outside of the disc and shade it as a sphere facing the camera
+	vec2 q = 2.0*gl_PointCoord - 1.0;
+	float r2 = dot(q,q);
+	if (r2 > 1.0)
+		discard;
+	vec3 n = vec3(q.x, -q.y, sqrt(1.0-r2));
+	float diffuse = max(dot(n, normalize(vec3(0.3,0.5,1.0))), 0.0);
+
+	FragColor = vec4((0.3+0.7*diffuse)*color, 1.0);
+}
+)";
\ No newline at end of file
@@ -0,0 +1,19 @@
+std::string s = R"(
+#version 330 core
+
+layout (location = 0) in vec3 position;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+uniform float radius = 0.01;           // Radius of the sphere in world coordinates
+uniform float viewport_height = 1000;  // Height of the viewport in pixels
+
+void main()
+{
+	gl_Position = projection * view * model * vec4(position, 1.0);
+	// Diameter of the sphere projected on the screen (in pixels)
+	gl_PointSize = viewport_height * projection[1][1] * radius / gl_Position.w;
+}
+)";
\ No newline at end of file
@@ -24,6 +24,15 @@ namespace vcl
 			return s;
 		}
 
+		if (shader_name == "points_vertex") {
+			#include "points/points.vert.glsl"
+			return s;
+		}
+		if (shader_name == "points_fragment") {
+			#include "points/points.frag.glsl"
+			return s;
+		}
+
 		error_vcl("Shader not found");
 		return "Error";
 	}
@@ -57,7 +57,7 @@ mesh mesh_load_file_obj(const std::string& filename, buffer<buffer<int> >& verte
 {
     assert_file_exist(filename);
 
-    // Load parameters
+    // Load parameters (the std::vector read from the file are moved into the buffers without copy)
     buffer<vec3> positions = loader::obj_read_positions(filename);
     buffer<vec2> texture_uv = loader::obj_read_texture_uv(filename);
     buffer<vec3> normals = loader::obj_read_normals(filename);
@@ -99,6 +99,12 @@ buffer<buffer_stack<int3,3>> triangulate_faces(buffer<buffer<int3>> faces)
 {
     buffer<buffer_stack<int3,3>> faces_triangulation;
     size_t const N_face = faces.size();
+
+    size_t N_triangle = 0;
+    for(size_t k_face=0; k_face<N_face; ++k_face)
+        N_triangle += faces[k_face].size()>2? faces[k_face].size()-2 : 0;
+    faces_triangulation.reserve(N_triangle);
+
     for(size_t k_face=0; k_face<N_face; ++k_face)
     {
         buffer<int3> const& current_polygon = faces[k_face];
@@ -129,6 +135,15 @@ std::pair<mesh, std::map<int3, int, comparator_int3>>
 
 
     size_t const N_triangle = faces.size();
+
+    // Each vertex of the file is used at least once (more if it has several uv/normals)
+    m.position.reserve(positions.size());
+    if(type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_texture)
+        m.uv.reserve(positions.size());
+    if(type==loader::obj_type::vertex_texture_normal || type==loader::obj_type::vertex_normal)
+        m.normal.reserve(positions.size());
+    m.connectivity.reserve(N_triangle);
+
     for(size_t k_triangle=0; k_triangle<N_triangle; ++k_triangle)
     {
         buffer_stack<int3,3> const& tri = faces[k_triangle];
@@ -166,7 +181,7 @@ std::pair<mesh, std::map<int3, int, comparator_int3>>
         m.connectivity.push_back(new_triangle_index);
     }
 
-    return {m, connectivity_map};
+    return {std::move(m), std::move(connectivity_map)};
 }
 
 
@@ -178,13 +193,14 @@ std::vector<vec3> obj_read_positions(const std::string& filename)
 
     std::ifstream stream(filename);
     assert_vcl(stream.is_open(), "Cannot open file "+str(filename));
+    std::string buffer, first_word;
+    std::stringstream tokens_buffer; // reused from one line to the next to avoid allocations per line
     while(stream.good()) {
-        std::string buffer;
         std::getline(stream,buffer);
         if( buffer.size()>0 )
         {
-            std::stringstream tokens_buffer(buffer);
-            std::string first_word;
+            tokens_buffer.clear();
+            tokens_buffer.str(buffer);
             tokens_buffer >> first_word;
             if( first_word.size()>0 && first_word[0]!='#' ) {
                 if( first_word=="v" ) {
@@ -207,13 +223,14 @@ std::vector<vec3> obj_read_normals(const std::string& filename)
 
     std::ifstream stream(filename);
     assert_vcl(stream.is_open(), "Cannot open file "+str(filename));
+    std::string buffer, first_word;
+    std::stringstream tokens_buffer; // reused from one line to the next to avoid allocations per line
     while(stream.good()) {
-        std::string buffer;
         std::getline(stream,buffer);
         if( buffer.size()>0 )
         {
-            std::stringstream tokens_buffer(buffer);
-            std::string first_word;
+            tokens_buffer.clear();
+            tokens_buffer.str(buffer);
             tokens_buffer >> first_word;
             if( first_word.size()>0 && first_word[0]!='#' ) {
                 if( first_word=="vn" ) {
@@ -236,13 +253,14 @@ std::vector<vec2> obj_read_texture_uv(const std::string& filename)
 
     std::ifstream stream(filename);
     assert_vcl(stream.is_open(), "Cannot open file "+str(filename));
+    std::string buffer, first_word;
+    std::stringstream tokens_buffer; // reused from one line to the next to avoid allocations per line
     while(stream.good()) {
-        std::string buffer;
         std::getline(stream,buffer);
         if( buffer.size()>0 )
         {
-            std::stringstream tokens_buffer(buffer);
-            std::string first_word;
+            tokens_buffer.clear();
+            tokens_buffer.str(buffer);
             tokens_buffer >> first_word;
             if( first_word.size()>0 && first_word[0]!='#' ) {
                 if( first_word=="vt" ) {
@@ -270,15 +288,16 @@ std::vector<uint3> obj_read_connectivity(const std::string& filename)
     assert_vcl(stream.is_open(), "Cannot open file "+str(filename));
 
 
+    std::string buffer, first_word;
+    std::stringstream tokens_buffer; // reused from one line to the next to avoid allocations per line
     while(stream.good())
     {
-        std::string buffer;
         std::getline(stream,buffer);
 
         if( buffer.size()>0 )
         {
-            std::stringstream tokens_buffer(buffer);
-            std::string first_word;
+            tokens_buffer.clear();
+            tokens_buffer.str(buffer);
             tokens_buffer >> first_word;
 
             if( first_word.size()>0 && first_word[0]!='#' )
@@ -335,19 +354,20 @@ buffer<buffer<int3>> obj_read_faces(const std::string& filename, obj_type const
 
     std::ifstream stream(filename);
     assert_vcl(stream.is_open(), "Cannot open file "+str(filename));
+    std::string buffer, first_word, word;
+    std::stringstream tokens_buffer; // reused from one line to the next to avoid allocations per line
     while(stream.good()) {
-        std::string buffer;
         std::getline(stream,buffer);
         if( buffer.size()>0 )
         {
-            std::stringstream tokens_buffer(buffer);
-            std::string first_word;
+            tokens_buffer.clear();
+            tokens_buffer.str(buffer);
             tokens_buffer >> first_word;
             if( first_word.size()>0 && first_word[0]!='#' ) {
                 if( first_word=="f" ) {
 
-                    std::string word;
                     vcl::buffer<int3> current_face;
+                    current_face.reserve(4); // triangles and quads in a single allocation
                     while(tokens_buffer) {
                         tokens_buffer >> word;
 
@@ -356,7 +376,7 @@ buffer<buffer<int3>> obj_read_faces(const std::string& filename, obj_type const
                             current_face.push_back(face_index);
                         }
                     }
-                    faces.push_back(current_face);
+                    faces.push_back(std::move(current_face));
 
                 }
             }
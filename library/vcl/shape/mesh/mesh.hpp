@@ -1,5 +1,6 @@
 #pragma once
 
 #include "structure/mesh.hpp"
+#include "structure/mesh_grid.hpp"
 #include "primitive/mesh_primitive.hpp"
 #include "loader/loader.hpp"
\ No newline at end of file
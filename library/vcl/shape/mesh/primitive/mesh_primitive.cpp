@@ -4,9 +4,10 @@
 namespace vcl
 {
 
-	static buffer<uint3> connectivity_grid(size_t Nu, size_t Nv)
+	// Add the triangles of a grid of Nu x Nv vertices to connectivity
+	static void connectivity_grid(buffer<uint3>& connectivity, size_t Nu, size_t Nv)
 	{
-		buffer<uint3> connectivity;
+		connectivity.reserve(connectivity.size() + 2*(Nu-1)*(Nv-1));
 		for(size_t ku=0; ku<Nu-1; ++ku) {
 			for(size_t kv=0; kv<Nv-1; ++kv) {
 				unsigned int k00 = static_cast<unsigned int>(kv   + Nv* ku);
@@ -18,7 +19,6 @@ namespace vcl
 				connectivity.push_back(uint3{k00, k11, k01});
 			}
 		}
-		return connectivity;
 	}
 
 	mesh mesh_primitive_cylinder(float radius, vec3 const& p0, vec3 const& p1, int Nu, int Nv, bool is_closed)
@@ -31,6 +31,8 @@ namespace vcl
 		rotation const R = rotation_between_vector({0,0,1}, dir);
 
 		mesh shape;
+		size_t const N_cap = is_closed? 2 : 0; // discs of Nv+1 vertices and Nv-1 triangles
+		shape.reserve(size_t(Nu)*Nv + N_cap*(Nv+1), 2*size_t(Nu-1)*(Nv-1) + N_cap*(Nv-1));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 				float const u = ku/(Nu-1.0f);
@@ -55,7 +57,7 @@ namespace vcl
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 
 		if(is_closed){
 			shape.push_back( mesh_primitive_disc(radius, p0, dir, Nv).flip_connectivity() );
@@ -102,6 +104,7 @@ namespace vcl
 		assert_vcl(N>2, "Disc samples ("+str(N)+") must be >2");
 
 		mesh shape;
+		shape.reserve(N+1, N-1);
 
 		rotation const r = rotation_between_vector({0,0,1}, normal);
 
@@ -131,6 +134,7 @@ namespace vcl
 		assert_vcl(Nu>2 && Nv>2, "Sphere samples should be > 2");
 
 		mesh shape;
+		shape.reserve(size_t(Nu)*Nv + 2*(Nu-1), 2*size_t(Nu-1)*(Nv-1) + 2*(Nu-1));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 				float const u = ku/(Nu-1.0f);
@@ -154,7 +158,7 @@ namespace vcl
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 
 		
 		// poles
@@ -189,6 +193,7 @@ namespace vcl
 		assert_vcl(Nu>2 && Nv>2, "Sphere samples should be > 2");
 
 		mesh shape;
+		shape.reserve(size_t(Nu)*Nv + 2*(Nu-1), 2*size_t(Nu-1)*(Nv-1) + 2*(Nu-1));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 				float const u = ku/(Nu-1.0f);
@@ -212,7 +217,7 @@ namespace vcl
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 
 		
 		// poles
@@ -249,6 +254,7 @@ namespace vcl
 		assert_vcl(Nv>1, "Grid sample must be >1");
 
 		mesh shape;
+		shape.reserve(size_t(Nu)*Nv, 2*size_t(Nu-1)*(Nv-1));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 
@@ -267,7 +273,7 @@ namespace vcl
 				shape.uv.push_back(uv);
 			}
 		}
-     	shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 		shape.fill_empty_field();
 		shape.flip_connectivity();
 		return shape;
@@ -283,6 +289,7 @@ namespace vcl
 		rotation R = rotation_between_vector({0,0,1}, axis_orientation);
 
 		mesh shape;
+		shape.reserve(size_t(Nu)*Nv, 2*size_t(Nu-1)*(Nv-1));
 		for( size_t ku=0; ku<size_t(Nu); ++ku ) {
 			for( size_t kv=0; kv<size_t(Nv); ++kv ) {
 
@@ -306,7 +313,7 @@ namespace vcl
 				shape.uv.push_back({u,v});
 			}
 		}
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 		shape.fill_empty_field();
 		return shape;
 	}
@@ -319,6 +326,8 @@ namespace vcl
 
 
 		mesh shape;
+		size_t const N_base = is_closed_base? 1 : 0; // disc of Nu+1 vertices and Nu-1 triangles
+		shape.reserve(size_t(Nu)*Nv + (Nu-1) + N_base*(Nu+1), 2*size_t(Nu-1)*(Nv-1) + (Nu-1) + N_base*(Nu-1));
 		rotation R = rotation_between_vector({0,0,1}, axis_direction);
 
 		//base
@@ -341,7 +350,7 @@ namespace vcl
 			}
 		}
 
-		shape.connectivity = connectivity_grid(Nu,Nv);
+		connectivity_grid(shape.connectivity, Nu, Nv);
 		shape.flip_connectivity();
 
 		//Extremity
@@ -383,6 +392,7 @@ namespace vcl
 		vec3 p011 = p000 + u*vec3{0,1,1};
 
 		mesh shape;
+		shape.reserve(6*4, 6*2);
 		shape.push_back(mesh_primitive_quadrangle(p000, p100, p101, p001));
 		shape.push_back(mesh_primitive_quadrangle(p100, p110, p111, p101));
 		shape.push_back(mesh_primitive_quadrangle(p110, p010, p011, p111));
@@ -409,6 +419,9 @@ namespace vcl
 		//vec3 p011 = p000 + u*vec3{0,1,1};
 
 		mesh shape;
+		size_t const N_vertex = 2*(size_t(Nx)*Nz + size_t(Ny)*Nz + size_t(Nx)*Ny);
+		size_t const N_triangle = 4*(size_t(Nx-1)*(Nz-1) + size_t(Ny-1)*(Nz-1) + size_t(Nx-1)*(Ny-1));
+		shape.reserve(N_vertex, N_triangle);
 		shape.push_back(mesh_primitive_grid(p000, p100, p101, p001, Nx, Nz));
 		shape.push_back(mesh_primitive_grid(p100, p110, p111, p101, Ny, Nz));
 		shape.push_back(mesh_primitive_grid(p110, p010, p011, p111, Nx, Nz));
@@ -1,6 +1,8 @@
 #include "mesh.hpp"
 
 #include <set>
+#include <algorithm>
+
 
 namespace vcl
 {
@@ -21,44 +23,62 @@ namespace vcl
 		return *this;
 	}
 
+	mesh& mesh::reserve(size_t number_vertex, size_t number_triangle)
+	{
+		position.reserve(number_vertex);
+		normal.reserve(number_vertex);
+		color.reserve(number_vertex);
+		uv.reserve(number_vertex);
+		connectivity.reserve(number_triangle);
+		return *this;
+	}
+
 	mesh& mesh::push_back(mesh const& to_add)
 	{
 		unsigned int const N_vertex = static_cast<unsigned int>(position.size());
+		size_t const N_triangle = connectivity.size();
 
 		position.push_back(to_add.position);
 		normal.push_back(to_add.normal);
 		color.push_back(to_add.color);
 		uv.push_back(to_add.uv);
 
-
-		for(auto const& tri : to_add.connectivity)
-			connectivity.push_back( tri + uint3{N_vertex,N_vertex,N_vertex} );
+		// Append the triangles in bulk, then offset their indices
+		connectivity.push_back(to_add.connectivity);
+		uint3 const offset = {N_vertex, N_vertex, N_vertex};
+		for(size_t k = N_triangle; k < connectivity.size(); ++k)
+			connectivity[k] = connectivity[k] + offset;
 
 		return *this;
 	}
 
 
 	void normal_per_vertex(buffer<vec3> const& position, buffer<uint3> const& connectivity, buffer<vec3>& normals, bool invert)
+	{
+		normals.resize(position.size());
+		normal_per_vertex(buffer_view<vec3 const>(position), buffer_view<uint3 const>(connectivity), buffer_view<vec3>(normals), invert);
+	}
+
+	void normal_per_vertex(buffer_view<vec3 const> position, buffer_view<uint3 const> connectivity, buffer_view<vec3> normals, bool invert)
 	{
 		size_t const N = position.size();
-		if(normals.size()!=N)
-			normals.resize(N);
-		else
-			normals.fill(vec3{0,0,0});
+		assert_vcl(normals.size()==N, "Normals of size "+str(normals.size())+" for "+str(N)+" positions");
+		for (vec3& n : normals)
+			n = vec3{0,0,0};
 
 		size_t const N_tri = connectivity.size();
 		for (size_t k_tri = 0; k_tri < N_tri; ++k_tri)
 		{
-			uint3 const& face = connectivity[k_tri];
+			uint3 const& face = connectivity.at_unsafe(k_tri);
 
-			//sanity check
+			//sanity check (the indices are then used without bound checking)
 			assert_vcl_no_msg(get<0>(face)<N);
 			assert_vcl_no_msg(get<1>(face)<N);
 			assert_vcl_no_msg(get<2>(face)<N);
 
-			vec3 const& p0 = position[get<0>(face)];
-			vec3 const& p1 = position[get<1>(face)];
-			vec3 const& p2 = position[get<2>(face)];
+			vec3 const& p0 = position.at_unsafe(get<0>(face));
+			vec3 const& p1 = position.at_unsafe(get<1>(face));
+			vec3 const& p2 = position.at_unsafe(get<2>(face));
 
 			// compute normal of the triangle
 			vec3 const p10 = p1-p0;
@@ -78,7 +98,7 @@ namespace vcl
 				{
 					vec3 const n_unit = n/Ln;
 					for(unsigned int idx : face)
-						normals[idx] += n_unit;
+						normals.at_unsafe(idx) += n_unit;
 				}
 			}
 		}
@@ -86,7 +106,7 @@ namespace vcl
 		// Normalize all normals
 		for (size_t k = 0; k < N; ++k)
 		{
-			vec3& n = normals[k];
+			vec3& n = normals.at_unsafe(k);
 			float const L = norm(n);
 			if(L>1e-6f)
 				n /= L;
@@ -243,4 +263,29 @@ namespace vcl
 				one_ring_buffer[k].push_back(idx);
 		return one_ring_buffer;
 	}
+
+	buffer<uint2> connectivity_edges(buffer<uint3> const& connectivity)
+	{
+		size_t const N_tri = connectivity.size();
+		std::vector<std::pair<unsigned int, unsigned int> > edges;
+		edges.reserve(3*N_tri);
+		for (size_t k = 0; k < N_tri; ++k)
+		{
+			uint3 const& tri = connectivity[k];
+			for (int e = 0; e < 3; ++e) {
+				unsigned int const a = tri[e];
+				unsigned int const b = tri[(e+1)%3];
+				edges.push_back( a<b ? std::make_pair(a,b) : std::make_pair(b,a) );
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		buffer<uint2> edges_buffer;
+		edges_buffer.resize(edges.size());
+		for (size_t k = 0; k < edges.size(); ++k)
+			edges_buffer[k] = { edges[k].first, edges[k].second };
+		return edges_buffer;
+	}
+
 }
\ No newline at end of file
@@ -18,6 +18,10 @@ namespace vcl
 		* This function should be called before creating a mesh_drawable if there is empty buffers */
 		mesh& fill_empty_field();
 
+		/** Allocate the memory of all the per-vertex buffers for number_vertex elements, and of the connectivity for number_triangle elements
+		* Avoids the successive reallocations when a mesh of known size is built with push_back */
+		mesh& reserve(size_t number_vertex, size_t number_triangle);
+
 		/** Concatenate the content of another mesh to the current one */
 		mesh& push_back(mesh const& to_add);
 		mesh& flip_connectivity();
@@ -28,6 +32,9 @@ namespace vcl
 	* Version where the normal is passed as in/out argument (usefull in case of real-time update of the normals) 
 	*   allows to save time and avoid unecessary allocation if the normal vector has already the correct size.	*/
 	void normal_per_vertex(buffer<vec3> const& position, buffer<uint3> const& connectivity, buffer<vec3>& normals_to_fill, bool invert=false);
+	/** Version on views: the normals are written in normals_to_fill which must have the same size as position (no allocation).
+	*   Allows to compute the normals of a part of a larger mesh, or of data mapped from a file, without copy. */
+	void normal_per_vertex(buffer_view<vec3 const> position, buffer_view<uint3 const> connectivity, buffer_view<vec3> normals_to_fill, bool invert=false);
 	/** Compute automaticaly a per-vertex normal given a set of positions and their connectivity */
 	buffer<vec3> normal_per_vertex(buffer<vec3> const& position, buffer<uint3> const& connectivity, bool invert=false);
 
@@ -36,6 +43,9 @@ namespace vcl
 
 
 	buffer<buffer<unsigned int> > connectivity_one_ring(buffer<uint3> const& connectivity);
+	/** List of unique edges (i,j) with i<j of a triangular connectivity, sorted by increasing (i,j) */
+	buffer<uint2> connectivity_edges(buffer<uint3> const& connectivity);
+
 
 	std::string str(mesh const& m);
 	std::string type_str(mesh const&);
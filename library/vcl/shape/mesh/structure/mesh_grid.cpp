@@ -0,0 +1,118 @@
+#include "mesh_grid.hpp"
+
+#include "vcl/base/base.hpp"
+
+#include <algorithm>
+
+namespace vcl
+{
+	bool mesh_grid_region::empty() const
+	{
+		return ku_min > ku_max || kv_min > kv_max;
+	}
+
+	void mesh_grid_region::clear()
+	{
+		*this = mesh_grid_region();
+	}
+
+	size_t mesh_grid_region::size() const
+	{
+		return empty() ? 0 : size_t(ku_max-ku_min+1)*size_t(kv_max-kv_min+1);
+	}
+
+	mesh_grid_region& mesh_grid_region::add(int ku, int kv)
+	{
+		if (empty()) {
+			ku_min = ku_max = ku;
+			kv_min = kv_max = kv;
+		}
+		else {
+			ku_min = std::min(ku_min, ku); ku_max = std::max(ku_max, ku);
+			kv_min = std::min(kv_min, kv); kv_max = std::max(kv_max, kv);
+		}
+		return *this;
+	}
+
+	mesh_grid_region& mesh_grid_region::add(mesh_grid_region const& region)
+	{
+		if (!region.empty()) {
+			add(region.ku_min, region.kv_min);
+			add(region.ku_max, region.kv_max);
+		}
+		return *this;
+	}
+
+	mesh_grid_region mesh_grid_region::expand(int ring, int Nu, int Nv) const
+	{
+		if (empty())
+			return *this;
+		mesh_grid_region r;
+		r.ku_min = std::max(ku_min-ring, 0); r.ku_max = std::min(ku_max+ring, Nu-1);
+		r.kv_min = std::max(kv_min-ring, 0); r.kv_max = std::min(kv_max+ring, Nv-1);
+		return r;
+	}
+
+
+	mesh_grid_region normal_per_vertex_grid(buffer<vec3> const& position, buffer<uint3> const& connectivity, int Nu, int Nv, mesh_grid_region const& region, buffer<vec3>& normals, bool invert)
+	{
+		assert_vcl(position.size()==size_t(Nu)*Nv, "Incorrect number of vertices for a grid of size "+str(Nu)+"x"+str(Nv));
+		assert_vcl(connectivity.size()==2*size_t(Nu-1)*(Nv-1), "The connectivity is not the one of a grid of size "+str(Nu)+"x"+str(Nv));
+		assert_vcl(normals.size()==position.size(), "Normals must be computed before their partial update");
+
+		mesh_grid_region const updated = region.expand(1, Nu, Nv);
+		if (updated.empty())
+			return updated;
+
+		for (int ku = updated.ku_min; ku <= updated.ku_max; ++ku)
+			for (int kv = updated.kv_min; kv <= updated.kv_max; ++kv)
+				normals[kv + size_t(Nv)*ku] = { 0,0,0 };
+
+		// Cells adjacent to the updated vertices, in the same order as in normal_per_vertex
+		int const cu_min = std::max(updated.ku_min-1, 0), cu_max = std::min(updated.ku_max, Nu-2);
+		int const cv_min = std::max(updated.kv_min-1, 0), cv_max = std::min(updated.kv_max, Nv-2);
+		for (int cu = cu_min; cu <= cu_max; ++cu) {
+			for (int cv = cv_min; cv <= cv_max; ++cv) {
+				size_t const k_cell = cv + size_t(Nv-1)*cu;
+				for (size_t k_tri = 2*k_cell; k_tri < 2*k_cell+2; ++k_tri)
+				{
+					uint3 const& face = connectivity[k_tri];
+					vec3 const& p0 = position[get<0>(face)];
+					vec3 const& p1 = position[get<1>(face)];
+					vec3 const& p2 = position[get<2>(face)];
+
+					vec3 const p10 = p1-p0;
+					vec3 const p20 = p2-p0;
+					float const L10 = norm(p10);
+					float const L20 = norm(p20);
+					if (L10 > 1e-6f && L20 > 1e-6f)
+					{
+						vec3 const n = cross(p10/L10, p20/L20);
+						float const Ln = norm(n);
+						if (Ln > 1e-6f)
+						{
+							vec3 const n_unit = n/Ln;
+							for (unsigned int idx : face) {
+								int const ku = int(idx/Nv), kv = int(idx%Nv);
+								if (ku >= updated.ku_min && ku <= updated.ku_max && kv >= updated.kv_min && kv <= updated.kv_max)
+									normals[idx] += n_unit;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		for (int ku = updated.ku_min; ku <= updated.ku_max; ++ku) {
+			for (int kv = updated.kv_min; kv <= updated.kv_max; ++kv) {
+				vec3& n = normals[kv + size_t(Nv)*ku];
+				float const L = norm(n);
+				if (L>1e-6f)
+					n /= L;
+				if (invert)
+					n = -n;
+			}
+		}
+		return updated;
+	}
+}
\ No newline at end of file
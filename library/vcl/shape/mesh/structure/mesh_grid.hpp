@@ -0,0 +1,34 @@
+#pragma once
+
+#include "mesh.hpp"
+
+namespace vcl
+{
+	/** Rectangle of samples [ku_min,ku_max] x [kv_min,kv_max] (bounds included) of a grid mesh built with mesh_primitive_grid(..., Nu, Nv)
+	* The sample (ku,kv) is the vertex of index kv + Nv*ku: each value of ku is a row of Nv consecutive vertices.
+	* Used to track the vertices modified since the last update (dirty rectangle) and to update only them. An empty region has ku_min>ku_max. */
+	struct mesh_grid_region
+	{
+		int ku_min = 1;
+		int ku_max = 0;
+		int kv_min = 1;
+		int kv_max = 0;
+
+		bool empty() const;
+		void clear();
+		/** Number of samples in the region */
+		size_t size() const;
+
+		/** Extend the region to contain the sample (ku,kv), or another region */
+		mesh_grid_region& add(int ku, int kv);
+		mesh_grid_region& add(mesh_grid_region const& region);
+		/** Region extended by ring samples in each direction, and clamped to the grid of Nu x Nv samples */
+		mesh_grid_region expand(int ring, int Nu, int Nv) const;
+	};
+
+	/** Update the normals of a grid mesh after the vertices of region moved
+	* The normals of the region extended by one ring are recomputed (these vertices share a triangle with a moved vertex). The returned value is this extended region.
+	* The connectivity must be the one of mesh_primitive_grid (two triangles per cell, the cells being ordered as their first vertex).
+	* The normals are the same as the ones computed by normal_per_vertex on the whole mesh. */
+	mesh_grid_region normal_per_vertex_grid(buffer<vec3> const& position, buffer<uint3> const& connectivity, int Nu, int Nv, mesh_grid_region const& region, buffer<vec3>& normals, bool invert=false);
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "benchmark_mesh_grid.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../mesh.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Raise the grid around the sample (cu,cv) with a gaussian brush and return the modified region
+	static mesh_grid_region brush(mesh& shape, int Nu, int Nv, int cu, int cv, int radius)
+	{
+		mesh_grid_region region;
+		for (int ku = std::max(cu-radius, 0); ku <= std::min(cu+radius, Nu-1); ++ku) {
+			for (int kv = std::max(cv-radius, 0); kv <= std::min(cv+radius, Nv-1); ++kv) {
+				float const d2 = float((ku-cu)*(ku-cu) + (kv-cv)*(kv-cv)) / (radius*radius);
+				shape.position[kv + size_t(Nv)*ku].z += 0.01f*std::exp(-4*d2);
+				region.add(ku, kv);
+			}
+		}
+		return region;
+	}
+
+	void benchmark_mesh_grid()
+	{
+		int const N = 2048;
+		int const radius = 16;
+		int const N_edit = 100;
+		int const N_edit_full = 5; // the reference is measured on the first edits only
+		mesh shape = mesh_primitive_grid({-1,-1,0}, {1,-1,0}, {1,1,0}, {-1,1,0}, N, N);
+		std::cout << "Brush edits (radius " << radius << " samples) on a " << N << "x" << N << " grid mesh, " << N_edit << " edits" << std::endl;
+
+		double time_full = 0, time_region = 0;
+		size_t rows_region = 0, bytes_region = 0;
+		for (int k = 0; k < N_edit; ++k)
+		{
+			int const cu = (k*733 + 101) % N;
+			int const cv = (k*389 + 977) % N;
+			mesh_grid_region const region = brush(shape, N, N, cu, cv, radius);
+
+			// Reference: normals of the whole mesh (and upload of the complete buffers of positions and normals)
+			if (k < N_edit_full) {
+				auto const t0 = std::chrono::steady_clock::now();
+				shape.compute_normal();
+				auto const t1 = std::chrono::steady_clock::now();
+				time_full += std::chrono::duration<double, std::milli>(t1-t0).count();
+			}
+
+			// Incremental: normals of the modified region and its one-ring (uploaded row by row)
+			auto const t2 = std::chrono::steady_clock::now();
+			mesh_grid_region const updated = normal_per_vertex_grid(shape.position, shape.connectivity, N, N, region, shape.normal);
+			auto const t3 = std::chrono::steady_clock::now();
+			time_region += std::chrono::duration<double, std::milli>(t3-t2).count();
+
+			rows_region += updated.ku_max-updated.ku_min+1;
+			bytes_region += region.size()*sizeof(vec3) + updated.size()*sizeof(vec3);
+		}
+		size_t const bytes_full = 2*shape.position.size()*sizeof(vec3);
+		std::cout << "  compute_normal         : " << time_full/N_edit_full << " ms per edit, " << bytes_full/1048576.0 << " MB uploaded per edit" << std::endl;
+		std::cout << "  normal_per_vertex_grid : " << time_region/N_edit << " ms per edit, " << bytes_region/double(N_edit)/1024.0 << " KB uploaded per edit in " << rows_region/N_edit << " rows" << std::endl;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "benchmark_mesh_loading.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../mesh.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Number of calls to the global operator new of the program (all the allocations: buffer, std::vector, std::string, streams, ...)
+	static std::atomic<size_t> allocation_count(0);
+}
+
+// Replacement of the global allocation functions counting the allocations (one relaxed atomic increment per call)
+void* operator new(std::size_t size)
+{
+	vcl_test::allocation_count.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size==0 ? 1 : size))
+		return p;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace vcl_test
+{
+	// Write a grid of N x N vertices with uv and normals, and quad faces
+	static void write_obj_grid(std::string const& filename, int N)
+	{
+		std::ofstream stream(filename);
+		for (int ku = 0; ku < N; ++ku)
+			for (int kv = 0; kv < N; ++kv)
+				stream << "v " << ku/(N-1.0f) << " " << kv/(N-1.0f) << " 0\n";
+		for (int ku = 0; ku < N; ++ku)
+			for (int kv = 0; kv < N; ++kv)
+				stream << "vt " << ku/(N-1.0f) << " " << kv/(N-1.0f) << "\n";
+		stream << "vn 0 0 1\n";
+		for (int ku = 0; ku < N-1; ++ku) {
+			for (int kv = 0; kv < N-1; ++kv) {
+				int const k00 = 1 + kv + N*ku, k10 = k00 + 1, k01 = k00 + N, k11 = k01 + 1;
+				stream << "f " << k00 << "/" << k00 << "/1 " << k10 << "/" << k10 << "/1 " << k11 << "/" << k11 << "/1 " << k01 << "/" << k01 << "/1\n";
+			}
+		}
+	}
+
+	void benchmark_mesh_loading()
+	{
+		int const N = 400;
+		std::string const filename = "benchmark_mesh_loading.obj";
+		write_obj_grid(filename, N);
+
+		size_t const count_loading = allocation_count;
+		auto const t0 = std::chrono::steady_clock::now();
+		mesh const shape = mesh_load_file_obj(filename);
+		auto const t1 = std::chrono::steady_clock::now();
+		size_t const N_allocation_loading = allocation_count - count_loading;
+		std::remove(filename.c_str());
+		std::cout << "Loading of a " << N << "x" << N << " grid OBJ file (" << shape.position.size() << " vertices, " << shape.connectivity.size() << " triangles): "
+			<< N_allocation_loading << " allocations, " << std::chrono::duration<double, std::milli>(t1-t0).count() << " ms" << std::endl;
+
+		// Concatenation of N_part copies of the loaded mesh with mesh::push_back
+		int const N_part = 16;
+		std::cout << "Concatenation of " << N_part << " meshes of " << shape.position.size() << " vertices" << std::endl;
+		for (bool reserve : { false, true })
+		{
+			size_t const count_assembly = allocation_count;
+			auto const t2 = std::chrono::steady_clock::now();
+			mesh m;
+			if (reserve)
+				m.reserve(N_part*shape.position.size(), N_part*shape.connectivity.size());
+			for (int k_part = 0; k_part < N_part; ++k_part)
+				m.push_back(shape);
+			auto const t3 = std::chrono::steady_clock::now();
+			std::cout << (reserve ? "  reserve + push_back : " : "  push_back           : ")
+				<< allocation_count - count_assembly << " allocations, " << std::chrono::duration<double, std::milli>(t3-t2).count() << " ms (" << m.position.size() << " vertices)" << std::endl;
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#include "test_mesh_grid.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../mesh.hpp"
+
+#include <cmath>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_mesh_grid()
+	{
+		// Region
+		{
+			mesh_grid_region r;
+			assert_vcl_no_msg(r.empty() && r.size()==0);
+			r.add(3, 5).add(1, 7);
+			assert_vcl_no_msg(r.ku_min==1 && r.ku_max==3 && r.kv_min==5 && r.kv_max==7 && r.size()==9);
+			mesh_grid_region const e = r.expand(2, 4, 8);
+			assert_vcl_no_msg(e.ku_min==0 && e.ku_max==3 && e.kv_min==3 && e.kv_max==7);
+			r.clear();
+			assert_vcl_no_msg(r.empty());
+		}
+
+		// Partial update of the normals gives the same result as the normals of the whole mesh (also for the inverted connectivity)
+		for (int flip = 0; flip < 2; ++flip)
+		{
+			int const Nu = 23, Nv = 17;
+			mesh shape = mesh_primitive_grid({0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}, Nu, Nv);
+			if (flip)
+				shape.flip_connectivity();
+			shape.compute_normal();
+
+			mesh_grid_region region;
+			for (int ku = 5; ku <= 9; ++ku) {
+				for (int kv = 0; kv <= 3; ++kv) {
+					shape.position[kv + Nv*ku].z += 0.1f*std::sin(float(ku+kv));
+					region.add(ku, kv);
+				}
+			}
+			mesh_grid_region const updated = normal_per_vertex_grid(shape.position, shape.connectivity, Nu, Nv, region, shape.normal);
+			assert_vcl_no_msg(updated.ku_min==4 && updated.ku_max==10 && updated.kv_min==0 && updated.kv_max==4);
+
+			buffer<vec3> const reference = normal_per_vertex(shape.position, shape.connectivity);
+			for (size_t k = 0; k < reference.size(); ++k)
+				assert_vcl_no_msg(norm(shape.normal[k]-reference[k]) < 1e-6f);
+		}
+	}
+}
\ No newline at end of file
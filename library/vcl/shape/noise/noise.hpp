@@ -1,10 +1,31 @@
 #pragma once
 
 #include "vcl/containers/containers.hpp"
+#include "vcl/shape/mesh/structure/mesh.hpp"
 
 namespace vcl
 {
 	float noise_perlin(float x,       int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
 	float noise_perlin(vec2 const& p, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
 	float noise_perlin(vec3 const& p, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+
+	/** Batched evaluation of noise_perlin
+	* The octaves are accumulated for 4 samples at a time using SIMD float operations, and the samples are distributed over several threads (by rows for the grids).
+	* The values match the scalar noise_perlin up to float precision (the scalar version is computed in double) for positive coordinates.
+	* - grid_2D/grid_3D: values(kx,ky[,kz]) is the noise at the sample p_min + (kx/(Nx-1), ky/(Ny-1)[, kz/(Nz-1)]) * (p_max-p_min)
+	* - buffer<vec2>: values[k] is the noise at the sample p[k] (values is resized) */
+	void fill_noise_perlin(grid_2D<float>& values, vec2 const& p_min, vec2 const& p_max, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+	void fill_noise_perlin(grid_3D<float>& values, vec3 const& p_min, vec3 const& p_max, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+	void fill_noise_perlin(buffer<float>& values, buffer<vec2> const& p, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+
+	/** Fractal noise and its analytic gradient
+	* Return the same value as noise_perlin, and fill gradient with the exact derivatives of the noise with respect to the coordinates of p
+	* (computed with the noise itself: no finite differences). */
+	float noise_perlin(vec2 const& p, vec2& gradient, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+	float noise_perlin(vec3 const& p, vec3& gradient, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
+
+	/** Update a heightfield terrain parameterized by its uv coordinates (such as the meshes of mesh_primitive_grid)
+	* position[k] = (p_min + uv[k]*(p_max-p_min), height*noise_perlin(uv[k])), and normal[k] is the exact normal of this surface computed from the gradient of the noise.
+	* Positions and normals are written in a single parallel pass: compute_normal() is not needed after this call. */
+	void update_terrain_noise_perlin(mesh& terrain, vec2 const& p_min, vec2 const& p_max, float height, int octave=5, float persistency=0.3f, float frequency_gain=2.0f);
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "noise.hpp"
+
+#include "third_party/src/simplexnoise/simplexnoise1234.hpp"
+#include "vcl/base/base.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VCL_NOISE_SSE
+#endif
+
+// Permutation table of simplexnoise1234.cpp: the batched noise uses the same gradients as snoise2/snoise3
+extern unsigned char perm[512];
+
+namespace vcl
+{
+#ifdef VCL_NOISE_SSE
+    static inline __m128 sse_floor(__m128 x)
+    {
+        __m128 const t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmplt_ps(x, t), _mm_set1_ps(1.0f)));
+    }
+    static inline __m128 sse_select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    // Integer cell coordinate wrapped to [0,255], stored in an array for the scalar lookups in the permutation table
+    static inline void sse_store_index(__m128 cell, int index[4])
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(index), _mm_and_si128(_mm_cvttps_epi32(cell), _mm_set1_epi32(255)));
+    }
+    static inline void sse_store_offset(__m128 offset, int index[4])
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(index), _mm_cvttps_epi32(offset));
+    }
+    static inline __m128i sse_load(int const hash[4])
+    {
+        return _mm_loadu_si128(reinterpret_cast<__m128i const*>(hash));
+    }
+    // Value t^4 of the radial falloff of a simplex corner (0 outside of its support)
+    static inline __m128 sse_falloff(__m128 t)
+    {
+        t = _mm_max_ps(t, _mm_setzero_ps());
+        t = _mm_mul_ps(t, t);
+        return _mm_mul_ps(t, t);
+    }
+    static inline __m128 sse_sign(__m128 v, __m128i h, int bit)
+    {
+        // Flip the sign of v where (h & bit) != 0
+        __m128i const flip = _mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(bit)), _mm_set1_epi32(bit));
+        return _mm_xor_ps(v, _mm_and_ps(_mm_castsi128_ps(flip), _mm_set1_ps(-0.0f)));
+    }
+
+    // Same gradients as grad2() of simplexnoise1234
+    static inline __m128 sse_grad2(__m128i hash, __m128 x, __m128 y)
+    {
+        __m128i const h = _mm_and_si128(hash, _mm_set1_epi32(7));
+        __m128 const h_lt_4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+        __m128 const u = sse_select(h_lt_4, x, y);
+        __m128 const v = sse_select(h_lt_4, y, x);
+        return _mm_add_ps(sse_sign(u, h, 1), sse_sign(_mm_add_ps(v, v), h, 2));
+    }
+    // Same gradients as grad3() of simplexnoise1234
+    static inline __m128 sse_grad3(__m128i hash, __m128 x, __m128 y, __m128 z)
+    {
+        __m128i const h = _mm_and_si128(hash, _mm_set1_epi32(15));
+        __m128 const h_lt_8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+        __m128 const h_lt_4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+        __m128 const h_12_14 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_or_si128(h, _mm_set1_epi32(2)), _mm_set1_epi32(14)));
+        __m128 const u = sse_select(h_lt_8, x, y);
+        __m128 const v = sse_select(h_lt_4, y, sse_select(h_12_14, x, z));
+        return _mm_add_ps(sse_sign(u, h, 1), sse_sign(v, h, 2));
+    }
+
+    // 2D simplex noise of 4 samples - float version of snoise2
+    static __m128 sse_simplex2(__m128 x, __m128 y)
+    {
+        __m128 const one = _mm_set1_ps(1.0f);
+        __m128 const F2 = _mm_set1_ps(0.366025403f);
+        __m128 const G2 = _mm_set1_ps(0.211324865f);
+
+        // Skew the input space to determine the simplex cell
+        __m128 const s = _mm_mul_ps(_mm_add_ps(x, y), F2);
+        __m128 const i = sse_floor(_mm_add_ps(x, s));
+        __m128 const j = sse_floor(_mm_add_ps(y, s));
+        __m128 const t = _mm_mul_ps(_mm_add_ps(i, j), G2);
+        __m128 const x0 = _mm_sub_ps(x, _mm_sub_ps(i, t));
+        __m128 const y0 = _mm_sub_ps(y, _mm_sub_ps(j, t));
+
+        // Offsets of the middle corner: lower triangle (1,0) if x0>y0, upper triangle (0,1) otherwise
+        __m128 const i1 = _mm_and_ps(_mm_cmpgt_ps(x0, y0), one);
+        __m128 const j1 = _mm_sub_ps(one, i1);
+        __m128 const x1 = _mm_add_ps(_mm_sub_ps(x0, i1), G2);
+        __m128 const y1 = _mm_add_ps(_mm_sub_ps(y0, j1), G2);
+        __m128 const x2 = _mm_add_ps(_mm_sub_ps(x0, one), _mm_add_ps(G2, G2));
+        __m128 const y2 = _mm_add_ps(_mm_sub_ps(y0, one), _mm_add_ps(G2, G2));
+
+        // Hashed gradient index of the corners (scalar lookups)
+        int ii[4], jj[4], oi[4], h0[4], h1[4], h2[4];
+        sse_store_index(i, ii);
+        sse_store_index(j, jj);
+        sse_store_offset(i1, oi);
+        for (int k = 0; k < 4; ++k) {
+            int const oj = 1-oi[k];
+            h0[k] = perm[ii[k] + perm[jj[k]]];
+            h1[k] = perm[ii[k] + oi[k] + perm[jj[k] + oj]];
+            h2[k] = perm[ii[k] + 1 + perm[jj[k] + 1]];
+        }
+
+        __m128 const half = _mm_set1_ps(0.5f);
+        __m128 const n0 = _mm_mul_ps(sse_falloff(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0))), sse_grad2(sse_load(h0), x0, y0));
+        __m128 const n1 = _mm_mul_ps(sse_falloff(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1))), sse_grad2(sse_load(h1), x1, y1));
+        __m128 const n2 = _mm_mul_ps(sse_falloff(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x2, x2)), _mm_mul_ps(y2, y2))), sse_grad2(sse_load(h2), x2, y2));
+        return _mm_mul_ps(_mm_set1_ps(40.0f), _mm_add_ps(_mm_add_ps(n0, n1), n2));
+    }
+
+    static inline __m128 sse_corner3(float r, __m128 x, __m128 y, __m128 z, int const hash[4])
+    {
+        __m128 const t = _mm_sub_ps(_mm_set1_ps(r), _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+        return _mm_mul_ps(sse_falloff(t), sse_grad3(sse_load(hash), x, y, z));
+    }
+
+    // 3D simplex noise of 4 samples - float version of snoise3
+    static __m128 sse_simplex3(__m128 x, __m128 y, __m128 z)
+    {
+        __m128 const one = _mm_set1_ps(1.0f);
+        __m128 const F3 = _mm_set1_ps(0.333333333f);
+        __m128 const G3 = _mm_set1_ps(0.166666667f);
+
+        __m128 const s = _mm_mul_ps(_mm_add_ps(_mm_add_ps(x, y), z), F3);
+        __m128 const i = sse_floor(_mm_add_ps(x, s));
+        __m128 const j = sse_floor(_mm_add_ps(y, s));
+        __m128 const k = sse_floor(_mm_add_ps(z, s));
+        __m128 const t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(i, j), k), G3);
+        __m128 const x0 = _mm_sub_ps(x, _mm_sub_ps(i, t));
+        __m128 const y0 = _mm_sub_ps(y, _mm_sub_ps(j, t));
+        __m128 const z0 = _mm_sub_ps(z, _mm_sub_ps(k, t));
+
+        // Offsets of the second and third corners from the ordering of (x0,y0,z0) - branchless version of the selection in snoise3 (identical choice in case of equality)
+        __m128 const all = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        __m128 const a = _mm_cmpge_ps(x0, y0), b = _mm_cmpge_ps(y0, z0), c = _mm_cmpge_ps(x0, z0);
+        __m128 const not_a = _mm_xor_ps(a, all), not_b = _mm_xor_ps(b, all);
+        __m128 const i1 = _mm_and_ps(_mm_and_ps(a, _mm_or_ps(b, c)), one);
+        __m128 const j1 = _mm_and_ps(_mm_and_ps(not_a, b), one);
+        __m128 const k1 = _mm_and_ps(_mm_andnot_ps(_mm_and_ps(a, c), not_b), one);
+        __m128 const i2 = _mm_and_ps(_mm_or_ps(a, _mm_and_ps(b, c)), one);
+        __m128 const j2 = _mm_and_ps(_mm_or_ps(not_a, b), one);
+        __m128 const k2 = _mm_and_ps(_mm_or_ps(_mm_and_ps(a, not_b), _mm_andnot_ps(_mm_and_ps(b, c), not_a)), one);
+
+        __m128 const x1 = _mm_add_ps(_mm_sub_ps(x0, i1), G3), y1 = _mm_add_ps(_mm_sub_ps(y0, j1), G3), z1 = _mm_add_ps(_mm_sub_ps(z0, k1), G3);
+        __m128 const G3_2 = _mm_add_ps(G3, G3);
+        __m128 const x2 = _mm_add_ps(_mm_sub_ps(x0, i2), G3_2), y2 = _mm_add_ps(_mm_sub_ps(y0, j2), G3_2), z2 = _mm_add_ps(_mm_sub_ps(z0, k2), G3_2);
+        __m128 const G3_3 = _mm_sub_ps(_mm_add_ps(G3_2, G3), one);
+        __m128 const x3 = _mm_add_ps(x0, G3_3), y3 = _mm_add_ps(y0, G3_3), z3 = _mm_add_ps(z0, G3_3);
+
+        int ii[4], jj[4], kk[4], oi1[4], oj1[4], ok1[4], oi2[4], oj2[4], ok2[4];
+        int h0[4], h1[4], h2[4], h3[4];
+        sse_store_index(i, ii); sse_store_index(j, jj); sse_store_index(k, kk);
+        sse_store_offset(i1, oi1); sse_store_offset(j1, oj1); sse_store_offset(k1, ok1);
+        sse_store_offset(i2, oi2); sse_store_offset(j2, oj2); sse_store_offset(k2, ok2);
+        for (int n = 0; n < 4; ++n) {
+            h0[n] = perm[ii[n] + perm[jj[n] + perm[kk[n]]]];
+            h1[n] = perm[ii[n] + oi1[n] + perm[jj[n] + oj1[n] + perm[kk[n] + ok1[n]]]];
+            h2[n] = perm[ii[n] + oi2[n] + perm[jj[n] + oj2[n] + perm[kk[n] + ok2[n]]]];
+            h3[n] = perm[ii[n] + 1 + perm[jj[n] + 1 + perm[kk[n] + 1]]];
+        }
+
+        __m128 const n0 = sse_corner3(0.6f, x0, y0, z0, h0);
+        __m128 const n1 = sse_corner3(0.6f, x1, y1, z1, h1);
+        __m128 const n2 = sse_corner3(0.6f, x2, y2, z2, h2);
+        __m128 const n3 = sse_corner3(0.6f, x3, y3, z3, h3);
+        return _mm_mul_ps(_mm_set1_ps(32.0f), _mm_add_ps(_mm_add_ps(n0, n1), _mm_add_ps(n2, n3)));
+    }
+#endif
+
+    // Evaluate the fractal noise of N samples: sample(k, x, y[, z]) gives the coordinates of the k-th sample, and the result is stored in values[k]
+    template <typename SAMPLE>
+    static void noise_perlin_2D_kernel(float* values, size_t N, SAMPLE const& sample, int octave, float persistency, float frequency_gain)
+    {
+        size_t k = 0;
+#ifdef VCL_NOISE_SSE
+        for (; k < N; k += 4)
+        {
+            // Incomplete last group: the last sample is repeated
+            float x[4], y[4];
+            for (size_t n = 0; n < 4; ++n)
+                sample(std::min(k+n, N-1), x[n], y[n]);
+            __m128 const px = _mm_loadu_ps(x);
+            __m128 const py = _mm_loadu_ps(y);
+
+            __m128 value = _mm_setzero_ps();
+            float a = 1.0f; // current magnitude
+            float f = 1.0f; // current frequency
+            for (int o = 0; o < octave; ++o)
+            {
+                __m128 const f4 = _mm_set1_ps(f);
+                __m128 const n = sse_simplex2(_mm_mul_ps(px, f4), _mm_mul_ps(py, f4));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(a), _mm_add_ps(_mm_set1_ps(0.5f), _mm_mul_ps(_mm_set1_ps(0.5f), n))));
+                f *= frequency_gain;
+                a *= persistency;
+            }
+
+            float result[4];
+            _mm_storeu_ps(result, value);
+            for (size_t n = 0; n < 4 && k+n < N; ++n)
+                values[k+n] = result[n];
+        }
+#endif
+        for (; k < N; ++k) {
+            float x, y;
+            sample(k, x, y);
+            values[k] = noise_perlin(vec2{x, y}, octave, persistency, frequency_gain);
+        }
+    }
+
+    template <typename SAMPLE>
+    static void noise_perlin_3D_kernel(float* values, size_t N, SAMPLE const& sample, int octave, float persistency, float frequency_gain)
+    {
+        size_t k = 0;
+#ifdef VCL_NOISE_SSE
+        for (; k < N; k += 4)
+        {
+            float x[4], y[4], z[4];
+            for (size_t n = 0; n < 4; ++n)
+                sample(std::min(k+n, N-1), x[n], y[n], z[n]);
+            __m128 const px = _mm_loadu_ps(x);
+            __m128 const py = _mm_loadu_ps(y);
+            __m128 const pz = _mm_loadu_ps(z);
+
+            __m128 value = _mm_setzero_ps();
+            float a = 1.0f;
+            float f = 1.0f;
+            for (int o = 0; o < octave; ++o)
+            {
+                __m128 const f4 = _mm_set1_ps(f);
+                __m128 const n = sse_simplex3(_mm_mul_ps(px, f4), _mm_mul_ps(py, f4), _mm_mul_ps(pz, f4));
+                value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(a), _mm_add_ps(_mm_set1_ps(0.5f), _mm_mul_ps(_mm_set1_ps(0.5f), n))));
+                f *= frequency_gain;
+                a *= persistency;
+            }
+
+            float result[4];
+            _mm_storeu_ps(result, value);
+            for (size_t n = 0; n < 4 && k+n < N; ++n)
+                values[k+n] = result[n];
+        }
+#endif
+        for (; k < N; ++k) {
+            float x, y, z;
+            sample(k, x, y, z);
+            values[k] = noise_perlin(vec3{x, y, z}, octave, persistency, frequency_gain);
+        }
+    }
+
+    // Coordinate of the k-th sample among N regularly spaced between a and b
+    static inline float sample_coordinate(float a, float b, size_t k, size_t N)
+    {
+        return N>1 ? a + (k/(N-1.0f))*(b-a) : a;
+    }
+
+
+    void fill_noise_perlin(grid_2D<float>& values, vec2 const& p_min, vec2 const& p_max, int octave, float persistency, float frequency_gain)
+    {
+        size_t const Nx = values.dimension.x;
+        size_t const Ny = values.dimension.y;
+        float* data = values.data.data.data();
+        parallel_for(Ny, [=](size_t ky) {
+            float const y = sample_coordinate(p_min.y, p_max.y, ky, Ny);
+            noise_perlin_2D_kernel(data + ky*Nx, Nx, [=](size_t kx, float& px, float& py) {
+                px = sample_coordinate(p_min.x, p_max.x, kx, Nx);
+                py = y;
+            }, octave, persistency, frequency_gain);
+        }, 1);
+    }
+
+    void fill_noise_perlin(grid_3D<float>& values, vec3 const& p_min, vec3 const& p_max, int octave, float persistency, float frequency_gain)
+    {
+        size_t const Nx = values.dimension.x;
+        size_t const Ny = values.dimension.y;
+        size_t const Nz = values.dimension.z;
+        float* data = values.data.data.data();
+        parallel_for(Ny*Nz, [=](size_t row) {
+            size_t const ky = row % Ny;
+            size_t const kz = row / Ny;
+            float const y = sample_coordinate(p_min.y, p_max.y, ky, Ny);
+            float const z = sample_coordinate(p_min.z, p_max.z, kz, Nz);
+            noise_perlin_3D_kernel(data + row*Nx, Nx, [=](size_t kx, float& px, float& py, float& pz) {
+                px = sample_coordinate(p_min.x, p_max.x, kx, Nx);
+                py = y;
+                pz = z;
+            }, octave, persistency, frequency_gain);
+        }, 1);
+    }
+
+    void fill_noise_perlin(buffer<float>& values, buffer<vec2> const& p, int octave, float persistency, float frequency_gain)
+    {
+        size_t const N = p.size();
+        values.resize(N);
+        float* data = values.data.data();
+        vec2 const* samples = p.data.data();
+        parallel_for_range((N+255)/256, [=](size_t block_begin, size_t block_end) {
+            size_t const k_begin = 256*block_begin;
+            size_t const k_end = std::min(N, 256*block_end);
+            noise_perlin_2D_kernel(data + k_begin, k_end-k_begin, [=](size_t k, float& px, float& py) {
+                px = samples[k_begin+k].x;
+                py = samples[k_begin+k].y;
+            }, octave, persistency, frequency_gain);
+        }, 1);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "noise.hpp"
+
+#include "vcl/base/base.hpp"
+
+#include <cmath>
+
+// Permutation table of simplexnoise1234.cpp: the noise below uses the same gradients as snoise2/snoise3
+extern unsigned char perm[512];
+
+// The functions below follow step by step snoise2/snoise3 (same operations in double precision, giving the same values),
+//  and accumulate in addition the derivative of each corner contribution t^4 (g.d) with respect to d: -8 t^3 (g.d) d + t^4 g
+
+namespace vcl
+{
+    // Contribution of a corner of the 2D simplex at offset (x,y) with gradient index hash
+    static inline double corner2(double x, double y, int hash, double& dx, double& dy)
+    {
+        double const t = 0.5f - x*x-y*y;
+        if (t < 0.0f)
+            return 0.0;
+
+        // Gradient of grad2()
+        int const h = hash & 7;
+        double const su = (h&1) ? -1.0 : 1.0;
+        double const sv = (h&2) ? -2.0 : 2.0;
+        double const gx = h<4 ? su : sv;
+        double const gy = h<4 ? sv : su;
+        double const u = h<4 ? x : y;
+        double const v = h<4 ? y : x;
+        double const gd = ((h&1)? -u : u) + ((h&2)? -2.0f*v : 2.0f*v);
+
+        double const t2 = t*t;
+        double const t4 = t2*t2;
+        dx += -8*t2*t*gd*x + t4*gx;
+        dy += -8*t2*t*gd*y + t4*gy;
+        return t4 * gd;
+    }
+
+    static double snoise2_gradient(double x, double y, double& dx, double& dy)
+    {
+        double const F2 = 0.366025403;
+        double const G2 = 0.211324865;
+
+        double const s = (x+y)*F2;
+        int const i = static_cast<int>(std::floor(x+s));
+        int const j = static_cast<int>(std::floor(y+s));
+        double const t = (double)(i+j)*G2;
+        double const x0 = x-(i-t);
+        double const y0 = y-(j-t);
+
+        int const i1 = x0>y0 ? 1 : 0;
+        int const j1 = 1-i1;
+        double const x1 = x0 - i1 + G2;
+        double const y1 = y0 - j1 + G2;
+        double const x2 = x0 - 1.0f + 2.0f * G2;
+        double const y2 = y0 - 1.0f + 2.0f * G2;
+
+        int const ii = i & 255;
+        int const jj = j & 255;
+
+        dx = 0; dy = 0;
+        double const n0 = corner2(x0, y0, perm[ii+perm[jj]], dx, dy);
+        double const n1 = corner2(x1, y1, perm[ii+i1+perm[jj+j1]], dx, dy);
+        double const n2 = corner2(x2, y2, perm[ii+1+perm[jj+1]], dx, dy);
+        dx *= 40.0f;
+        dy *= 40.0f;
+        return 40.0f * (n0 + n1 + n2);
+    }
+
+    // Contribution of a corner of the 3D simplex
+    static inline double corner3(double x, double y, double z, int hash, double& dx, double& dy, double& dz)
+    {
+        double const t = 0.6f - x*x - y*y - z*z;
+        if (t < 0.0f)
+            return 0.0;
+
+        // Gradient of grad3(): su along the axis of u, sv along the axis of v
+        int const h = hash & 15;
+        double const su = (h&1) ? -1.0 : 1.0;
+        double const sv = (h&2) ? -1.0 : 1.0;
+        int const axis_u = h<8 ? 0 : 1;
+        int const axis_v = h<4 ? 1 : (h==12||h==14 ? 0 : 2);
+        double g[3] = { 0,0,0 };
+        g[axis_u] += su;
+        g[axis_v] += sv;
+        double const d[3] = { x,y,z };
+        double const gd = ((h&1)? -d[axis_u] : d[axis_u]) + ((h&2)? -d[axis_v] : d[axis_v]);
+
+        double const t2 = t*t;
+        double const t4 = t2*t2;
+        dx += -8*t2*t*gd*x + t4*g[0];
+        dy += -8*t2*t*gd*y + t4*g[1];
+        dz += -8*t2*t*gd*z + t4*g[2];
+        return t4 * gd;
+    }
+
+    static double snoise3_gradient(double x, double y, double z, double& dx, double& dy, double& dz)
+    {
+        double const F3 = 0.333333333;
+        double const G3 = 0.166666667;
+
+        double const s = (x+y+z)*F3;
+        int const i = static_cast<int>(std::floor(x+s));
+        int const j = static_cast<int>(std::floor(y+s));
+        int const k = static_cast<int>(std::floor(z+s));
+        double const t = (double)(i+j+k)*G3;
+        double const x0 = x-(i-t);
+        double const y0 = y-(j-t);
+        double const z0 = z-(k-t);
+
+        int i1, j1, k1, i2, j2, k2;
+        if (x0>=y0) {
+            if (y0>=z0)     { i1=1; j1=0; k1=0; i2=1; j2=1; k2=0; }
+            else if (x0>=z0) { i1=1; j1=0; k1=0; i2=1; j2=0; k2=1; }
+            else            { i1=0; j1=0; k1=1; i2=1; j2=0; k2=1; }
+        }
+        else {
+            if (y0<z0)      { i1=0; j1=0; k1=1; i2=0; j2=1; k2=1; }
+            else if (x0<z0) { i1=0; j1=1; k1=0; i2=0; j2=1; k2=1; }
+            else            { i1=0; j1=1; k1=0; i2=1; j2=1; k2=0; }
+        }
+
+        double const x1 = x0 - i1 + G3, y1 = y0 - j1 + G3, z1 = z0 - k1 + G3;
+        double const x2 = x0 - i2 + 2.0f*G3, y2 = y0 - j2 + 2.0f*G3, z2 = z0 - k2 + 2.0f*G3;
+        double const x3 = x0 - 1.0f + 3.0f*G3, y3 = y0 - 1.0f + 3.0f*G3, z3 = z0 - 1.0f + 3.0f*G3;
+
+        int const ii = i & 255;
+        int const jj = j & 255;
+        int const kk = k & 255;
+
+        dx = 0; dy = 0; dz = 0;
+        double const n0 = corner3(x0, y0, z0, perm[ii+perm[jj+perm[kk]]], dx, dy, dz);
+        double const n1 = corner3(x1, y1, z1, perm[ii+i1+perm[jj+j1+perm[kk+k1]]], dx, dy, dz);
+        double const n2 = corner3(x2, y2, z2, perm[ii+i2+perm[jj+j2+perm[kk+k2]]], dx, dy, dz);
+        double const n3 = corner3(x3, y3, z3, perm[ii+1+perm[jj+1+perm[kk+1]]], dx, dy, dz);
+        dx *= 32.0f;
+        dy *= 32.0f;
+        dz *= 32.0f;
+        return 32.0f * (n0 + n1 + n2 + n3);
+    }
+
+
+    float noise_perlin(vec2 const& p, vec2& gradient, int octave, float persistency, float frequency_gain)
+    {
+        float value = 0.0f;
+        float a = 1.0f; // current magnitude
+        float f = 1.0f; // current frequency
+        gradient = { 0,0 };
+        for(int k=0;k<octave;k++)
+        {
+            double dx, dy;
+            const float n = static_cast<float>(snoise2_gradient(p.x*f, p.y*f, dx, dy));
+            value += a*(0.5f+0.5f*n);
+            // d/dp of a*(0.5+0.5*n(f*p))
+            gradient += (0.5f*a*f) * vec2(float(dx), float(dy));
+            f *= frequency_gain;
+            a *= persistency;
+        }
+        return value;
+    }
+
+    float noise_perlin(vec3 const& p, vec3& gradient, int octave, float persistency, float frequency_gain)
+    {
+        float value = 0.0f;
+        float a = 1.0f; // current magnitude
+        float f = 1.0f; // current frequency
+        gradient = { 0,0,0 };
+        for(int k=0;k<octave;k++)
+        {
+            double dx, dy, dz;
+            const float n = static_cast<float>(snoise3_gradient(p.x*f, p.y*f, p.z*f, dx, dy, dz));
+            value += a*(0.5f+0.5f*n);
+            gradient += (0.5f*a*f) * vec3(float(dx), float(dy), float(dz));
+            f *= frequency_gain;
+            a *= persistency;
+        }
+        return value;
+    }
+
+    void update_terrain_noise_perlin(mesh& terrain, vec2 const& p_min, vec2 const& p_max, float height, int octave, float persistency, float frequency_gain)
+    {
+        vec2 const extent = p_max - p_min;
+        assert_vcl(extent.x!=0 && extent.y!=0, "Terrain domain must have a non zero extent");
+
+        size_t const N = terrain.uv.size();
+        terrain.position.resize(N);
+        terrain.normal.resize(N);
+
+        vec2 const* uv = terrain.uv.data.data();
+        vec3* position = terrain.position.data.data();
+        vec3* normal = terrain.normal.data.data();
+        parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+            for (size_t k = k_begin; k < k_end; ++k)
+            {
+                vec2 dn;
+                float const n = noise_perlin(uv[k], dn, octave, persistency, frequency_gain);
+                position[k] = { p_min.x + uv[k].x*extent.x, p_min.y + uv[k].y*extent.y, height*n };
+
+                // Surface z = height*n(u,v) with u = (x-p_min.x)/extent.x, v = (y-p_min.y)/extent.y: normal = (-dz/dx, -dz/dy, 1)
+                normal[k] = normalize(vec3(-height*dn.x/extent.x, -height*dn.y/extent.y, 1.0f));
+            }
+        });
+    }
+}
\ No newline at end of file
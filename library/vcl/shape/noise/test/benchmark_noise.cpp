@@ -0,0 +1,62 @@
+#include "benchmark_noise.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../noise.hpp"
+#include "vcl/shape/mesh/mesh.hpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void benchmark_noise()
+	{
+		size_t const N = 2048;
+		int const octave = 6;
+		vec2 const p_min = { 0.1f, 0.1f }, p_max = { 8.1f, 8.1f };
+		grid_2D<float> values; values.resize(N, N);
+		std::cout << "Perlin noise on a " << N << "x" << N << " heightfield, " << octave << " octaves, " << parallel_thread_count() << " threads" << std::endl;
+
+		{
+			// Reference: one call to the scalar noise per sample
+			auto const t0 = std::chrono::steady_clock::now();
+			for (size_t ky = 0; ky < N; ++ky)
+				for (size_t kx = 0; kx < N; ++kx) {
+					vec2 const p = { p_min.x + (kx/(N-1.0f))*(p_max.x-p_min.x), p_min.y + (ky/(N-1.0f))*(p_max.y-p_min.y) };
+					values(kx, ky) = noise_perlin(p, octave);
+				}
+			auto const t1 = std::chrono::steady_clock::now();
+			std::cout << "  noise_perlin per sample : " << std::chrono::duration<double, std::milli>(t1-t0).count() << " ms" << std::endl;
+		}
+		{
+			auto const t0 = std::chrono::steady_clock::now();
+			fill_noise_perlin(values, p_min, p_max, octave);
+			auto const t1 = std::chrono::steady_clock::now();
+			std::cout << "  fill_noise_perlin       : " << std::chrono::duration<double, std::milli>(t1-t0).count() << " ms" << std::endl;
+		}
+	
+
+		// Terrain update: heights and normals of a grid mesh
+		{
+			size_t const N_terrain = 1024;
+			mesh terrain = mesh_primitive_grid({-1,-1,0},{1,-1,0},{1,1,0},{-1,1,0}, int(N_terrain), int(N_terrain));
+			std::cout << "Terrain update on a " << N_terrain << "x" << N_terrain << " grid mesh, " << octave << " octaves" << std::endl;
+
+			// Reference: heights from noise_perlin, then normals recomputed from the triangles
+			auto const t0 = std::chrono::steady_clock::now();
+			for (size_t k = 0; k < terrain.position.size(); ++k)
+				terrain.position[k].z = 0.5f*noise_perlin(terrain.uv[k], octave);
+			auto const t1 = std::chrono::steady_clock::now();
+			terrain.compute_normal();
+			auto const t2 = std::chrono::steady_clock::now();
+			std::cout << "  noise_perlin + compute_normal : " << std::chrono::duration<double, std::milli>(t2-t0).count() << " ms (compute_normal: " << std::chrono::duration<double, std::milli>(t2-t1).count() << " ms)" << std::endl;
+
+			auto const t3 = std::chrono::steady_clock::now();
+			update_terrain_noise_perlin(terrain, {-1,-1}, {1,1}, 0.5f, octave);
+			auto const t4 = std::chrono::steady_clock::now();
+			std::cout << "  update_terrain_noise_perlin   : " << std::chrono::duration<double, std::milli>(t4-t3).count() << " ms" << std::endl;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "test_noise.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../noise.hpp"
+#include "vcl/shape/mesh/mesh.hpp"
+
+#include <cmath>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_noise()
+	{
+		// Batched 2D noise on a grid matches the scalar noise (coordinates > 0, odd size to cover the incomplete groups of samples)
+		{
+			vec2 const p_min = { 0.1f, 0.2f }, p_max = { 7.3f, 5.9f };
+			grid_2D<float> values; values.resize(37, 23);
+			fill_noise_perlin(values, p_min, p_max, 6, 0.4f, 2.1f);
+			float error = 0.0f;
+			for (size_t ky = 0; ky < 23; ++ky) {
+				for (size_t kx = 0; kx < 37; ++kx) {
+					vec2 const p = { p_min.x + (kx/36.0f)*(p_max.x-p_min.x), p_min.y + (ky/22.0f)*(p_max.y-p_min.y) };
+					error = std::max(error, std::abs(values(kx, ky) - noise_perlin(p, 6, 0.4f, 2.1f)));
+				}
+			}
+			assert_vcl_no_msg(error < 1e-4f);
+		}
+
+		// Batched 3D noise (float computation of the skewed coordinates: slightly larger difference than in 2D)
+		{
+			vec3 const p_min = { 0.3f, 0.1f, 0.2f }, p_max = { 4.1f, 3.7f, 2.9f };
+			grid_3D<float> values; values.resize(13, 9, 7);
+			fill_noise_perlin(values, p_min, p_max, 4, 0.5f, 2.0f);
+			float error = 0.0f;
+			for (size_t kz = 0; kz < 7; ++kz)
+				for (size_t ky = 0; ky < 9; ++ky)
+					for (size_t kx = 0; kx < 13; ++kx) {
+						vec3 const p = { p_min.x + (kx/12.0f)*(p_max.x-p_min.x), p_min.y + (ky/8.0f)*(p_max.y-p_min.y), p_min.z + (kz/6.0f)*(p_max.z-p_min.z) };
+						error = std::max(error, std::abs(values(kx, ky, kz) - noise_perlin(p, 4, 0.5f, 2.0f)));
+					}
+			assert_vcl_no_msg(error < 1e-3f);
+		}
+
+		// Arbitrary samples
+		{
+			buffer<vec2> p;
+			for (int k = 0; k < 1001; ++k)
+				p.push_back({ 0.5f + 0.013f*k, 0.2f + 0.007f*k*(k%3) });
+			buffer<float> values;
+			fill_noise_perlin(values, p, 5, 0.3f, 2.0f);
+			assert_vcl_no_msg(values.size() == p.size());
+			float error = 0.0f;
+			for (size_t k = 0; k < p.size(); ++k)
+				error = std::max(error, std::abs(values[k] - noise_perlin(p[k], 5, 0.3f, 2.0f)));
+			assert_vcl_no_msg(error < 1e-4f);
+		}
+	
+
+		// Analytic gradient: same value as noise_perlin, and derivatives matching finite differences
+		{
+			float error_value = 0.0f, error_gradient = 0.0f;
+			float const h = 1e-3f;
+			for (int k = 0; k < 200; ++k) {
+				vec2 const p = { 0.5f + 0.031f*k, 0.7f + 0.017f*(k%13) };
+				vec2 g;
+				float const n = noise_perlin(p, g, 4, 0.4f, 2.0f);
+				error_value = std::max(error_value, std::abs(n - noise_perlin(p, 4, 0.4f, 2.0f)));
+				vec2 const g_fd = { (noise_perlin(p+vec2(h,0), 4, 0.4f, 2.0f)-noise_perlin(p-vec2(h,0), 4, 0.4f, 2.0f))/(2*h), (noise_perlin(p+vec2(0,h), 4, 0.4f, 2.0f)-noise_perlin(p-vec2(0,h), 4, 0.4f, 2.0f))/(2*h) };
+				error_gradient = std::max(error_gradient, norm(g-g_fd));
+			}
+			assert_vcl_no_msg(error_value == 0.0f);
+			assert_vcl_no_msg(error_gradient < 1e-2f);
+		}
+		{
+			float error_value = 0.0f, error_gradient = 0.0f;
+			float const h = 1e-3f;
+			for (int k = 0; k < 200; ++k) {
+				vec3 const p = { 0.5f + 0.031f*k, 0.7f + 0.017f*(k%13), 0.3f + 0.023f*(k%7) };
+				vec3 g;
+				float const n = noise_perlin(p, g, 4, 0.4f, 2.0f);
+				error_value = std::max(error_value, std::abs(n - noise_perlin(p, 4, 0.4f, 2.0f)));
+				vec3 g_fd;
+				for (int c = 0; c < 3; ++c) {
+					vec3 dp = { 0,0,0 }; dp[c] = h;
+					g_fd[c] = (noise_perlin(p+dp, 4, 0.4f, 2.0f)-noise_perlin(p-dp, 4, 0.4f, 2.0f))/(2*h);
+				}
+				error_gradient = std::max(error_gradient, norm(g-g_fd));
+			}
+			assert_vcl_no_msg(error_value == 0.0f);
+			assert_vcl_no_msg(error_gradient < 1e-2f);
+		}
+
+		// Terrain: positions as computed per vertex, and normals close to the normals of the triangles of a fine mesh
+		{
+			mesh terrain = mesh_primitive_grid({-1,-1,0},{1,-1,0},{1,1,0},{-1,1,0}, 200, 200);
+			mesh reference = terrain;
+			update_terrain_noise_perlin(terrain, {-1,-1}, {1,1}, 0.5f, 4, 0.4f, 2.0f);
+			for (size_t k = 0; k < reference.position.size(); ++k)
+				reference.position[k].z = 0.5f*noise_perlin(reference.uv[k], 4, 0.4f, 2.0f);
+			reference.compute_normal();
+
+			float error_position = 0.0f, dot_min = 1.0f;
+			for (size_t k = 0; k < terrain.position.size(); ++k) {
+				error_position = std::max(error_position, norm(terrain.position[k]-reference.position[k]));
+				dot_min = std::min(dot_min, dot(terrain.normal[k], reference.normal[k]));
+			}
+			assert_vcl_no_msg(error_position < 1e-5f);
+			assert_vcl_no_msg(dot_min > 0.99f);
+		}
+	}
+}
\ No newline at end of file
@@ -3,4 +3,5 @@
 #include "mesh/mesh.hpp"
 #include "curve/curve.hpp"
 #include "noise/noise.hpp"
-#include "intersection/intersection.hpp"
+#include "intersection/intersection.hpp"
+#include "terrain/terrain.hpp"
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "terrain_chunk.hpp"
+#include "terrain_generator.hpp"
@@ -0,0 +1,194 @@
+#include "terrain_chunk.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/shape/noise/noise.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace vcl
+{
+	bool operator==(terrain_chunk_key const& a, terrain_chunk_key const& b)
+	{
+		return a.level==b.level && a.i==b.i && a.j==b.j;
+	}
+	bool operator!=(terrain_chunk_key const& a, terrain_chunk_key const& b)
+	{
+		return !(a==b);
+	}
+	bool operator<(terrain_chunk_key const& a, terrain_chunk_key const& b)
+	{
+		if (a.level != b.level) return a.level < b.level;
+		if (a.i != b.i) return a.i < b.i;
+		return a.j < b.j;
+	}
+	std::ostream& operator<<(std::ostream& s, terrain_chunk_key const& key)
+	{
+		s << "(" << key.level << "," << key.i << "," << key.j << ")";
+		return s;
+	}
+
+	static int floor_div2(int a)
+	{
+		return (a >= 0) ? a/2 : -((-a+1)/2);
+	}
+	terrain_chunk_key terrain_chunk_parent(terrain_chunk_key const& key)
+	{
+		return { key.level+1, floor_div2(key.i), floor_div2(key.j) };
+	}
+	terrain_chunk_key terrain_chunk_child(terrain_chunk_key const& key, int a, int b)
+	{
+		assert_vcl(key.level>0, "Chunks of level 0 have no children");
+		return { key.level-1, 2*key.i+a, 2*key.j+b };
+	}
+
+	float terrain_chunk_size(terrain_parameters const& parameters, int level)
+	{
+		return std::ldexp(parameters.chunk_size, level);
+	}
+
+	float terrain_chunk_distance(terrain_parameters const& parameters, terrain_chunk_key const& key, vec3 const& p)
+	{
+		float const s = terrain_chunk_size(parameters, key.level);
+		float const dx = std::max({ key.i*s - p.x, 0.0f, p.x - (key.i+1)*s });
+		float const dy = std::max({ key.j*s - p.y, 0.0f, p.y - (key.j+1)*s });
+		float const dz = std::max({ -p.z, 0.0f, p.z - parameters.height });
+		return std::sqrt(dx*dx + dy*dy + dz*dz);
+	}
+
+	bool terrain_chunk_subdivide(terrain_parameters const& parameters, terrain_chunk_key const& key, vec3 const& p)
+	{
+		return key.level > 0 && terrain_chunk_distance(parameters, key, p) < parameters.lod_factor*terrain_chunk_size(parameters, key.level);
+	}
+
+
+	terrain_chunk terrain_generate_chunk(terrain_parameters const& parameters, terrain_chunk_key const& key)
+	{
+		int const N = parameters.sample;
+		assert_vcl(N>1, "Terrain chunks must have at least 2 samples per side");
+
+		float const s = terrain_chunk_size(parameters, key.level);
+		float const h = s/(N-1);
+		vec2 const p_min = { key.i*s, key.j*s };
+
+		// Heights with one extra sample on each side (used for the normals)
+		grid_2D<float> extended;
+		extended.resize(N+2, N+2);
+		vec2 const q_min = (p_min - vec2(h, h)) / parameters.noise_scale;
+		vec2 const q_max = (p_min + vec2(s+h, s+h)) / parameters.noise_scale;
+		fill_noise_perlin(extended, q_min, q_max, parameters.octave, parameters.persistency, parameters.frequency_gain);
+
+		terrain_chunk chunk;
+		chunk.key = key;
+		chunk.height.resize(N, N);
+		for (int ky = 0; ky < N; ++ky)
+			for (int kx = 0; kx < N; ++kx)
+				chunk.height(kx, ky) = parameters.height * extended(kx+1, ky+1);
+
+		// Mesh: N*N vertices of the heightfield (index kx + N*ky) followed by the 4(N-1) vertices of the skirt
+		mesh& shape = chunk.shape;
+		size_t const N_grid = size_t(N)*N;
+		size_t const N_skirt = 4*size_t(N-1);
+		shape.position.resize(N_grid + N_skirt);
+		shape.normal.resize(N_grid + N_skirt);
+		shape.uv.resize(N_grid + N_skirt);
+		float const H = parameters.height;
+		for (int ky = 0; ky < N; ++ky) {
+			for (int kx = 0; kx < N; ++kx) {
+				size_t const idx = kx + size_t(N)*ky;
+				shape.position[idx] = { p_min.x + kx*h, p_min.y + ky*h, chunk.height(kx, ky) };
+				float const dzdx = H*(extended(kx+2, ky+1) - extended(kx, ky+1)) / (2*h);
+				float const dzdy = H*(extended(kx+1, ky+2) - extended(kx+1, ky)) / (2*h);
+				shape.normal[idx] = normalize(vec3(-dzdx, -dzdy, 1.0f));
+				shape.uv[idx] = { kx/(N-1.0f), ky/(N-1.0f) };
+			}
+		}
+
+		size_t const N_triangle = 2*size_t(N-1)*(N-1) + 2*N_skirt;
+		shape.connectivity.resize(N_triangle);
+		size_t t = 0;
+		for (int ky = 0; ky < N-1; ++ky) {
+			for (int kx = 0; kx < N-1; ++kx) {
+				unsigned int const a = kx + N*ky;
+				unsigned int const b = a+1;
+				unsigned int const c = a+1+N;
+				unsigned int const d = a+N;
+				shape.connectivity[t++] = { a, b, c };
+				shape.connectivity[t++] = { a, c, d };
+			}
+		}
+
+		// Skirt: the border of the heightfield (counterclockwise seen from above) is duplicated and moved down
+		float const skirt_depth = 2*h;
+		buffer<unsigned int> border;
+		for (int k = 0; k < N-1; ++k) border.push_back(k);                      // y = y_min
+		for (int k = 0; k < N-1; ++k) border.push_back(N-1 + N*k);              // x = x_max
+		for (int k = N-1; k > 0; --k) border.push_back(k + N*(N-1));            // y = y_max
+		for (int k = N-1; k > 0; --k) border.push_back(N*k);                    // x = x_min
+		for (size_t k = 0; k < N_skirt; ++k) {
+			unsigned int const top = border[k];
+			unsigned int const bottom = static_cast<unsigned int>(N_grid + k);
+			shape.position[bottom] = shape.position[top] - vec3(0, 0, skirt_depth);
+			shape.normal[bottom] = shape.normal[top];
+			shape.uv[bottom] = shape.uv[top];
+		}
+		for (size_t k = 0; k < N_skirt; ++k) {
+			unsigned int const top0 = border[k], top1 = border[(k+1)%N_skirt];
+			unsigned int const bottom0 = static_cast<unsigned int>(N_grid + k), bottom1 = static_cast<unsigned int>(N_grid + (k+1)%N_skirt);
+			// Facing outside of the chunk
+			shape.connectivity[t++] = { top0, bottom0, bottom1 };
+			shape.connectivity[t++] = { top0, bottom1, top1 };
+		}
+
+		shape.fill_empty_field();
+		return chunk;
+	}
+
+
+	// Add the chunks selected in the subtree of key
+	static void terrain_select_lod(terrain_parameters const& parameters, vec3 const& p, terrain_chunk_key const& key, buffer<terrain_chunk_key>& selection)
+	{
+		if (terrain_chunk_subdivide(parameters, key, p)) {
+			for (int b = 0; b < 2; ++b)
+				for (int a = 0; a < 2; ++a)
+					terrain_select_lod(parameters, p, terrain_chunk_child(key, a, b), selection);
+		}
+		else
+			selection.push_back(key);
+	}
+
+	buffer<terrain_chunk_key> terrain_lod_roots(terrain_parameters const& parameters, vec3 const& p)
+	{
+		assert_vcl(parameters.level_count>0, "Terrain must have at least one level");
+		int const level = parameters.level_count-1;
+		float const s = terrain_chunk_size(parameters, level);
+		float const r = parameters.view_distance;
+
+		buffer<terrain_chunk_key> roots;
+		int const i_min = int(std::floor((p.x-r)/s)), i_max = int(std::floor((p.x+r)/s));
+		int const j_min = int(std::floor((p.y-r)/s)), j_max = int(std::floor((p.y+r)/s));
+		for (int j = j_min; j <= j_max; ++j) {
+			for (int i = i_min; i <= i_max; ++i) {
+				terrain_chunk_key const root = { level, i, j };
+				if (terrain_chunk_distance(parameters, root, p) <= r)
+					roots.push_back(root);
+			}
+		}
+		return roots;
+	}
+
+	buffer<terrain_chunk_key> terrain_select_lod(terrain_parameters const& parameters, vec3 const& p)
+	{
+		buffer<terrain_chunk_key> selection;
+		for (terrain_chunk_key const& root : terrain_lod_roots(parameters, p))
+			terrain_select_lod(parameters, p, root, selection);
+
+		std::sort(selection.data.begin(), selection.data.end(), [&](terrain_chunk_key const& a, terrain_chunk_key const& b) {
+			if (a.level != b.level)
+				return a.level > b.level;
+			return terrain_chunk_distance(parameters, a, p) < terrain_chunk_distance(parameters, b, p);
+		});
+		return selection;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/shape/mesh/structure/mesh.hpp"
+
+namespace vcl
+{
+	/** Parameters of a large procedural terrain divided into square chunks
+	* Chunks of level l have a size chunk_size*2^l, level 0 being the finest one. All chunks have the same number of samples.
+	* The height of the terrain at (x,y) is height*noise_perlin((x,y)/noise_scale). */
+	struct terrain_parameters
+	{
+		float chunk_size = 250.0f;        // Size of the chunks of level 0
+		int level_count = 6;              // Number of levels of details (the coarsest chunks have a size chunk_size*2^(level_count-1))
+		int sample = 65;                  // Number of samples along each side of a chunk
+		float lod_factor = 1.5f;          // A chunk is subdivided when the camera is closer than lod_factor * (size of the chunk)
+		float view_distance = 12000.0f;   // Chunks further than this distance from the camera are not displayed
+
+		float height = 400.0f;
+		float noise_scale = 3000.0f;
+		int octave = 8;
+		float persistency = 0.45f;
+		float frequency_gain = 2.0f;
+	};
+
+	/** Chunk (level, i, j) covers the square [i,i+1]x[j,j+1] * chunk_size*2^level
+	* Its four children are the chunks (level-1, 2i+a, 2j+b) with a,b in {0,1}. */
+	struct terrain_chunk_key
+	{
+		int level = 0;
+		int i = 0;
+		int j = 0;
+	};
+	bool operator==(terrain_chunk_key const& a, terrain_chunk_key const& b);
+	bool operator!=(terrain_chunk_key const& a, terrain_chunk_key const& b);
+	bool operator<(terrain_chunk_key const& a, terrain_chunk_key const& b);
+	std::ostream& operator<<(std::ostream& s, terrain_chunk_key const& key);
+
+	terrain_chunk_key terrain_chunk_parent(terrain_chunk_key const& key);
+	terrain_chunk_key terrain_chunk_child(terrain_chunk_key const& key, int a, int b);
+	/** Size of the chunks of a given level */
+	float terrain_chunk_size(terrain_parameters const& parameters, int level);
+	/** Distance from p to the bounding box of the chunk (the box spans the heights [0,height]) */
+	float terrain_chunk_distance(terrain_parameters const& parameters, terrain_chunk_key const& key, vec3 const& p);
+	/** True if the chunk should be replaced by its four children when the camera is at position p */
+	bool terrain_chunk_subdivide(terrain_parameters const& parameters, terrain_chunk_key const& key, vec3 const& p);
+
+	/** Generated chunk
+	* - height: heightfield of sample x sample values, height(kx,ky) is the height at the position (x_min + kx*h, y_min + ky*h) with h the distance between samples
+	* - shape: mesh of the heightfield in world coordinates, with a skirt along its border
+	*
+	* Neighboring chunks of different levels do not share the same samples along their common border: the skirt (a vertical band of triangles
+	*  going down from the border) hides the cracks between them. The normals are computed from the heights of the chunk and of one extra sample
+	*  around it, so that they are continuous between neighboring chunks of the same level. */
+	struct terrain_chunk
+	{
+		terrain_chunk_key key;
+		grid_2D<float> height;
+		mesh shape;
+	};
+
+	/** Generate the heightfield and the mesh of a chunk (the noise is evaluated with fill_noise_perlin) */
+	terrain_chunk terrain_generate_chunk(terrain_parameters const& parameters, terrain_chunk_key const& key);
+
+	/** Coarsest chunks around the camera position p (within view_distance): roots of the quadtree */
+	buffer<terrain_chunk_key> terrain_lod_roots(terrain_parameters const& parameters, vec3 const& p);
+	/** Select the chunks to display from the camera position p: the coarsest chunks around the camera (within view_distance) are recursively
+	* subdivided as long as terrain_chunk_subdivide is true (quadtree). The selected chunks cover the area without overlapping, and are sorted
+	* from the coarsest level to the finest, then from the closest to the camera to the furthest. */
+	buffer<terrain_chunk_key> terrain_select_lod(terrain_parameters const& parameters, vec3 const& p);
+}
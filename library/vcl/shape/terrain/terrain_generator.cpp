@@ -0,0 +1,106 @@
+#include "terrain_generator.hpp"
+
+#include "vcl/base/base.hpp"
+
+#include <algorithm>
+
+namespace vcl
+{
+	terrain_generator::terrain_generator(terrain_parameters const& parameters_arg, size_t thread_count_arg)
+		:parameters(parameters_arg)
+	{
+		if (thread_count_arg == 0)
+			thread_count_arg = std::max<size_t>(1, std::thread::hardware_concurrency()) - 1;
+		thread_count_arg = std::max<size_t>(1, thread_count_arg);
+		for (size_t k = 0; k < thread_count_arg; ++k)
+			workers.emplace_back(&terrain_generator::worker_loop, this);
+	}
+
+	terrain_generator::~terrain_generator()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+			queue.clear();
+		}
+		cv_request.notify_all();
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	void terrain_generator::worker_loop()
+	{
+		parallel_set_sequential_in_this_thread(true);
+		while (true)
+		{
+			terrain_chunk_key key;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				cv_request.wait(lock, [&] { return stop || !queue.empty(); });
+				if (stop)
+					return;
+				key = queue.front();
+				queue.pop_front();
+			}
+
+			terrain_chunk chunk = terrain_generate_chunk(parameters, key);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				done.push_back(std::move(chunk));
+				in_progress.erase(key);
+			}
+			cv_idle.notify_all();
+		}
+	}
+
+	void terrain_generator::request(terrain_chunk_key const& key)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!in_progress.insert(key).second)
+				return;
+			queue.push_back(key);
+		}
+		cv_request.notify_one();
+	}
+
+	void terrain_generator::cancel_requests_except(std::set<terrain_chunk_key> const& needed)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::deque<terrain_chunk_key> kept;
+		for (terrain_chunk_key const& key : queue) {
+			if (needed.count(key))
+				kept.push_back(key);
+			else
+				in_progress.erase(key);
+		}
+		queue.swap(kept);
+		cv_idle.notify_all();
+	}
+
+	std::vector<terrain_chunk> terrain_generator::collect()
+	{
+		std::vector<terrain_chunk> result;
+		std::lock_guard<std::mutex> lock(mutex);
+		result.swap(done);
+		return result;
+	}
+
+	void terrain_generator::wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cv_idle.wait(lock, [&] { return in_progress.empty(); });
+	}
+
+	size_t terrain_generator::pending() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return in_progress.size();
+	}
+
+	size_t terrain_generator::thread_count() const
+	{
+		return workers.size();
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "terrain_chunk.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace vcl
+{
+	/** Generate terrain chunks on background threads
+	* - request(key) adds a chunk to the queue of chunks to generate (ignored if it is already queued or being generated).
+	* - The worker threads take the requests in their order of arrival and generate them with terrain_generate_chunk.
+	* - collect() returns the chunks generated since the last call (called from the main thread, typically once per frame).
+	* - cancel_requests_except() removes the queued requests that are no longer needed (typically after the camera moved).
+	* Each worker generates its chunks sequentially: the parallel loops called from the worker threads do not use the shared thread pool.
+	* The parameters must not be modified while chunks are pending. */
+	struct terrain_generator
+	{
+		terrain_parameters parameters;
+
+		/** Start thread_count worker threads (0 = number of hardware threads minus one, with at least one worker) */
+		explicit terrain_generator(terrain_parameters const& parameters = terrain_parameters(), size_t thread_count = 0);
+		~terrain_generator();
+		terrain_generator(terrain_generator const&) = delete;
+		terrain_generator& operator=(terrain_generator const&) = delete;
+
+		void request(terrain_chunk_key const& key);
+		void cancel_requests_except(std::set<terrain_chunk_key> const& needed);
+		std::vector<terrain_chunk> collect();
+		/** Wait until all the requested chunks are generated */
+		void wait();
+
+		/** Number of chunks queued or being generated */
+		size_t pending() const;
+		size_t thread_count() const;
+
+		/** Internal data */
+		std::vector<std::thread> workers;
+		mutable std::mutex mutex;
+		std::condition_variable cv_request;
+		std::condition_variable cv_idle;
+		std::deque<terrain_chunk_key> queue;
+		std::set<terrain_chunk_key> in_progress; // queued or being generated
+		std::vector<terrain_chunk> done;
+		bool stop = false;
+
+		void worker_loop();
+	};
+}
@@ -0,0 +1,51 @@
+#include "benchmark_terrain.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../terrain.hpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void benchmark_terrain()
+	{
+		terrain_parameters parameters;
+		size_t const N_chunk = 256;
+		buffer<terrain_chunk_key> keys;
+		for (size_t k = 0; k < N_chunk; ++k)
+			keys.push_back({ 0, int(k%16), int(k/16) });
+		double const samples = double(N_chunk)*parameters.sample*parameters.sample;
+		std::cout << "Terrain generation of " << N_chunk << " chunks of " << parameters.sample << "x" << parameters.sample << " samples, " << parameters.octave << " octaves" << std::endl;
+
+		{
+			auto const t0 = std::chrono::steady_clock::now();
+			for (terrain_chunk_key const& key : keys)
+				terrain_generate_chunk(parameters, key);
+			auto const t1 = std::chrono::steady_clock::now();
+			double const s = std::chrono::duration<double>(t1-t0).count();
+			std::cout << "  main thread                    : " << N_chunk/s << " chunks/s, " << samples/s*1e-6 << " Msamples/s" << std::endl;
+		}
+		{
+			terrain_generator generator(parameters);
+			auto const t0 = std::chrono::steady_clock::now();
+			for (terrain_chunk_key const& key : keys)
+				generator.request(key);
+			generator.wait();
+			auto const t1 = std::chrono::steady_clock::now();
+			double const s = std::chrono::duration<double>(t1-t0).count();
+			std::cout << "  terrain_generator (" << generator.thread_count() << " workers)  : " << N_chunk/s << " chunks/s, " << samples/s*1e-6 << " Msamples/s" << std::endl;
+		}
+		{
+			size_t const N_frame = 1000;
+			size_t count = 0;
+			auto const t0 = std::chrono::steady_clock::now();
+			for (size_t k = 0; k < N_frame; ++k)
+				count += terrain_select_lod(parameters, { 10.0f*k, 5.0f*k, 100.0f }).size();
+			auto const t1 = std::chrono::steady_clock::now();
+			std::cout << "  terrain_select_lod             : " << std::chrono::duration<double, std::milli>(t1-t0).count()/N_frame << " ms per frame (" << count/N_frame << " chunks)" << std::endl;
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#include "test_terrain.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../terrain.hpp"
+#include "vcl/shape/noise/noise.hpp"
+
+#include <cmath>
+#include <set>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_terrain()
+	{
+		terrain_parameters parameters;
+		parameters.chunk_size = 100.0f;
+		parameters.level_count = 4;
+		parameters.sample = 17;
+		parameters.view_distance = 3000.0f;
+
+		// Quadtree
+		{
+			terrain_chunk_key const key = { 2, -3, 5 };
+			for (int b = 0; b < 2; ++b)
+				for (int a = 0; a < 2; ++a)
+					assert_vcl_no_msg(terrain_chunk_parent(terrain_chunk_child(key, a, b)) == key);
+		}
+
+		// LOD selection: the selected chunks cover the roots without overlapping, and the finest level is used around the camera
+		{
+			vec3 const camera = { 123.0f, -456.0f, 50.0f };
+			buffer<terrain_chunk_key> const selection = terrain_select_lod(parameters, camera);
+			buffer<terrain_chunk_key> const roots = terrain_lod_roots(parameters, camera);
+			std::set<terrain_chunk_key> const selected(selection.begin(), selection.end());
+			assert_vcl_no_msg(selected.size() == selection.size());
+
+			double area_selected = 0, area_roots = 0;
+			for (terrain_chunk_key const& key : selection) {
+				double const s = terrain_chunk_size(parameters, key.level);
+				area_selected += s*s;
+				for (terrain_chunk_key parent = key; parent.level < parameters.level_count-1; ) {
+					parent = terrain_chunk_parent(parent);
+					assert_vcl_no_msg(selected.count(parent) == 0);
+				}
+			}
+			for (terrain_chunk_key const& key : roots) {
+				double const s = terrain_chunk_size(parameters, key.level);
+				area_roots += s*s;
+			}
+			assert_vcl_no_msg(std::abs(area_selected-area_roots) < 1e-6*area_roots);
+			assert_vcl_no_msg(selected.count({ 0, 1, -5 }) == 1);
+
+			// Sorted from the coarsest level to the finest
+			for (size_t k = 1; k < selection.size(); ++k)
+				assert_vcl_no_msg(selection[k-1].level >= selection[k].level);
+		}
+
+		// Generated chunks: neighbors share the heights of their common border
+		{
+			terrain_chunk const a = terrain_generate_chunk(parameters, { 1, 2, 3 });
+			terrain_chunk const b = terrain_generate_chunk(parameters, { 1, 3, 3 });
+			int const N = parameters.sample;
+			assert_vcl_no_msg(a.height.dimension.x == size_t(N) && a.height.dimension.y == size_t(N));
+			assert_vcl_no_msg(a.shape.position.size() == size_t(N*N + 4*(N-1)));
+			assert_vcl_no_msg(mesh_check(a.shape));
+			for (int k = 0; k < N; ++k) {
+				assert_vcl_no_msg(std::abs(a.height(N-1, k) - b.height(0, k)) < 1e-3f);
+				assert_vcl_no_msg(norm(a.shape.normal[N-1 + N*k] - b.shape.normal[N*k]) < 1e-3f);
+			}
+			for (vec3 const& n : a.shape.normal)
+				assert_vcl_no_msg(n.z > 0);
+
+			// Heights sampled from the noise at the world positions
+			vec3 const p = a.shape.position[5 + N*7];
+			float const expected = parameters.height * noise_perlin(vec2(p.x, p.y)/parameters.noise_scale, parameters.octave, parameters.persistency, parameters.frequency_gain);
+			assert_vcl_no_msg(std::abs(p.z - expected) < 1e-2f);
+		}
+
+		// Background generation
+		{
+			terrain_generator generator(parameters, 2);
+			buffer<terrain_chunk_key> keys;
+			for (int i = 0; i < 6; ++i)
+				keys.push_back({ 0, i, -i });
+			for (terrain_chunk_key const& key : keys)
+				generator.request(key);
+			generator.wait();
+			assert_vcl_no_msg(generator.pending() == 0);
+			std::vector<terrain_chunk> const chunks = generator.collect();
+			assert_vcl_no_msg(chunks.size() == keys.size());
+			std::set<terrain_chunk_key> generated;
+			for (terrain_chunk const& chunk : chunks)
+				generated.insert(chunk.key);
+			for (terrain_chunk_key const& key : keys)
+				assert_vcl_no_msg(generated.count(key) == 1);
+			assert_vcl_no_msg(generator.collect().size() == 0);
+
+			// Canceled requests are not generated
+			for (int i = 0; i < 40; ++i)
+				generator.request({ 1, i, i });
+			generator.cancel_requests_except({});
+			generator.wait();
+			assert_vcl_no_msg(generator.collect().size() < 40);
+		}
+	}
+}
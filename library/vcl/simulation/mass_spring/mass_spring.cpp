@@ -0,0 +1,369 @@
+#include "mass_spring.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// The kernels below work on raw pointers and explicit x,y,z components:
+//  they are called on every particle/spring at each iteration of the solver and avoid the bound checks of the containers.
+
+namespace vcl
+{
+	// Size of the blocks used for the reductions: partial sums are computed per block then summed sequentially
+	//  so that the result does not depend on the number of threads.
+	static size_t const reduction_block_size = 4096;
+
+	static double parallel_dot(buffer<vec3> const& a, buffer<vec3> const& b, buffer<double>& partial_sum)
+	{
+		size_t const N = a.size();
+		size_t const N_block = (N + reduction_block_size - 1) / reduction_block_size;
+		partial_sum.resize(N_block);
+
+		vec3 const* pa = a.data.data();
+		vec3 const* pb = b.data.data();
+		double* partial = partial_sum.data.data();
+		parallel_for(N_block, [=](size_t k_block) {
+			size_t const k_end = std::min(N, (k_block+1)*reduction_block_size);
+			double s = 0.0;
+			for (size_t k = k_block*reduction_block_size; k < k_end; ++k)
+				s += pa[k].x*pb[k].x + pa[k].y*pb[k].y + pa[k].z*pb[k].z;
+			partial[k_block] = s;
+		}, 1);
+
+		double s = 0.0;
+		for (size_t k = 0; k < N_block; ++k)
+			s += partial[k];
+		return s;
+	}
+
+	// Set to zero the components associated to fixed particles
+	static void filter_fixed(buffer<vec3>& v, buffer<int> const& fixed)
+	{
+		size_t const N = v.size();
+		for (size_t k = 0; k < N; ++k)
+			if (fixed.data[k])
+				v.data[k] = { 0,0,0 };
+	}
+
+	// Product of the stiffness block of a spring (w w^t + b Id) with a vector x
+	static inline vec3 spring_block_product(vec4 const& J, float x, float y, float z)
+	{
+		float const wx = J.x*x + J.y*y + J.z*z;
+		return { wx*J.x + J.w*x, wx*J.y + J.w*y, wx*J.z + J.w*z };
+	}
+
+
+	size_t mass_spring_system::add_particle(vec3 const& p, float m, vec3 const& v)
+	{
+		assert_vcl(m>0, "Particle mass must be >0");
+		position.push_back(p);
+		velocity.push_back(v);
+		mass.push_back(m);
+		fixed.push_back(0);
+		return position.size()-1;
+	}
+
+	size_t mass_spring_system::add_spring(size_t i, size_t j, float K)
+	{
+		assert_vcl(i<position.size() && j<position.size() && i!=j, "Incorrect spring extremities ("+str(i)+","+str(j)+")");
+		spring.push_back(uint2{ static_cast<unsigned int>(i), static_cast<unsigned int>(j) });
+		rest_length.push_back(norm(position[j]-position[i]));
+		stiffness.push_back(K);
+		return spring.size()-1;
+	}
+
+	void mass_spring_system::fix(size_t i)
+	{
+		fixed[i] = 1;
+		velocity[i] = { 0,0,0 };
+	}
+
+	void mass_spring_system::update_topology()
+	{
+		size_t const N = position.size();
+		size_t const N_spring = spring.size();
+
+		// Count the springs around each particle, then fill the lists (CSR storage)
+		particle_spring_offset.resize_clear(N+1);
+		for (size_t s = 0; s < N_spring; ++s) {
+			particle_spring_offset[spring[s].x+1]++;
+			particle_spring_offset[spring[s].y+1]++;
+		}
+		for (size_t k = 0; k < N; ++k)
+			particle_spring_offset[k+1] += particle_spring_offset[k];
+
+		particle_spring.resize(2*N_spring);
+		buffer<unsigned int> counter = particle_spring_offset;
+		for (size_t s = 0; s < N_spring; ++s) {
+			particle_spring[counter[spring[s].x]++] = static_cast<unsigned int>(s);
+			particle_spring[counter[spring[s].y]++] = static_cast<unsigned int>(s);
+		}
+	}
+
+	// Compute the force of each spring (applied on its first extremity), and optionally its stiffness block
+	//  K_s = k ( u u^t + t (Id - u u^t) ), t = max(0, 1-L0/L), is the derivative of the force on the first extremity with respect to the second one.
+	//  The negative transverse term of compressed springs is clamped to keep the implicit system positive definite.
+	//  K_s is stored as (w,b) with w = sqrt(k(1-t)) u and b = k t.
+	static void compute_spring_terms(mass_spring_system& system, bool jacobian)
+	{
+		size_t const N_spring = system.spring.size();
+		system.spring_force.resize(N_spring);
+		if (jacobian)
+			system.spring_jacobian.resize(N_spring);
+
+		uint2 const* spring = system.spring.data.data();
+		float const* L0 = system.rest_length.data.data();
+		float const* K = system.stiffness.data.data();
+		vec3 const* p = system.position.data.data();
+		vec3* f = system.spring_force.data.data();
+		vec4* J = jacobian ? system.spring_jacobian.data.data() : nullptr;
+
+		parallel_for_range(N_spring, [=](size_t s_begin, size_t s_end) {
+			for (size_t s = s_begin; s < s_end; ++s)
+			{
+				vec3 const& pi = p[spring[s].x];
+				vec3 const& pj = p[spring[s].y];
+				float const dx = pj.x-pi.x, dy = pj.y-pi.y, dz = pj.z-pi.z;
+				float const L = std::sqrt(dx*dx + dy*dy + dz*dz);
+				float const inv_L = (L > 1e-8f) ? 1.0f/L : 0.0f;
+				float const ux = dx*inv_L, uy = dy*inv_L, uz = dz*inv_L;
+				float const fs = K[s] * (L - L0[s]);
+				f[s] = { fs*ux, fs*uy, fs*uz };
+
+				if (J != nullptr)
+				{
+					float const t = std::max(0.0f, 1.0f - L0[s]*inv_L);
+					float const w = std::sqrt(K[s]*(1.0f-t));
+					J[s] = { w*ux, w*uy, w*uz, K[s]*t };
+				}
+			}
+		});
+	}
+
+	void mass_spring_system::compute_forces(buffer<vec3>& forces)
+	{
+		size_t const N = position.size();
+		assert_vcl(particle_spring_offset.size()==N+1, "update_topology() must be called before the simulation");
+
+		compute_spring_terms(*this, false);
+
+		forces.resize(N);
+		vec3* F = forces.data.data();
+		vec3 const* v = velocity.data.data();
+		float const* m = mass.data.data();
+		unsigned int const* offset = particle_spring_offset.data.data();
+		unsigned int const* adjacent = particle_spring.data.data();
+		uint2 const* springs = spring.data.data();
+		vec3 const* fs = spring_force.data.data();
+		vec3 const g = gravity;
+		float const mu = damping;
+
+		// Gather the spring forces around each particle: each particle only writes its own force
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k)
+			{
+				float fx = m[k]*g.x - mu*v[k].x;
+				float fy = m[k]*g.y - mu*v[k].y;
+				float fz = m[k]*g.z - mu*v[k].z;
+				for (unsigned int a = offset[k]; a < offset[k+1]; ++a) {
+					unsigned int const s = adjacent[a];
+					float const sign = (springs[s].x == k) ? 1.0f : -1.0f;
+					fx += sign*fs[s].x;
+					fy += sign*fs[s].y;
+					fz += sign*fs[s].z;
+				}
+				F[k] = { fx, fy, fz };
+			}
+		});
+	}
+
+	void mass_spring_system::step_explicit(float dt)
+	{
+		compute_forces(force);
+
+		size_t const N = position.size();
+		vec3* p = position.data.data();
+		vec3* v = velocity.data.data();
+		vec3 const* F = force.data.data();
+		float const* m = mass.data.data();
+		int const* is_fixed = fixed.data.data();
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k)
+			{
+				if (is_fixed[k])
+					continue;
+				float const dt_m = dt/m[k];
+				v[k] = { v[k].x + dt_m*F[k].x, v[k].y + dt_m*F[k].y, v[k].z + dt_m*F[k].z };
+				p[k] = { p[k].x + dt*v[k].x, p[k].y + dt*v[k].y, p[k].z + dt*v[k].z };
+			}
+		});
+	}
+
+	// y = A x, with A = (M + dt*damping Id) + dt^2 sum_s K_s (x_i - x_j)
+	//  A is a block sparse matrix: its off-diagonal 3x3 blocks are the stiffness blocks of the springs, accessed per row through the list of springs of each particle.
+	static void multiply_system_matrix(mass_spring_system& system, float dt, buffer<vec3> const& x, buffer<vec3>& y)
+	{
+		size_t const N = system.position.size();
+		vec3 const* px = x.data.data();
+		vec3* py = y.data.data();
+		float const* m = system.mass.data.data();
+		unsigned int const* offset = system.particle_spring_offset.data.data();
+		unsigned int const* adjacent = system.particle_spring.data.data();
+		uint2 const* springs = system.spring.data.data();
+		vec4 const* J = system.spring_jacobian.data.data();
+		float const diagonal_damping = dt*system.damping;
+		float const dt2 = dt*dt;
+
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k)
+			{
+				float const mk = m[k] + diagonal_damping;
+				float yx = 0, yy = 0, yz = 0;
+				for (unsigned int a = offset[k]; a < offset[k+1]; ++a) {
+					unsigned int const s = adjacent[a];
+					unsigned int const other = (springs[s].x == k) ? springs[s].y : springs[s].x;
+					vec3 const Kd = spring_block_product(J[s], px[k].x-px[other].x, px[k].y-px[other].y, px[k].z-px[other].z);
+					yx += Kd.x; yy += Kd.y; yz += Kd.z;
+				}
+				py[k] = { mk*px[k].x + dt2*yx, mk*px[k].y + dt2*yy, mk*px[k].z + dt2*yz };
+			}
+		});
+	}
+
+	int mass_spring_system::step_implicit(float dt, int cg_iteration_max, float cg_tolerance)
+	{
+		size_t const N = position.size();
+		assert_vcl(particle_spring_offset.size()==N+1, "update_topology() must be called before the simulation");
+
+		// Forces and stiffness blocks at the current state
+		compute_spring_terms(*this, true);
+		compute_forces(force);
+
+		rhs.resize(N); dv.resize(N); residual.resize(N); z.resize(N); direction.resize(N); A_direction.resize(N); preconditioner.resize(N);
+
+		// Right hand side: b = dt ( f + dt df/dx v ), with (df/dx v)_i = sum_s K_s (v_j - v_i)
+		// Jacobi preconditioner: inverse of the diagonal of A
+		{
+			vec3* b = rhs.data.data();
+			vec3* P = preconditioner.data.data();
+			vec3 const* F = force.data.data();
+			vec3 const* v = velocity.data.data();
+			float const* m = mass.data.data();
+			unsigned int const* offset = particle_spring_offset.data.data();
+			unsigned int const* adjacent = particle_spring.data.data();
+			uint2 const* springs = spring.data.data();
+			vec4 const* J = spring_jacobian.data.data();
+			float const diagonal_damping = dt*damping;
+			float const dt2 = dt*dt;
+			parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+				for (size_t k = k_begin; k < k_end; ++k)
+				{
+					float dfx = 0, dfy = 0, dfz = 0;
+					float Dx = 0, Dy = 0, Dz = 0;
+					for (unsigned int a = offset[k]; a < offset[k+1]; ++a) {
+						unsigned int const s = adjacent[a];
+						unsigned int const other = (springs[s].x == k) ? springs[s].y : springs[s].x;
+						vec3 const Kv = spring_block_product(J[s], v[other].x-v[k].x, v[other].y-v[k].y, v[other].z-v[k].z);
+						dfx += Kv.x; dfy += Kv.y; dfz += Kv.z;
+						Dx += J[s].x*J[s].x + J[s].w;
+						Dy += J[s].y*J[s].y + J[s].w;
+						Dz += J[s].z*J[s].z + J[s].w;
+					}
+					b[k] = { dt*(F[k].x + dt*dfx), dt*(F[k].y + dt*dfy), dt*(F[k].z + dt*dfz) };
+					float const mk = m[k] + diagonal_damping;
+					P[k] = { 1.0f/(mk + dt2*Dx), 1.0f/(mk + dt2*Dy), 1.0f/(mk + dt2*Dz) };
+				}
+			});
+		}
+		filter_fixed(rhs, fixed);
+
+		// Preconditioned conjugate gradient on A dv = b, restricted to the free particles (dv=0 for fixed particles)
+		dv.fill({ 0,0,0 });
+		residual = rhs;
+
+		vec3* x = dv.data.data();
+		vec3* r = residual.data.data();
+		vec3* zk = z.data.data();
+		vec3* d = direction.data.data();
+		vec3 const* Ad = A_direction.data.data();
+		vec3 const* P = preconditioner.data.data();
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k) {
+				zk[k] = { P[k].x*r[k].x, P[k].y*r[k].y, P[k].z*r[k].z };
+				d[k] = zk[k];
+			}
+		});
+
+		double rz = parallel_dot(residual, z, partial_sum);
+		double const rr_stop = double(cg_tolerance)*double(cg_tolerance) * std::max(parallel_dot(residual, residual, partial_sum), 1e-30);
+
+		int iteration = 0;
+		while (iteration < cg_iteration_max)
+		{
+			multiply_system_matrix(*this, dt, direction, A_direction);
+			filter_fixed(A_direction, fixed);
+
+			double const dAd = parallel_dot(direction, A_direction, partial_sum);
+			if (dAd <= 0)
+				break;
+			float const alpha = float(rz/dAd);
+
+			parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+				for (size_t k = k_begin; k < k_end; ++k) {
+					x[k] = { x[k].x + alpha*d[k].x, x[k].y + alpha*d[k].y, x[k].z + alpha*d[k].z };
+					r[k] = { r[k].x - alpha*Ad[k].x, r[k].y - alpha*Ad[k].y, r[k].z - alpha*Ad[k].z };
+					zk[k] = { P[k].x*r[k].x, P[k].y*r[k].y, P[k].z*r[k].z };
+				}
+			});
+			++iteration;
+
+			if (parallel_dot(residual, residual, partial_sum) <= rr_stop)
+				break;
+
+			double const rz_new = parallel_dot(residual, z, partial_sum);
+			float const beta = float(rz_new/rz);
+			rz = rz_new;
+
+			parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+				for (size_t k = k_begin; k < k_end; ++k)
+					d[k] = { zk[k].x + beta*d[k].x, zk[k].y + beta*d[k].y, zk[k].z + beta*d[k].z };
+			});
+		}
+
+		// Update velocity and position
+		vec3* p = position.data.data();
+		vec3* v = velocity.data.data();
+		int const* is_fixed = fixed.data.data();
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k)
+			{
+				if (is_fixed[k]) {
+					v[k] = { 0,0,0 };
+					continue;
+				}
+				v[k] = { v[k].x + x[k].x, v[k].y + x[k].y, v[k].z + x[k].z };
+				p[k] = { p[k].x + dt*v[k].x, p[k].y + dt*v[k].y, p[k].z + dt*v[k].z };
+			}
+		});
+
+		return iteration;
+	}
+
+
+	mass_spring_system mass_spring_from_mesh(mesh const& shape, float stiffness, float mass_total)
+	{
+		size_t const N = shape.position.size();
+		assert_vcl(N>0, "Cannot build a mass-spring network from an empty mesh");
+
+		mass_spring_system system;
+		float const m = mass_total / N;
+		for (size_t k = 0; k < N; ++k)
+			system.add_particle(shape.position[k], m);
+
+		buffer<uint2> const edges = connectivity_edges(shape.connectivity);
+		for (uint2 const& e : edges)
+			system.add_spring(e.x, e.y, stiffness);
+
+		system.update_topology();
+		return system;
+	}
+}
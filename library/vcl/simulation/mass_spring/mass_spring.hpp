@@ -0,0 +1,63 @@
+#pragma once
+
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/shape/mesh/mesh.hpp"
+
+namespace vcl
+{
+	/** Network of particles connected by springs
+	* - Per-particle data (position, velocity, mass, fixed) and per-spring data (extremities, rest length, stiffness) are stored in separate buffers
+	* - Forces are accumulated in parallel without atomics: spring forces are first computed per spring, then gathered per particle using the list of springs around each particle
+	* - step_explicit uses a semi-implicit (symplectic) Euler integration: it requires small time steps for stiff springs
+	* - step_implicit uses a linearized backward Euler integration solved with a conjugate gradient: it remains stable for large time steps
+	*
+	* update_topology() must be called after the springs are added/modified (done automatically by mass_spring_from_mesh). */
+	struct mass_spring_system
+	{
+		buffer<vec3> position;
+		buffer<vec3> velocity;
+		buffer<float> mass;
+		buffer<int> fixed;          // 1 if the particle position is constrained, 0 otherwise
+
+		buffer<uint2> spring;       // Index of the two particles connected by the spring
+		buffer<float> rest_length;
+		buffer<float> stiffness;
+
+		vec3 gravity = { 0,0,-9.81f };
+		float damping = 0.0f;       // Linear damping force: -damping * velocity
+
+		/** Add a particle and return its index */
+		size_t add_particle(vec3 const& p, float m, vec3 const& v = { 0,0,0 });
+		/** Add a spring between particles i and j. The rest length is set to the current distance between the particles. */
+		size_t add_spring(size_t i, size_t j, float K);
+		/** Constrain the particle i to remain at its current position */
+		void fix(size_t i);
+
+		/** Build the list of springs connected to each particle (called after adding springs) */
+		void update_topology();
+
+		/** Compute the sum of the forces (gravity, damping, springs) applied on each particle */
+		void compute_forces(buffer<vec3>& forces);
+
+		/** Advance the simulation by a time step dt using a semi-implicit Euler integration */
+		void step_explicit(float dt);
+		/** Advance the simulation by a time step dt using a linearized backward Euler integration
+		* The linear system is solved with a Jacobi-preconditioned conjugate gradient. Return the number of iterations used by the solver. */
+		int step_implicit(float dt, int cg_iteration_max = 100, float cg_tolerance = 1e-5f);
+
+		/** Internal data - List of springs connected to each particle (particle k: particle_spring[particle_spring_offset[k] ... particle_spring_offset[k+1]-1]) */
+		buffer<unsigned int> particle_spring_offset;
+		buffer<unsigned int> particle_spring;
+		/** Internal data - Temporary buffers reused between time steps */
+		buffer<vec3> spring_force;
+		buffer<vec4> spring_jacobian;  // (w,b) such that the 3x3 stiffness block of the spring is w w^t + b Id
+		buffer<vec3> preconditioner;    // inverse of the diagonal of the implicit system
+		buffer<vec3> force, rhs, dv, residual, z, direction, A_direction;
+		buffer<double> partial_sum;
+	};
+
+	/** Build a mass-spring network from a mesh: each vertex becomes a particle and each edge of the triangles becomes a spring.
+	* The total mass is uniformly distributed among the particles. */
+	mass_spring_system mass_spring_from_mesh(mesh const& shape, float stiffness, float mass_total = 1.0f);
+}
@@ -0,0 +1,55 @@
+#include "benchmark_mass_spring.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/shape/mesh/primitive/mesh_primitive.hpp"
+#include "../mass_spring.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	static bool is_finite(buffer<vec3> const& p)
+	{
+		for (vec3 const& v : p)
+			if (!std::isfinite(v.x) || !std::isfinite(v.y) || !std::isfinite(v.z))
+				return false;
+		return true;
+	}
+
+	void benchmark_mass_spring()
+	{
+		int const N = 183; // ~100k springs
+		mass_spring_system const cloth_initial = mass_spring_from_mesh(mesh_primitive_grid({0,0,0},{1,0,0},{1,1,0},{0,1,0},N,N), 5000.0f, 1.0f);
+		float const dt = 1/60.0f;
+		int const N_step = 20;
+
+		std::cout << "Mass-spring cloth: " << cloth_initial.position.size() << " particles, " << cloth_initial.spring.size() << " springs, " << parallel_thread_count() << " threads" << std::endl;
+
+		{
+			mass_spring_system cloth = cloth_initial;
+			cloth.fix(0); cloth.fix(N-1);
+			int iterations = 0;
+			auto const t0 = std::chrono::steady_clock::now();
+			for (int k = 0; k < N_step; ++k)
+				iterations += cloth.step_implicit(dt);
+			auto const t1 = std::chrono::steady_clock::now();
+			double const time = std::chrono::duration<double>(t1-t0).count();
+			std::cout << "  implicit (dt=1/60) : " << N_step/time << " steps/s, " << iterations/float(N_step) << " CG iterations/step, stable=" << is_finite(cloth.position) << std::endl;
+		}
+
+		{
+			mass_spring_system cloth = cloth_initial;
+			cloth.fix(0); cloth.fix(N-1);
+			auto const t0 = std::chrono::steady_clock::now();
+			for (int k = 0; k < N_step; ++k)
+				cloth.step_explicit(dt);
+			auto const t1 = std::chrono::steady_clock::now();
+			double const time = std::chrono::duration<double>(t1-t0).count();
+			std::cout << "  explicit (dt=1/60) : " << N_step/time << " steps/s, stable=" << is_finite(cloth.position) << std::endl;
+		}
+	}
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace vcl_test
+{
+	// Steps per second of the explicit and implicit integration of a cloth with ~100k springs
+	void benchmark_mass_spring();
+}
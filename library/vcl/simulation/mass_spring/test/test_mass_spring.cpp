@@ -0,0 +1,58 @@
+#include "test_mass_spring.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/shape/mesh/primitive/mesh_primitive.hpp"
+#include "../mass_spring.hpp"
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_mass_spring()
+	{
+		// Springs from the edges of a grid: (N-1)N horizontal + (N-1)N vertical + (N-1)^2 diagonal edges
+		{
+			int const N = 5;
+			mass_spring_system cloth = mass_spring_from_mesh(mesh_primitive_grid({0,0,0},{1,0,0},{1,1,0},{0,1,0},N,N), 10.0f);
+			assert_vcl_no_msg(cloth.position.size() == N*N);
+			assert_vcl_no_msg(cloth.spring.size() == 2*(N-1)*N + (N-1)*(N-1));
+			assert_vcl_no_msg(cloth.particle_spring_offset.size() == N*N+1);
+			assert_vcl_no_msg(cloth.particle_spring_offset[N*N] == 2*cloth.spring.size());
+		}
+
+		// Hanging particle: implicit integration with a large time step converges to the static equilibrium L = L0 + m g / K
+		{
+			mass_spring_system system;
+			system.add_particle({ 0,0,0 }, 1.0f);
+			system.add_particle({ 0,0,-1 }, 0.1f);
+			system.add_spring(0, 1, 100.0f);
+			system.fix(0);
+			system.damping = 0.5f;
+			system.update_topology();
+
+			for (int k = 0; k < 200; ++k)
+				system.step_implicit(0.1f);
+
+			assert_vcl_no_msg(is_equal(system.position[0], vec3{ 0,0,0 }));
+			float const L_expected = 1.0f + 0.1f*9.81f/100.0f;
+			assert_vcl_no_msg(std::abs(system.position[1].z + L_expected) < 1e-3f);
+		}
+
+		// Explicit and implicit integration agree for small time steps
+		{
+			mass_spring_system a;
+			a.add_particle({ 0,0,0 }, 1.0f);
+			a.add_particle({ 1,0,0 }, 1.0f);
+			a.add_spring(0, 1, 10.0f);
+			a.fix(0);
+			a.update_topology();
+			mass_spring_system b = a;
+
+			for (int k = 0; k < 100; ++k) {
+				a.step_explicit(1e-4f);
+				b.step_implicit(1e-4f);
+			}
+			assert_vcl_no_msg(norm(a.position[1]-b.position[1]) < 1e-4f);
+		}
+	}
+}
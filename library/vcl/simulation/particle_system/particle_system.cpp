@@ -0,0 +1,162 @@
+#include "particle_system.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VCL_PARTICLE_SSE
+#endif
+
+namespace vcl
+{
+	static_assert(sizeof(vec3)==3*sizeof(float), "Particle kernels expect vec3 to be stored as 3 contiguous floats");
+
+	// Integration kernel working on the flat float arrays of positions and velocities (3 floats per particle)
+	//  The acceleration increment follows the pattern (x,y,z,x,y,z,...): 4 particles fill exactly 3 SSE registers.
+	static void integrate_kernel(float* p, float* v, size_t N_float, float dt, vec3 const& acceleration, bool semi_implicit)
+	{
+		float const dv[3] = { dt*acceleration.x, dt*acceleration.y, dt*acceleration.z };
+		size_t k = 0;
+
+#ifdef VCL_PARTICLE_SSE
+		__m128 const dv0 = _mm_setr_ps(dv[0], dv[1], dv[2], dv[0]);
+		__m128 const dv1 = _mm_setr_ps(dv[1], dv[2], dv[0], dv[1]);
+		__m128 const dv2 = _mm_setr_ps(dv[2], dv[0], dv[1], dv[2]);
+		__m128 const dt4 = _mm_set1_ps(dt);
+		for (; k + 12 <= N_float; k += 12)
+		{
+			__m128 v0 = _mm_loadu_ps(v + k);
+			__m128 v1 = _mm_loadu_ps(v + k + 4);
+			__m128 v2 = _mm_loadu_ps(v + k + 8);
+			__m128 const v0_new = _mm_add_ps(v0, dv0);
+			__m128 const v1_new = _mm_add_ps(v1, dv1);
+			__m128 const v2_new = _mm_add_ps(v2, dv2);
+			if (semi_implicit) {
+				v0 = v0_new; v1 = v1_new; v2 = v2_new;
+			}
+			_mm_storeu_ps(p + k,     _mm_add_ps(_mm_loadu_ps(p + k),     _mm_mul_ps(dt4, v0)));
+			_mm_storeu_ps(p + k + 4, _mm_add_ps(_mm_loadu_ps(p + k + 4), _mm_mul_ps(dt4, v1)));
+			_mm_storeu_ps(p + k + 8, _mm_add_ps(_mm_loadu_ps(p + k + 8), _mm_mul_ps(dt4, v2)));
+			_mm_storeu_ps(v + k,     v0_new);
+			_mm_storeu_ps(v + k + 4, v1_new);
+			_mm_storeu_ps(v + k + 8, v2_new);
+		}
+#endif
+
+		// Remaining values (k is a multiple of 3 at this point)
+		for (; k < N_float; ++k)
+		{
+			float const v_new = v[k] + dv[k % 3];
+			p[k] += dt * (semi_implicit ? v_new : v[k]);
+			v[k] = v_new;
+		}
+	}
+
+
+	size_t particle_system::size() const
+	{
+		return p.size();
+	}
+
+	particle_system& particle_system::reserve(size_t capacity)
+	{
+		p.data.reserve(capacity);
+		v.data.reserve(capacity);
+		age.data.reserve(capacity);
+		return *this;
+	}
+
+	size_t particle_system::capacity() const
+	{
+		return p.data.capacity();
+	}
+
+	size_t particle_system::add(vec3 const& position, vec3 const& velocity)
+	{
+		p.push_back(position);
+		v.push_back(velocity);
+		age.push_back(0.0f);
+		return p.size()-1;
+	}
+
+	void particle_system::remove(size_t index)
+	{
+		size_t const N = size();
+		assert_vcl(index<N, "Cannot remove particle "+str(index)+" in a system of "+str(N)+" particles");
+
+		size_t const last = N-1;
+		if (index != last) {
+			p[index] = p[last];
+			v[index] = v[last];
+			age[index] = age[last];
+		}
+		p.data.pop_back();
+		v.data.pop_back();
+		age.data.pop_back();
+	}
+
+	size_t particle_system::remove_if(std::function<bool(vec3 const& p, vec3 const& v, float age)> const& condition)
+	{
+		size_t counter = 0;
+		size_t k = 0;
+		while (k < size())
+		{
+			if (condition(p[k], v[k], age[k])) {
+				remove(k); // the last particle is moved at index k and must be tested as well
+				++counter;
+			}
+			else
+				++k;
+		}
+		return counter;
+	}
+
+	size_t particle_system::remove_older_than(float age_max)
+	{
+		return remove_if([age_max](vec3 const&, vec3 const&, float a) { return a > age_max; });
+	}
+
+	void particle_system::clear()
+	{
+		p.clear();
+		v.clear();
+		age.clear();
+	}
+
+	void particle_system::integrate(float dt, vec3 const& acceleration, particle_integration scheme)
+	{
+		size_t const N = size();
+		if (N == 0)
+			return;
+		assert_vcl(v.size()==N && age.size()==N, "Incoherent size of particle attributes");
+
+		bool const semi_implicit = (scheme == particle_integration::euler_semi_implicit);
+		integrate_kernel(&p.data[0].x, &v.data[0].x, 3*N, dt, acceleration, semi_implicit);
+
+		float* const a = age.data.data();
+		for (size_t k = 0; k < N; ++k)
+			a[k] += dt;
+	}
+
+
+	particle_emitter::particle_emitter(float period, size_t count_arg)
+		:timer(period), count(count_arg), generator()
+	{}
+
+	float particle_emitter::update(particle_system& system)
+	{
+		float const dt = timer.update();
+		if (timer.event)
+			emit(system);
+		return dt;
+	}
+
+	void particle_emitter::emit(particle_system& system) const
+	{
+		assert_vcl(generator!=nullptr, "The emitter has no generator function");
+		for (size_t k = 0; k < count; ++k)
+		{
+			vec3 p0, v0;
+			generator(p0, v0);
+			system.add(p0, v0);
+		}
+	}
+}
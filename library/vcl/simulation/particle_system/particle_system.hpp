@@ -0,0 +1,65 @@
+#pragma once
+
+#include "vcl/containers/containers.hpp"
+#include "vcl/interaction/timer/timer.hpp"
+
+#include <functional>
+
+namespace vcl
+{
+	/** Integration scheme used by particle_system::integrate */
+	enum class particle_integration { euler_explicit, euler_semi_implicit };
+
+	/** Set of particles stored as a structure of arrays (one buffer per attribute)
+	* - Position, velocity and age of the k-th particle are stored in p[k], v[k], age[k]
+	* - Removing a particle swaps it with the last one (the order of the particles is not preserved)
+	* - The storage is never released when particles are removed: once reserved, the capacity is reused by new particles */
+	struct particle_system
+	{
+		buffer<vec3> p;     // Position
+		buffer<vec3> v;     // Velocity
+		buffer<float> age;  // Time since the particle was added
+
+		/** Number of active particles */
+		size_t size() const;
+		/** Pre-allocate the storage for a given number of particles */
+		particle_system& reserve(size_t capacity);
+		/** Number of particles that can be stored without new allocation */
+		size_t capacity() const;
+
+		/** Add a new particle and return its index */
+		size_t add(vec3 const& position, vec3 const& velocity);
+		/** Remove the particle at the given index (swap with the last particle and pop) */
+		void remove(size_t index);
+		/** Remove all particles satisfying the condition(p,v,age). Return the number of removed particles. */
+		size_t remove_if(std::function<bool(vec3 const& p, vec3 const& v, float age)> const& condition);
+		/** Remove all particles whose age is greater than age_max */
+		size_t remove_older_than(float age_max);
+		/** Remove all particles (the capacity is kept) */
+		void clear();
+
+		/** Advance all particles by a time step dt under a uniform acceleration (typically the gravity)
+		* - euler_semi_implicit: v = v + dt*a, then p = p + dt*v
+		* - euler_explicit:      p = p + dt*v, then v = v + dt*a */
+		void integrate(float dt, vec3 const& acceleration, particle_integration scheme = particle_integration::euler_semi_implicit);
+	};
+
+	/** Periodic emission of particles driven by a timer_event_periodic
+	* Every time the timer generates an event, "count" new particles are created by the generator function.
+	* The generator fills the initial position and velocity of each new particle. */
+	struct particle_emitter
+	{
+		timer_event_periodic timer;
+		/** Number of particles created at each event */
+		size_t count;
+		/** Function called to set the initial position and velocity of a new particle */
+		std::function<void(vec3& p, vec3& v)> generator;
+
+		particle_emitter(float period=1.0f, size_t count=1);
+
+		/** Update the timer and emit new particles in the system in case of event. Return the elapsed time dt given by the timer. */
+		float update(particle_system& system);
+		/** Emit immediately "count" particles in the system (without considering the timer) */
+		void emit(particle_system& system) const;
+	};
+}
@@ -0,0 +1,68 @@
+#include "benchmark_particle_system.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../particle_system.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <list>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void benchmark_particle_system()
+	{
+		size_t const N = 1000000;
+		int const N_step = 50;
+		float const dt = 0.01f;
+		vec3 const g = { 0,0,-9.81f };
+
+		// Reference: one node per particle in a std::list, removal through iterators
+		double time_list = 0;
+		{
+			struct particle_structure { vec3 p; vec3 v; };
+			std::list<particle_structure> particles;
+			for (size_t k = 0; k < N; ++k)
+				particles.push_back({ {0,0,0}, {rand_interval(),rand_interval(),5.0f*rand_interval()} });
+
+			auto const t0 = std::chrono::steady_clock::now();
+			for (int step = 0; step < N_step; ++step)
+			{
+				for (particle_structure& particle : particles) {
+					particle.v = particle.v + dt*g;
+					particle.p = particle.p + dt*particle.v;
+				}
+				for (auto it = particles.begin(); it != particles.end(); ) {
+					if (it->p.z < -3)
+						it = particles.erase(it);
+					else
+						++it;
+				}
+			}
+			auto const t1 = std::chrono::steady_clock::now();
+			time_list = std::chrono::duration<double, std::milli>(t1-t0).count() / N_step;
+		}
+
+		double time_soa = 0;
+		{
+			particle_system particles;
+			particles.reserve(N);
+			for (size_t k = 0; k < N; ++k)
+				particles.add({ 0,0,0 }, { rand_interval(),rand_interval(),5.0f*rand_interval() });
+
+			auto const t0 = std::chrono::steady_clock::now();
+			for (int step = 0; step < N_step; ++step)
+			{
+				particles.integrate(dt, g);
+				particles.remove_if([](vec3 const& p, vec3 const&, float) { return p.z < -3; });
+			}
+			auto const t1 = std::chrono::steady_clock::now();
+			time_soa = std::chrono::duration<double, std::milli>(t1-t0).count() / N_step;
+		}
+
+		std::cout << "Particle step (" << N << " particles)" << std::endl;
+		std::cout << "  std::list       : " << time_list << " ms/step" << std::endl;
+		std::cout << "  particle_system : " << time_soa << " ms/step" << std::endl;
+	}
+}
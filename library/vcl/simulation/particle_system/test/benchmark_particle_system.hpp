@@ -0,0 +1,7 @@
+#pragma once
+
+namespace vcl_test
+{
+	// Compare the step time of particle_system against a std::list of particles (as in the 04a_simulation_gravity scene)
+	void benchmark_particle_system();
+}
@@ -0,0 +1,71 @@
+#include "test_particle_system.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../particle_system.hpp"
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_particle_system()
+	{
+		// Swap-and-pop removal
+		{
+			particle_system particles;
+			particles.reserve(8);
+			for (int k = 0; k < 4; ++k)
+				particles.add({ float(k),0,0 }, { 0,0,float(k) });
+			assert_vcl_no_msg(particles.size() == 4);
+			assert_vcl_no_msg(particles.capacity() >= 8);
+
+			particles.remove(1);
+			assert_vcl_no_msg(particles.size() == 3);
+			assert_vcl_no_msg(is_equal(particles.p[1], vec3{ 3,0,0 }));
+			assert_vcl_no_msg(is_equal(particles.v[1], vec3{ 0,0,3 }));
+
+			particles.remove(2);
+			assert_vcl_no_msg(particles.size() == 2);
+			assert_vcl_no_msg(is_equal(particles.p[0], vec3{ 0,0,0 }));
+			assert_vcl_no_msg(is_equal(particles.p[1], vec3{ 3,0,0 }));
+
+			particles.clear();
+			assert_vcl_no_msg(particles.size() == 0);
+			assert_vcl_no_msg(particles.capacity() >= 8);
+		}
+
+		// Conditional removal also tests the particles moved by the swap
+		{
+			particle_system particles;
+			for (int k = 0; k < 10; ++k)
+				particles.add({ 0,0,float(k % 2) }, { 0,0,0 });
+			size_t const N_removed = particles.remove_if([](vec3 const& p, vec3 const&, float) { return p.z > 0.5f; });
+			assert_vcl_no_msg(N_removed == 5);
+			assert_vcl_no_msg(particles.size() == 5);
+			for (vec3 const& p : particles.p)
+				assert_vcl_no_msg(is_equal(p.z, 0.0f));
+		}
+
+		// Integration: vectorized kernel and scalar remainder give the same result for all particles
+		{
+			particle_system particles;
+			for (int k = 0; k < 7; ++k)
+				particles.add({ float(k),0,0 }, { 1,2,3 });
+
+			vec3 const g = { 0,0,-10 };
+			particles.integrate(0.1f, g, particle_integration::euler_semi_implicit);
+			for (int k = 0; k < 7; ++k) {
+				assert_vcl_no_msg(is_equal(particles.v[k], vec3{ 1,2,2 }));
+				assert_vcl_no_msg(is_equal(particles.p[k], vec3{ k+0.1f,0.2f,0.2f }));
+				assert_vcl_no_msg(is_equal(particles.age[k], 0.1f));
+			}
+
+			particles.integrate(0.1f, g, particle_integration::euler_explicit);
+			for (int k = 0; k < 7; ++k) {
+				assert_vcl_no_msg(is_equal(particles.v[k], vec3{ 1,2,1 }));
+				assert_vcl_no_msg(is_equal(particles.p[k], vec3{ k+0.2f,0.4f,0.4f }));
+			}
+
+			assert_vcl_no_msg(particles.remove_older_than(0.15f) == 7);
+		}
+	}
+}
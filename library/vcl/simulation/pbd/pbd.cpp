@@ -0,0 +1,341 @@
+#include "pbd.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// The projection kernels work on raw pointers and explicit x,y,z components to avoid the bound checks of the containers in the inner loops.
+
+namespace vcl
+{
+	// Run the kernel with the parallel loops, or on the calling thread
+	template <typename KERNEL>
+	static void run_range(size_t N, KERNEL const& kernel, size_t grain, bool parallel)
+	{
+		if (parallel)
+			parallel_for_range(N, kernel, grain);
+		else
+			kernel(0, N);
+	}
+
+
+	size_t pbd_distance_constraint::size() const
+	{
+		return index.size();
+	}
+
+	size_t pbd_distance_constraint::color_count() const
+	{
+		return color_offset.size()>0 ? color_offset.size()-1 : 0;
+	}
+
+	buffer<unsigned int> pbd_greedy_coloring(buffer<uint2> const& constraint_index, size_t particle_count)
+	{
+		size_t const N = constraint_index.size();
+
+		// List of constraints around each particle (CSR storage)
+		buffer<unsigned int> offset; offset.resize_clear(particle_count+1);
+		for (size_t c = 0; c < N; ++c) {
+			assert_vcl(constraint_index[c].x<particle_count && constraint_index[c].y<particle_count, "Incorrect particle index in constraint "+str(c));
+			offset[constraint_index[c].x+1]++;
+			offset[constraint_index[c].y+1]++;
+		}
+		for (size_t k = 0; k < particle_count; ++k)
+			offset[k+1] += offset[k];
+		buffer<unsigned int> neighbor; neighbor.resize(2*N);
+		buffer<unsigned int> counter = offset;
+		for (size_t c = 0; c < N; ++c) {
+			neighbor[counter[constraint_index[c].x]++] = static_cast<unsigned int>(c);
+			neighbor[counter[constraint_index[c].y]++] = static_cast<unsigned int>(c);
+		}
+
+		// Each constraint takes the smallest color not used by the already colored constraints sharing one of its particles
+		//  forbidden[color]==c+1 marks the colors used around the constraint c
+		unsigned int const no_color = static_cast<unsigned int>(-1);
+		buffer<unsigned int> color; color.resize(N); color.fill(no_color);
+		std::vector<size_t> forbidden;
+		for (size_t c = 0; c < N; ++c)
+		{
+			unsigned int const particles[2] = { constraint_index[c].x, constraint_index[c].y };
+			for (unsigned int p : particles) {
+				for (unsigned int k = offset[p]; k < offset[p+1]; ++k) {
+					unsigned int const color_neighbor = color[neighbor[k]];
+					if (color_neighbor != no_color) {
+						if (color_neighbor >= forbidden.size())
+							forbidden.resize(color_neighbor+1, 0);
+						forbidden[color_neighbor] = c+1;
+					}
+				}
+			}
+
+			unsigned int current = 0;
+			while (current < forbidden.size() && forbidden[current] == c+1)
+				++current;
+			color[c] = current;
+		}
+		return color;
+	}
+
+	// Reorder the constraints by increasing color (stable counting sort: the order of the constraints within a color is preserved)
+	static void sort_by_color(pbd_distance_constraint& constraint, size_t particle_count)
+	{
+		size_t const N = constraint.size();
+		assert_vcl(constraint.rest_length.size()==N, "Incoherent size of the constraint attributes");
+
+		buffer<unsigned int> const color = pbd_greedy_coloring(constraint.index, particle_count);
+		unsigned int const N_color = N>0 ? *std::max_element(color.begin(), color.end())+1 : 0;
+
+		buffer<unsigned int>& offset = constraint.color_offset;
+		offset.resize_clear(N_color+1);
+		for (size_t c = 0; c < N; ++c)
+			offset[color[c]+1]++;
+		for (size_t k = 0; k < N_color; ++k)
+			offset[k+1] += offset[k];
+
+		buffer<uint2> index; index.resize(N);
+		buffer<float> rest_length; rest_length.resize(N);
+		buffer<unsigned int> counter = offset;
+		for (size_t c = 0; c < N; ++c) {
+			unsigned int const target = counter[color[c]]++;
+			index[target] = constraint.index[c];
+			rest_length[target] = constraint.rest_length[c];
+		}
+		constraint.index = index;
+		constraint.rest_length = rest_length;
+		constraint.lambda.resize_clear(N);
+	}
+
+	// XPBD projection of the distance constraints of one color
+	static void project_distance(pbd_distance_constraint& constraint, size_t color, vec3* x, float const* w, float dt, bool parallel)
+	{
+		size_t const c_begin = constraint.color_offset[color];
+		size_t const N_color = constraint.color_offset[color+1] - c_begin;
+		uint2 const* index = constraint.index.data.data() + c_begin;
+		float const* L0 = constraint.rest_length.data.data() + c_begin;
+		float* lambda = constraint.lambda.data.data() + c_begin;
+		float const alpha = constraint.compliance / (dt*dt);
+
+		auto const kernel = [=](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k)
+			{
+				unsigned int const i = index[k].x;
+				unsigned int const j = index[k].y;
+				float const w_sum = w[i] + w[j];
+				if (w_sum == 0.0f)
+					continue;
+
+				float const dx = x[i].x-x[j].x, dy = x[i].y-x[j].y, dz = x[i].z-x[j].z;
+				float const L = std::sqrt(dx*dx + dy*dy + dz*dz);
+				if (L < 1e-9f)
+					continue;
+
+				float const C = L - L0[k];
+				float const d_lambda = (-C - alpha*lambda[k]) / (w_sum + alpha);
+				lambda[k] += d_lambda;
+
+				float const s = d_lambda / L;
+				x[i].x += w[i]*s*dx; x[i].y += w[i]*s*dy; x[i].z += w[i]*s*dz;
+				x[j].x -= w[j]*s*dx; x[j].y -= w[j]*s*dy; x[j].z -= w[j]*s*dz;
+			}
+		};
+
+		run_range(N_color, kernel, 256, parallel);
+	}
+
+	static void project_collision(buffer<pbd_collision_plane> const& planes, buffer<pbd_collision_sphere> const& spheres, vec3* x, float const* w, size_t N, bool parallel)
+	{
+		if (planes.size()==0 && spheres.size()==0)
+			return;
+
+		pbd_collision_plane const* plane = planes.data.data();
+		pbd_collision_sphere const* sphere = spheres.data.data();
+		size_t const N_plane = planes.size();
+		size_t const N_sphere = spheres.size();
+
+		auto const kernel = [=](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k)
+			{
+				if (w[k] == 0.0f)
+					continue;
+				for (size_t c = 0; c < N_plane; ++c) {
+					vec3 const& n = plane[c].normal;
+					float const d = (x[k].x-plane[c].point.x)*n.x + (x[k].y-plane[c].point.y)*n.y + (x[k].z-plane[c].point.z)*n.z;
+					if (d < 0) {
+						x[k].x -= d*n.x; x[k].y -= d*n.y; x[k].z -= d*n.z;
+					}
+				}
+				for (size_t c = 0; c < N_sphere; ++c) {
+					float const dx = x[k].x-sphere[c].center.x, dy = x[k].y-sphere[c].center.y, dz = x[k].z-sphere[c].center.z;
+					float const d = std::sqrt(dx*dx + dy*dy + dz*dz);
+					if (d < sphere[c].radius && d > 1e-9f) {
+						float const s = sphere[c].radius / d;
+						x[k].x = sphere[c].center.x + s*dx; x[k].y = sphere[c].center.y + s*dy; x[k].z = sphere[c].center.z + s*dz;
+					}
+				}
+			}
+		};
+
+		run_range(N, kernel, 1024, parallel);
+	}
+
+
+	size_t pbd_system::add_particle(vec3 const& p, float mass, vec3 const& v)
+	{
+		assert_vcl(mass>=0, "Particle mass must be >=0");
+		position.push_back(p);
+		velocity.push_back(v);
+		inverse_mass.push_back(mass>0 ? 1.0f/mass : 0.0f);
+		return position.size()-1;
+	}
+
+	static size_t add_distance(pbd_distance_constraint& constraint, buffer<vec3> const& position, size_t i, size_t j)
+	{
+		assert_vcl(i<position.size() && j<position.size() && i!=j, "Incorrect constraint extremities ("+str(i)+","+str(j)+")");
+		constraint.index.push_back(uint2{ static_cast<unsigned int>(i), static_cast<unsigned int>(j) });
+		constraint.rest_length.push_back(norm(position[j]-position[i]));
+		return constraint.size()-1;
+	}
+
+	size_t pbd_system::add_stretch(size_t i, size_t j)
+	{
+		return add_distance(stretch, position, i, j);
+	}
+
+	size_t pbd_system::add_bending(size_t i, size_t j)
+	{
+		return add_distance(bending, position, i, j);
+	}
+
+	void pbd_system::fix(size_t i)
+	{
+		inverse_mass[i] = 0.0f;
+		velocity[i] = { 0,0,0 };
+	}
+
+	void pbd_system::update_coloring()
+	{
+		sort_by_color(stretch, position.size());
+		sort_by_color(bending, position.size());
+	}
+
+	void pbd_system::step(float dt)
+	{
+		size_t const N = position.size();
+		assert_vcl(velocity.size()==N && inverse_mass.size()==N, "Incoherent size of particle attributes");
+		assert_vcl(stretch.lambda.size()==stretch.size() && bending.lambda.size()==bending.size(), "update_coloring() must be called before the simulation");
+		if (N == 0)
+			return;
+
+		// Prediction of the positions
+		prediction.resize(N);
+		vec3* x = prediction.data.data();
+		vec3* p = position.data.data();
+		vec3* v = velocity.data.data();
+		float const* w = inverse_mass.data.data();
+		vec3 const g = gravity;
+		run_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k) {
+				if (w[k] > 0) {
+					v[k].x += dt*g.x; v[k].y += dt*g.y; v[k].z += dt*g.z;
+				}
+				x[k].x = p[k].x + dt*v[k].x; x[k].y = p[k].y + dt*v[k].y; x[k].z = p[k].z + dt*v[k].z;
+			}
+		}, 1024, parallel);
+
+		// Collision normals are expected to be unit vectors
+		buffer<pbd_collision_plane> planes = collision_plane;
+		for (pbd_collision_plane& plane : planes)
+			plane.normal = normalize(plane.normal);
+
+		stretch.lambda.fill(0.0f);
+		bending.lambda.fill(0.0f);
+		iteration_time.resize_clear(timing ? iteration : 0);
+
+		// Constraint projection
+		for (int k_iteration = 0; k_iteration < iteration; ++k_iteration)
+		{
+			auto const t0 = std::chrono::steady_clock::now();
+
+			for (size_t color = 0; color < stretch.color_count(); ++color)
+				project_distance(stretch, color, x, w, dt, parallel);
+			for (size_t color = 0; color < bending.color_count(); ++color)
+				project_distance(bending, color, x, w, dt, parallel);
+			project_collision(planes, collision_sphere, x, w, N, parallel);
+
+			if (timing)
+				iteration_time[k_iteration] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-t0).count();
+		}
+
+		// Velocity and position update
+		float const damping_factor = std::max(0.0f, 1.0f - damping*dt);
+		run_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t k = k_begin; k < k_end; ++k) {
+				v[k].x = damping_factor*(x[k].x-p[k].x)/dt;
+				v[k].y = damping_factor*(x[k].y-p[k].y)/dt;
+				v[k].z = damping_factor*(x[k].z-p[k].z)/dt;
+				p[k] = x[k];
+			}
+		}, 1024, parallel);
+	}
+
+
+	pbd_system pbd_from_mesh(mesh const& shape, float mass_total, float stretch_compliance, float bending_compliance)
+	{
+		size_t const N = shape.position.size();
+		assert_vcl(N>0, "Cannot build a PBD system from an empty mesh");
+
+		pbd_system system;
+		system.stretch.compliance = stretch_compliance;
+		system.bending.compliance = bending_compliance;
+		float const m = mass_total / N;
+		for (size_t k = 0; k < N; ++k)
+			system.add_particle(shape.position[k], m);
+
+		buffer<uint2> const edges = connectivity_edges(shape.connectivity);
+		for (uint2 const& e : edges)
+			system.add_stretch(e.x, e.y);
+
+		// Bending: the two vertices opposite to an edge shared by two triangles
+		//  Each triangle edge is stored as (min vertex, max vertex, opposite vertex) then sorted to find the pairs of triangles sharing an edge
+		std::vector<uint3> edge_opposite;
+		edge_opposite.reserve(3*shape.connectivity.size());
+		for (uint3 const& tri : shape.connectivity) {
+			for (int e = 0; e < 3; ++e) {
+				unsigned int const a = tri[e];
+				unsigned int const b = tri[(e+1)%3];
+				edge_opposite.push_back({ std::min(a,b), std::max(a,b), tri[(e+2)%3] });
+			}
+		}
+		std::sort(edge_opposite.begin(), edge_opposite.end(), [](uint3 const& a, uint3 const& b) {
+			return a.x<b.x || (a.x==b.x && (a.y<b.y || (a.y==b.y && a.z<b.z)));
+		});
+		for (size_t k = 0; k+1 < edge_opposite.size(); ++k) {
+			uint3 const& e0 = edge_opposite[k];
+			uint3 const& e1 = edge_opposite[k+1];
+			if (e0.x==e1.x && e0.y==e1.y && e0.z!=e1.z)
+				system.add_bending(e0.z, e1.z);
+		}
+
+		system.update_coloring();
+		return system;
+	}
+
+	pbd_system pbd_from_polyline(buffer<vec3> const& polyline, float mass_total, float stretch_compliance, float bending_compliance)
+	{
+		size_t const N = polyline.size();
+		assert_vcl(N>1, "A rope requires at least two particles");
+
+		pbd_system system;
+		system.stretch.compliance = stretch_compliance;
+		system.bending.compliance = bending_compliance;
+		for (size_t k = 0; k < N; ++k)
+			system.add_particle(polyline[k], mass_total/N);
+		for (size_t k = 0; k+1 < N; ++k)
+			system.add_stretch(k, k+1);
+		for (size_t k = 0; k+2 < N; ++k)
+			system.add_bending(k, k+2);
+
+		system.update_coloring();
+		return system;
+	}
+}
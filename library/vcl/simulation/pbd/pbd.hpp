@@ -0,0 +1,86 @@
+#pragma once
+
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/math.hpp"
+#include "vcl/shape/mesh/mesh.hpp"
+
+namespace vcl
+{
+	/** Set of constraints enforcing the distance between pairs of particles (XPBD formulation)
+	* The constraints are sorted by color: constraints of the same color do not share any particle and are projected in parallel.
+	* The constraints of color c are stored between color_offset[c] and color_offset[c+1]-1. */
+	struct pbd_distance_constraint
+	{
+		buffer<uint2> index;        // Index of the two particles
+		buffer<float> rest_length;
+		float compliance = 0.0f;    // Inverse of the stiffness (0 = infinitely stiff)
+
+		/** Internal data - Lagrange multipliers accumulated during a time step */
+		buffer<float> lambda;
+		/** Internal data - Start of each color in the constraint buffers (filled by pbd_system::update_coloring) */
+		buffer<unsigned int> color_offset;
+
+		size_t size() const;
+		size_t color_count() const;
+	};
+
+	/** Collision shapes (the particles are projected outside of them) */
+	struct pbd_collision_plane  { vec3 point; vec3 normal; };
+	struct pbd_collision_sphere { vec3 center; float radius; };
+
+	/** Position-based dynamics solver (XPBD) for cloth and ropes
+	* - Each time step predicts the positions under gravity, then iteratively projects the constraints (distance, bending, collisions), and deduces the velocities.
+	* - Bending is modeled by distance constraints between the opposite vertices of two adjacent triangles (or between particles i and i+2 along a rope), with their own compliance.
+	* - Distance and bending constraints are projected in Gauss-Seidel fashion color by color, each color being processed in parallel.
+	*   Colors are computed with a greedy graph coloring in the order of the constraints and always processed in the same order:
+	*   the result is deterministic and does not depend on the number of threads (parallel=false runs the same computation on the calling thread).
+	*
+	* update_coloring() must be called after the constraints are added/modified (done automatically by pbd_from_mesh). */
+	struct pbd_system
+	{
+		buffer<vec3> position;
+		buffer<vec3> velocity;
+		buffer<float> inverse_mass;  // 0 for fixed particles
+
+		pbd_distance_constraint stretch;
+		pbd_distance_constraint bending;
+		buffer<pbd_collision_plane> collision_plane;
+		buffer<pbd_collision_sphere> collision_sphere;
+
+		vec3 gravity = { 0,0,-9.81f };
+		float damping = 0.0f;      // Velocity damping per second
+		int iteration = 10;        // Number of solver iterations per time step
+		bool parallel = true;      // Projection of the colors and collisions using the parallel loops
+
+		/** Measure the time spent in each solver iteration (stored in iteration_time in milliseconds) */
+		bool timing = false;
+		buffer<double> iteration_time;
+
+		/** Add a particle and return its index (mass=0 creates a fixed particle) */
+		size_t add_particle(vec3 const& p, float mass, vec3 const& v = { 0,0,0 });
+		/** Add a distance constraint between particles i and j. The rest length is set to the current distance between the particles. */
+		size_t add_stretch(size_t i, size_t j);
+		size_t add_bending(size_t i, size_t j);
+		/** Constrain the particle i to remain at its current position */
+		void fix(size_t i);
+
+		/** Sort the distance and bending constraints by color (called after adding constraints) */
+		void update_coloring();
+
+		/** Advance the simulation by a time step dt */
+		void step(float dt);
+
+		/** Internal data - Predicted positions during the time step */
+		buffer<vec3> prediction;
+	};
+
+	/** Build a cloth from a mesh: each vertex becomes a particle, each edge a stretch constraint, and each pair of adjacent triangles a bending constraint.
+	* The total mass is uniformly distributed among the particles. */
+	pbd_system pbd_from_mesh(mesh const& shape, float mass_total = 1.0f, float stretch_compliance = 0.0f, float bending_compliance = 0.0f);
+	/** Build a rope from a polyline: stretch constraints between consecutive particles, bending constraints between particles i and i+2 */
+	pbd_system pbd_from_polyline(buffer<vec3> const& polyline, float mass_total = 1.0f, float stretch_compliance = 0.0f, float bending_compliance = 0.0f);
+
+	/** Greedy graph coloring of constraints: constraints sharing a particle receive different colors.
+	* Return the color of each constraint (colors are numbered from 0, and each constraint gets the smallest color available in the order of the constraints). */
+	buffer<unsigned int> pbd_greedy_coloring(buffer<uint2> const& constraint_index, size_t particle_count);
+}
@@ -0,0 +1,40 @@
+#include "benchmark_pbd.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/shape/mesh/primitive/mesh_primitive.hpp"
+#include "../pbd.hpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void benchmark_pbd()
+	{
+		int const N = 183; // ~100k stretch constraints
+		auto const t0 = std::chrono::steady_clock::now();
+		pbd_system cloth = pbd_from_mesh(mesh_primitive_grid({0,0,0},{1,0,0},{1,1,0},{0,1,0},N,N), 1.0f, 1e-7f, 1e-4f);
+		auto const t1 = std::chrono::steady_clock::now();
+		cloth.fix(0); cloth.fix(N-1);
+		cloth.collision_sphere.push_back({ {0.5f,0.5f,-0.3f}, 0.2f });
+		cloth.timing = true;
+
+		std::cout << "PBD cloth: " << cloth.position.size() << " particles, " << cloth.stretch.size() << " stretch (" << cloth.stretch.color_count() << " colors), "
+			<< cloth.bending.size() << " bending (" << cloth.bending.color_count() << " colors), " << parallel_thread_count() << " threads" << std::endl;
+		std::cout << "  construction and coloring : " << std::chrono::duration<double, std::milli>(t1-t0).count() << " ms" << std::endl;
+
+		int const N_step = 20;
+		double iteration_time = 0.0;
+		auto const t2 = std::chrono::steady_clock::now();
+		for (int k = 0; k < N_step; ++k) {
+			cloth.step(1/60.0f);
+			for (double t : cloth.iteration_time)
+				iteration_time += t;
+		}
+		auto const t3 = std::chrono::steady_clock::now();
+		double const time = std::chrono::duration<double>(t3-t2).count();
+		std::cout << "  step (" << cloth.iteration << " iterations) : " << N_step/time << " steps/s, " << iteration_time/(N_step*cloth.iteration) << " ms/iteration" << std::endl;
+	}
+}
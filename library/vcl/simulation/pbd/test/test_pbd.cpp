@@ -0,0 +1,106 @@
+#include "test_pbd.hpp"
+
+#include "vcl/base/base.hpp"
+#include "vcl/shape/mesh/primitive/mesh_primitive.hpp"
+#include "../pbd.hpp"
+
+#include <algorithm>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	// Check that two constraints of the same color never share a particle
+	static bool is_valid_coloring(pbd_distance_constraint const& constraint, size_t particle_count)
+	{
+		for (size_t color = 0; color < constraint.color_count(); ++color) {
+			buffer<int> used; used.resize_clear(particle_count);
+			for (size_t k = constraint.color_offset[color]; k < constraint.color_offset[color+1]; ++k) {
+				if (used[constraint.index[k].x] || used[constraint.index[k].y])
+					return false;
+				used[constraint.index[k].x] = 1;
+				used[constraint.index[k].y] = 1;
+			}
+		}
+		return true;
+	}
+
+	void test_pbd()
+	{
+		// Greedy coloring of a chain: alternating colors
+		{
+			buffer<unsigned int> const color = pbd_greedy_coloring({ {0,1},{1,2},{2,3},{3,4} }, 5);
+			assert_vcl_no_msg(color.size() == 4);
+			assert_vcl_no_msg(color[0]==0 && color[1]==1 && color[2]==0 && color[3]==1);
+		}
+
+		// Cloth from a grid: stretch constraints on the edges, bending constraints on the interior edges, valid colorings
+		{
+			int const N = 6;
+			pbd_system cloth = pbd_from_mesh(mesh_primitive_grid({0,0,0},{1,0,0},{1,1,0},{0,1,0},N,N));
+			assert_vcl_no_msg(cloth.position.size() == N*N);
+			assert_vcl_no_msg(cloth.stretch.size() == 2*(N-1)*N + (N-1)*(N-1));
+			assert_vcl_no_msg(cloth.bending.size() == 3*(N-1)*(N-1) - 2*(N-1));
+			assert_vcl_no_msg(cloth.stretch.color_offset[cloth.stretch.color_count()] == cloth.stretch.size());
+			assert_vcl_no_msg(is_valid_coloring(cloth.stretch, cloth.position.size()));
+			assert_vcl_no_msg(is_valid_coloring(cloth.bending, cloth.position.size()));
+		}
+
+		// Soft rope attached at one extremity: inextensible constraints preserve the length of the segments while it falls
+		{
+			buffer<vec3> polyline;
+			for (int k = 0; k < 10; ++k)
+				polyline.push_back({ 0.1f*k,0,0 });
+			pbd_system rope = pbd_from_polyline(polyline, 1.0f, 0.0f, 1.0f);
+			rope.fix(0);
+			rope.iteration = 50;
+			float z_min = 0.0f;
+			for (int k = 0; k < 100; ++k) {
+				rope.step(0.01f);
+				z_min = std::min(z_min, rope.position[9].z);
+			}
+
+			assert_vcl_no_msg(is_equal(rope.position[0], vec3{ 0,0,0 }));
+			for (int k = 0; k < 9; ++k)
+				assert_vcl_no_msg(std::abs(norm(rope.position[k+1]-rope.position[k]) - 0.1f) < 1e-3f);
+			assert_vcl_no_msg(z_min < -0.5f);
+		}
+
+		// Collisions: falling particles stay outside of the sphere and above the ground
+		{
+			pbd_system system;
+			for (int k = 0; k < 5; ++k)
+				system.add_particle({ 0.1f*k,0,1 }, 1.0f);
+			system.collision_sphere.push_back({ {0,0,0}, 0.5f });
+			system.collision_plane.push_back({ {0,0,-0.2f}, {0,0,2} });
+			system.update_coloring();
+			for (int k = 0; k < 100; ++k)
+				system.step(0.01f);
+
+			for (vec3 const& p : system.position) {
+				assert_vcl_no_msg(norm(p) >= 0.5f-1e-4f);
+				assert_vcl_no_msg(p.z >= -0.2f-1e-4f);
+			}
+		}
+
+		// Deterministic result: parallel and sequential projections give the same positions
+		{
+			int const N = 40;
+			pbd_system a = pbd_from_mesh(mesh_primitive_grid({0,0,0},{1,0,0},{1,1,0},{0,1,0},N,N), 1.0f, 1e-6f, 1e-4f);
+			a.fix(0); a.fix(N-1);
+			pbd_system b = a;
+			b.parallel = false;
+
+			size_t const thread_count = parallel_thread_count();
+			parallel_set_thread_count(4);
+			for (int k = 0; k < 10; ++k) {
+				a.step(1/60.0f);
+				b.step(1/60.0f);
+			}
+			parallel_set_thread_count(thread_count);
+
+			for (size_t k = 0; k < a.position.size(); ++k)
+				assert_vcl_no_msg(a.position[k].x==b.position[k].x && a.position[k].y==b.position[k].y && a.position[k].z==b.position[k].z);
+		}
+	}
+}
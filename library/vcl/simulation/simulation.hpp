@@ -0,0 +1,12 @@
+#pragma once
+
+// ***************************************************************** //
+// Simulation helpers
+//
+// Reusable solvers and data structures for physically based animation
+// ***************************************************************** //
+
+#include "particle_system/particle_system.hpp"
+#include "mass_spring/mass_spring.hpp"
+#include "pbd/pbd.hpp"
+#include "sph/sph.hpp"
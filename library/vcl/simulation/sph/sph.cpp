@@ -0,0 +1,253 @@
+#include "sph.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// The kernels below work on raw pointers and explicit x,y,z components: they loop over all neighbors of every particle and avoid the bound checks of the containers.
+
+namespace vcl
+{
+	// Index (i,j,k) of the cell containing p, clamped to the grid
+	static inline void cell_coordinates(vec3 const& p, vec3 const& p_min, float inv_h, size_t3 const& N, int& i, int& j, int& k)
+	{
+		i = std::min(std::max(int((p.x-p_min.x)*inv_h), 0), int(N.x)-1);
+		j = std::min(std::max(int((p.y-p_min.y)*inv_h), 0), int(N.y)-1);
+		k = std::min(std::max(int((p.z-p_min.z)*inv_h), 0), int(N.z)-1);
+	}
+
+	// Call f(j) for all particles j in the cells around the particle at position p (including the particle itself)
+	template <typename F>
+	static inline void for_each_neighbor(vec3 const& p, vec3 const& p_min, float inv_h, size_t3 const& N, uint2 const* cell, F const& f)
+	{
+		int ci, cj, ck;
+		cell_coordinates(p, p_min, inv_h, N, ci, cj, ck);
+		int const i_min = std::max(ci-1, 0), i_max = std::min(ci+1, int(N.x)-1);
+		int const j_min = std::max(cj-1, 0), j_max = std::min(cj+1, int(N.y)-1);
+		int const k_min = std::max(ck-1, 0), k_max = std::min(ck+1, int(N.z)-1);
+
+		// Same storage order as grid_3D: offset = i + Nx (j + Ny k)
+		//  The particles of consecutive cells along i are contiguous: each row of 3 cells is a single range.
+		for (int k = k_min; k <= k_max; ++k)
+			for (int j = j_min; j <= j_max; ++j) {
+				size_t const offset = N.x*(j + N.y*k);
+				unsigned int const n_end = cell[i_max + offset].y;
+				for (unsigned int n = cell[i_min + offset].x; n < n_end; ++n)
+					f(n);
+			}
+	}
+
+
+	size_t sph_system::add_particle(vec3 const& p, vec3 const& v)
+	{
+		position.push_back(p);
+		velocity.push_back(v);
+		return position.size()-1;
+	}
+
+	void sph_system::add_block(vec3 const& p_min, vec3 const& p_max, float spacing)
+	{
+		assert_vcl(spacing>0, "Spacing must be >0");
+		for (float z = p_min.z; z <= p_max.z; z += spacing)
+			for (float y = p_min.y; y <= p_max.y; y += spacing)
+				for (float x = p_min.x; x <= p_max.x; x += spacing)
+					add_particle({ x,y,z });
+	}
+
+	void sph_system::set_mass_from_spacing(float spacing)
+	{
+		parameters.mass = parameters.rho0 * spacing*spacing*spacing;
+	}
+
+	void sph_system::update_neighbor_grid()
+	{
+		size_t const N = position.size();
+		float const h = parameters.h;
+		assert_vcl(h>0, "SPH influence distance h must be >0");
+		assert_vcl(velocity.size()==N, "Incoherent size of particle attributes");
+
+		vec3 const extent = domain_max - domain_min;
+		size_t3 const N_cell = { std::max(size_t(1), size_t(std::ceil(extent.x/h))), std::max(size_t(1), size_t(std::ceil(extent.y/h))), std::max(size_t(1), size_t(std::ceil(extent.z/h))) };
+		if (cell_range.dimension.x!=N_cell.x || cell_range.dimension.y!=N_cell.y || cell_range.dimension.z!=N_cell.z)
+			cell_range.resize(N_cell);
+
+		// Cell of each particle
+		particle_cell.resize(N);
+		vec3 const* p = position.data.data();
+		unsigned int* c = particle_cell.data.data();
+		vec3 const p_min = domain_min;
+		float const inv_h = 1.0f/h;
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t n = k_begin; n < k_end; ++n) {
+				int i, j, k;
+				cell_coordinates(p[n], p_min, inv_h, N_cell, i, j, k);
+				c[n] = static_cast<unsigned int>(i + N_cell.x*(j + N_cell.y*k));
+			}
+		});
+
+		// Counting sort of the particles by cell (stable: the order of the particles in a cell is preserved)
+		size_t const N_total = cell_range.size();
+		uint2* cell = cell_range.data.data.data();
+		for (size_t k = 0; k < N_total; ++k)
+			cell[k] = { 0,0 };
+		for (size_t n = 0; n < N; ++n)
+			cell[c[n]].y++;
+		unsigned int offset = 0;
+		for (size_t k = 0; k < N_total; ++k) {
+			unsigned int const count = cell[k].y;
+			cell[k] = { offset, offset };
+			offset += count;
+		}
+		sorted_index.resize(N);
+		for (size_t n = 0; n < N; ++n)
+			sorted_index[cell[c[n]].y++] = static_cast<unsigned int>(n);
+
+		// Reorder the particle attributes: neighbors become close in memory
+		position_sorted.resize(N);
+		velocity_sorted.resize(N);
+		unsigned int const* index = sorted_index.data.data();
+		vec3 const* v = velocity.data.data();
+		vec3* p_sorted = position_sorted.data.data();
+		vec3* v_sorted = velocity_sorted.data.data();
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t n = k_begin; n < k_end; ++n) {
+				p_sorted[n] = p[index[n]];
+				v_sorted[n] = v[index[n]];
+			}
+		});
+		std::swap(position.data, position_sorted.data);
+		std::swap(velocity.data, velocity_sorted.data);
+	}
+
+	void sph_system::compute_density()
+	{
+		size_t const N = position.size();
+		density.resize(N);
+		pressure.resize(N);
+
+		float const h = parameters.h;
+		float const h2 = h*h;
+		float const m = parameters.mass;
+		float const rho0 = parameters.rho0;
+		float const B = rho0*parameters.stiffness/7.0f;
+		float const poly6 = 315.0f/(64.0f*pi*std::pow(h, 9.0f));
+
+		vec3 const* p = position.data.data();
+		float* rho = density.data.data();
+		float* P = pressure.data.data();
+		uint2 const* cell = cell_range.data.data.data();
+		size_t3 const N_cell = cell_range.dimension;
+		vec3 const p_min = domain_min;
+		float const inv_h = 1.0f/h;
+
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t i = k_begin; i < k_end; ++i)
+			{
+				vec3 const xi = p[i];
+				float sum = 0.0f;
+				for_each_neighbor(xi, p_min, inv_h, N_cell, cell, [&](unsigned int j) {
+					float const dx = xi.x-p[j].x, dy = xi.y-p[j].y, dz = xi.z-p[j].z;
+					float const r2 = dx*dx + dy*dy + dz*dz;
+					if (r2 < h2) {
+						float const d = h2-r2;
+						sum += d*d*d;
+					}
+				});
+				rho[i] = m*poly6*sum;
+
+				// Tait equation of state, negative pressures are clamped to avoid clustering
+				float const ratio = rho[i]/rho0;
+				float const ratio2 = ratio*ratio;
+				P[i] = std::max(0.0f, B*(ratio2*ratio2*ratio2*ratio - 1.0f));
+			}
+		}, 256);
+	}
+
+	void sph_system::compute_forces()
+	{
+		size_t const N = position.size();
+		assert_vcl(density.size()==N && pressure.size()==N, "compute_density() must be called before compute_forces()");
+		force.resize(N);
+
+		float const h = parameters.h;
+		float const h2 = h*h;
+		float const m = parameters.mass;
+		float const mu = parameters.viscosity;
+		float const spiky = 45.0f/(pi*std::pow(h, 6.0f)); // -gradient of the spiky kernel, and laplacian of the viscosity kernel
+		vec3 const g = gravity;
+
+		vec3 const* p = position.data.data();
+		vec3 const* v = velocity.data.data();
+		float const* rho = density.data.data();
+		float const* P = pressure.data.data();
+		vec3* f = force.data.data();
+		uint2 const* cell = cell_range.data.data.data();
+		size_t3 const N_cell = cell_range.dimension;
+		vec3 const p_min = domain_min;
+		float const inv_h = 1.0f/h;
+
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t i = k_begin; i < k_end; ++i)
+			{
+				vec3 const xi = p[i];
+				vec3 const vi = v[i];
+				float const Pi = P[i];
+				float fx = 0, fy = 0, fz = 0;
+				for_each_neighbor(xi, p_min, inv_h, N_cell, cell, [&](unsigned int j) {
+					float const dx = xi.x-p[j].x, dy = xi.y-p[j].y, dz = xi.z-p[j].z;
+					float const r2 = dx*dx + dy*dy + dz*dz;
+					if (r2 < h2 && j != i) {
+						float const r = std::sqrt(r2);
+						float const d = h-r;
+						float const inv_rho_j = 1.0f/rho[j];
+
+						// Pressure (symmetrized) - repulsive along the direction (pi-pj)
+						float const s_pressure = (r > 1e-9f) ? m*(Pi+P[j])*0.5f*inv_rho_j*spiky*d*d/r : 0.0f;
+						// Viscosity
+						float const s_viscosity = mu*m*inv_rho_j*spiky*d;
+
+						fx += s_pressure*dx + s_viscosity*(v[j].x-vi.x);
+						fy += s_pressure*dy + s_viscosity*(v[j].y-vi.y);
+						fz += s_pressure*dz + s_viscosity*(v[j].z-vi.z);
+					}
+				});
+				f[i] = { fx + rho[i]*g.x, fy + rho[i]*g.y, fz + rho[i]*g.z };
+			}
+		}, 256);
+	}
+
+	void sph_system::step(float dt)
+	{
+		size_t const N = position.size();
+		if (N == 0)
+			return;
+
+		update_neighbor_grid();
+		compute_density();
+		compute_forces();
+
+		vec3* p = position.data.data();
+		vec3* v = velocity.data.data();
+		float const* rho = density.data.data();
+		vec3 const* f = force.data.data();
+		vec3 const p_min = domain_min;
+		vec3 const p_max = domain_max;
+		float const e = restitution;
+
+		parallel_for_range(N, [=](size_t k_begin, size_t k_end) {
+			for (size_t i = k_begin; i < k_end; ++i)
+			{
+				float const inv_rho = 1.0f/rho[i];
+				v[i].x += dt*f[i].x*inv_rho; v[i].y += dt*f[i].y*inv_rho; v[i].z += dt*f[i].z*inv_rho;
+				p[i].x += dt*v[i].x; p[i].y += dt*v[i].y; p[i].z += dt*v[i].z;
+
+				// Collision with the walls of the box
+				for (int c = 0; c < 3; ++c) {
+					float& pc = p[i][c];
+					float& vc = v[i][c];
+					if (pc < p_min[c]) { pc = p_min[c]; if (vc < 0) vc = -e*vc; }
+					if (pc > p_max[c]) { pc = p_max[c]; if (vc > 0) vc = -e*vc; }
+				}
+			}
+		});
+	}
+}
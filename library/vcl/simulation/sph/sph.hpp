@@ -0,0 +1,61 @@
+#pragma once
+
+#include "vcl/containers/containers.hpp"
+#include "vcl/math/math.hpp"
+
+namespace vcl
+{
+	/** Physical parameters of the SPH fluid */
+	struct sph_parameters
+	{
+		float h = 0.12f;            // Influence distance of a particle (radius of the kernels)
+		float rho0 = 1000.0f;       // Rest density
+		float mass = 1.0f;          // Mass of each particle
+		float stiffness = 400.0f;   // Square of the numerical speed of sound in the Tait equation of state (stable time step: dt < 0.4 h/sqrt(stiffness))
+		float viscosity = 20.0f;    // Dynamic viscosity (also damps the numerical noise of the weakly compressible model)
+	};
+
+	/** Weakly compressible SPH fluid (WCSPH) in a box
+	* - Particle attributes are stored in separate buffers (position, velocity, density, pressure, force).
+	* - Neighbors are found using a cell list: the box is divided into cells of size h, and cell_range(i,j,k) stores the range of particles in the cell.
+	*   The particles are sorted by cell at each time step: the order of the particles changes over time.
+	* - The density/pressure pass and the force pass (pressure + viscosity) are computed per particle in parallel, gathering the contributions of the neighbors (no atomics).
+	* - The solver does not depend on the display and can run without window. */
+	struct sph_system
+	{
+		buffer<vec3> position;
+		buffer<vec3> velocity;
+		buffer<float> density;
+		buffer<float> pressure;
+		buffer<vec3> force;
+
+		sph_parameters parameters;
+		vec3 gravity = { 0,0,-9.81f };
+		vec3 domain_min = { -1,-1,-1 }; // Box containing the fluid
+		vec3 domain_max = {  1, 1, 1 };
+		float restitution = 0.5f;       // Fraction of the normal velocity kept after a collision with the box
+
+		/** Add a particle and return its index */
+		size_t add_particle(vec3 const& p, vec3 const& v = { 0,0,0 });
+		/** Fill the box [p_min,p_max] with particles on a regular grid of spacing "spacing" */
+		void add_block(vec3 const& p_min, vec3 const& p_max, float spacing);
+		/** Set the particle mass such that particles placed on a grid of the given spacing are at rest density */
+		void set_mass_from_spacing(float spacing);
+
+		/** Sort the particles in the cells of size h */
+		void update_neighbor_grid();
+		/** Compute the density and the pressure of each particle */
+		void compute_density();
+		/** Compute the pressure, viscosity and gravity forces */
+		void compute_forces();
+		/** Advance the simulation by a time step dt (neighbor grid, density, forces, then semi-implicit Euler and collision with the box) */
+		void step(float dt);
+
+		/** Internal data - Cell list: particles of cell (i,j,k) are stored at index cell_range(i,j,k).x ... cell_range(i,j,k).y-1 */
+		grid_3D<uint2> cell_range;
+		/** Internal data - Temporary buffers used to sort the particles by cell */
+		buffer<unsigned int> particle_cell;
+		buffer<unsigned int> sorted_index;
+		buffer<vec3> position_sorted, velocity_sorted;
+	};
+}
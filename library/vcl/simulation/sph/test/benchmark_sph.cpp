@@ -0,0 +1,50 @@
+#include "benchmark_sph.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../sph.hpp"
+
+#include <chrono>
+#include <iostream>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void benchmark_sph()
+	{
+		// Dam break with ~100k particles
+		sph_system fluid;
+		float const spacing = 0.02f;
+		fluid.parameters.h = 2*spacing;
+		fluid.set_mass_from_spacing(spacing);
+		fluid.domain_min = { 0,0,0 };
+		fluid.domain_max = { 3,1,1.5f };
+		fluid.add_block({ 0.01f,0.01f,0.01f }, { 1.5f,0.96f,0.6f }, spacing);
+
+		std::cout << "SPH dam break: " << fluid.position.size() << " particles, " << parallel_thread_count() << " threads" << std::endl;
+
+		int const N_step = 20;
+		double time_grid = 0, time_density = 0, time_forces = 0;
+		for (int k = 0; k < N_step; ++k) {
+			auto const ta = std::chrono::steady_clock::now();
+			fluid.update_neighbor_grid();
+			auto const tb = std::chrono::steady_clock::now();
+			fluid.compute_density();
+			auto const tc = std::chrono::steady_clock::now();
+			fluid.compute_forces();
+			auto const td = std::chrono::steady_clock::now();
+			time_grid += std::chrono::duration<double, std::milli>(tb-ta).count();
+			time_density += std::chrono::duration<double, std::milli>(tc-tb).count();
+			time_forces += std::chrono::duration<double, std::milli>(td-tc).count();
+		}
+		std::cout << "  neighbor grid : " << time_grid/N_step << " ms/step" << std::endl;
+		std::cout << "  density       : " << time_density/N_step << " ms/step" << std::endl;
+		std::cout << "  forces        : " << time_forces/N_step << " ms/step" << std::endl;
+
+		auto const t2 = std::chrono::steady_clock::now();
+		for (int k = 0; k < N_step; ++k)
+			fluid.step(0.001f);
+		auto const t3 = std::chrono::steady_clock::now();
+		std::cout << "  full step     : " << N_step/std::chrono::duration<double>(t3-t2).count() << " steps/s" << std::endl;
+	}
+}
@@ -0,0 +1,73 @@
+#include "test_sph.hpp"
+
+#include "vcl/base/base.hpp"
+#include "../sph.hpp"
+
+#include <algorithm>
+
+using namespace vcl;
+
+namespace vcl_test
+{
+	void test_sph()
+	{
+		// Density computed with the cell list is equal to the brute-force sum over all particles
+		{
+			sph_system fluid;
+			fluid.domain_min = { 0,0,0 };
+			fluid.domain_max = { 1,1,1 };
+			fluid.parameters.h = 0.15f;
+			for (int k = 0; k < 500; ++k)
+				fluid.add_particle({ rand_interval(), rand_interval(), rand_interval() });
+			fluid.update_neighbor_grid();
+			fluid.compute_density();
+
+			float const h = fluid.parameters.h;
+			float const poly6 = 315.0f/(64.0f*pi*std::pow(h, 9.0f));
+			for (size_t i = 0; i < fluid.position.size(); ++i) {
+				float rho = 0.0f;
+				for (size_t j = 0; j < fluid.position.size(); ++j) {
+					float const r2 = dot(fluid.position[i]-fluid.position[j], fluid.position[i]-fluid.position[j]);
+					if (r2 < h*h)
+						rho += fluid.parameters.mass*poly6*std::pow(h*h-r2, 3.0f);
+				}
+				assert_vcl_no_msg(std::abs(fluid.density[i]-rho) <= 1e-4f*rho);
+			}
+
+			// The cells contain all the particles, and each particle is in the cell of its position
+			size_t3 const N = fluid.cell_range.dimension;
+			assert_vcl_no_msg(N.x==7 && N.y==7 && N.z==7);
+			assert_vcl_no_msg(fluid.cell_range(size_t(N.x-1), size_t(N.y-1), size_t(N.z-1)).y == fluid.position.size());
+			for (size_t k = 0; k < N.z; ++k)
+				for (size_t j = 0; j < N.y; ++j)
+					for (size_t i = 0; i < N.x; ++i)
+						for (unsigned int n = fluid.cell_range(i,j,k).x; n < fluid.cell_range(i,j,k).y; ++n)
+							assert_vcl_no_msg(size_t(fluid.position[n].x/h)==i && size_t(fluid.position[n].y/h)==j && size_t(fluid.position[n].z/h)==k);
+		}
+
+		// Block of fluid falling in a box: the particles remain in the box and the fluid settles at the rest density
+		{
+			sph_system fluid;
+			float const spacing = 0.04f;
+			fluid.parameters.h = 2*spacing;
+			fluid.set_mass_from_spacing(spacing);
+			fluid.domain_min = { 0,0,0 };
+			fluid.domain_max = { 0.6f,0.3f,1.0f };
+			fluid.add_block({ 0.02f,0.02f,0.02f }, { 0.3f,0.28f,0.5f }, spacing);
+
+			for (int k = 0; k < 1500; ++k)
+				fluid.step(0.001f);
+
+			float rho_mean = 0.0f;
+			float v_max = 0.0f;
+			for (size_t k = 0; k < fluid.position.size(); ++k) {
+				vec3 const& p = fluid.position[k];
+				assert_vcl_no_msg(p.x>=0 && p.x<=0.6f && p.y>=0 && p.y<=0.3f && p.z>=0 && p.z<=1.0f);
+				rho_mean += fluid.density[k]/fluid.position.size();
+				v_max = std::max(v_max, norm(fluid.velocity[k]));
+			}
+			assert_vcl_no_msg(std::abs(rho_mean-fluid.parameters.rho0) < 0.1f*fluid.parameters.rho0);
+			assert_vcl_no_msg(v_max < 1.0f);
+		}
+	}
+}
@@ -27,8 +27,10 @@
 #include "files/files.hpp"
 
 #include "shape/shape.hpp"
+#include "simulation/simulation.hpp"
 
 #include "display/display.hpp"
 #include "shaders_preset/shaders_preset.hpp"
+#include "animation/animation.hpp"
 
 #include "interaction/interaction.hpp"
\ No newline at end of file
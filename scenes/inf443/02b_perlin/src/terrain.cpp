@@ -12,33 +12,16 @@ mesh initialize_terrain()
 
 void update_terrain(mesh& terrain, mesh_drawable& terrain_visual, perlin_noise_parameters const& parameters)
 {
-	// Number of samples in each direction (assuming a square grid)
-	int const N = std::sqrt(terrain.position.size());
-
-	// Recompute the new vertices
-	for (int ku = 0; ku < N; ++ku) {
-		for (int kv = 0; kv < N; ++kv) {
-			
-			// Compute local parametric coordinates (u,v) \in [0,1]
-            const float u = ku/(N-1.0f);
-            const float v = kv/(N-1.0f);
-
-			int const idx = ku*N+kv;
-
-			// Compute the Perlin noise
-			float const noise = noise_perlin({u, v}, parameters.octave, parameters.persistency, parameters.frequency_gain);
-
-			// use the noise as height value
-			terrain.position[idx].z = parameters.terrain_height*noise;
-
-			// use also the noise as color value
-			terrain.color[idx] = 0.3f*vec3(0,0.5f,0)+0.7f*noise*vec3(1,1,1);
-		}
+	// Compute the new vertices and their exact normals from the gradient of the noise
+	//  The vertex of parametric coordinates (u,v) \in [0,1]^2 is placed at (x,y) = (-1,-1) + 2(u,v) and z = terrain_height * noise(u,v)
+	update_terrain_noise_perlin(terrain, {-1,-1}, {1,1}, parameters.terrain_height, parameters.octave, parameters.persistency, parameters.frequency_gain);
+
+	// use also the noise as color value
+	for (size_t idx = 0; idx < terrain.position.size(); ++idx) {
+		float const n = terrain.position[idx].z / parameters.terrain_height;
+		terrain.color[idx] = 0.3f*vec3(0,0.5f,0)+0.7f*n*vec3(1,1,1);
 	}
 
-	// Update the normal of the mesh structure
-	terrain.compute_normal();
-	
 	// Update step: Allows to update a mesh_drawable without creating a new one
 	terrain_visual.update_position(terrain.position);
 	terrain_visual.update_normal(terrain.normal);
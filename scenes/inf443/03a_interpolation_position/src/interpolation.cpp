@@ -1,5 +1,7 @@
 #include "interpolation.hpp"
 
+#include <algorithm>
+
 using namespace vcl;
 
 /** Compute the linear interpolation p(t) between p1 at time t1 and p2 at time t2*/
@@ -71,8 +73,8 @@ size_t find_index_of_interval(float t, buffer<float> const& intervals)
     }
 
 
-    size_t k=0;
-    while( intervals[k+1]<t )
-        ++k;
+    // Binary search of the first value intervals[k+1] >= t
+    auto const it = std::lower_bound(intervals.data.begin()+1, intervals.data.end(), t);
+    size_t const k = size_t(it - intervals.data.begin()) - 1;
     return k;
 }
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include "vcl/vcl.hpp"
 #include <iostream>
-#include <list>
 
 
 using namespace vcl;
@@ -27,13 +26,6 @@ struct scene_environment
 scene_environment scene;
 
 
-// Structure of a particle
-struct particle_structure
-{
-    vcl::vec3 p; // Position
-    vcl::vec3 v; // Speed
-};
-
 void mouse_move_callback(GLFWwindow* window, double xpos, double ypos);
 void window_size_callback(GLFWwindow* window, int width, int height);
 
@@ -42,10 +34,10 @@ void display_interface();
 void display_frame();
 
 
-std::list<particle_structure> particles; // Storage of all currently active particles
+particle_system particles; // Storage of all currently active particles
+particle_emitter emitter(0.6f); // Periodic creation of new particles
 mesh_drawable sphere;
 mesh_drawable disc;
-timer_event_periodic timer(0.6f);
 
 int main(int, char* argv[])
 {
@@ -119,7 +111,13 @@ void initialize_data()
 	sphere.shading.color = {0.5f,0.5f,1.0f};
 	disc = mesh_drawable( mesh_primitive_disc(2.0f) );
 	disc.transform.translate = {0,0,-r};
-	
+
+	// Initial random velocity (x,y) components are uniformly distributed along a circle.
+	emitter.generator = [](vec3& p0, vec3& v0) {
+		const float theta = rand_interval(0,2*pi);
+		p0 = {0,0,0};
+		v0 = vec3( std::cos(theta), std::sin(theta), 5.0f);
+	};
 
 }
 
@@ -128,48 +126,19 @@ void display_frame()
 {
 
 	draw(disc, scene);
-	float const dt = timer.update();
-
-	bool const new_particle = timer.event;
-	if (new_particle == true) {
-		vec3 const p0 = {0,0,0};
-
-		// Initial random velocity (x,y) components are uniformly distributed along a circle.
-        const float theta = rand_interval(0,2*pi);
-        const vec3 v0 = vec3( std::cos(theta), std::sin(theta), 5.0f);
-
-		particles.push_back({p0,v0});
-	}
+	float const dt = emitter.update(particles);
 
 	// Evolve position of particles
-    const vec3 g = {0.0f,0.0f,-9.81f};
-    for(particle_structure& particle : particles)
-    {
-        const float m = 0.01f; // particle mass
-
-        vec3& p = particle.p;
-        vec3& v = particle.v;
-
-        const vec3 F = m*g;
-
-        // Numerical integration
-        v = v + dt*F/m;
-        p = p + dt*v;
-    }
-
+	const vec3 g = {0.0f,0.0f,-9.81f};
+	particles.integrate(dt, g);
 
 	// Remove particles that are too low
-    for(auto it = particles.begin(); it!=particles.end(); ){
-        if( it->p.z < -3)
-            it = particles.erase(it);
-		if(it!=particles.end())
-			++it;
-	}
+	particles.remove_if([](vec3 const& p, vec3 const&, float) { return p.z < -3; });
 
 	// Display particles
-    for(particle_structure& particle : particles)
+    for(vec3 const& p : particles.p)
     {
-        sphere.transform.translate = particle.p;
+        sphere.transform.translate = p;
         draw(sphere, scene);
     }
 
@@ -182,7 +151,7 @@ void display_frame()
 void display_interface()
 {
 	ImGui::Checkbox("Frame", &user.gui.display_frame);
-	ImGui::SliderFloat("Scale", &timer.scale, 0.0f, 3.0f, "%.3f", 2.0f);
+	ImGui::SliderFloat("Scale", &emitter.timer.scale, 0.0f, 3.0f, "%.3f", 2.0f);
 }
 
 
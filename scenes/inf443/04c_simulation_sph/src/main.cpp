@@ -0,0 +1,209 @@
+#include "vcl/vcl.hpp"
+#include <iostream>
+
+
+using namespace vcl;
+
+struct gui_parameters {
+	bool display_frame = true;
+	bool run = true;
+};
+
+struct user_interaction_parameters {
+	vec2 mouse_prev;
+	timer_fps fps_record;
+	mesh_drawable global_frame;
+	gui_parameters gui;
+	bool cursor_on_gui;
+};
+user_interaction_parameters user;
+
+struct scene_environment
+{
+	camera_around_center camera;
+	mat4 projection;
+	vec3 light;
+};
+scene_environment scene;
+
+
+void mouse_move_callback(GLFWwindow* window, double xpos, double ypos);
+void window_size_callback(GLFWwindow* window, int width, int height);
+
+void initialize_data();
+void display_interface();
+void display_frame();
+
+
+int main(int, char* argv[])
+{
+	std::cout << "Run " << argv[0] << std::endl;
+
+	int const width = 1280, height = 1024;
+	GLFWwindow* window = create_window(width, height);
+	window_size_callback(window, width, height);
+	std::cout << opengl_info_display() << std::endl;;
+
+	imgui_init(window);
+	glfwSetCursorPosCallback(window, mouse_move_callback);
+	glfwSetWindowSizeCallback(window, window_size_callback);
+	
+	std::cout<<"Initialize data ..."<<std::endl;
+	initialize_data();
+
+	std::cout<<"Start animation loop ..."<<std::endl;
+	user.fps_record.start();
+	glEnable(GL_DEPTH_TEST);
+	while (!glfwWindowShouldClose(window))
+	{
+		scene.light = scene.camera.position();
+		user.fps_record.update();
+		
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glClear(GL_DEPTH_BUFFER_BIT);
+		imgui_create_frame();
+		if(user.fps_record.event) {
+			std::string const title = "VCL Display - "+str(user.fps_record.fps)+" fps";
+			glfwSetWindowTitle(window, title.c_str());
+		}
+
+		ImGui::Begin("GUI",NULL,ImGuiWindowFlags_AlwaysAutoResize);
+		user.cursor_on_gui = ImGui::GetIO().WantCaptureMouse;
+
+		if(user.gui.display_frame) draw(user.global_frame, scene);
+
+		display_interface();
+		display_frame();
+
+
+		ImGui::End();
+		imgui_render_frame(window);
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	imgui_cleanup();
+	glfwDestroyWindow(window);
+	glfwTerminate();
+
+	return 0;
+}
+
+
+sph_system fluid;         // SPH particles (positions, velocities, densities, ...)
+points_drawable particles; // Display of the particles as point sprites
+segments_drawable box;     // Borders of the domain
+timer_fixed_step timer(0.002f, 10); // The weakly compressible fluid requires small time steps: dt < 0.4 h/sqrt(stiffness)
+
+void initialize_fluid()
+{
+	float const spacing = 0.04f;
+	fluid = sph_system();
+	fluid.parameters.h = 2*spacing;
+	fluid.set_mass_from_spacing(spacing);
+	fluid.domain_min = {-1.0f,-0.5f,0.0f};
+	fluid.domain_max = { 1.0f, 0.5f,1.5f};
+	fluid.add_block({-0.98f,-0.48f,0.02f}, {-0.2f,0.48f,0.8f}, spacing);
+}
+
+void initialize_data()
+{
+	// Basic setups of shaders and camera
+	GLuint const shader_mesh = opengl_create_shader_program(opengl_shader_preset("mesh_vertex"), opengl_shader_preset("mesh_fragment"));
+	GLuint const shader_single_color = opengl_create_shader_program(opengl_shader_preset("single_color_vertex"), opengl_shader_preset("single_color_fragment"));
+	GLuint const shader_points = opengl_create_shader_program(opengl_shader_preset("points_vertex"), opengl_shader_preset("points_fragment"));
+	mesh_drawable::default_shader = shader_mesh;
+	mesh_drawable::default_texture = opengl_texture_to_gpu(image_raw{1,1,image_color_type::rgba,{255,255,255,255}});
+	segments_drawable::default_shader = shader_single_color;
+	points_drawable::default_shader = shader_points;
+
+	user.global_frame = mesh_drawable(mesh_primitive_frame());
+	scene.camera.distance_to_center = 10.0f;
+	scene.camera.look_at({2,-3,2}, {0,0,0.5}, {0,0,1});
+
+	initialize_fluid();
+	particles = points_drawable(fluid.position);
+	particles.radius = 0.02f;
+
+	// 12 edges of the box
+	vec3 const& a = fluid.domain_min;
+	vec3 const& b = fluid.domain_max;
+	buffer<vec3> const corners = { {a.x,a.y,a.z},{b.x,a.y,a.z},{b.x,b.y,a.z},{a.x,b.y,a.z},{a.x,a.y,b.z},{b.x,a.y,b.z},{b.x,b.y,b.z},{a.x,b.y,b.z} };
+	buffer<vec3> edges;
+	for (int k = 0; k < 4; ++k) {
+		edges.push_back(corners[k]);   edges.push_back(corners[(k+1)%4]);
+		edges.push_back(corners[k+4]); edges.push_back(corners[(k+1)%4+4]);
+		edges.push_back(corners[k]);   edges.push_back(corners[k+4]);
+	}
+	box = segments_drawable(edges);
+}
+
+
+void display_frame()
+{
+	// Fixed time steps independent of the frame rate
+	//  The particles are reordered at each step: the display shows the last state without interpolation
+	timer.update([](float dt) { fluid.step(dt); });
+
+	particles.update(fluid.position);
+	draw(particles, scene);
+	draw(box, scene);
+}
+
+
+void display_interface()
+{
+	ImGui::Checkbox("Frame", &user.gui.display_frame);
+	if (ImGui::Checkbox("Run", &user.gui.run)) {
+		if (user.gui.run) timer.start();
+		else timer.stop();
+	}
+	ImGui::SliderFloat("Viscosity", &fluid.parameters.viscosity, 1.0f, 100.0f);
+	ImGui::SliderFloat("Gravity", &fluid.gravity.z, -20.0f, 0.0f);
+	ImGui::SliderFloat("Time scale", &timer.scale, 0.0f, 2.0f);
+	ImGui::Text("%d particles", int(fluid.position.size()));
+	ImGui::Text("%d steps/frame, %.2f ms/step (%lld dropped)", timer.step_last_frame, 1000*timer.step_time_average, timer.step_dropped);
+	if (ImGui::Button("Restart"))
+		initialize_fluid();
+}
+
+
+void window_size_callback(GLFWwindow* , int width, int height)
+{
+	glViewport(0, 0, width, height);
+	float const aspect = width / static_cast<float>(height);
+	scene.projection = projection_perspective(50.0f*pi/180.0f, aspect, 0.1f, 100.0f);
+}
+
+
+void mouse_move_callback(GLFWwindow* window, double xpos, double ypos)
+{
+	vec2 const  p1 = glfw_get_mouse_cursor(window, xpos, ypos);
+	vec2 const& p0 = user.mouse_prev;
+	glfw_state state = glfw_current_state(window);
+
+
+
+	auto& camera = scene.camera;
+	if(!user.cursor_on_gui){
+		if(state.mouse_click_left && !state.key_ctrl)
+			scene.camera.manipulator_rotate_trackball(p0, p1);
+		if(state.mouse_click_left && state.key_ctrl)
+			camera.manipulator_translate_in_plane(p1-p0);
+		if(state.mouse_click_right)
+			camera.manipulator_scale_distance_to_center( (p1-p0).y );
+	}
+
+	user.mouse_prev = p1;
+}
+
+void opengl_uniform(GLuint shader, scene_environment const& current_scene)
+{
+	opengl_uniform(shader, "projection", current_scene.projection);
+	opengl_uniform(shader, "view", current_scene.camera.matrix_view());
+	opengl_uniform(shader, "light", current_scene.light, false);
+}
+
+
+